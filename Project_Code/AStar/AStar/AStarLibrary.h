@@ -4,10 +4,26 @@
 #include "Coordinates2D.h"
 #include "AStarResult.h"
 #include "MinHeap.h"
+#include "ClearanceMap.h"
+#include "WorldMapSnapshot.h"
+#include "TiledWorldMap.h"
+#include "SearchTrace.h"
 #include <vector>
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
 using std::vector;
 
+//heuristics that can be used by the search; the Euclidean distance is calculated directly,
+//while the other heuristics are looked up in a table indexed by the row and column distances
+const int HEURISTIC_EUCLIDEAN = 0;
+const int HEURISTIC_MANHATTAN = 1;
+const int HEURISTIC_CHEBYSHEV = 2;
+
+//the heuristic table covers row and column distances below this value, so its size doesn't depend on the size of the map;
+//the heuristic of farther fields is calculated directly
+const int HEURISTIC_TABLE_SIZE = 128;
+
 //<summary>
 //Class used for finding a best path between
 //two points on a grid using the A* algorithm.
@@ -15,29 +31,105 @@ using std::vector;
 class AStarLibrary
 {
 public:
+	AStarLibrary();
+
 	//implementation of the A* algorithm for grids
 	AStarResult AStar(Coordinates2D source, Coordinates2D destination);
 
 	//used for storing the map of the environment
 	vector<vector<double>> WorldMap;
 
-private:
-	//calculates a heuristic between the source and destination vertex
+	//optional map of distances to the closest obstacle; if it is set, the fields
+	//on which a robot with radius 'RobotRadius' doesn't fit are not expanded
+	ClearanceMap* Clearance;
+
+	//radius of the robot in fields; only used if 'Clearance' is set
+	double RobotRadius;
+
+	//optional snapshot of a versioned map; if it is set, the costs are read from it instead of 'WorldMap'
+	const WorldMapSnapshot* Snapshot;
+
+	//optional map stored in a tiled map file; if it is set (and 'Snapshot' is not), the costs are read from it instead of 'WorldMap'
+	TiledWorldMap* Tiles;
+
+	//optional trace; if it is set, the push, pop and decrease-key events of the search are recorded in it
+	SearchTrace* Trace;
+
+	//optional mask of the fields (indexed by row * number of columns + column) to which the search is restricted;
+	//if it is set, the fields with value 0 are not expanded
+	const vector<unsigned char>* Corridor;
+
+	//the heuristic used by the search (one of the 'HEURISTIC_' constants); all of them assume that moving to a field costs at least 1
+	int Heuristic;
+
+	//number of nodes generated and number of heuristic values calculated since the library was created
+	unsigned long long NumberOfGeneratedNodes;
+	unsigned long long NumberOfHeuristicEvaluations;
+
+	//calculates a heuristic between the source and destination vertex; throws an exception
+	//if the heuristic is table-driven and the table wasn't prepared by a search with the same heuristic
 	double CalculateHeuristic(Coordinates2D source, Coordinates2D destination);
 
+private:
+	//checks whether the robot fits on the field with grid coordinates 'x' and 'y'
+	bool FieldAllowed(int x, int y);
+
+	//returns the cost of moving to the field with grid coordinates 'x' and 'y'
+	double GetFieldCost(int x, int y);
+
+	//returns the number of rows of the map
+	int GetNumberOfRows();
+
+	//returns the number of columns of the map
+	int GetNumberOfColumns();
+
+	//prepares the heuristic table for the next search
+	void PrepareHeuristic();
+
+	//returns the heuristic of the field with grid coordinates 'x' and 'y' and counts the calculation
+	double GetHeuristic(int x, int y, Coordinates2D destination);
+
 	//returns the nodes adjacent to 'node'
-	vector<AStarNode> GetAdjacent(AStarNode node, Coordinates2D destination);
+	vector<AStarNode> GetAdjacent(AStarNode node);
+
+	//heuristic values indexed by the row distance * 'HEURISTIC_TABLE_SIZE' + the column distance; used by the table-driven heuristics
+	vector<double> heuristicTable;
+	int heuristicTableType;
 };
 
 
+//<summary>
+//Default constructor; the robot is treated as a single field, so no clearance map is used.
+//</summary>
+AStarLibrary::AStarLibrary()
+{
+	this->Clearance = NULL;
+	this->RobotRadius = 0.0;
+	this->Snapshot = NULL;
+	this->Tiles = NULL;
+	this->Trace = NULL;
+	this->Corridor = NULL;
+	this->Heuristic = HEURISTIC_EUCLIDEAN;
+	this->NumberOfGeneratedNodes = 0;
+	this->NumberOfHeuristicEvaluations = 0;
+	this->heuristicTableType = -1;
+}
+
 //<summary>
 //Implementation of the A* algorithm for finding a shortest path between 'source' and 'destination'.
 //Uses a heap for speeding up the operation that looks for the least costly vertex at a given iteration.
+//The heuristic of a field is only calculated when the field is inserted on the heap or its node is updated.
 //</summary>
 //<param name='source'>Object containing the grid coordinates of the source field.</param>
 //<param name='destination'>Object containing the grid coordinates of the destination field.</param>
 AStarResult AStarLibrary::AStar(Coordinates2D source, Coordinates2D destination)
 {
+	//there is no path if the robot doesn't fit on the destination field
+	if(!this->FieldAllowed(destination.X, destination.Y))
+		return AStarResult();
+
+	this->PrepareHeuristic();
+
 	//used for storing the vertices currently on the open list
 	MinHeap open;
 
@@ -47,6 +139,8 @@ AStarResult AStarLibrary::AStar(Coordinates2D source, Coordinates2D destination)
 	//we create a node for the source vertex and insert it on the heap
 	AStarNode node(source, 0.0, 0.0);
 	open.Insert(node);
+	if(this->Trace != NULL)
+		this->Trace->Push(source.X, source.Y, node.TotalCost);
 
 	//used for indicating if the shortest path to the goal is found or not
 	bool pathFound = false;
@@ -62,6 +156,8 @@ AStarResult AStarLibrary::AStar(Coordinates2D source, Coordinates2D destination)
 	{
 		//we take the node with the least cost at the moment
 		currentNode = open.ExtractMin();
+		if(this->Trace != NULL)
+			this->Trace->Pop(currentNode.NodeCoordinates.X, currentNode.NodeCoordinates.Y);
 
 		//we append the node to the list of processed nodes
 		closed.push_back(currentNode);
@@ -74,7 +170,8 @@ AStarResult AStarLibrary::AStar(Coordinates2D source, Coordinates2D destination)
 		}
 
 		//we take the vertices adjacent to the currently processed node
-		adjacent = this->GetAdjacent(currentNode, destination);
+		adjacent = this->GetAdjacent(currentNode);
+		this->NumberOfGeneratedNodes += adjacent.size();
 
 		//we look at each of the adjacent nodes and perform appropriate actions
 		//depending on whether the node is already on the open list, is already on the closed list,
@@ -86,13 +183,17 @@ AStarResult AStarLibrary::AStar(Coordinates2D source, Coordinates2D destination)
 			int nodePosition = open.GetIndex(adjacent[i].NodeCoordinates);
 
 			//if the node is on the open list, we check if we found a better path to it;
-			//if that is the case, we update the node's info and restore the heap properties
+			//if that is the case, we update the node's info and restore the heap properties;
+			//the heuristic of a field doesn't change, so it is enough to compare the costs
 			if(nodePosition != -1)
 			{
-				if(open.nodes[nodePosition].TotalCost > adjacent[i].TotalCost)
+				if(open.nodes[nodePosition].Cost > adjacent[i].Cost)
 				{
+					adjacent[i].TotalCost = adjacent[i].Cost + this->GetHeuristic(adjacent[i].NodeCoordinates.X, adjacent[i].NodeCoordinates.Y, destination);
 					open.nodes[nodePosition] = adjacent[i];
 					open.BubbleUp(nodePosition);
+					if(this->Trace != NULL)
+						this->Trace->DecreaseKey(adjacent[i].NodeCoordinates.X, adjacent[i].NodeCoordinates.Y, adjacent[i].TotalCost);
 				}
 			}
 			//if the node is not on the open list, we check if it is on the closed list;
@@ -110,7 +211,12 @@ AStarResult AStarLibrary::AStar(Coordinates2D source, Coordinates2D destination)
 				}
 
 				if(!nodeClosed)
+				{
+					adjacent[i].TotalCost = adjacent[i].Cost + this->GetHeuristic(adjacent[i].NodeCoordinates.X, adjacent[i].NodeCoordinates.Y, destination);
 					open.Insert(adjacent[i]);
+					if(this->Trace != NULL)
+						this->Trace->Push(adjacent[i].NodeCoordinates.X, adjacent[i].NodeCoordinates.Y, adjacent[i].TotalCost);
+				}
 			}
 		}
 	}//end of the main loop in the algorithm
@@ -167,107 +273,134 @@ AStarResult AStarLibrary::AStar(Coordinates2D source, Coordinates2D destination)
 }
 
 //<summary>
-//Returns a value for the heuristic function as Euclidean distance between
-//the coordinates of 'source' and 'destination'.
+//Returns a value for the heuristic function between the coordinates of 'source' and 'destination'.
+//The Euclidean distance is calculated directly; the other heuristics are taken from the heuristic table
+//(or calculated directly if the distances are outside of the table), so 'PrepareHeuristic' has to be called before.
 //</summary>
 //<param name='source'>The vertex for which we want to return a heuristic function.</param>
 //<param name='destination'>The vertex that is the destination of the desired path.</param>
 //<returns>A value for the heuristic function.</returns>
 double AStarLibrary::CalculateHeuristic(Coordinates2D source, Coordinates2D destination)
 {
+	if(this->Heuristic != HEURISTIC_EUCLIDEAN)
+	{
+		if(this->heuristicTableType != this->Heuristic)
+			throw "Heuristic table not prepared";
+
+		int differenceX = abs(destination.X - source.X);
+		int differenceY = abs(destination.Y - source.Y);
+		if(differenceX < HEURISTIC_TABLE_SIZE && differenceY < HEURISTIC_TABLE_SIZE)
+			return this->heuristicTable[differenceX * HEURISTIC_TABLE_SIZE + differenceY];
+
+		if(this->Heuristic == HEURISTIC_MANHATTAN)
+			return differenceX + differenceY;
+		return differenceX > differenceY ? differenceX : differenceY;
+	}
+
 	//we calculate the heuristic as a Euclidean distance between the coordinates of the source and destination cells
 	double heuristic = sqrt(((destination.X - source.X) * (destination.X - source.X) * 1.0)
 					 +		((destination.Y- source.Y) * (destination.Y - source.Y) * 1.0));
 	return heuristic;
 }
 
+//<summary>
+//Builds the heuristic table if a table-driven heuristic is used and the table doesn't belong to it.
+//</summary>
+void AStarLibrary::PrepareHeuristic()
+{
+	if(this->Heuristic != HEURISTIC_EUCLIDEAN && this->heuristicTableType != this->Heuristic)
+	{
+		this->heuristicTable.resize(HEURISTIC_TABLE_SIZE * HEURISTIC_TABLE_SIZE);
+		for(int x=0; x<HEURISTIC_TABLE_SIZE; x++)
+		{
+			for(int y=0; y<HEURISTIC_TABLE_SIZE; y++)
+			{
+				if(this->Heuristic == HEURISTIC_MANHATTAN)
+					this->heuristicTable[x * HEURISTIC_TABLE_SIZE + y] = x + y;
+				else
+					this->heuristicTable[x * HEURISTIC_TABLE_SIZE + y] = x > y ? x : y;
+			}
+		}
+		this->heuristicTableType = this->Heuristic;
+	}
+}
+
+//<summary>
+//Returns the heuristic of the field with grid coordinates 'x' and 'y'. The search only calls it for the fields that are
+//inserted on the open list or updated; the values aren't cached, since complete searches with a hash map of the calculated
+//values weren't faster than without it (looking a value up costs about as much as a square root or a table lookup).
+//</summary>
+//<param name='x'>Row of the field.</param>
+//<param name='y'>Column of the field.</param>
+//<param name='destination'>The destination vertex of the desired path.</param>
+double AStarLibrary::GetHeuristic(int x, int y, Coordinates2D destination)
+{
+	this->NumberOfHeuristicEvaluations++;
+	return this->CalculateHeuristic(Coordinates2D(x, y), destination);
+}
+
 //<summary>
 //Returns a list of nodes adjacent to 'node'. Assumes that we can't make diagonal movements.
-//For each adjacent vertex, calculates the value of 
+//For each adjacent vertex, calculates the cost g(x) to reach the adjacent vertex; the value of
 //			f(x) = g(x) + h(x)
-//where g(x) is the cost to reach the adjacent vertex, while h(x)
-//is the value of the heuristic function for the adjacent vertex.
+//is calculated by the search only for the nodes that are inserted on the open list or updated,
+//so that the heuristic h(x) isn't calculated for nodes that are already closed or not improved.
 //</summary>
 //<param name='node'>The vertex whose adjacent vertices we want to take.</param>
-//<param name='destination'>The destination vertex of the desired shortest path.</param>
-vector<AStarNode> AStarLibrary::GetAdjacent(AStarNode node, Coordinates2D destination)
+vector<AStarNode> AStarLibrary::GetAdjacent(AStarNode node)
 {
 	vector<AStarNode> adjacentNodes;
 	
 	//we take the left adjacent vertex if the current node is not on the left bound
-	if(node.NodeCoordinates.X+1 < this->WorldMap[0].size())
+	if(node.NodeCoordinates.X+1 < this->GetNumberOfRows() && this->FieldAllowed(node.NodeCoordinates.X+1, node.NodeCoordinates.Y))
 	{
 		Coordinates2D newCoordinates(node.NodeCoordinates.X+1, node.NodeCoordinates.Y);
 
 		//we calculate the cost as a sum of the cost to reach the current vertex and the
 		//cost to go to the adjacent vertex (the function g(x))
-		double cost = node.Cost + this->WorldMap[newCoordinates.X][newCoordinates.Y];
+		double cost = node.Cost + this->GetFieldCost(newCoordinates.X, newCoordinates.Y);
 
-		//we calculate the heuristic (the function h(x))
-		double heuristic = this->CalculateHeuristic(newCoordinates, destination);
-
-		//we calculate f(x) = g(x) + h(x)
-		double totalCost = cost + heuristic;
-
-		//we add the new node to the list of adjacent nodes
-		AStarNode newNode(newCoordinates, node.NodeCoordinates, cost, totalCost);
+		//we add the new node to the list of adjacent nodes; f(x) is calculated later
+		AStarNode newNode(newCoordinates, node.NodeCoordinates, cost, -1.0);
 		adjacentNodes.push_back(newNode);
 	}
 
-	if(node.NodeCoordinates.X-1 >= 0)
+	if(node.NodeCoordinates.X-1 >= 0 && this->FieldAllowed(node.NodeCoordinates.X-1, node.NodeCoordinates.Y))
 	{
 		Coordinates2D newCoordinates(node.NodeCoordinates.X-1, node.NodeCoordinates.Y);
 
 		//we calculate the cost as a sum of the cost to reach the current vertex and the
 		//cost to go to the adjacent vertex (the function g(x))
-		double cost = node.Cost + this->WorldMap[newCoordinates.X][newCoordinates.Y];
-
-		//we calculate the heuristic (the function h(x))
-		double heuristic = this->CalculateHeuristic(newCoordinates, destination);
+		double cost = node.Cost + this->GetFieldCost(newCoordinates.X, newCoordinates.Y);
 
-		//we calculate f(x) = g(x) + h(x)
-		double totalCost = cost + heuristic;
-
-		//we add the new node to the list of adjacent nodes
-		AStarNode newNode(newCoordinates, node.NodeCoordinates, cost, totalCost);
+		//we add the new node to the list of adjacent nodes; f(x) is calculated later
+		AStarNode newNode(newCoordinates, node.NodeCoordinates, cost, -1.0);
 		adjacentNodes.push_back(newNode);
 	}
 
-	if(node.NodeCoordinates.Y-1 >= 0)
+	if(node.NodeCoordinates.Y-1 >= 0 && this->FieldAllowed(node.NodeCoordinates.X, node.NodeCoordinates.Y-1))
 	{
 		Coordinates2D newCoordinates(node.NodeCoordinates.X, node.NodeCoordinates.Y-1);
 
 		//we calculate the cost as a sum of the cost to reach the current vertex and the
 		//cost to go to the adjacent vertex (the function g(x))
-		double cost = node.Cost + this->WorldMap[newCoordinates.X][newCoordinates.Y];
-
-		//we calculate the heuristic (the function h(x))
-		double heuristic = this->CalculateHeuristic(newCoordinates, destination);
+		double cost = node.Cost + this->GetFieldCost(newCoordinates.X, newCoordinates.Y);
 
-		//we calculate f(x) = g(x) + h(x)
-		double totalCost = cost + heuristic;
-
-		//we add the new node to the list of adjacent nodes
-		AStarNode newNode(newCoordinates, node.NodeCoordinates, cost, totalCost);
+		//we add the new node to the list of adjacent nodes; f(x) is calculated later
+		AStarNode newNode(newCoordinates, node.NodeCoordinates, cost, -1.0);
 		adjacentNodes.push_back(newNode);
 	}
 
-	if(node.NodeCoordinates.Y+1 < this->WorldMap.size())
+	if(node.NodeCoordinates.Y+1 < this->GetNumberOfColumns() && this->FieldAllowed(node.NodeCoordinates.X, node.NodeCoordinates.Y+1))
 	{
 		Coordinates2D newCoordinates(node.NodeCoordinates.X, node.NodeCoordinates.Y+1);
 
 		//we calculate the cost as a sum of the cost to reach the current vertex and the
 		//cost to go to the adjacent vertex (the function g(x))
-		double cost = node.Cost + this->WorldMap[newCoordinates.X][newCoordinates.Y];
-
-		//we calculate the heuristic (the function h(x))
-		double heuristic = this->CalculateHeuristic(newCoordinates, destination);
-
-		//we calculate f(x) = g(x) + h(x)
-		double totalCost = cost + heuristic;
+		double cost = node.Cost + this->GetFieldCost(newCoordinates.X, newCoordinates.Y);
 
-		//we add the new node to the list of adjacent nodes
-		AStarNode newNode(newCoordinates, node.NodeCoordinates, cost, totalCost);
+		//we add the new node to the list of adjacent nodes; f(x) is calculated later
+		AStarNode newNode(newCoordinates, node.NodeCoordinates, cost, -1.0);
 		adjacentNodes.push_back(newNode);
 	}
 
@@ -278,10 +411,8 @@ vector<AStarNode> AStarLibrary::GetAdjacent(AStarNode node, Coordinates2D destin
 	//{
 	//	Coordinates2D newCoordinates(node.NodeCoordinates.X+1, node.NodeCoordinates.Y-1);
 	//	double cost = node.Cost + this->WorldMap[newCoordinates.X][newCoordinates.Y];
-	//	double heuristic = this->CalculateHeuristic(newCoordinates, destination);
-	//	double totalCost = cost + heuristic;
 
-	//	AStarNode newNode(newCoordinates, node.NodeCoordinates, cost, totalCost);
+	//	AStarNode newNode(newCoordinates, node.NodeCoordinates, cost, -1.0);
 	//	adjacentNodes.push_back(newNode);
 	//}
 
@@ -289,10 +420,8 @@ vector<AStarNode> AStarLibrary::GetAdjacent(AStarNode node, Coordinates2D destin
 	//{
 	//	Coordinates2D newCoordinates(node.NodeCoordinates.X-1, node.NodeCoordinates.Y-1);
 	//	double cost = node.Cost + this->WorldMap[newCoordinates.X][newCoordinates.Y];
-	//	double heuristic = this->CalculateHeuristic(newCoordinates, destination);
-	//	double totalCost = cost + heuristic;
 
-	//	AStarNode newNode(newCoordinates, node.NodeCoordinates, cost, totalCost);
+	//	AStarNode newNode(newCoordinates, node.NodeCoordinates, cost, -1.0);
 	//	adjacentNodes.push_back(newNode);
 	//}
 
@@ -300,10 +429,8 @@ vector<AStarNode> AStarLibrary::GetAdjacent(AStarNode node, Coordinates2D destin
 	//{
 	//	Coordinates2D newCoordinates(node.NodeCoordinates.X+1, node.NodeCoordinates.Y+1);
 	//	double cost = node.Cost + this->WorldMap[newCoordinates.X][newCoordinates.Y];
-	//	double heuristic = this->CalculateHeuristic(newCoordinates, destination);
-	//	double totalCost = cost + heuristic;
 
-	//	AStarNode newNode(newCoordinates, node.NodeCoordinates, cost, totalCost);
+	//	AStarNode newNode(newCoordinates, node.NodeCoordinates, cost, -1.0);
 	//	adjacentNodes.push_back(newNode);
 	//}
 
@@ -311,14 +438,65 @@ vector<AStarNode> AStarLibrary::GetAdjacent(AStarNode node, Coordinates2D destin
 	//{
 	//	Coordinates2D newCoordinates(node.NodeCoordinates.X-1, node.NodeCoordinates.Y+1);
 	//	double cost = node.Cost + this->WorldMap[newCoordinates.X][newCoordinates.Y];
-	//	double heuristic = this->CalculateHeuristic(newCoordinates, destination);
-	//	double totalCost = cost + heuristic;
 
-	//	AStarNode newNode(newCoordinates, node.NodeCoordinates, cost, totalCost);
+	//	AStarNode newNode(newCoordinates, node.NodeCoordinates, cost, -1.0);
 	//	adjacentNodes.push_back(newNode);
 	//}
 
 	return adjacentNodes;
 }
 
+//<summary>
+//Returns true if the field with grid coordinates 'x' and 'y' is inside 'Corridor' (if it is set) and
+//no clearance map is used or a robot with radius 'RobotRadius' fits on the field. The distances to the obstacles are
+//precalculated in the clearance map, so there is no need to check the footprint of the robot.
+//</summary>
+//<param name='x'>Row of the field.</param>
+//<param name='y'>Column of the field.</param>
+bool AStarLibrary::FieldAllowed(int x, int y)
+{
+	if(this->Corridor != NULL && (*this->Corridor)[x * this->GetNumberOfColumns() + y] == 0)
+		return false;
+
+	return this->Clearance == NULL || this->Clearance->HasClearance(x, y, this->RobotRadius);
+}
+
+
+//<summary>
+//Returns the cost of moving to the field with grid coordinates 'x' and 'y',
+//taken from 'Snapshot' or 'Tiles' if one of them is set and from 'WorldMap' otherwise.
+//</summary>
+double AStarLibrary::GetFieldCost(int x, int y)
+{
+	if(this->Snapshot != NULL)
+		return this->Snapshot->GetCost(x, y);
+	if(this->Tiles != NULL)
+		return this->Tiles->GetCost(x, y);
+	return this->WorldMap[x][y];
+}
+
+//<summary>
+//Returns the number of rows of 'Snapshot' or 'Tiles' if one of them is set or of 'WorldMap' otherwise.
+//</summary>
+int AStarLibrary::GetNumberOfRows()
+{
+	if(this->Snapshot != NULL)
+		return this->Snapshot->NumberOfRows;
+	if(this->Tiles != NULL)
+		return this->Tiles->NumberOfRows;
+	return this->WorldMap.size();
+}
+
+//<summary>
+//Returns the number of columns of 'Snapshot' or 'Tiles' if one of them is set or of 'WorldMap' otherwise.
+//</summary>
+int AStarLibrary::GetNumberOfColumns()
+{
+	if(this->Snapshot != NULL)
+		return this->Snapshot->NumberOfColumns;
+	if(this->Tiles != NULL)
+		return this->Tiles->NumberOfColumns;
+	return this->WorldMap[0].size();
+}
+
 #endif
\ No newline at end of file
@@ -9,6 +9,18 @@ class AStarVisualWorldMap : public VisualWorldMap
 public:
 	AStarVisualWorldMap();
 
+	//stores the result of a search and marks the fields whose expanded state changed
+	void SetSearchResult(const AStarResult& result);
+
+	//returns true if the field was expanded by the search
+	bool IsExpanded(int row, int column) const;
+
+	//marks a field as expanded or not expanded, e.g. while a search is replayed
+	void SetExpanded(int row, int column, bool expanded);
+
+	//marks a field as being on the open list or not
+	void SetOpen(int row, int column, bool open);
+
 	//stores a source vertex
 	Coordinates2D Source;
 
@@ -20,11 +32,58 @@ public:
 
 	//stores the shortest path and the expanded nodes by the algorithm
 	AStarResult ShortestPathAndExpandedNodes;
+
+	//indicates whether the shortest path changed since it was last drawn
+	bool PathChanged;
 };
 
 AStarVisualWorldMap::AStarVisualWorldMap()
 {
 	this->ShortestPathFound = false;
+	this->PathChanged = true;
+}
+
+//<summary>
+//Stores 'result' as the result of the search shown on the grid. The fields expanded by the previous search
+//are cleared and the fields expanded by this one are set, so only the fields that differ are drawn again.
+//Should be called after 'SetVisualMap'.
+//</summary>
+//<param name='result'>The shortest path and the expanded nodes found by a search on the grid.</param>
+void AStarVisualWorldMap::SetSearchResult(const AStarResult& result)
+{
+	for(unsigned int i=0; i<this->ShortestPathAndExpandedNodes.ExpandedNodes.size(); i++)
+		this->SetFieldFlag(this->ShortestPathAndExpandedNodes.ExpandedNodes[i].X, this->ShortestPathAndExpandedNodes.ExpandedNodes[i].Y, FIELD_EXPANDED, false);
+
+	for(unsigned int i=0; i<result.ExpandedNodes.size(); i++)
+		this->SetFieldFlag(result.ExpandedNodes[i].X, result.ExpandedNodes[i].Y, FIELD_EXPANDED, true);
+
+	this->ShortestPathAndExpandedNodes = result;
+	this->PathChanged = true;
+}
+
+//<summary>
+//Returns true if the field with grid coordinates 'row' and 'column' was expanded by the search and false otherwise.
+//</summary>
+bool AStarVisualWorldMap::IsExpanded(int row, int column) const
+{
+	return (this->fieldFlags[row * this->NumberOfColumns + column] & FIELD_EXPANDED) != 0;
+}
+
+//<summary>
+//Marks the field with grid coordinates 'row' and 'column' as expanded if 'expanded' is true and as not expanded otherwise.
+//</summary>
+void AStarVisualWorldMap::SetExpanded(int row, int column, bool expanded)
+{
+	this->SetFieldFlag(row, column, FIELD_EXPANDED, expanded);
+}
+
+//<summary>
+//Marks the field with grid coordinates 'row' and 'column' as being on the open list of the search if 'open' is true
+//and as not being on it otherwise.
+//</summary>
+void AStarVisualWorldMap::SetOpen(int row, int column, bool open)
+{
+	this->SetFieldFlag(row, column, FIELD_OPEN, open);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,255 @@
+#ifndef CLEARANCE_MAP_H
+#define CLEARANCE_MAP_H
+
+#include "Coordinates2D.h"
+#include "DrawingConstants.h"
+#include <vector>
+#include <cmath>
+using std::vector;
+
+//used instead of infinity for fields that have no obstacle in their row or column
+const double CLEARANCE_INFINITY = 1e20;
+
+//<summary>
+//Class that stores the Euclidean distance from each field of a grid to the closest obstacle. The fields outside the grid
+//count as obstacles, so the distance of a field is never larger than its distance to the row or column just outside the border.
+//The distances are calculated exactly in linear time using the separable algorithm by Felzenszwalb and Huttenlocher:
+//first a one-dimensional transform is calculated for each column and then for each row of the column results.
+//Both passes are cached, so changing a few fields only requires recalculating the columns of the changed
+//fields and the rows in which those column results changed.
+//</summary>
+class ClearanceMap
+{
+public:
+	ClearanceMap();
+
+	//calculates the distances for the grid given by 'worldMap'
+	void Build(const vector<vector<double>>& worldMap);
+
+	//recalculates the distances after the fields in 'changedFields' were changed in 'worldMap'
+	void UpdateFields(const vector<vector<double>>& worldMap, const vector<Coordinates2D>& changedFields);
+
+	//returns the distance between a field and the closest obstacle
+	double GetClearance(int x, int y);
+
+	//checks whether a robot with radius 'robotRadius' can be placed on a field
+	bool HasClearance(int x, int y, double robotRadius);
+
+	int NumberOfRows;
+	int NumberOfColumns;
+
+private:
+	//calculates the one-dimensional transform of the column 'column'
+	void TransformColumn(int column);
+
+	//calculates the one-dimensional transform of the row 'row' using the column results and limits it by the distances to the border
+	void TransformRow(int row);
+
+	//calculates the one-dimensional squared distance transform of 'numberOfValues' values
+	void Transform(const double* values, double* distances, int numberOfValues);
+
+	//indicates whether each field is an obstacle
+	vector<bool> obstacles;
+
+	//squared distances to the closest obstacle in the same column
+	vector<double> columnDistances;
+
+	//squared distances to the closest obstacle
+	vector<double> squaredDistances;
+
+	//buffers used by 'Transform'
+	vector<double> input;
+	vector<double> output;
+	vector<int> parabolaVertices;
+	vector<double> parabolaBoundaries;
+};
+
+
+//<summary>
+//Default constructor; creates an empty map.
+//</summary>
+ClearanceMap::ClearanceMap()
+{
+	this->NumberOfRows = 0;
+	this->NumberOfColumns = 0;
+}
+
+//<summary>
+//Calculates the distance from each field of 'worldMap' to the closest obstacle.
+//A field is an obstacle if its value is equal to OBSTACLE_DELIMITER.
+//</summary>
+//<param name='worldMap'>A logical grid.</param>
+void ClearanceMap::Build(const vector<vector<double>>& worldMap)
+{
+	this->NumberOfRows = worldMap.size();
+	this->NumberOfColumns = worldMap[0].size();
+
+	int numberOfFields = this->NumberOfRows * this->NumberOfColumns;
+	this->obstacles.assign(numberOfFields, false);
+	this->columnDistances.assign(numberOfFields, CLEARANCE_INFINITY);
+	this->squaredDistances.assign(numberOfFields, CLEARANCE_INFINITY);
+
+	int longerSide = this->NumberOfRows > this->NumberOfColumns ? this->NumberOfRows : this->NumberOfColumns;
+	this->input.resize(longerSide);
+	this->output.resize(longerSide);
+	this->parabolaVertices.resize(longerSide);
+	this->parabolaBoundaries.resize(longerSide + 1);
+
+	for(int x=0; x<this->NumberOfRows; x++)
+		for(int y=0; y<this->NumberOfColumns; y++)
+			this->obstacles[x * this->NumberOfColumns + y] = fabs(worldMap[x][y] - OBSTACLE_DELIMITER) < 0.005;
+
+	for(int y=0; y<this->NumberOfColumns; y++)
+		this->TransformColumn(y);
+
+	for(int x=0; x<this->NumberOfRows; x++)
+		this->TransformRow(x);
+}
+
+//<summary>
+//Updates the distances after the fields in 'changedFields' were changed in 'worldMap'.
+//Only the columns that contain changed obstacles and the rows whose column results changed are recalculated,
+//so the result is the same as if the whole map was built again.
+//</summary>
+//<param name='worldMap'>The changed logical grid.</param>
+//<param name='changedFields'>The fields that were changed.</param>
+void ClearanceMap::UpdateFields(const vector<vector<double>>& worldMap, const vector<Coordinates2D>& changedFields)
+{
+	vector<bool> columnChanged(this->NumberOfColumns, false);
+	for(unsigned int i=0; i<changedFields.size(); i++)
+	{
+		int x = changedFields[i].X;
+		int y = changedFields[i].Y;
+		bool isObstacle = fabs(worldMap[x][y] - OBSTACLE_DELIMITER) < 0.005;
+
+		if(this->obstacles[x * this->NumberOfColumns + y] != isObstacle)
+		{
+			this->obstacles[x * this->NumberOfColumns + y] = isObstacle;
+			columnChanged[y] = true;
+		}
+	}
+
+	vector<bool> rowChanged(this->NumberOfRows, false);
+	vector<double> previousColumn(this->NumberOfRows);
+	for(int y=0; y<this->NumberOfColumns; y++)
+	{
+		if(!columnChanged[y])
+			continue;
+
+		for(int x=0; x<this->NumberOfRows; x++)
+			previousColumn[x] = this->columnDistances[x * this->NumberOfColumns + y];
+
+		this->TransformColumn(y);
+
+		for(int x=0; x<this->NumberOfRows; x++)
+			if(previousColumn[x] != this->columnDistances[x * this->NumberOfColumns + y])
+				rowChanged[x] = true;
+	}
+
+	for(int x=0; x<this->NumberOfRows; x++)
+		if(rowChanged[x])
+			this->TransformRow(x);
+}
+
+//<summary>
+//Returns the Euclidean distance (in fields) between the center of the field with grid coordinates 'x' and 'y'
+//and the center of the closest obstacle or the closest field outside the grid; returns 0 for obstacles.
+//</summary>
+double ClearanceMap::GetClearance(int x, int y)
+{
+	return sqrt(this->squaredDistances[x * this->NumberOfColumns + y]);
+}
+
+//<summary>
+//Returns true if a robot with radius 'robotRadius' (in fields) that is placed in the center of the field
+//with grid coordinates 'x' and 'y' doesn't reach the center of any obstacle or of any field outside the grid,
+//so the robot stays inside the map. A single comparison is needed, since the distances are precalculated.
+//</summary>
+bool ClearanceMap::HasClearance(int x, int y, double robotRadius)
+{
+	return this->squaredDistances[x * this->NumberOfColumns + y] > robotRadius * robotRadius;
+}
+
+//<summary>
+//Calculates the squared distance from each field in the column 'column' to the closest obstacle in the same column.
+//</summary>
+void ClearanceMap::TransformColumn(int column)
+{
+	for(int x=0; x<this->NumberOfRows; x++)
+		this->input[x] = this->obstacles[x * this->NumberOfColumns + column] ? 0.0 : CLEARANCE_INFINITY;
+
+	this->Transform(&this->input[0], &this->output[0], this->NumberOfRows);
+
+	for(int x=0; x<this->NumberOfRows; x++)
+		this->columnDistances[x * this->NumberOfColumns + column] = this->output[x];
+}
+
+//<summary>
+//Calculates the squared distance from each field in the row 'row' to the closest obstacle by transforming the column
+//results of the row. The fields outside the grid form full rows and columns around it, so the closest of them is straight
+//above, below, left or right of a field and the distances to them only need to be compared with the transformed ones.
+//</summary>
+void ClearanceMap::TransformRow(int row)
+{
+	double* distances = &this->squaredDistances[row * this->NumberOfColumns];
+	this->Transform(&this->columnDistances[row * this->NumberOfColumns], distances, this->NumberOfColumns);
+
+	int rowBorder = row + 1 < this->NumberOfRows - row ? row + 1 : this->NumberOfRows - row;
+	for(int y=0; y<this->NumberOfColumns; y++)
+	{
+		int border = y + 1 < this->NumberOfColumns - y ? y + 1 : this->NumberOfColumns - y;
+		if(rowBorder < border)
+			border = rowBorder;
+
+		if((double)border * border < distances[y])
+			distances[y] = (double)border * border;
+	}
+}
+
+//<summary>
+//Calculates d(p) = min over q of ((p - q)^2 + f(q)) for each p by finding the lower envelope of the parabolas
+//rooted at each q; the calculation is linear in the number of values. The squares are calculated in floating point,
+//since they overflow an int for rows or columns longer than 46340 fields.
+//</summary>
+//<param name='values'>The values f(q).</param>
+//<param name='distances'>Array in which the results are stored.</param>
+//<param name='numberOfValues'>The number of values.</param>
+void ClearanceMap::Transform(const double* values, double* distances, int numberOfValues)
+{
+	int* vertices = &this->parabolaVertices[0];
+	double* boundaries = &this->parabolaBoundaries[0];
+
+	//we find the parabolas that form the lower envelope and the points where they intersect
+	int k = 0;
+	vertices[0] = 0;
+	boundaries[0] = -CLEARANCE_INFINITY;
+	boundaries[1] = CLEARANCE_INFINITY;
+	for(int q=1; q<numberOfValues; q++)
+	{
+		double intersection = ((values[q] + (double)q * q) - (values[vertices[k]] + (double)vertices[k] * vertices[k])) / (2.0 * (q - vertices[k]));
+		while(intersection <= boundaries[k])
+		{
+			k--;
+			intersection = ((values[q] + (double)q * q) - (values[vertices[k]] + (double)vertices[k] * vertices[k])) / (2.0 * (q - vertices[k]));
+		}
+
+		k++;
+		vertices[k] = q;
+		boundaries[k] = intersection;
+		boundaries[k+1] = CLEARANCE_INFINITY;
+	}
+
+	//we take the value of the envelope at each point
+	k = 0;
+	for(int q=0; q<numberOfValues; q++)
+	{
+		while(boundaries[k+1] < q)
+			k++;
+
+		double difference = q - vertices[k];
+		double distance = difference * difference + values[vertices[k]];
+		distances[q] = distance < CLEARANCE_INFINITY ? distance : CLEARANCE_INFINITY;
+	}
+}
+
+#endif
\ No newline at end of file
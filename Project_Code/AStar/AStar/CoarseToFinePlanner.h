@@ -0,0 +1,223 @@
+#ifndef COARSE_TO_FINE_PLANNER_H
+#define COARSE_TO_FINE_PLANNER_H
+
+#include "AStarLibrary.h"
+#include "CostPyramid.h"
+#include "MapCellUpdate.h"
+#include <vector>
+using std::vector;
+
+//<summary>
+//Class used for finding paths on big grids in two steps. A path is first found on a coarse level of a cost pyramid built
+//from the grid; the coarse fields on that path and the ones around it form a corridor, and the A* search on the grid
+//only expands the fields inside the corridor. The path is not guaranteed to be a shortest path: the coarser the level
+//and the narrower the corridor, the faster the search and the more expensive the path can be.
+//</summary>
+class CoarseToFinePlanner
+{
+public:
+	CoarseToFinePlanner();
+
+	//sets the grid and builds the cost pyramid
+	void SetWorldMap(const vector<vector<double>>& worldMap);
+
+	//changes the costs of a few fields of the grid and updates the cost pyramid
+	void UpdateFields(const vector<MapCellUpdate>& updates);
+
+	//finds a path between the source and destination field
+	AStarResult FindPath(Coordinates2D source, Coordinates2D destination);
+
+	//the level of the pyramid on which the coarse path is found; with 0, the whole grid is searched
+	int Level;
+
+	//the number of coarse fields around each field of the coarse path that also belong to the corridor
+	int CorridorRadius;
+
+	//the way in which the costs of the pyramid are aggregated (one of the 'PYRAMID_' constants); only PYRAMID_MAXIMUM_COST
+	//keeps the coarse path away from expensive fields, PYRAMID_ANY_OBSTACLE only keeps it away from obstacles
+	int Aggregation;
+
+	//number of searches that found no path inside the corridor and were repeated on the whole grid
+	unsigned long long NumberOfFallbacks;
+
+private:
+	//builds the cost pyramid again if 'Level' or 'Aggregation' changed
+	void PreparePyramid();
+
+	//marks the fields covered by the coarse fields near 'coarsePath' as the corridor
+	void MarkCorridor(const vector<Coordinates2D>& coarsePath);
+
+	//sets the corridor value of the fields covered by a coarse field
+	void SetCorridorBlock(Coordinates2D coarseField, unsigned char value);
+
+	//searches on the grid and on the coarse level
+	AStarLibrary fineLibrary;
+	AStarLibrary coarseLibrary;
+
+	CostPyramid pyramid;
+
+	//set when the coarse level has to be copied to 'coarseLibrary' before the next search
+	bool coarseLevelChanged;
+
+	//the corridor of the last search and the coarse fields that were marked in it, so that only they have to be cleared
+	vector<unsigned char> corridor;
+	vector<Coordinates2D> corridorFields;
+};
+
+
+//<summary>
+//Default constructor; coarse paths are found on level 3 (8x8 fields), with a corridor radius of 1 and PYRAMID_MAXIMUM_COST.
+//</summary>
+CoarseToFinePlanner::CoarseToFinePlanner()
+{
+	this->Level = 3;
+	this->CorridorRadius = 1;
+	this->Aggregation = PYRAMID_MAXIMUM_COST;
+	this->NumberOfFallbacks = 0;
+	this->coarseLevelChanged = true;
+}
+
+//<summary>
+//Sets the grid on which paths are found and builds the cost pyramid for it.
+//</summary>
+//<param name='worldMap'>A logical grid.</param>
+void CoarseToFinePlanner::SetWorldMap(const vector<vector<double>>& worldMap)
+{
+	this->fineLibrary.WorldMap = worldMap;
+	this->corridor.assign(worldMap.size() * worldMap[0].size(), 0);
+	this->corridorFields.clear();
+
+	this->pyramid.Aggregation = this->Aggregation;
+	this->pyramid.Build(worldMap, this->Level);
+	this->coarseLevelChanged = true;
+}
+
+//<summary>
+//Changes the costs of the fields in 'updates' and recalculates only the coarse fields above them.
+//</summary>
+//<param name='updates'>The fields to change and their new costs.</param>
+void CoarseToFinePlanner::UpdateFields(const vector<MapCellUpdate>& updates)
+{
+	vector<Coordinates2D> changedFields;
+	for(unsigned int i=0; i<updates.size(); i++)
+	{
+		this->fineLibrary.WorldMap[updates[i].Field.X][updates[i].Field.Y] = updates[i].Cost;
+		changedFields.push_back(updates[i].Field);
+	}
+
+	this->pyramid.UpdateFields(this->fineLibrary.WorldMap, changedFields);
+	this->coarseLevelChanged = true;
+}
+
+//<summary>
+//Finds a path between 'source' and 'destination'. The coarse path is found on level 'Level' of the pyramid (or on the
+//coarsest level if the pyramid has fewer levels) and the search on the grid is restricted to the corridor around it.
+//If there is no path inside the corridor (e.g. because a clearance map is used), the whole grid is searched.
+//</summary>
+//<param name='source'>Object containing the grid coordinates of the source field.</param>
+//<param name='destination'>Object containing the grid coordinates of the destination field.</param>
+AStarResult CoarseToFinePlanner::FindPath(Coordinates2D source, Coordinates2D destination)
+{
+	this->PreparePyramid();
+	if(this->pyramid.NumberOfLevels == 0)
+		return this->fineLibrary.AStar(source, destination);
+
+	if(this->coarseLevelChanged)
+	{
+		this->coarseLibrary.WorldMap = this->pyramid.GetLevel(this->pyramid.NumberOfLevels);
+		this->coarseLevelChanged = false;
+	}
+
+	int blockSize = 1 << this->pyramid.NumberOfLevels;
+	Coordinates2D coarseSource(source.X / blockSize, source.Y / blockSize);
+	Coordinates2D coarseDestination(destination.X / blockSize, destination.Y / blockSize);
+	this->MarkCorridor(this->coarseLibrary.AStar(coarseSource, coarseDestination).ShortestPath);
+
+	this->fineLibrary.Corridor = &this->corridor;
+	AStarResult result = this->fineLibrary.AStar(source, destination);
+	this->fineLibrary.Corridor = NULL;
+
+	if(result.ShortestPath.empty())
+	{
+		this->NumberOfFallbacks++;
+		result = this->fineLibrary.AStar(source, destination);
+	}
+
+	return result;
+}
+
+//<summary>
+//Builds the cost pyramid again if the number of levels or the aggregation differ from 'Level' and 'Aggregation';
+//a pyramid with fewer levels than 'Level' is only built again if the grid allows more levels.
+//</summary>
+void CoarseToFinePlanner::PreparePyramid()
+{
+	bool levelChanged = this->pyramid.NumberOfLevels > this->Level;
+	if(this->pyramid.NumberOfLevels < this->Level)
+	{
+		const vector<vector<double>>& coarsestLevel = this->pyramid.NumberOfLevels > 0 ? this->pyramid.GetLevel(this->pyramid.NumberOfLevels) : this->fineLibrary.WorldMap;
+		levelChanged = coarsestLevel.size() > 1 || coarsestLevel[0].size() > 1;
+	}
+
+	if(levelChanged || this->pyramid.Aggregation != this->Aggregation)
+	{
+		this->pyramid.Aggregation = this->Aggregation;
+		this->pyramid.Build(this->fineLibrary.WorldMap, this->Level);
+		this->coarseLevelChanged = true;
+
+		//the marked coarse fields of the previous corridor belong to the old level
+		this->corridor.assign(this->corridor.size(), 0);
+		this->corridorFields.clear();
+	}
+}
+
+//<summary>
+//Clears the corridor of the previous search and marks all fields covered by the coarse fields that are at most
+//'CorridorRadius' coarse fields away (in rows and columns) from a field of 'coarsePath'.
+//</summary>
+//<param name='coarsePath'>A path on the coarse level used by the last search.</param>
+void CoarseToFinePlanner::MarkCorridor(const vector<Coordinates2D>& coarsePath)
+{
+	for(unsigned int i=0; i<this->corridorFields.size(); i++)
+		this->SetCorridorBlock(this->corridorFields[i], 0);
+	this->corridorFields.clear();
+
+	int numberOfCoarseRows = this->coarseLibrary.WorldMap.size();
+	int numberOfCoarseColumns = this->coarseLibrary.WorldMap[0].size();
+	int blockSize = 1 << this->pyramid.NumberOfLevels;
+	int numberOfColumns = this->fineLibrary.WorldMap[0].size();
+
+	for(unsigned int i=0; i<coarsePath.size(); i++)
+	{
+		for(int x=coarsePath[i].X-this->CorridorRadius; x<=coarsePath[i].X+this->CorridorRadius; x++)
+		{
+			for(int y=coarsePath[i].Y-this->CorridorRadius; y<=coarsePath[i].Y+this->CorridorRadius; y++)
+			{
+				//the top left field of a block tells whether the block was already marked
+				if(x >= 0 && x < numberOfCoarseRows && y >= 0 && y < numberOfCoarseColumns && this->corridor[x * blockSize * numberOfColumns + y * blockSize] == 0)
+				{
+					this->SetCorridorBlock(Coordinates2D(x, y), 1);
+					this->corridorFields.push_back(Coordinates2D(x, y));
+				}
+			}
+		}
+	}
+}
+
+//<summary>
+//Sets the corridor value of all fields covered by the coarse field 'coarseField' to 'value'.
+//</summary>
+void CoarseToFinePlanner::SetCorridorBlock(Coordinates2D coarseField, unsigned char value)
+{
+	int numberOfRows = this->fineLibrary.WorldMap.size();
+	int numberOfColumns = this->fineLibrary.WorldMap[0].size();
+	int blockSize = 1 << this->pyramid.NumberOfLevels;
+
+	int lastRow = (coarseField.X + 1) * blockSize < numberOfRows ? (coarseField.X + 1) * blockSize : numberOfRows;
+	int lastColumn = (coarseField.Y + 1) * blockSize < numberOfColumns ? (coarseField.Y + 1) * blockSize : numberOfColumns;
+	for(int x=coarseField.X*blockSize; x<lastRow; x++)
+		for(int y=coarseField.Y*blockSize; y<lastColumn; y++)
+			this->corridor[x * numberOfColumns + y] = value;
+}
+
+#endif
\ No newline at end of file
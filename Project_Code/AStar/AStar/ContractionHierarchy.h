@@ -0,0 +1,819 @@
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include "Coordinates2D.h"
+#include "AStarResult.h"
+#include "ContractionHierarchyEdge.h"
+#include <vector>
+#include <queue>
+#include <utility>
+#include <functional>
+#include <fstream>
+#include <limits>
+using std::vector;
+using std::priority_queue;
+using std::pair;
+using std::make_pair;
+using std::greater;
+using std::ifstream;
+using std::ofstream;
+using std::ios;
+using std::numeric_limits;
+
+//<summary>
+//Class used for answering many shortest path queries on a grid that rarely changes.
+//The grid graph derived from a world map is preprocessed once into a contraction hierarchy
+//(the nodes are contracted one by one and shortcut edges are added between their neighbours);
+//a query is then answered by two searches (one from the source and one from the destination)
+//that only follow edges leading to nodes contracted later than the current one.
+//</summary>
+class ContractionHierarchy
+{
+public:
+	ContractionHierarchy();
+
+	//builds the hierarchy for the grid given by 'worldMap'
+	void Build(const vector<vector<double>>& worldMap);
+
+	//finds a shortest path between two grid fields using the hierarchy
+	AStarResult ShortestPath(Coordinates2D source, Coordinates2D destination);
+
+	//saves the hierarchy to a binary file
+	void SaveToFile(const char* filename);
+
+	//loads a hierarchy that was saved by 'SaveToFile' for the grid given by 'worldMap'
+	void LoadFromFile(const char* filename, const vector<vector<double>>& worldMap);
+
+	//dimensions of the grid for which the hierarchy was built
+	int NumberOfRows;
+	int NumberOfColumns;
+
+private:
+	typedef pair<double, int> QueueEntry;
+	typedef priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> Queue;
+
+	//adds an edge to the graph used while building the hierarchy
+	void AddEdge(int from, int to, double cost, int middle);
+
+	//contracts 'node' (or only counts the shortcuts that would be added if 'simulate' is true)
+	int ContractNode(int node, bool simulate);
+
+	//returns the priority of 'node' in the contraction order
+	int CalculateImportance(int node);
+
+	//runs a bounded search from 'source' that ignores 'excludedNode'
+	void WitnessSearch(int source, int excludedNode, double maximumCost);
+
+	//returns the edge 'from'->'to' of the hierarchy
+	const ContractionHierarchyEdge* FindEdge(int from, int to);
+
+	//appends the grid nodes represented by an edge of the hierarchy to 'path'
+	void UnpackEdge(int from, int to, int middle, vector<int>& path);
+
+	//converts a grid field to a node index and vice versa
+	int GetIndex(Coordinates2D field);
+	Coordinates2D GetCoordinates(int index);
+
+	//checks that the ranks and edges of a loaded hierarchy are consistent, so that queries on it stay inside the grid
+	bool IsConsistent();
+
+	//returns a hash of the dimensions and costs of 'worldMap'
+	static unsigned long long CalculateMapHash(const vector<vector<double>>& worldMap);
+
+	//reads 'size' bytes from 'document'; returns false if the file ended or couldn't be read
+	static bool ReadBytes(ifstream& document, void* buffer, long long size);
+
+	//hash of the grid for which the hierarchy was built (see 'CalculateMapHash')
+	unsigned long long mapHash;
+
+	//position of each node in the contraction order
+	vector<int> rank;
+
+	//for each node, the edges leading to higher ranked nodes
+	vector<vector<ContractionHierarchyEdge>> upwardEdges;
+
+	//for each node, the edges coming from higher ranked nodes (stored as reversed edges)
+	vector<vector<ContractionHierarchyEdge>> downwardEdges;
+
+	//graph used only while the hierarchy is built
+	vector<vector<ContractionHierarchyEdge>> outgoingEdges;
+	vector<vector<ContractionHierarchyEdge>> incomingEdges;
+	vector<bool> contracted;
+	vector<int> contractedNeighbours;
+
+	//state of the witness searches; only the touched entries are reset between searches
+	vector<double> witnessCost;
+	vector<int> witnessTouched;
+
+	//state of the query searches; only the touched entries are reset between queries
+	vector<double> forwardCost;
+	vector<double> backwardCost;
+	vector<int> forwardParent;
+	vector<int> backwardParent;
+	vector<int> forwardMiddle;
+	vector<int> backwardMiddle;
+	vector<int> queryTouched;
+};
+
+//maximum number of nodes settled by a single witness search; a search that runs out
+//of nodes only results in an unnecessary (but correct) shortcut
+const int WITNESS_SEARCH_LIMIT = 500;
+
+//identifies hierarchy files written by 'SaveToFile'
+const int CONTRACTION_HIERARCHY_FILE_MAGIC = 0x31304843;
+
+//version of the file format; files of other versions are rejected
+const int CONTRACTION_HIERARCHY_FILE_VERSION = 2;
+
+//size of an edge in a hierarchy file: node, cost and middle node
+const long long CONTRACTION_HIERARCHY_FILE_EDGE_BYTES = sizeof(int) + sizeof(double) + sizeof(int);
+
+
+//<summary>
+//Default constructor; creates an empty hierarchy.
+//</summary>
+ContractionHierarchy::ContractionHierarchy()
+{
+	this->NumberOfRows = 0;
+	this->NumberOfColumns = 0;
+	this->mapHash = 0;
+}
+
+//<summary>
+//Builds a contraction hierarchy for the grid given by 'worldMap'. Moving to a field costs as much as the value
+//of the field in the map, as in 'AStarLibrary'. The nodes are contracted in the order of their edge difference
+//(the number of added shortcuts minus the number of removed edges), which is updated lazily.
+//</summary>
+//<param name='worldMap'>The grid for which we want to build the hierarchy.</param>
+void ContractionHierarchy::Build(const vector<vector<double>>& worldMap)
+{
+	this->NumberOfRows = worldMap.size();
+	this->NumberOfColumns = worldMap[0].size();
+	this->mapHash = CalculateMapHash(worldMap);
+	int numberOfNodes = this->NumberOfRows * this->NumberOfColumns;
+
+	this->outgoingEdges.assign(numberOfNodes, vector<ContractionHierarchyEdge>());
+	this->incomingEdges.assign(numberOfNodes, vector<ContractionHierarchyEdge>());
+	this->upwardEdges.assign(numberOfNodes, vector<ContractionHierarchyEdge>());
+	this->downwardEdges.assign(numberOfNodes, vector<ContractionHierarchyEdge>());
+	this->contracted.assign(numberOfNodes, false);
+	this->contractedNeighbours.assign(numberOfNodes, 0);
+	this->rank.assign(numberOfNodes, -1);
+	this->witnessCost.assign(numberOfNodes, numeric_limits<double>::infinity());
+	this->witnessTouched.clear();
+
+	//we add the edges of the grid graph; we can't make diagonal movements
+	int rowOffsets[4] = { 1, -1, 0, 0 };
+	int columnOffsets[4] = { 0, 0, -1, 1 };
+	for(int x=0; x<this->NumberOfRows; x++)
+	{
+		for(int y=0; y<this->NumberOfColumns; y++)
+		{
+			for(int k=0; k<4; k++)
+			{
+				int neighbourX = x + rowOffsets[k];
+				int neighbourY = y + columnOffsets[k];
+				if(neighbourX < 0 || neighbourX >= this->NumberOfRows || neighbourY < 0 || neighbourY >= this->NumberOfColumns)
+					continue;
+
+				this->AddEdge(this->GetIndex(Coordinates2D(x, y)), this->GetIndex(Coordinates2D(neighbourX, neighbourY)), worldMap[neighbourX][neighbourY], -1);
+			}
+		}
+	}
+
+	Queue contractionOrder;
+	for(int i=0; i<numberOfNodes; i++)
+		contractionOrder.push(make_pair((double)this->CalculateImportance(i), i));
+
+	int currentRank = 0;
+	while(!contractionOrder.empty())
+	{
+		int node = contractionOrder.top().second;
+		contractionOrder.pop();
+
+		//the importance may have changed since the node was inserted; if the node
+		//is not the least important one anymore, we put it back in the queue
+		double importance = this->CalculateImportance(node);
+		if(!contractionOrder.empty() && importance > contractionOrder.top().first)
+		{
+			contractionOrder.push(make_pair(importance, node));
+			continue;
+		}
+
+		//the edges to the nodes that are not contracted yet are final, so they become part of the hierarchy
+		for(unsigned int i=0; i<this->outgoingEdges[node].size(); i++)
+			if(!this->contracted[this->outgoingEdges[node][i].Node])
+				this->upwardEdges[node].push_back(this->outgoingEdges[node][i]);
+
+		for(unsigned int i=0; i<this->incomingEdges[node].size(); i++)
+			if(!this->contracted[this->incomingEdges[node][i].Node])
+				this->downwardEdges[node].push_back(this->incomingEdges[node][i]);
+
+		this->ContractNode(node, false);
+		this->contracted[node] = true;
+		this->rank[node] = currentRank++;
+
+		for(unsigned int i=0; i<this->upwardEdges[node].size(); i++)
+			this->contractedNeighbours[this->upwardEdges[node][i].Node]++;
+		for(unsigned int i=0; i<this->downwardEdges[node].size(); i++)
+			this->contractedNeighbours[this->downwardEdges[node][i].Node]++;
+	}
+
+	//the graph used while building is not needed anymore
+	vector<vector<ContractionHierarchyEdge>>().swap(this->outgoingEdges);
+	vector<vector<ContractionHierarchyEdge>>().swap(this->incomingEdges);
+	vector<bool>().swap(this->contracted);
+	vector<int>().swap(this->contractedNeighbours);
+	vector<double>().swap(this->witnessCost);
+}
+
+//<summary>
+//Finds a shortest path between 'source' and 'destination'. Two searches are run at the same time:
+//one from the source over the upward edges and one from the destination over the reversed downward edges.
+//The searches stop once neither of them can improve the best path found through a common node.
+//The shortcuts on the path are then unpacked to the original grid fields.
+//</summary>
+//<param name='source'>Object containing the grid coordinates of the source field.</param>
+//<param name='destination'>Object containing the grid coordinates of the destination field.</param>
+AStarResult ContractionHierarchy::ShortestPath(Coordinates2D source, Coordinates2D destination)
+{
+	int numberOfNodes = this->NumberOfRows * this->NumberOfColumns;
+	if(this->forwardCost.size() != (unsigned int)numberOfNodes)
+	{
+		this->forwardCost.assign(numberOfNodes, numeric_limits<double>::infinity());
+		this->backwardCost.assign(numberOfNodes, numeric_limits<double>::infinity());
+		this->forwardParent.assign(numberOfNodes, -1);
+		this->backwardParent.assign(numberOfNodes, -1);
+		this->forwardMiddle.assign(numberOfNodes, -1);
+		this->backwardMiddle.assign(numberOfNodes, -1);
+	}
+
+	AStarResult result;
+	int sourceIndex = this->GetIndex(source);
+	int destinationIndex = this->GetIndex(destination);
+
+	Queue forwardQueue, backwardQueue;
+	this->forwardCost[sourceIndex] = 0.0;
+	this->backwardCost[destinationIndex] = 0.0;
+	this->queryTouched.push_back(sourceIndex);
+	this->queryTouched.push_back(destinationIndex);
+	forwardQueue.push(make_pair(0.0, sourceIndex));
+	backwardQueue.push(make_pair(0.0, destinationIndex));
+
+	double bestCost = numeric_limits<double>::infinity();
+	int meetingNode = -1;
+
+	while(!forwardQueue.empty() || !backwardQueue.empty())
+	{
+		double forwardMinimum = forwardQueue.empty() ? numeric_limits<double>::infinity() : forwardQueue.top().first;
+		double backwardMinimum = backwardQueue.empty() ? numeric_limits<double>::infinity() : backwardQueue.top().first;
+		if(forwardMinimum >= bestCost && backwardMinimum >= bestCost)
+			break;
+
+		//we advance the search whose next node is closer
+		bool forward = forwardMinimum <= backwardMinimum;
+		Queue& queue = forward ? forwardQueue : backwardQueue;
+		vector<double>& cost = forward ? this->forwardCost : this->backwardCost;
+		vector<double>& otherCost = forward ? this->backwardCost : this->forwardCost;
+		vector<int>& parent = forward ? this->forwardParent : this->backwardParent;
+		vector<int>& middle = forward ? this->forwardMiddle : this->backwardMiddle;
+		vector<vector<ContractionHierarchyEdge>>& edges = forward ? this->upwardEdges : this->downwardEdges;
+
+		QueueEntry entry = queue.top();
+		queue.pop();
+		int node = entry.second;
+
+		//the queue can contain outdated entries for nodes whose cost was decreased
+		if(entry.first > cost[node])
+			continue;
+
+		result.ExpandedNodes.push_back(this->GetCoordinates(node));
+
+		if(cost[node] + otherCost[node] < bestCost)
+		{
+			bestCost = cost[node] + otherCost[node];
+			meetingNode = node;
+		}
+
+		for(unsigned int i=0; i<edges[node].size(); i++)
+		{
+			const ContractionHierarchyEdge& edge = edges[node][i];
+			double newCost = cost[node] + edge.Cost;
+			if(newCost < cost[edge.Node])
+			{
+				if(this->forwardCost[edge.Node] == numeric_limits<double>::infinity() && this->backwardCost[edge.Node] == numeric_limits<double>::infinity())
+					this->queryTouched.push_back(edge.Node);
+
+				cost[edge.Node] = newCost;
+				parent[edge.Node] = node;
+				middle[edge.Node] = edge.Middle;
+				queue.push(make_pair(newCost, edge.Node));
+			}
+		}
+	}
+
+	if(meetingNode != -1)
+	{
+		//we collect the hierarchy edges from the source to the meeting node...
+		vector<int> forwardNodes;
+		for(int node = meetingNode; node != sourceIndex; node = this->forwardParent[node])
+			forwardNodes.push_back(node);
+
+		vector<int> path;
+		path.push_back(sourceIndex);
+		for(int i=forwardNodes.size()-1; i>=0; i--)
+		{
+			int node = forwardNodes[i];
+			this->UnpackEdge(this->forwardParent[node], node, this->forwardMiddle[node], path);
+		}
+
+		//...and from the meeting node to the destination
+		for(int node = meetingNode; node != destinationIndex; node = this->backwardParent[node])
+			this->UnpackEdge(node, this->backwardParent[node], this->backwardMiddle[node], path);
+
+		for(unsigned int i=0; i<path.size(); i++)
+			result.ShortestPath.push_back(this->GetCoordinates(path[i]));
+	}
+	else
+		result.ExpandedNodes.clear();
+
+	//we reset the search state for the next query
+	for(unsigned int i=0; i<this->queryTouched.size(); i++)
+	{
+		int node = this->queryTouched[i];
+		this->forwardCost[node] = numeric_limits<double>::infinity();
+		this->backwardCost[node] = numeric_limits<double>::infinity();
+		this->forwardParent[node] = -1;
+		this->backwardParent[node] = -1;
+	}
+	this->queryTouched.clear();
+
+	return result;
+}
+
+//<summary>
+//Saves the hierarchy to a binary file, so that it doesn't have to be built again after a restart.
+//The file contains a header (magic number, format version, grid dimensions and the hash of the grid),
+//the rank of each node and the upward and downward edges of each node.
+//</summary>
+//<param name='filename'>Name of the file in which we want to save the hierarchy.</param>
+void ContractionHierarchy::SaveToFile(const char* filename)
+{
+	ofstream outFile;
+
+	try
+	{
+		outFile.exceptions(ofstream::badbit | ofstream::failbit);
+		outFile.open(filename, ios::out | ios::binary);
+
+		int magic = CONTRACTION_HIERARCHY_FILE_MAGIC;
+		int version = CONTRACTION_HIERARCHY_FILE_VERSION;
+		outFile.write((const char*)&magic, sizeof(int));
+		outFile.write((const char*)&version, sizeof(int));
+		outFile.write((const char*)&this->NumberOfRows, sizeof(int));
+		outFile.write((const char*)&this->NumberOfColumns, sizeof(int));
+		outFile.write((const char*)&this->mapHash, sizeof(unsigned long long));
+
+		int numberOfNodes = this->NumberOfRows * this->NumberOfColumns;
+		outFile.write((const char*)&this->rank[0], sizeof(int) * numberOfNodes);
+
+		for(int direction=0; direction<2; direction++)
+		{
+			vector<vector<ContractionHierarchyEdge>>& edges = direction == 0 ? this->upwardEdges : this->downwardEdges;
+			for(int i=0; i<numberOfNodes; i++)
+			{
+				int numberOfEdges = edges[i].size();
+				outFile.write((const char*)&numberOfEdges, sizeof(int));
+				for(int j=0; j<numberOfEdges; j++)
+				{
+					outFile.write((const char*)&edges[i][j].Node, sizeof(int));
+					outFile.write((const char*)&edges[i][j].Cost, sizeof(double));
+					outFile.write((const char*)&edges[i][j].Middle, sizeof(int));
+				}
+			}
+		}
+
+		outFile.close();
+	}
+	catch(...)
+	{
+		//we close the file stream in case it is open
+		if(outFile.is_open())
+			outFile.close();
+
+		throw "Error while writing file";
+	}
+}
+
+//<summary>
+//Loads a hierarchy that was saved by 'SaveToFile' for the grid given by 'worldMap'. The file is read into a new
+//hierarchy which replaces this one only if the whole file was read and is consistent: the header has to match the
+//format and the grid, the numbers of edges have to fit in the rest of the file and every rank, node and middle node
+//has to be valid (see 'IsConsistent'). If loading fails, this hierarchy is not changed.
+//</summary>
+//<param name='filename'>Name of a file containing a saved hierarchy.</param>
+//<param name='worldMap'>The grid for which the hierarchy was built.</param>
+void ContractionHierarchy::LoadFromFile(const char* filename, const vector<vector<double>>& worldMap)
+{
+	ifstream document;
+	const char* error = "Error while reading file";
+	ContractionHierarchy loaded;
+
+	try
+	{
+		document.open(filename, ios::in | ios::binary);
+		if(!document.is_open())
+			throw error;
+
+		document.seekg(0, ios::end);
+		long long fileSize = document.tellg();
+		document.seekg(0, ios::beg);
+
+		int header[4];
+		if(!ReadBytes(document, header, sizeof(header)) || !ReadBytes(document, &loaded.mapHash, sizeof(unsigned long long)))
+			throw error;
+		if(header[0] != CONTRACTION_HIERARCHY_FILE_MAGIC || header[1] != CONTRACTION_HIERARCHY_FILE_VERSION)
+		{
+			error = "Wrong format";
+			throw error;
+		}
+
+		loaded.NumberOfRows = header[2];
+		loaded.NumberOfColumns = header[3];
+		if(loaded.NumberOfRows != (int)worldMap.size() || loaded.NumberOfColumns != (int)worldMap[0].size())
+		{
+			error = "Wrong map size";
+			throw error;
+		}
+		if(loaded.mapHash != CalculateMapHash(worldMap))
+		{
+			error = "Wrong map";
+			throw error;
+		}
+
+		//the dimensions match the grid, so the number of nodes fits in memory; a truncated file is rejected before anything is allocated
+		error = "Wrong format";
+		long long numberOfNodes = (long long)loaded.NumberOfRows * loaded.NumberOfColumns;
+		if((long long)sizeof(int) * numberOfNodes > fileSize - (long long)document.tellg())
+			throw error;
+
+		loaded.rank.resize((size_t)numberOfNodes);
+		if(!ReadBytes(document, &loaded.rank[0], sizeof(int) * numberOfNodes))
+			throw error;
+
+		for(int direction=0; direction<2; direction++)
+		{
+			vector<vector<ContractionHierarchyEdge>>& edges = direction == 0 ? loaded.upwardEdges : loaded.downwardEdges;
+			edges.assign((size_t)numberOfNodes, vector<ContractionHierarchyEdge>());
+			for(int i=0; i<numberOfNodes; i++)
+			{
+				int numberOfEdges;
+				if(!ReadBytes(document, &numberOfEdges, sizeof(int)))
+					throw error;
+				if(numberOfEdges < 0 || numberOfEdges >= numberOfNodes || numberOfEdges * CONTRACTION_HIERARCHY_FILE_EDGE_BYTES > fileSize - (long long)document.tellg())
+					throw error;
+
+				edges[i].resize(numberOfEdges);
+				for(int j=0; j<numberOfEdges; j++)
+				{
+					if(!ReadBytes(document, &edges[i][j].Node, sizeof(int)) || !ReadBytes(document, &edges[i][j].Cost, sizeof(double)) || !ReadBytes(document, &edges[i][j].Middle, sizeof(int)))
+						throw error;
+				}
+			}
+		}
+
+		if(document.tellg() != fileSize || !loaded.IsConsistent())
+			throw error;
+
+		document.close();
+	}
+	catch(...)
+	{
+		//we close the file stream in case it is open
+		if(document.is_open())
+			document.close();
+
+		throw error;
+	}
+
+	this->NumberOfRows = loaded.NumberOfRows;
+	this->NumberOfColumns = loaded.NumberOfColumns;
+	this->mapHash = loaded.mapHash;
+	this->rank.swap(loaded.rank);
+	this->upwardEdges.swap(loaded.upwardEdges);
+	this->downwardEdges.swap(loaded.downwardEdges);
+
+	//the query state is allocated again for the loaded grid
+	this->forwardCost.clear();
+	this->queryTouched.clear();
+}
+
+//<summary>
+//Adds the edge 'from'->'to' to the graph used while building the hierarchy.
+//If the edge already exists, only its cost is decreased (if the new cost is lower).
+//</summary>
+//<param name='from'>Index of the node where the edge starts.</param>
+//<param name='to'>Index of the node where the edge ends.</param>
+//<param name='cost'>Cost of the edge.</param>
+//<param name='middle'>Index of the node that the edge bypasses (-1 for grid edges).</param>
+void ContractionHierarchy::AddEdge(int from, int to, double cost, int middle)
+{
+	for(unsigned int i=0; i<this->outgoingEdges[from].size(); i++)
+	{
+		if(this->outgoingEdges[from][i].Node == to)
+		{
+			if(this->outgoingEdges[from][i].Cost > cost)
+			{
+				this->outgoingEdges[from][i].Cost = cost;
+				this->outgoingEdges[from][i].Middle = middle;
+
+				for(unsigned int j=0; j<this->incomingEdges[to].size(); j++)
+				{
+					if(this->incomingEdges[to][j].Node == from)
+					{
+						this->incomingEdges[to][j].Cost = cost;
+						this->incomingEdges[to][j].Middle = middle;
+						break;
+					}
+				}
+			}
+			return;
+		}
+	}
+
+	ContractionHierarchyEdge outgoingEdge = { to, cost, middle };
+	ContractionHierarchyEdge incomingEdge = { from, cost, middle };
+	this->outgoingEdges[from].push_back(outgoingEdge);
+	this->incomingEdges[to].push_back(incomingEdge);
+}
+
+//<summary>
+//Contracts 'node': for each pair of neighbours (u, w) such that u->node->w might be the only shortest path
+//between u and w, a shortcut u->w is added. A shortcut is not needed if a witness search from u finds
+//a path to w that doesn't go through 'node' and isn't more expensive.
+//</summary>
+//<param name='node'>Index of the node that we want to contract.</param>
+//<param name='simulate'>If true, the shortcuts are only counted but not added.</param>
+//<returns>The number of shortcuts that are (or would be) added.</returns>
+int ContractionHierarchy::ContractNode(int node, bool simulate)
+{
+	int numberOfShortcuts = 0;
+	vector<ContractionHierarchyEdge> incoming = this->incomingEdges[node];
+	vector<ContractionHierarchyEdge> outgoing = this->outgoingEdges[node];
+
+	for(unsigned int i=0; i<incoming.size(); i++)
+	{
+		int from = incoming[i].Node;
+		if(this->contracted[from])
+			continue;
+
+		double maximumCost = 0.0;
+		for(unsigned int j=0; j<outgoing.size(); j++)
+			if(!this->contracted[outgoing[j].Node] && outgoing[j].Node != from && incoming[i].Cost + outgoing[j].Cost > maximumCost)
+				maximumCost = incoming[i].Cost + outgoing[j].Cost;
+
+		this->WitnessSearch(from, node, maximumCost);
+
+		for(unsigned int j=0; j<outgoing.size(); j++)
+		{
+			int to = outgoing[j].Node;
+			if(this->contracted[to] || to == from)
+				continue;
+
+			double shortcutCost = incoming[i].Cost + outgoing[j].Cost;
+			if(this->witnessCost[to] <= shortcutCost)
+				continue;
+
+			numberOfShortcuts++;
+			if(!simulate)
+				this->AddEdge(from, to, shortcutCost, node);
+		}
+
+		//we reset the witness search state
+		for(unsigned int j=0; j<this->witnessTouched.size(); j++)
+			this->witnessCost[this->witnessTouched[j]] = numeric_limits<double>::infinity();
+		this->witnessTouched.clear();
+	}
+
+	return numberOfShortcuts;
+}
+
+//<summary>
+//Returns the priority of 'node' in the contraction order: the edge difference plus the number of contracted
+//neighbours (the second term spreads the contracted nodes uniformly over the grid).
+//</summary>
+//<param name='node'>Index of the node.</param>
+int ContractionHierarchy::CalculateImportance(int node)
+{
+	int numberOfRemovedEdges = 0;
+	for(unsigned int i=0; i<this->outgoingEdges[node].size(); i++)
+		if(!this->contracted[this->outgoingEdges[node][i].Node])
+			numberOfRemovedEdges++;
+	for(unsigned int i=0; i<this->incomingEdges[node].size(); i++)
+		if(!this->contracted[this->incomingEdges[node][i].Node])
+			numberOfRemovedEdges++;
+
+	return this->ContractNode(node, true) - numberOfRemovedEdges + this->contractedNeighbours[node];
+}
+
+//<summary>
+//Runs a Dijkstra search from 'source' over the nodes that are not contracted yet, ignoring 'excludedNode'.
+//The search stops when the cost exceeds 'maximumCost' or after WITNESS_SEARCH_LIMIT settled nodes.
+//The costs found are left in 'witnessCost'.
+//</summary>
+//<param name='source'>Index of the node where the search starts.</param>
+//<param name='excludedNode'>Index of the node that is being contracted.</param>
+//<param name='maximumCost'>The cost of the most expensive shortcut that we are trying to avoid.</param>
+void ContractionHierarchy::WitnessSearch(int source, int excludedNode, double maximumCost)
+{
+	Queue queue;
+	this->witnessCost[source] = 0.0;
+	this->witnessTouched.push_back(source);
+	queue.push(make_pair(0.0, source));
+
+	int numberOfSettledNodes = 0;
+	while(!queue.empty() && numberOfSettledNodes < WITNESS_SEARCH_LIMIT)
+	{
+		QueueEntry entry = queue.top();
+		queue.pop();
+		int node = entry.second;
+
+		if(entry.first > this->witnessCost[node])
+			continue;
+		if(entry.first > maximumCost)
+			break;
+
+		numberOfSettledNodes++;
+
+		for(unsigned int i=0; i<this->outgoingEdges[node].size(); i++)
+		{
+			const ContractionHierarchyEdge& edge = this->outgoingEdges[node][i];
+			if(edge.Node == excludedNode || this->contracted[edge.Node])
+				continue;
+
+			double newCost = entry.first + edge.Cost;
+			if(newCost < this->witnessCost[edge.Node])
+			{
+				if(this->witnessCost[edge.Node] == numeric_limits<double>::infinity())
+					this->witnessTouched.push_back(edge.Node);
+
+				this->witnessCost[edge.Node] = newCost;
+				queue.push(make_pair(newCost, edge.Node));
+			}
+		}
+	}
+}
+
+//<summary>
+//Returns the edge 'from'->'to' of the hierarchy. The edge is stored with the lower ranked of the two nodes:
+//as an upward edge of 'from' or as a downward edge of 'to'.
+//</summary>
+//<param name='from'>Index of the node where the edge starts.</param>
+//<param name='to'>Index of the node where the edge ends.</param>
+const ContractionHierarchyEdge* ContractionHierarchy::FindEdge(int from, int to)
+{
+	const vector<ContractionHierarchyEdge>& edges = this->rank[from] < this->rank[to] ? this->upwardEdges[from] : this->downwardEdges[to];
+	int otherNode = this->rank[from] < this->rank[to] ? to : from;
+
+	for(unsigned int i=0; i<edges.size(); i++)
+		if(edges[i].Node == otherNode)
+			return &edges[i];
+
+	return NULL;
+}
+
+//<summary>
+//Replaces the edge 'from'->'to' by the grid fields that it represents and appends them to 'path'
+//('from' itself is not appended). Shortcuts are unpacked recursively through their middle nodes;
+//an explicit stack is used so that long shortcuts on big grids don't overflow the call stack.
+//</summary>
+//<param name='from'>Index of the node where the edge starts.</param>
+//<param name='to'>Index of the node where the edge ends.</param>
+//<param name='middle'>Index of the node that the edge bypasses (-1 for grid edges).</param>
+//<param name='path'>The path to which the unpacked nodes are appended.</param>
+void ContractionHierarchy::UnpackEdge(int from, int to, int middle, vector<int>& path)
+{
+	//each edge on the stack is stored as three consecutive values: start, end and middle node
+	vector<int> stack;
+	stack.push_back(from);
+	stack.push_back(to);
+	stack.push_back(middle);
+
+	while(!stack.empty())
+	{
+		int currentMiddle = stack.back(); stack.pop_back();
+		int currentTo = stack.back(); stack.pop_back();
+		int currentFrom = stack.back(); stack.pop_back();
+
+		if(currentMiddle == -1)
+		{
+			path.push_back(currentTo);
+			continue;
+		}
+
+		//we push the second half first, so that the first half is unpacked first
+		stack.push_back(currentMiddle);
+		stack.push_back(currentTo);
+		stack.push_back(this->FindEdge(currentMiddle, currentTo)->Middle);
+
+		stack.push_back(currentFrom);
+		stack.push_back(currentMiddle);
+		stack.push_back(this->FindEdge(currentFrom, currentMiddle)->Middle);
+	}
+}
+
+//<summary>
+//Returns the node index of the grid field 'field'.
+//</summary>
+int ContractionHierarchy::GetIndex(Coordinates2D field)
+{
+	return field.X * this->NumberOfColumns + field.Y;
+}
+
+//<summary>
+//Returns the grid coordinates of the node with index 'index'.
+//</summary>
+Coordinates2D ContractionHierarchy::GetCoordinates(int index)
+{
+	return Coordinates2D(index / this->NumberOfColumns, index % this->NumberOfColumns);
+}
+
+//<summary>
+//Checks the ranks and edges of a loaded hierarchy: the ranks have to be a permutation of the node indices, each edge
+//has to lead to a higher ranked node with a cost that is not negative, and each shortcut has to bypass a lower ranked
+//node through two edges that exist. This is what the queries rely on; it also makes 'UnpackEdge' terminate,
+//since the ranks of the middle nodes decrease with every unpacked shortcut.
+//</summary>
+//<returns>True if the hierarchy is consistent.</returns>
+bool ContractionHierarchy::IsConsistent()
+{
+	int numberOfNodes = this->rank.size();
+	vector<bool> rankUsed(numberOfNodes, false);
+	for(int i=0; i<numberOfNodes; i++)
+	{
+		if(this->rank[i] < 0 || this->rank[i] >= numberOfNodes || rankUsed[this->rank[i]])
+			return false;
+		rankUsed[this->rank[i]] = true;
+	}
+
+	for(int direction=0; direction<2; direction++)
+	{
+		const vector<vector<ContractionHierarchyEdge>>& edges = direction == 0 ? this->upwardEdges : this->downwardEdges;
+		for(int i=0; i<numberOfNodes; i++)
+		{
+			for(unsigned int j=0; j<edges[i].size(); j++)
+			{
+				const ContractionHierarchyEdge& edge = edges[i][j];
+				if(edge.Node < 0 || edge.Node >= numberOfNodes || this->rank[edge.Node] <= this->rank[i] || !(edge.Cost >= 0.0))
+					return false;
+				if(edge.Middle == -1)
+					continue;
+				if(edge.Middle < 0 || edge.Middle >= numberOfNodes || this->rank[edge.Middle] >= this->rank[i])
+					return false;
+
+				//the upward edge i->Node bypasses i->Middle->Node; the downward edge Node->i bypasses Node->Middle->i
+				int from = direction == 0 ? i : edge.Node;
+				int to = direction == 0 ? edge.Node : i;
+				if(this->FindEdge(from, edge.Middle) == NULL || this->FindEdge(edge.Middle, to) == NULL)
+					return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+//<summary>
+//Calculates a hash (FNV-1a) of the dimensions of 'worldMap' and the bytes of its costs, so that a saved hierarchy
+//isn't used for another grid or for a grid whose costs changed.
+//</summary>
+//<param name='worldMap'>The grid for which we want to calculate the hash.</param>
+unsigned long long ContractionHierarchy::CalculateMapHash(const vector<vector<double>>& worldMap)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	int dimensions[2] = { (int)worldMap.size(), (int)worldMap[0].size() };
+	const unsigned char* bytes = (const unsigned char*)dimensions;
+	for(unsigned int i=0; i<sizeof(dimensions); i++)
+		hash = (hash ^ bytes[i]) * 1099511628211ULL;
+
+	for(unsigned int x=0; x<worldMap.size(); x++)
+	{
+		bytes = (const unsigned char*)&worldMap[x][0];
+		for(unsigned int i=0; i<worldMap[x].size() * sizeof(double); i++)
+			hash = (hash ^ bytes[i]) * 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+//<summary>
+//Reads 'size' bytes from 'document' into 'buffer' and checks that all of them were read.
+//</summary>
+//<returns>False if the file ended or couldn't be read.</returns>
+bool ContractionHierarchy::ReadBytes(ifstream& document, void* buffer, long long size)
+{
+	document.read((char*)buffer, size);
+	return !document.fail() && document.gcount() == size;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,17 @@
+#ifndef CONTRACTION_HIERARCHY_EDGE_H
+#define CONTRACTION_HIERARCHY_EDGE_H
+
+//<summary>
+//Stores info for an edge of a contraction hierarchy, including:
+//	- the index of the node on the other end of the edge.
+//	- the cost of the edge.
+//	- the index of the contracted node that the edge bypasses (-1 if the edge is an original grid edge).
+//</summary>
+struct ContractionHierarchyEdge
+{
+	int Node;
+	double Cost;
+	int Middle;
+};
+
+#endif
\ No newline at end of file
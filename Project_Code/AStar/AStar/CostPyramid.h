@@ -0,0 +1,172 @@
+#ifndef COST_PYRAMID_H
+#define COST_PYRAMID_H
+
+#include "Coordinates2D.h"
+#include "DrawingConstants.h"
+#include <vector>
+#include <cmath>
+using std::vector;
+
+//ways of calculating the cost of a coarse field from the 2x2 finer fields it covers
+//	- PYRAMID_MAXIMUM_COST: the highest cost of the finer fields. Conservative: a coarse field is never cheaper than any
+//	  of the fields it covers, so a coarse path never crosses an expensive field or an obstacle without paying for it.
+//	- PYRAMID_ANY_OBSTACLE: an obstacle if any of the finer fields is one and the average cost of the finer fields otherwise.
+//	  Only conservative for obstacles: a block without obstacles costs the average, which is lower than its most expensive
+//	  field, so coarse paths may go through blocks with expensive fields and the corridor may miss cheaper detours.
+const int PYRAMID_MAXIMUM_COST = 0;
+const int PYRAMID_ANY_OBSTACLE = 1;
+
+//<summary>
+//Class that stores coarser versions of a grid, like the levels of a mip map. Level 1 has half the rows and columns
+//of the grid (rounded up) and each of its fields covers 2x2 fields of the grid; each further level halves the previous one,
+//so a field of level 'l' covers a block of 2^l x 2^l fields of the grid. The grid itself is not stored.
+//After a few fields of the grid change, only the coarse fields above them are recalculated, and only as long as their costs change.
+//</summary>
+class CostPyramid
+{
+public:
+	CostPyramid();
+
+	//calculates the levels for the grid given by 'worldMap'
+	void Build(const vector<vector<double>>& worldMap, int numberOfLevels);
+
+	//recalculates the coarse fields above the fields in 'changedFields' after they were changed in 'worldMap'
+	void UpdateFields(const vector<vector<double>>& worldMap, const vector<Coordinates2D>& changedFields);
+
+	//returns the grid of a level
+	const vector<vector<double>>& GetLevel(int level) const;
+
+	//number of coarse levels
+	int NumberOfLevels;
+
+	//the way in which the costs are aggregated (one of the 'PYRAMID_' constants); used by the next call to 'Build'
+	int Aggregation;
+
+private:
+	//calculates the cost of the field with coordinates 'x' and 'y' from the fields of the finer level that it covers
+	double AggregateBlock(const vector<vector<double>>& finerLevel, int x, int y);
+
+	//the coarse levels; 'levels[0]' is level 1
+	vector<vector<vector<double>>> levels;
+
+	//the aggregation used for the current levels
+	int levelAggregation;
+};
+
+
+//<summary>
+//Default constructor; creates an empty pyramid that aggregates costs with PYRAMID_MAXIMUM_COST.
+//</summary>
+CostPyramid::CostPyramid()
+{
+	this->NumberOfLevels = 0;
+	this->Aggregation = PYRAMID_MAXIMUM_COST;
+	this->levelAggregation = PYRAMID_MAXIMUM_COST;
+}
+
+//<summary>
+//Calculates 'numberOfLevels' coarse levels of 'worldMap'; fewer levels are calculated if a level
+//with a single field is reached before that.
+//</summary>
+//<param name='worldMap'>A logical grid.</param>
+//<param name='numberOfLevels'>The desired number of coarse levels.</param>
+void CostPyramid::Build(const vector<vector<double>>& worldMap, int numberOfLevels)
+{
+	this->levels.clear();
+	this->levelAggregation = this->Aggregation;
+
+	const vector<vector<double>>* finerLevel = &worldMap;
+	while((int)this->levels.size() < numberOfLevels && (finerLevel->size() > 1 || (*finerLevel)[0].size() > 1))
+	{
+		int numberOfRows = (finerLevel->size() + 1) / 2;
+		int numberOfColumns = ((*finerLevel)[0].size() + 1) / 2;
+
+		vector<vector<double>> level(numberOfRows, vector<double>(numberOfColumns));
+		for(int x=0; x<numberOfRows; x++)
+			for(int y=0; y<numberOfColumns; y++)
+				level[x][y] = this->AggregateBlock(*finerLevel, x, y);
+
+		this->levels.push_back(level);
+		finerLevel = &this->levels.back();
+	}
+
+	this->NumberOfLevels = this->levels.size();
+}
+
+//<summary>
+//Recalculates the coarse fields above the fields in 'changedFields'. The fields of the next level are only
+//recalculated above the coarse fields whose costs changed, so a change that doesn't affect the aggregated cost stops early.
+//</summary>
+//<param name='worldMap'>The grid that was used for building the pyramid, with the changed costs.</param>
+//<param name='changedFields'>The grid coordinates of the changed fields.</param>
+void CostPyramid::UpdateFields(const vector<vector<double>>& worldMap, const vector<Coordinates2D>& changedFields)
+{
+	vector<Coordinates2D> fields = changedFields;
+	vector<Coordinates2D> changedCoarseFields;
+
+	const vector<vector<double>>* finerLevel = &worldMap;
+	for(int level=0; level<this->NumberOfLevels && !fields.empty(); level++)
+	{
+		//a coarse field above several changed fields is recalculated for each of them,
+		//but it is added to the changed fields of its level only the first time
+		changedCoarseFields.clear();
+		for(unsigned int i=0; i<fields.size(); i++)
+		{
+			int x = fields[i].X / 2;
+			int y = fields[i].Y / 2;
+			double cost = this->AggregateBlock(*finerLevel, x, y);
+			if(cost != this->levels[level][x][y])
+			{
+				this->levels[level][x][y] = cost;
+				changedCoarseFields.push_back(Coordinates2D(x, y));
+			}
+		}
+
+		fields.swap(changedCoarseFields);
+		finerLevel = &this->levels[level];
+	}
+}
+
+//<summary>
+//Returns the grid of the level 'level', between 1 and 'NumberOfLevels'.
+//</summary>
+const vector<vector<double>>& CostPyramid::GetLevel(int level) const
+{
+	return this->levels[level - 1];
+}
+
+//<summary>
+//Calculates the cost of the coarse field with coordinates 'x' and 'y' from the (up to) 2x2 fields of 'finerLevel' that it covers:
+//their highest cost with PYRAMID_MAXIMUM_COST and, with PYRAMID_ANY_OBSTACLE, an obstacle or the average cost (which
+//underestimates the cost of crossing the most expensive field of the block; see the 'PYRAMID_' constants).
+//</summary>
+//<param name='finerLevel'>The grid of the level below the coarse field.</param>
+//<param name='x'>Row of the coarse field.</param>
+//<param name='y'>Column of the coarse field.</param>
+double CostPyramid::AggregateBlock(const vector<vector<double>>& finerLevel, int x, int y)
+{
+	int lastRow = 2 * x + 1 < (int)finerLevel.size() ? 2 * x + 1 : 2 * x;
+	int lastColumn = 2 * y + 1 < (int)finerLevel[0].size() ? 2 * y + 1 : 2 * y;
+
+	double maximumCost = 0.0, sumOfCosts = 0.0;
+	bool containsObstacle = false;
+	for(int i=2*x; i<=lastRow; i++)
+	{
+		for(int j=2*y; j<=lastColumn; j++)
+		{
+			if(finerLevel[i][j] > maximumCost)
+				maximumCost = finerLevel[i][j];
+			if(fabs(finerLevel[i][j] - OBSTACLE_DELIMITER) < 0.005)
+				containsObstacle = true;
+			sumOfCosts += finerLevel[i][j];
+		}
+	}
+
+	if(this->levelAggregation == PYRAMID_MAXIMUM_COST)
+		return maximumCost;
+	if(containsObstacle)
+		return OBSTACLE_DELIMITER;
+	return sumOfCosts / ((lastRow - 2 * x + 1) * (lastColumn - 2 * y + 1));
+}
+
+#endif
\ No newline at end of file
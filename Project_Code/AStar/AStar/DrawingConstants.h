@@ -29,6 +29,18 @@ const float UPPER_Y_POINT = 4.0f;
 //leftmost point of the window
 const float LEFT_X_POINT = -5.5f;
 
+//maximum number of fields in a row or a column of a texture used for drawing the grid
+const int FIELD_TEXTURE_TILE_SIZE = 512;
+
+//if more fields of a texture change at once, the whole texture is updated instead of the single fields
+const int MAXIMUM_FIELD_UPDATES_PER_TILE = 1024;
+
+//grid lines are only drawn if a field is at least this many pixels wide and high
+const int MINIMUM_GRID_FIELD_SIZE = 4;
+
+//time between two frames of a replayed search in milliseconds
+const int REPLAY_FRAME_MILLISECONDS = 33;
+
 //obstacle delimiter in the logical grid
 const double OBSTACLE_DELIMITER = 100.0;
 
@@ -6,13 +6,30 @@
 #include <gl\glut.h>
 #include "AStarVisualWorldMap.h"
 #include "DrawingConstants.h"
+#include "SearchReplay.h"
+#include <vector>
+using std::vector;
 
 //object storing the visual map and the shortest path
 AStarVisualWorldMap WorldMap;
 
+//textures holding one texel per field; each covers at most FIELD_TEXTURE_TILE_SIZE x FIELD_TEXTURE_TILE_SIZE fields
+vector<GLuint> FieldTextures;
+int NumberOfTextureRows = 0;
+int NumberOfTextureColumns = 0;
+
+//end points of the grid lines and points of the shortest path in window coordinates
+vector<GLfloat> GridLineVertices;
+vector<GLfloat> ShortestPathVertices;
+
+//optional replay of a recorded search; if it is set before 'StartDrawing', the search is shown step by step
+SearchReplay* Replay = NULL;
+
 //<summary>
 //Class used for initializing OpenGL parameters for drawing
-//the world grid and the shortest path.
+//the world grid and the shortest path. The fields are kept in textures and the lines in vertex arrays,
+//which are built once and then only updated where 'WorldMap' changes; the window is only drawn again
+//when it is uncovered or when 'RedrawMap' is called after changing 'WorldMap'.
 //</summary>
 class DrawingLibrary
 {
@@ -23,11 +40,15 @@ private:
 };
 
 void Render();
-void DrawMap();
+void RedrawMap();
+void UpdateBuffers();
+void BuildBuffers();
+void BuildShortestPath();
+void UpdateTexture(int textureRow, int textureColumn);
+void GetFieldColor(int row, int column, GLubyte* color);
+int GetTextureSize(int numberOfFields);
+void ReplayTick(int value);
 void TrackKeyboardKeys(unsigned char key, int mousePositionX, int mousePositionY);
-void DrawField(unsigned int i, unsigned int j);
-void DrawShortestPath();
-bool FieldExpanded(int row, int column);
 
 //<summary>
 //Initializes GLUT parameters and starts drawing;
@@ -39,8 +60,12 @@ void DrawingLibrary::StartDrawing()
 	glutInitWindowSize(WINDOW_WIDTH,WINDOW_HEIGHT);				// set window size
 	glutCreateWindow("A* Visualization");					// create Window
 	glutDisplayFunc(Render);									// register Display Function
-	glutIdleFunc(Render);										// register Idle Function
     glutKeyboardFunc(TrackKeyboardKeys);						// register Keyboard Handler
+	if(Replay != NULL)
+	{
+		Replay->Restart(WorldMap);
+		glutTimerFunc(REPLAY_FRAME_MILLISECONDS, ReplayTick, 0);	// register Replay Timer
+	}
 	this->Initialize();
 	glutMainLoop();												// run GLUT mainloop
 	return;
@@ -65,122 +90,282 @@ void DrawingLibrary::Initialize()
     glDepthFunc( GL_LEQUAL );
     glHint( GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST );						// specify implementation-specific hints
 	glClearColor(0.0, 0.0, 0.0, 1.0);											// specify clear values for the color buffers								
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);										// rows of field colors are not padded
+	glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);				// textures are drawn with their own colors
 }
 
 //<summary>
-//Prepares the window for drawing and draws the grid.
+//Prepares the window for drawing and draws the grid and the shortest path,
+//after bringing the textures and vertex arrays up to date with 'WorldMap'.
 //</summary>
 void Render()
 {
+	UpdateBuffers();
+
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);		     // Clear Screen and Depth Buffer
 	glLoadIdentity();
 	glTranslatef(0.0f,0.0f,-10.0f);		//y: [-4,4], x: [-5.5,5.5]
 	glLineWidth(2.5f);
-	DrawMap();
+
+	//we are drawing the fields, one quad per texture
+	glEnable(GL_TEXTURE_2D);
+	for(int textureRow=0; textureRow<NumberOfTextureRows; textureRow++)
+	{
+		for(int textureColumn=0; textureColumn<NumberOfTextureColumns; textureColumn++)
+		{
+			int firstRow = textureRow * FIELD_TEXTURE_TILE_SIZE;
+			int firstColumn = textureColumn * FIELD_TEXTURE_TILE_SIZE;
+			int numberOfRows = WorldMap.NumberOfRows - firstRow < FIELD_TEXTURE_TILE_SIZE ? WorldMap.NumberOfRows - firstRow : FIELD_TEXTURE_TILE_SIZE;
+			int numberOfColumns = WorldMap.NumberOfColumns - firstColumn < FIELD_TEXTURE_TILE_SIZE ? WorldMap.NumberOfColumns - firstColumn : FIELD_TEXTURE_TILE_SIZE;
+
+			VisualCoordinates topLeft = WorldMap.GetFieldCorner(firstRow, firstColumn);
+			VisualCoordinates bottomRight = WorldMap.GetFieldCorner(firstRow + numberOfRows, firstColumn + numberOfColumns);
+			GLfloat textureWidth = (GLfloat)numberOfColumns / GetTextureSize(numberOfColumns);
+			GLfloat textureHeight = (GLfloat)numberOfRows / GetTextureSize(numberOfRows);
+
+			glBindTexture(GL_TEXTURE_2D, FieldTextures[textureRow * NumberOfTextureColumns + textureColumn]);
+			glBegin(GL_QUADS);
+				glTexCoord2f(0.0f, 0.0f);
+				glVertex2f(topLeft.X, topLeft.Y);
+				glTexCoord2f(textureWidth, 0.0f);
+				glVertex2f(bottomRight.X, topLeft.Y);
+				glTexCoord2f(textureWidth, textureHeight);
+				glVertex2f(bottomRight.X, bottomRight.Y);
+				glTexCoord2f(0.0f, textureHeight);
+				glVertex2f(topLeft.X, bottomRight.Y);
+			glEnd();
+		}
+	}
+	glDisable(GL_TEXTURE_2D);
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	if(!GridLineVertices.empty())
+	{
+		glColor3ub(0,0,255);
+		glVertexPointer(2, GL_FLOAT, 0, &GridLineVertices[0]);
+		glDrawArrays(GL_LINES, 0, GridLineVertices.size() / 2);
+	}
+
+	//the shortest path is drawn as a red line that goes through the centers of all fields that are part of the path
+	if(!ShortestPathVertices.empty())
+	{
+		glColor3ub(255,0,0);
+		glVertexPointer(2, GL_FLOAT, 0, &ShortestPathVertices[0]);
+		glDrawArrays(GL_LINE_STRIP, 0, ShortestPathVertices.size() / 2);
+	}
+	glDisableClientState(GL_VERTEX_ARRAY);
+
 	glutSwapBuffers();
 }
 
 //<summary>
-//Draws the grid and the shortest path.
+//Asks GLUT to draw the window again; should be called after 'WorldMap' is changed while the window is shown.
 //</summary>
-void DrawMap()
+void RedrawMap()
 {
-	unsigned int numberOfRows = WorldMap.Vertices.size();
-	unsigned int numberOfColumns = WorldMap.Vertices[0].size();
+	glutPostRedisplay();
+}
 
-	//we are drawing the grid
-	for(unsigned int i=0; i<numberOfRows; i++)
+//<summary>
+//Brings the textures and vertex arrays up to date with 'WorldMap'. If the whole grid changed, everything is built again;
+//otherwise, only the texels of the changed fields are updated, or the whole texture if many of its fields changed.
+//</summary>
+void UpdateBuffers()
+{
+	if(WorldMap.AllFieldsChanged())
+		BuildBuffers();
+	else if(!WorldMap.GetChangedFields().empty())
 	{
-		for(unsigned int j=0; j<numberOfColumns; j++)
+		const vector<unsigned int>& changedFields = WorldMap.GetChangedFields();
+
+		//we count the changed fields of each texture first, so that we know which textures to update as a whole
+		vector<unsigned int> changesPerTexture(FieldTextures.size(), 0);
+		for(unsigned int i=0; i<changedFields.size(); i++)
 		{
-			if(WorldMap.Vertices[i][j].IsObstacle)
-			{
-				glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-				glColor3ub(0,255,0);
-			}
-			else if(FieldExpanded((int)i,(int)j))
-			{
-				glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-				glColor3ub(255,255,255);
-			}
+			int row = changedFields[i] / WorldMap.NumberOfColumns;
+			int column = changedFields[i] % WorldMap.NumberOfColumns;
+			changesPerTexture[(row / FIELD_TEXTURE_TILE_SIZE) * NumberOfTextureColumns + column / FIELD_TEXTURE_TILE_SIZE]++;
+		}
+
+		for(unsigned int i=0; i<changedFields.size(); i++)
+		{
+			int row = changedFields[i] / WorldMap.NumberOfColumns;
+			int column = changedFields[i] % WorldMap.NumberOfColumns;
+			int texture = (row / FIELD_TEXTURE_TILE_SIZE) * NumberOfTextureColumns + column / FIELD_TEXTURE_TILE_SIZE;
+			if(changesPerTexture[texture] > (unsigned int)MAXIMUM_FIELD_UPDATES_PER_TILE)
+				continue;
 
-			DrawField(i,j);
-			glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-			glColor3ub(0,0,255);
-			DrawField(i,j);
+			GLubyte color[3];
+			GetFieldColor(row, column, color);
+			glBindTexture(GL_TEXTURE_2D, FieldTextures[texture]);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, column % FIELD_TEXTURE_TILE_SIZE, row % FIELD_TEXTURE_TILE_SIZE, 1, 1, GL_RGB, GL_UNSIGNED_BYTE, color);
 		}
+
+		for(unsigned int texture=0; texture<changesPerTexture.size(); texture++)
+			if(changesPerTexture[texture] > (unsigned int)MAXIMUM_FIELD_UPDATES_PER_TILE)
+				UpdateTexture(texture / NumberOfTextureColumns, texture % NumberOfTextureColumns);
 	}
 
-	DrawShortestPath();
+	if(WorldMap.PathChanged)
+		BuildShortestPath();
+
+	WorldMap.ClearChanges();
+	WorldMap.PathChanged = false;
 }
 
 //<summary>
-//Draws the field with grid coordinates 'i' and 'j'.
+//Creates the textures for all fields of 'WorldMap' and the vertex array of the grid lines.
+//The grid lines are left out if the fields are too small for them to be seen.
 //</summary>
-//<param name='i'>Row of the field.</param>
-//<param name='j'>Column of the field.</param>
-void DrawField(unsigned int i, unsigned int j)
+void BuildBuffers()
 {
-	glBegin(GL_POLYGON);
-		glVertex2f(WorldMap.Vertices[i][j].Vertices[0].X, WorldMap.Vertices[i][j].Vertices[0].Y);
-		glVertex2f(WorldMap.Vertices[i][j].Vertices[1].X, WorldMap.Vertices[i][j].Vertices[1].Y);
+	if(!FieldTextures.empty())
+		glDeleteTextures(FieldTextures.size(), &FieldTextures[0]);
+
+	NumberOfTextureRows = (WorldMap.NumberOfRows + FIELD_TEXTURE_TILE_SIZE - 1) / FIELD_TEXTURE_TILE_SIZE;
+	NumberOfTextureColumns = (WorldMap.NumberOfColumns + FIELD_TEXTURE_TILE_SIZE - 1) / FIELD_TEXTURE_TILE_SIZE;
+	FieldTextures.assign(NumberOfTextureRows * NumberOfTextureColumns, 0);
+	if(FieldTextures.empty())
+		return;
+
+	glGenTextures(FieldTextures.size(), &FieldTextures[0]);
+	for(int textureRow=0; textureRow<NumberOfTextureRows; textureRow++)
+	{
+		for(int textureColumn=0; textureColumn<NumberOfTextureColumns; textureColumn++)
+		{
+			int numberOfRows = WorldMap.NumberOfRows - textureRow * FIELD_TEXTURE_TILE_SIZE;
+			int numberOfColumns = WorldMap.NumberOfColumns - textureColumn * FIELD_TEXTURE_TILE_SIZE;
+			numberOfRows = numberOfRows < FIELD_TEXTURE_TILE_SIZE ? numberOfRows : FIELD_TEXTURE_TILE_SIZE;
+			numberOfColumns = numberOfColumns < FIELD_TEXTURE_TILE_SIZE ? numberOfColumns : FIELD_TEXTURE_TILE_SIZE;
 
-		glVertex2f(WorldMap.Vertices[i][j].Vertices[1].X, WorldMap.Vertices[i][j].Vertices[1].Y);
-		glVertex2f(WorldMap.Vertices[i][j].Vertices[2].X, WorldMap.Vertices[i][j].Vertices[2].Y);
+			//the sizes of a texture have to be powers of two; the part outside of the grid is never drawn
+			glBindTexture(GL_TEXTURE_2D, FieldTextures[textureRow * NumberOfTextureColumns + textureColumn]);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, GetTextureSize(numberOfColumns), GetTextureSize(numberOfRows), 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+			UpdateTexture(textureRow, textureColumn);
+		}
+	}
 
-		glVertex2f(WorldMap.Vertices[i][j].Vertices[2].X, WorldMap.Vertices[i][j].Vertices[2].Y);
-		glVertex2f(WorldMap.Vertices[i][j].Vertices[3].X, WorldMap.Vertices[i][j].Vertices[3].Y);
+	GridLineVertices.clear();
+	if(WINDOW_WIDTH / WorldMap.NumberOfColumns < MINIMUM_GRID_FIELD_SIZE || WINDOW_HEIGHT / WorldMap.NumberOfRows < MINIMUM_GRID_FIELD_SIZE)
+		return;
 
-		glVertex2f(WorldMap.Vertices[i][j].Vertices[3].X, WorldMap.Vertices[i][j].Vertices[3].Y);
-		glVertex2f(WorldMap.Vertices[i][j].Vertices[0].X, WorldMap.Vertices[i][j].Vertices[0].Y);
-	glEnd();
+	VisualCoordinates topLeft = WorldMap.GetFieldCorner(0, 0);
+	VisualCoordinates bottomRight = WorldMap.GetFieldCorner(WorldMap.NumberOfRows, WorldMap.NumberOfColumns);
+	for(int i=0; i<=WorldMap.NumberOfRows; i++)
+	{
+		GLfloat y = WorldMap.GetFieldCorner(i, 0).Y;
+		GLfloat line[4] = { topLeft.X, y, bottomRight.X, y };
+		GridLineVertices.insert(GridLineVertices.end(), line, line + 4);
+	}
+	for(int j=0; j<=WorldMap.NumberOfColumns; j++)
+	{
+		GLfloat x = WorldMap.GetFieldCorner(0, j).X;
+		GLfloat line[4] = { x, topLeft.Y, x, bottomRight.Y };
+		GridLineVertices.insert(GridLineVertices.end(), line, line + 4);
+	}
 }
 
 //<summary>
-//Draws the shortest path as a red line that goes through all fiels that are part of the path.
+//Stores the centers of the fields of the shortest path in the vertex array of the path.
 //</summary>
-void DrawShortestPath()
+void BuildShortestPath()
 {
-	glColor3ub(255,0,0);
-	unsigned int numberOfVerticesInShortestPath = WorldMap.ShortestPathAndExpandedNodes.ShortestPath.size();
+	const vector<Coordinates2D>& shortestPath = WorldMap.ShortestPathAndExpandedNodes.ShortestPath;
 
-	for(unsigned int i=0; i<numberOfVerticesInShortestPath-1; i++)
+	ShortestPathVertices.clear();
+	for(unsigned int i=0; i<shortestPath.size(); i++)
 	{
-		int firstFieldRow = WorldMap.ShortestPathAndExpandedNodes.ShortestPath[i].X;
-		int firstFieldColumn = WorldMap.ShortestPathAndExpandedNodes.ShortestPath[i].Y;
+		VisualCoordinates center = WorldMap.GetFieldCenter(shortestPath[i].X, shortestPath[i].Y);
+		ShortestPathVertices.push_back(center.X);
+		ShortestPathVertices.push_back(center.Y);
+	}
+}
 
-		int secondFieldRow = WorldMap.ShortestPathAndExpandedNodes.ShortestPath[i+1].X;
-		int secondFieldColumn = WorldMap.ShortestPathAndExpandedNodes.ShortestPath[i+1].Y;
+//<summary>
+//Copies the colors of all fields covered by a texture to the texture.
+//</summary>
+//<param name='textureRow'>Row of the texture.</param>
+//<param name='textureColumn'>Column of the texture.</param>
+void UpdateTexture(int textureRow, int textureColumn)
+{
+	int firstRow = textureRow * FIELD_TEXTURE_TILE_SIZE;
+	int firstColumn = textureColumn * FIELD_TEXTURE_TILE_SIZE;
+	int numberOfRows = WorldMap.NumberOfRows - firstRow < FIELD_TEXTURE_TILE_SIZE ? WorldMap.NumberOfRows - firstRow : FIELD_TEXTURE_TILE_SIZE;
+	int numberOfColumns = WorldMap.NumberOfColumns - firstColumn < FIELD_TEXTURE_TILE_SIZE ? WorldMap.NumberOfColumns - firstColumn : FIELD_TEXTURE_TILE_SIZE;
 
-		glBegin(GL_LINES);
-			glVertex2f(WorldMap.Vertices[firstFieldRow][firstFieldColumn].VertexCenter.X, WorldMap.Vertices[firstFieldRow][firstFieldColumn].VertexCenter.Y);
-			glVertex2f(WorldMap.Vertices[secondFieldRow][secondFieldColumn].VertexCenter.X, WorldMap.Vertices[secondFieldRow][secondFieldColumn].VertexCenter.Y);
-		glEnd();
-	}
+	vector<GLubyte> colors(3 * numberOfRows * numberOfColumns);
+	for(int i=0; i<numberOfRows; i++)
+		for(int j=0; j<numberOfColumns; j++)
+			GetFieldColor(firstRow + i, firstColumn + j, &colors[3 * (i * numberOfColumns + j)]);
+
+	glBindTexture(GL_TEXTURE_2D, FieldTextures[textureRow * NumberOfTextureColumns + textureColumn]);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, numberOfColumns, numberOfRows, GL_RGB, GL_UNSIGNED_BYTE, &colors[0]);
 }
 
 //<summary>
-//Returns true if the field with grid coordinates 'row' and 'column'
-//was expanded by the A* algorithm and false otherwise.
+//Stores the color of the field with grid coordinates 'row' and 'column' in 'color': green for obstacles,
+//white for fields expanded by the A* algorithm and black for the rest.
 //</summary>
-//<param name='row'>Row of the field.</param>
-//<param name='column'>Column of the field.</param>
-bool FieldExpanded(int row, int column)
+void GetFieldColor(int row, int column, GLubyte* color)
 {
-	for(unsigned int i=0; i<WorldMap.ShortestPathAndExpandedNodes.ExpandedNodes.size(); i++)
+	unsigned char flags = WorldMap.GetFieldFlags(row, column);
+	if(flags & FIELD_OBSTACLE)
 	{
-		int fieldRow = WorldMap.ShortestPathAndExpandedNodes.ExpandedNodes[i].X;
-		int fieldColumn = WorldMap.ShortestPathAndExpandedNodes.ExpandedNodes[i].Y;
-
-		if(row == fieldRow && column == fieldColumn)
-			return true;
+		color[0] = 0;
+		color[1] = 255;
+		color[2] = 0;
+	}
+	else if(flags & FIELD_EXPANDED)
+	{
+		color[0] = 255;
+		color[1] = 255;
+		color[2] = 255;
+	}
+	else if(flags & FIELD_OPEN)
+	{
+		color[0] = 255;
+		color[1] = 255;
+		color[2] = 0;
+	}
+	else
+	{
+		color[0] = 0;
+		color[1] = 0;
+		color[2] = 0;
 	}
+}
 
-	return false;
+//<summary>
+//Returns the smallest power of two that is not smaller than 'numberOfFields'.
+//</summary>
+int GetTextureSize(int numberOfFields)
+{
+	int size = 1;
+	while(size < numberOfFields)
+		size <<= 1;
+	return size;
 }
 
 //<summary>
-//Ends the program if the escape key is pressed; otherwise, does nothing.
+//Shows the events of 'Replay' that fall into the last frame and draws the window again if some were shown;
+//registers itself again until the replay is finished.
+//</summary>
+void ReplayTick(int /*value*/)
+{
+	if(Replay->Advance(WorldMap, REPLAY_FRAME_MILLISECONDS / 1000.0) > 0)
+		RedrawMap();
+
+	if(!Replay->Finished())
+		glutTimerFunc(REPLAY_FRAME_MILLISECONDS, ReplayTick, 0);
+}
+
+//<summary>
+//Ends the program if the escape key is pressed. While a search is replayed, '+' and '-' double and halve
+//the speed of the replay and 'r' starts it again.
 //</summary>
 void TrackKeyboardKeys(unsigned char key, int mousePositionX, int mousePositionY)
 {
@@ -190,6 +375,27 @@ void TrackKeyboardKeys(unsigned char key, int mousePositionX, int mousePositionY
 			exit ( 0 );
 			break;
 
+		case '+':
+			if(Replay != NULL)
+				Replay->Speed *= 2.0;
+			break;
+
+		case '-':
+			if(Replay != NULL)
+				Replay->Speed /= 2.0;
+			break;
+
+		case 'r':
+			if(Replay != NULL)
+			{
+				bool finished = Replay->Finished();
+				Replay->Restart(WorldMap);
+				RedrawMap();
+				if(finished)
+					glutTimerFunc(REPLAY_FRAME_MILLISECONDS, ReplayTick, 0);
+			}
+			break;
+
 		default:
 			break;
 	}
@@ -0,0 +1,17 @@
+#ifndef LATTICE_MOTION_PRIMITIVE_H
+#define LATTICE_MOTION_PRIMITIVE_H
+
+//<summary>
+//Stores info for a motion that the robot can make from a lattice state, including:
+//	- the number of fields that the robot drives along its heading (negative values for driving backward).
+//	- the change of the heading after driving, in multiples of 90 degrees (positive values for turning right).
+//	- the time needed for the motion (per field if the robot drives, otherwise for the whole motion).
+//</summary>
+struct LatticeMotionPrimitive
+{
+	int Distance;
+	int HeadingChange;
+	double Time;
+};
+
+#endif
\ No newline at end of file
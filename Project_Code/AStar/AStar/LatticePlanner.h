@@ -0,0 +1,381 @@
+#ifndef LATTICE_PLANNER_H
+#define LATTICE_PLANNER_H
+
+#include "Coordinates2D.h"
+#include "LatticeMotionPrimitive.h"
+#include "LatticeResult.h"
+#include "SearchTrace.h"
+#include <vector>
+#include <queue>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include <limits>
+#include <cstdlib>
+using std::vector;
+using std::priority_queue;
+using std::pair;
+using std::make_pair;
+using std::greater;
+using std::numeric_limits;
+
+//headings of the robot; the row coordinate grows to the south and the column coordinate grows to the east
+const int HEADING_NORTH = 0;
+const int HEADING_EAST = 1;
+const int HEADING_SOUTH = 2;
+const int HEADING_WEST = 3;
+const int NUMBER_OF_HEADINGS = 4;
+
+//the heuristic is precalculated for destinations that are at most this many fields away in both directions
+const int LATTICE_HEURISTIC_WINDOW = 32;
+
+//times of the default motion primitives; the time unit is the time needed for driving one field forward on a field with cost 1.
+//In 'GoLeft' and 'GoRight' of the service the wheels run with powers 20 and -5, so the wheels drive apart 25/20 times
+//as fast as they drive forward and a quarter turn takes 0.4 * pi * (wheel base / field size) = 1.26 * (wheel base / field size) units.
+//The turn time of 2 units is an estimate for a wheel base of about 1.6 fields, not a measurement; for a real robot,
+//both times should be set from the measured times of 'GoForward' over a field and 'GoLeft' over a quarter turn.
+const double LATTICE_DRIVE_TIME = 1.0;
+const double LATTICE_TURN_TIME = 2.0;
+
+//<summary>
+//Class used for finding the fastest path for a differential drive robot on a grid.
+//The search runs over (x, y, heading) states, so turning costs time just like driving;
+//the heading is packed in the two lowest bits of the state index, which keeps the state arrays flat.
+//The heuristic is the time needed to reach the destination on an empty grid, precalculated
+//for all nearby destinations in a lookup table.
+//</summary>
+class LatticePlanner
+{
+public:
+	LatticePlanner();
+
+	//prepares the planner for 'worldMap' and precalculates the heuristic lookup table
+	void SetWorldMap(const vector<vector<double>>& worldMap);
+
+	//finds the fastest path from a field with a given heading to a destination field (reached with any heading)
+	LatticeResult Plan(Coordinates2D source, int sourceHeading, Coordinates2D destination);
+
+	//motions that the robot can make; by default driving one field forward and turning left or right in place
+	vector<LatticeMotionPrimitive> MotionPrimitives;
+
+	//used for storing the map of the environment
+	vector<vector<double>> WorldMap;
+
+	//optional trace; if it is set, the events of the search are recorded in it for the fields of the states
+	SearchTrace* Trace;
+
+private:
+	typedef pair<double, int> QueueEntry;
+	typedef priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> Queue;
+
+	//applies a motion primitive to a state; returns false if the motion leaves the grid
+	bool ApplyPrimitive(int x, int y, int heading, const LatticeMotionPrimitive& primitive,
+		const vector<vector<double>>* costs, int numberOfRows, int numberOfColumns,
+		int& newX, int& newY, int& newHeading, double& time);
+
+	//returns the heuristic for the state (x, y, heading)
+	double CalculateHeuristic(int x, int y, int heading, Coordinates2D destination);
+
+	//calculates the heuristic lookup table for an empty grid
+	void PrecalculateHeuristic();
+
+	//returns the index of the state (x, y, heading)
+	int GetStateIndex(int x, int y, int heading);
+
+	//time needed to reach each relative destination in the window from each heading
+	vector<double> heuristicTable;
+
+	//the lowest field cost in the map and the lowest driving time per field
+	double minimumFieldCost;
+	double minimumTimePerField;
+
+	int numberOfRows;
+	int numberOfColumns;
+
+	//state of the search; only the touched entries are reset between queries
+	vector<double> stateCost;
+	vector<int> stateParent;
+	vector<int> touchedStates;
+};
+
+//x and y offsets of a single field for each heading
+const int HEADING_X_OFFSETS[NUMBER_OF_HEADINGS] = { -1, 0, 1, 0 };
+const int HEADING_Y_OFFSETS[NUMBER_OF_HEADINGS] = { 0, 1, 0, -1 };
+
+
+//<summary>
+//Default constructor; the robot can drive one field forward or turn by 90 degrees in place.
+//Turning takes longer than driving a field, since the robot turns with one of the motors
+//running backward with low power (see 'GoLeft' and 'GoRight' in the service and 'LATTICE_TURN_TIME').
+//</summary>
+LatticePlanner::LatticePlanner()
+{
+	LatticeMotionPrimitive forward = { 1, 0, LATTICE_DRIVE_TIME };
+	LatticeMotionPrimitive turnLeft = { 0, -1, LATTICE_TURN_TIME };
+	LatticeMotionPrimitive turnRight = { 0, 1, LATTICE_TURN_TIME };
+	this->MotionPrimitives.push_back(forward);
+	this->MotionPrimitives.push_back(turnLeft);
+	this->MotionPrimitives.push_back(turnRight);
+
+	this->minimumFieldCost = 1.0;
+	this->minimumTimePerField = 1.0;
+	this->numberOfRows = 0;
+	this->numberOfColumns = 0;
+	this->Trace = NULL;
+}
+
+//<summary>
+//Stores 'worldMap' and precalculates the heuristic. Has to be called again if 'MotionPrimitives' are changed.
+//</summary>
+//<param name='worldMap'>A logical grid; driving to a field takes the time of the motion multiplied by the field value.</param>
+void LatticePlanner::SetWorldMap(const vector<vector<double>>& worldMap)
+{
+	this->WorldMap = worldMap;
+	this->numberOfRows = worldMap.size();
+	this->numberOfColumns = worldMap[0].size();
+
+	this->minimumFieldCost = numeric_limits<double>::infinity();
+	for(int x=0; x<this->numberOfRows; x++)
+		for(int y=0; y<this->numberOfColumns; y++)
+			this->minimumFieldCost = std::min(this->minimumFieldCost, worldMap[x][y]);
+
+	this->minimumTimePerField = numeric_limits<double>::infinity();
+	for(unsigned int i=0; i<this->MotionPrimitives.size(); i++)
+		if(this->MotionPrimitives[i].Distance != 0)
+			this->minimumTimePerField = std::min(this->minimumTimePerField, this->MotionPrimitives[i].Time);
+
+	int numberOfStates = this->numberOfRows * this->numberOfColumns * NUMBER_OF_HEADINGS;
+	this->stateCost.assign(numberOfStates, numeric_limits<double>::infinity());
+	this->stateParent.assign(numberOfStates, -1);
+	this->touchedStates.clear();
+
+	this->PrecalculateHeuristic();
+}
+
+//<summary>
+//Implementation of the A* algorithm over lattice states. The successors of a state are generated
+//by applying each motion primitive; the search ends when a state on the destination field is expanded.
+//The source and destination have to be inside the grid and the heading has to be one of the 'HEADING_' constants,
+//since they are packed into a state index without further checks.
+//</summary>
+//<param name='source'>Object containing the grid coordinates of the source field.</param>
+//<param name='sourceHeading'>Heading of the robot on the source field (one of the 'HEADING_' constants).</param>
+//<param name='destination'>Object containing the grid coordinates of the destination field.</param>
+LatticeResult LatticePlanner::Plan(Coordinates2D source, int sourceHeading, Coordinates2D destination)
+{
+	if(sourceHeading < 0 || sourceHeading >= NUMBER_OF_HEADINGS)
+		throw "Wrong heading";
+	if(source.X < 0 || source.X >= this->numberOfRows || source.Y < 0 || source.Y >= this->numberOfColumns ||
+		destination.X < 0 || destination.X >= this->numberOfRows || destination.Y < 0 || destination.Y >= this->numberOfColumns)
+		throw "Field out of bounds";
+
+	LatticeResult result;
+	result.TravelTime = -1.0;
+
+	Queue open;
+	int sourceState = this->GetStateIndex(source.X, source.Y, sourceHeading);
+	this->stateCost[sourceState] = 0.0;
+	this->touchedStates.push_back(sourceState);
+	open.push(make_pair(this->CalculateHeuristic(source.X, source.Y, sourceHeading, destination), sourceState));
+	if(this->Trace != NULL)
+		this->Trace->Push(source.X, source.Y, open.top().first);
+
+	int goalState = -1;
+	while(!open.empty())
+	{
+		QueueEntry entry = open.top();
+		open.pop();
+
+		int state = entry.second;
+		int heading = state & (NUMBER_OF_HEADINGS - 1);
+		int field = state >> 2;
+		int x = field / this->numberOfColumns;
+		int y = field % this->numberOfColumns;
+
+		//the queue can contain outdated entries for states whose cost was decreased
+		double cost = this->stateCost[state];
+		if(entry.first > cost + this->CalculateHeuristic(x, y, heading, destination))
+			continue;
+
+		result.ExpandedNodes.push_back(Coordinates2D(x, y));
+		if(this->Trace != NULL)
+			this->Trace->Pop(x, y);
+
+		if(x == destination.X && y == destination.Y)
+		{
+			goalState = state;
+			break;
+		}
+
+		for(unsigned int i=0; i<this->MotionPrimitives.size(); i++)
+		{
+			int newX, newY, newHeading;
+			double time;
+			if(!this->ApplyPrimitive(x, y, heading, this->MotionPrimitives[i], &this->WorldMap, this->numberOfRows, this->numberOfColumns, newX, newY, newHeading, time))
+				continue;
+
+			int newState = this->GetStateIndex(newX, newY, newHeading);
+			double newCost = cost + time;
+			if(newCost < this->stateCost[newState])
+			{
+				bool seen = this->stateCost[newState] != numeric_limits<double>::infinity();
+				if(!seen)
+					this->touchedStates.push_back(newState);
+
+				this->stateCost[newState] = newCost;
+				this->stateParent[newState] = state;
+				double totalCost = newCost + this->CalculateHeuristic(newX, newY, newHeading, destination);
+				open.push(make_pair(totalCost, newState));
+
+				//a state that was already reached gets a new queue entry with a lower cost, which acts as a decrease-key
+				if(this->Trace != NULL)
+				{
+					if(seen)
+						this->Trace->DecreaseKey(newX, newY, totalCost);
+					else
+						this->Trace->Push(newX, newY, totalCost);
+				}
+			}
+		}
+	}
+
+	if(goalState != -1)
+	{
+		result.TravelTime = this->stateCost[goalState];
+		for(int state = goalState; state != -1; state = this->stateParent[state])
+		{
+			int field = state >> 2;
+			result.ShortestPath.push_back(Coordinates2D(field / this->numberOfColumns, field % this->numberOfColumns));
+			result.Headings.push_back(state & (NUMBER_OF_HEADINGS - 1));
+		}
+
+		reverse(result.ShortestPath.begin(), result.ShortestPath.end());
+		reverse(result.Headings.begin(), result.Headings.end());
+	}
+	else
+		result.ExpandedNodes.clear();
+
+	//we reset the search state for the next query
+	for(unsigned int i=0; i<this->touchedStates.size(); i++)
+	{
+		this->stateCost[this->touchedStates[i]] = numeric_limits<double>::infinity();
+		this->stateParent[this->touchedStates[i]] = -1;
+	}
+	this->touchedStates.clear();
+
+	return result;
+}
+
+//<summary>
+//Applies 'primitive' to the state (x, y, heading). Driving to a field takes the time of the primitive
+//multiplied by the value of the field in 'costs' (or by the lowest field cost if 'costs' is NULL).
+//</summary>
+//<returns>False if the motion leaves the grid, true otherwise.</returns>
+bool LatticePlanner::ApplyPrimitive(int x, int y, int heading, const LatticeMotionPrimitive& primitive,
+	const vector<vector<double>>* costs, int numberOfRows, int numberOfColumns,
+	int& newX, int& newY, int& newHeading, double& time)
+{
+	int step = primitive.Distance > 0 ? 1 : -1;
+	int numberOfFields = abs(primitive.Distance);
+
+	newX = x;
+	newY = y;
+	time = numberOfFields == 0 ? primitive.Time : 0.0;
+	for(int i=0; i<numberOfFields; i++)
+	{
+		newX += step * HEADING_X_OFFSETS[heading];
+		newY += step * HEADING_Y_OFFSETS[heading];
+		if(newX < 0 || newX >= numberOfRows || newY < 0 || newY >= numberOfColumns)
+			return false;
+
+		time += primitive.Time * (costs == NULL ? this->minimumFieldCost : (*costs)[newX][newY]);
+	}
+
+	newHeading = ((heading + primitive.HeadingChange) % NUMBER_OF_HEADINGS + NUMBER_OF_HEADINGS) % NUMBER_OF_HEADINGS;
+	return true;
+}
+
+//<summary>
+//Returns the time needed to reach 'destination' from the state (x, y, heading) on an empty grid
+//in which every field has the lowest cost of the map. Nearby destinations are looked up in the
+//precalculated table; for the others, the Manhattan distance is driven with the fastest primitive.
+//</summary>
+double LatticePlanner::CalculateHeuristic(int x, int y, int heading, Coordinates2D destination)
+{
+	int differenceX = destination.X - x;
+	int differenceY = destination.Y - y;
+
+	if(abs(differenceX) <= LATTICE_HEURISTIC_WINDOW && abs(differenceY) <= LATTICE_HEURISTIC_WINDOW)
+	{
+		int windowSize = 2 * LATTICE_HEURISTIC_WINDOW + 1;
+		return this->heuristicTable[(heading * windowSize + differenceX + LATTICE_HEURISTIC_WINDOW) * windowSize + differenceY + LATTICE_HEURISTIC_WINDOW];
+	}
+
+	return (abs(differenceX) + abs(differenceY)) * this->minimumTimePerField * this->minimumFieldCost;
+}
+
+//<summary>
+//Calculates the heuristic lookup table by running a Dijkstra search from the center of an empty window
+//for each heading. An optimal path on an empty grid stays inside the bounding box of its endpoints,
+//so the window doesn't cut off any optimal paths.
+//</summary>
+void LatticePlanner::PrecalculateHeuristic()
+{
+	int windowSize = 2 * LATTICE_HEURISTIC_WINDOW + 1;
+	int numberOfWindowFields = windowSize * windowSize;
+	this->heuristicTable.assign(NUMBER_OF_HEADINGS * numberOfWindowFields, numeric_limits<double>::infinity());
+
+	vector<double> cost(numberOfWindowFields * NUMBER_OF_HEADINGS);
+	for(int startHeading=0; startHeading<NUMBER_OF_HEADINGS; startHeading++)
+	{
+		fill(cost.begin(), cost.end(), numeric_limits<double>::infinity());
+
+		Queue open;
+		int startState = (LATTICE_HEURISTIC_WINDOW * windowSize + LATTICE_HEURISTIC_WINDOW) * NUMBER_OF_HEADINGS + startHeading;
+		cost[startState] = 0.0;
+		open.push(make_pair(0.0, startState));
+
+		while(!open.empty())
+		{
+			QueueEntry entry = open.top();
+			open.pop();
+
+			int state = entry.second;
+			if(entry.first > cost[state])
+				continue;
+
+			int heading = state % NUMBER_OF_HEADINGS;
+			int field = state / NUMBER_OF_HEADINGS;
+			int x = field / windowSize;
+			int y = field % windowSize;
+
+			double& tableEntry = this->heuristicTable[startHeading * numberOfWindowFields + field];
+			tableEntry = std::min(tableEntry, entry.first);
+
+			for(unsigned int i=0; i<this->MotionPrimitives.size(); i++)
+			{
+				int newX, newY, newHeading;
+				double time;
+				if(!this->ApplyPrimitive(x, y, heading, this->MotionPrimitives[i], NULL, windowSize, windowSize, newX, newY, newHeading, time))
+					continue;
+
+				int newState = (newX * windowSize + newY) * NUMBER_OF_HEADINGS + newHeading;
+				if(entry.first + time < cost[newState])
+				{
+					cost[newState] = entry.first + time;
+					open.push(make_pair(cost[newState], newState));
+				}
+			}
+		}
+	}
+}
+
+//<summary>
+//Returns the index of the state (x, y, heading); the heading is stored in the two lowest bits.
+//</summary>
+int LatticePlanner::GetStateIndex(int x, int y, int heading)
+{
+	return ((x * this->numberOfColumns + y) << 2) | heading;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,21 @@
+#ifndef LATTICE_RESULT_H
+#define LATTICE_RESULT_H
+
+#include "Coordinates2D.h"
+#include <vector>
+using std::vector;
+
+//<summary>
+//Stores the result of the lattice planner: the fields and headings of the states on the path
+//(turning in place gives two consecutive states on the same field), the fields whose states
+//were expanded and the time needed to drive the path.
+//</summary>
+struct LatticeResult
+{
+	vector<Coordinates2D> ShortestPath;
+	vector<int> Headings;
+	vector<Coordinates2D> ExpandedNodes;
+	double TravelTime;
+};
+
+#endif
\ No newline at end of file
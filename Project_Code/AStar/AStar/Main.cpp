@@ -1,11 +1,18 @@
 #include "AStarLibrary.h"
 #include "DrawingLibrary.h"
+#include "RealTimeSearch.h"
+#include "WorldMapReader.h"
+#include "TiledWorldMap.h"
+#include "RasterExporter.h"
+#include "CoarseToFinePlanner.h"
 #include <iostream>
 #include <vector>
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <ctime>
+#include <chrono>
+#include <cstdlib>
 
 using std::cout;
 using std::ifstream;
@@ -13,21 +20,31 @@ using std::stringstream;
 using std::string;
 using std::vector;
 using std::ios;
+using std::chrono::high_resolution_clock;
+using std::chrono::duration_cast;
+using std::chrono::nanoseconds;
 
-void readDataFromFile(const char* filename, const char delimiter);
+void benchmarkRealTimeSearch(Coordinates2D source, Coordinates2D destination);
+void benchmarkTiledWorldMap(int mapSize, int maximumResidentTiles);
+void benchmarkHeuristicEvaluation(int mapSize);
+void benchmarkCoarseToFinePlanner(int mapSize);
 
 AStarLibrary aStarLibrary;
 	
 int main()
 {
-	readDataFromFile("worldMap 50x50.txt", ',');
+	aStarLibrary.WorldMap = WorldMapReader::ReadFromFile("worldMap 50x50.txt", ',');
 
 	//Coordinates2D sourceVertex(0,0), destinationVertex(3,3);		//used for testing the 5x5 grid
 	//Coordinates2D sourceVertex(3,0), destinationVertex(1,7);		//used for testing the 10x10 grid
 	Coordinates2D sourceVertex(5,4), destinationVertex(44,23);		//used for testing the 50x50 grid
 
+	//uncomment the line below to record the push, pop and decrease-key events of the search
+	SearchTrace searchTrace;
+	//aStarLibrary.Trace = &searchTrace;
+
 	clock_t start = clock();
-	WorldMap.ShortestPathAndExpandedNodes = aStarLibrary.AStar(sourceVertex, destinationVertex);
+	AStarResult shortestPathAndExpandedNodes = aStarLibrary.AStar(sourceVertex, destinationVertex);
 	clock_t end = clock();
 	double endTime = ((double)end-start)/(double(CLK_TCK/1000));
 	cout.setf(ios::fixed);
@@ -35,102 +52,297 @@ int main()
 	cout.precision(2);
 	cout << "time elapsed = " << endTime;
 
+	//uncomment the line below to compare the latency per tick and the path cost of the real-time search
+	//benchmarkRealTimeSearch(sourceVertex, destinationVertex);
+
+	//uncomment the line below to compare the expansions per second on a map in memory and on a map read from a tiled map file
+	//benchmarkTiledWorldMap(1024, 4);
+
+	//uncomment the line below to compare the share of the search time spent on calculating heuristics
+	//when all generated nodes are evaluated and when only the inserted and updated nodes are evaluated
+	//benchmarkHeuristicEvaluation(256);
+
+	//uncomment the line below to compare the time per query and the path cost of the coarse-to-fine planner
+	//on different levels of the cost pyramid with the A* search on the whole map
+	//benchmarkCoarseToFinePlanner(128);
+
 	WorldMap.ShortestPathFound = true;
 
 	DrawingLibrary drawingLibrary;
 	WorldMap.SetVisualMap(aStarLibrary.WorldMap);
+	WorldMap.SetSearchResult(shortestPathAndExpandedNodes);
 	WorldMap.Source = sourceVertex;
 	WorldMap.Destination = destinationVertex;
+
+	//uncomment the lines below to save the search as an image instead of (or before) drawing it in a window
+	//RasterExporter rasterExporter;
+	//rasterExporter.Render(WorldMap);
+	//rasterExporter.WritePng("worldMap 50x50.png");
+
+	//uncomment the lines below (and the line that sets 'aStarLibrary.Trace' above) to replay the search step by step;
+	//'+' and '-' change the speed of the replay and 'r' starts it again
+	//SearchReplay searchReplay;
+	//searchReplay.Load(&searchTrace.Data[0], searchTrace.Data.size());
+	//Replay = &searchReplay;
+
 	drawingLibrary.StartDrawing();
 
 	getchar();
 	return 0;
 }
 
-//<summary>Reads data from the file with name 'filename'.
+//<summary>
+//Drives from 'source' to 'destination' using the real-time search with different lookahead values and prints
+//the average and maximum time per tick and the cost of the driven path relative to the cost of the A* path.
+//Each lookahead is used for three trips, so that the effect of the learned heuristic is visible.
 //</summary>
-//<param name='filename'>Name of a file containing numerical data.</param>
-//<param name='delimiter'>Delimiter used to separate numbers in the file.</param>
-void readDataFromFile(const char* filename, const char delimiter)
+//<param name='source'>Object containing the grid coordinates of the source field.</param>
+//<param name='destination'>Object containing the grid coordinates of the destination field.</param>
+void benchmarkRealTimeSearch(Coordinates2D source, Coordinates2D destination)
 {
-	//stream for reading data from the file
-	ifstream document;
-
-	//string for storing a line from the file
-	string lineReader;
+	AStarResult optimalPath = aStarLibrary.AStar(source, destination);
+	double optimalCost = 0.0;
+	for(unsigned int i=1; i<optimalPath.ShortestPath.size(); i++)
+		optimalCost += aStarLibrary.WorldMap[optimalPath.ShortestPath[i].X][optimalPath.ShortestPath[i].Y];
 
-	//stream for converting strings to numbers
-	stringstream converter;
-
-	//variable for storing a converted string to number
-	double tempNumber;
-	
-	try
+	int lookaheads[] = { 1, 4, 16, 64, 256 };
+	for(int i=0; i<5; i++)
 	{
-		document.exceptions(ifstream::badbit | ifstream::failbit);
-		document.open(filename);
+		RealTimeSearch realTimeSearch;
+		realTimeSearch.Lookahead = lookaheads[i];
+		realTimeSearch.SetWorldMap(aStarLibrary.WorldMap);
 
-		while(!document.eof())
+		for(int trip=1; trip<=3; trip++)
 		{
-			getline(document,lineReader);
-			vector<double> currentRow;
+			Coordinates2D currentField = source;
+			double pathCost = 0.0, totalTime = 0.0, maximumTime = 0.0;
+			int numberOfTicks = 0;
 
-			//we make sure that the file does not contain letters
-			for(unsigned int character=0; character<lineReader.size(); character++)
+			//we stop if the destination can't be reached or if the robot wanders for too long
+			while(currentField != destination && numberOfTicks < 100000)
 			{
-				if(isalpha(lineReader[character]))
-					throw "Wrong format";
+				high_resolution_clock::time_point tickStart = high_resolution_clock::now();
+				Coordinates2D nextField = realTimeSearch.NextMove(currentField, destination);
+				double tickTime = duration_cast<nanoseconds>(high_resolution_clock::now() - tickStart).count() / 1000.0;
+
+				totalTime += tickTime;
+				if(tickTime > maximumTime)
+					maximumTime = tickTime;
+				numberOfTicks++;
+
+				if(nextField == currentField)
+					break;
+
+				pathCost += aStarLibrary.WorldMap[nextField.X][nextField.Y];
+				currentField = nextField;
 			}
 
-			//used for storing the previous position of a delimiter in the string;
-			//initially assigned to 0 because we haven't found a delimiter yet
-			int delimiterIndex = 0;
+			cout << "\nlookahead = " << lookaheads[i] << ", trip " << trip
+				 << ": ticks = " << numberOfTicks
+				 << ", average tick = " << totalTime / numberOfTicks << " us"
+				 << ", maximum tick = " << maximumTime << " us"
+				 << ", path cost / optimal cost = " << pathCost / optimalCost;
+		}
+	}
+}
 
-			//used for looping through the file line
-			//which was read in the current iteration
-			unsigned int i = 0;
+//<summary>
+//Creates a random 'mapSize' x 'mapSize' grid, writes it to a tiled map file and runs the same A* queries on the grid
+//in memory and on the file with at most 'maximumResidentTiles' resident tiles, printing the number of expansions per second.
+//</summary>
+//<param name='mapSize'>The number of rows and columns of the grid.</param>
+//<param name='maximumResidentTiles'>The maximum number of tiles of the file kept in memory.</param>
+void benchmarkTiledWorldMap(int mapSize, int maximumResidentTiles)
+{
+	const char* filename = "worldMap tiled.bin";
+	const int numberOfQueries = 20;
+	const int maximumDistance = 150;
+
+	srand(1);
+	vector<vector<double>> worldMap(mapSize, vector<double>(mapSize));
+	for(int x=0; x<mapSize; x++)
+		for(int y=0; y<mapSize; y++)
+			worldMap[x][y] = 1 + rand() % 5;
+	TiledWorldMap::WriteToFile(worldMap, filename);
+
+	//the queries are spread over the whole map, so that the tiles have to be replaced between them
+	vector<Coordinates2D> sources, destinations;
+	for(int i=0; i<numberOfQueries; i++)
+	{
+		Coordinates2D source(rand() % mapSize, rand() % mapSize);
+		Coordinates2D destination(source.X + rand() % (2 * maximumDistance + 1) - maximumDistance, source.Y + rand() % (2 * maximumDistance + 1) - maximumDistance);
+		destination.X = destination.X < 0 ? 0 : (destination.X >= mapSize ? mapSize - 1 : destination.X);
+		destination.Y = destination.Y < 0 ? 0 : (destination.Y >= mapSize ? mapSize - 1 : destination.Y);
+		sources.push_back(source);
+		destinations.push_back(destination);
+	}
+
+	TiledWorldMap tiledWorldMap;
+	tiledWorldMap.Open(filename, maximumResidentTiles);
+
+	AStarLibrary residentLibrary, tiledLibrary;
+	residentLibrary.WorldMap = worldMap;
+	tiledLibrary.Tiles = &tiledWorldMap;
 
-			//we loop through the file line and extract numbers
-			while(i<lineReader.size())
+	AStarLibrary* libraries[] = { &residentLibrary, &tiledLibrary };
+	const char* names[] = { "resident map", "tiled map file" };
+	for(int i=0; i<2; i++)
+	{
+		unsigned long long numberOfExpansions = 0;
+		high_resolution_clock::time_point start = high_resolution_clock::now();
+		for(int query=0; query<numberOfQueries; query++)
+			numberOfExpansions += libraries[i]->AStar(sources[query], destinations[query]).ExpandedNodes.size();
+		double seconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e9;
+
+		cout << "\n" << names[i] << ": expansions = " << numberOfExpansions
+			 << ", expansions per second = " << numberOfExpansions / seconds;
+	}
+	cout << ", tile loads = " << tiledWorldMap.NumberOfTileLoads;
+
+	tiledWorldMap.Close();
+	remove(filename);
+}
+
+//<summary>
+//Creates a random 'mapSize' x 'mapSize' grid and runs the same A* queries with each heuristic, printing the time of the complete
+//searches and the share of it spent on calculating heuristic values. The time of a single calculation is measured separately;
+//the search calculates the heuristic values without caching them, so each counted evaluation costs one such calculation.
+//The share for evaluating every generated node (as the search did before the heuristic values were calculated lazily)
+//is estimated from the number of generated nodes, and the share for the lazy evaluation from the number of calculated values.
+//</summary>
+//<param name='mapSize'>The number of rows and columns of the grid.</param>
+void benchmarkHeuristicEvaluation(int mapSize)
+{
+	const int numberOfQueries = 20;
+
+	srand(1);
+	AStarLibrary library;
+	library.WorldMap.assign(mapSize, vector<double>(mapSize));
+	for(int x=0; x<mapSize; x++)
+		for(int y=0; y<mapSize; y++)
+			library.WorldMap[x][y] = 1 + rand() % 5;
+
+	vector<Coordinates2D> sources, destinations;
+	for(int i=0; i<numberOfQueries; i++)
+	{
+		sources.push_back(Coordinates2D(rand() % mapSize, rand() % mapSize));
+		destinations.push_back(Coordinates2D(rand() % mapSize, rand() % mapSize));
+	}
+
+	int heuristics[] = { HEURISTIC_EUCLIDEAN, HEURISTIC_MANHATTAN };
+	const char* names[] = { "Euclidean", "Manhattan" };
+	for(int i=0; i<2; i++)
+	{
+		library.Heuristic = heuristics[i];
+		library.NumberOfGeneratedNodes = 0;
+		library.NumberOfHeuristicEvaluations = 0;
+
+		high_resolution_clock::time_point start = high_resolution_clock::now();
+		for(int query=0; query<numberOfQueries; query++)
+			library.AStar(sources[query], destinations[query]);
+		double searchTime = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e9;
+
+		//the calculations are timed on as many fields as there were generated nodes; the sum is printed
+		//so that the compiler can't leave the calculations out
+		double heuristicSum = 0.0;
+		start = high_resolution_clock::now();
+		for(unsigned long long evaluation=0; evaluation<library.NumberOfGeneratedNodes; evaluation++)
+			heuristicSum += library.CalculateHeuristic(Coordinates2D(evaluation % mapSize, (evaluation / mapSize) % mapSize), destinations[evaluation % numberOfQueries]);
+		double evaluationTime = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e9 / library.NumberOfGeneratedNodes;
+
+		double eagerTime = evaluationTime * library.NumberOfGeneratedNodes;
+		double lazyTime = evaluationTime * library.NumberOfHeuristicEvaluations;
+		cout << "\n" << names[i] << " heuristic: search time = " << searchTime * 1e3 << " ms, generated nodes = " << library.NumberOfGeneratedNodes
+			 << ", calculated heuristics = " << library.NumberOfHeuristicEvaluations
+			 << ", share of search time for all generated nodes = " << 100.0 * eagerTime / (searchTime - lazyTime + eagerTime) << "%"
+			 << ", share of search time for lazy evaluation = " << 100.0 * lazyTime / searchTime << "%"
+			 << " (sum " << heuristicSum << ")";
+	}
+}
+
+//<summary>
+//Creates a random 'mapSize' x 'mapSize' grid with obstacles and runs the same long queries with the A* search on the whole grid
+//and with the coarse-to-fine planner for each aggregation, pyramid level and corridor radius, printing the average time
+//per query and the cost of the paths relative to the cost of the A* paths. Finally compares the time for updating the pyramid
+//after a few fields changed with the time for building it again.
+//</summary>
+//<param name='mapSize'>The number of rows and columns of the grid.</param>
+void benchmarkCoarseToFinePlanner(int mapSize)
+{
+	const int numberOfQueries = 10;
+	const int numberOfUpdates = 100;
+
+	srand(1);
+	vector<vector<double>> worldMap(mapSize, vector<double>(mapSize));
+	for(int x=0; x<mapSize; x++)
+		for(int y=0; y<mapSize; y++)
+			worldMap[x][y] = rand() % 100 < 20 ? OBSTACLE_DELIMITER : 1 + rand() % 5;
+
+	//the queries go between opposite quarters of the map
+	vector<Coordinates2D> sources, destinations;
+	for(int i=0; i<numberOfQueries; i++)
+	{
+		sources.push_back(Coordinates2D(rand() % (mapSize / 4), rand() % (mapSize / 4)));
+		destinations.push_back(Coordinates2D(mapSize - 1 - rand() % (mapSize / 4), mapSize - 1 - rand() % (mapSize / 4)));
+	}
+
+	AStarLibrary library;
+	library.WorldMap = worldMap;
+	double optimalCost = 0.0;
+	high_resolution_clock::time_point start = high_resolution_clock::now();
+	for(int query=0; query<numberOfQueries; query++)
+	{
+		AStarResult result = library.AStar(sources[query], destinations[query]);
+		for(unsigned int i=1; i<result.ShortestPath.size(); i++)
+			optimalCost += worldMap[result.ShortestPath[i].X][result.ShortestPath[i].Y];
+	}
+	double optimalTime = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e6 / numberOfQueries;
+	cout << "\nwhole map: average query = " << optimalTime << " ms";
+
+	int aggregations[] = { PYRAMID_MAXIMUM_COST, PYRAMID_ANY_OBSTACLE };
+	const char* names[] = { "maximum cost", "any obstacle" };
+	CoarseToFinePlanner planner;
+	planner.SetWorldMap(worldMap);
+	for(int i=0; i<2; i++)
+	{
+		planner.Aggregation = aggregations[i];
+		for(int level=1; level<=5; level++)
+		{
+			planner.Level = level;
+			for(int radius=0; radius<=2; radius++)
 			{
-				//if we find a delimiter, we extract a number,
-				//convert it to 'float' and then store it in the data matrix
-				if(lineReader[i] == delimiter)
+				planner.CorridorRadius = radius;
+
+				double pathCost = 0.0;
+				start = high_resolution_clock::now();
+				for(int query=0; query<numberOfQueries; query++)
 				{
-					converter << lineReader.substr(delimiterIndex, i-delimiterIndex);
-					converter >> tempNumber;
-					currentRow.push_back(tempNumber);
-
-					delimiterIndex = i+1;
-
-					//we check for repetitive occurences of a delimiter
-					while(lineReader[delimiterIndex] == delimiter)
-					{
-						delimiterIndex++;
-						i++;
-					}
-					converter.clear();
+					AStarResult result = planner.FindPath(sources[query], destinations[query]);
+					for(unsigned int j=1; j<result.ShortestPath.size(); j++)
+						pathCost += worldMap[result.ShortestPath[j].X][result.ShortestPath[j].Y];
 				}
-				i++;
-			}
+				double time = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e6 / numberOfQueries;
 
-			//we extract the last number in the line
-			converter << lineReader.substr(delimiterIndex, lineReader.size()-delimiterIndex);
-			converter >> tempNumber;
-			currentRow.push_back(tempNumber);
-			converter.clear();
-
-			aStarLibrary.WorldMap.push_back(currentRow);
+				cout << "\n" << names[i] << ", level " << level << ", radius " << radius
+					 << ": average query = " << time << " ms"
+					 << ", path cost / optimal cost = " << pathCost / optimalCost;
+			}
 		}
-
-		document.close();
 	}
-	catch(...)
-	{
-		//we close the file stream in case it is open
-		if(document.is_open())
-			document.close();
 
-		throw "Error while reading file";
+	vector<MapCellUpdate> updates(numberOfUpdates);
+	for(int i=0; i<numberOfUpdates; i++)
+	{
+		updates[i].Field = Coordinates2D(rand() % mapSize, rand() % mapSize);
+		updates[i].Cost = rand() % 100 < 20 ? OBSTACLE_DELIMITER : 1 + rand() % 5;
+		worldMap[updates[i].Field.X][updates[i].Field.Y] = updates[i].Cost;
 	}
+
+	start = high_resolution_clock::now();
+	planner.UpdateFields(updates);
+	double updateTime = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e3;
+	start = high_resolution_clock::now();
+	planner.SetWorldMap(worldMap);
+	double buildTime = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e3;
+	cout << "\nupdating " << numberOfUpdates << " fields = " << updateTime << " us, building the pyramid = " << buildTime << " us";
 }
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef MAP_CELL_CHANGE_H
+#define MAP_CELL_CHANGE_H
+
+#include "Coordinates2D.h"
+
+//<summary>
+//Stores info for a change of a single field of a grid, including:
+//	- the grid coordinates of the field.
+//	- the cost of the field before the change.
+//	- the cost of the field after the change.
+//</summary>
+struct MapCellChange
+{
+	Coordinates2D Field;
+	double OldCost;
+	double NewCost;
+};
+
+#endif
\ No newline at end of file
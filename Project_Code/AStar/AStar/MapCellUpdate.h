@@ -0,0 +1,17 @@
+#ifndef MAP_CELL_UPDATE_H
+#define MAP_CELL_UPDATE_H
+
+#include "Coordinates2D.h"
+
+//<summary>
+//Stores info for a requested update of a single field of a grid, including:
+//	- the grid coordinates of the field.
+//	- the new cost of the field.
+//</summary>
+struct MapCellUpdate
+{
+	Coordinates2D Field;
+	double Cost;
+};
+
+#endif
\ No newline at end of file
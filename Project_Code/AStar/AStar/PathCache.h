@@ -0,0 +1,409 @@
+#ifndef PATH_CACHE_H
+#define PATH_CACHE_H
+
+#include "Coordinates2D.h"
+#include "MapCellChange.h"
+#include "PathCacheStatistics.h"
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+using std::vector;
+using std::list;
+using std::unordered_map;
+using std::mutex;
+using std::lock_guard;
+
+//<summary>
+//Class that stores shortest paths found on versioned maps, so that repeated queries don't need a new search.
+//A path is found again only for the same map, map version, source and destination, so the paths of several maps
+//(and of several versions of a map that are in use at the same time) are kept apart. Since every part of a shortest
+//path is a shortest path as well, a query is also answered if both of its fields lie (in the right order)
+//on a cached path. When the least recently used path has to make room for a new one, it is removed.
+//The cache can be used from several threads; the searches for the paths that are missing are done
+//by the callers, so the lock is only held while the cache itself is read or changed.
+//Grid coordinates have to be smaller than 65536.
+//</summary>
+class PathCache
+{
+public:
+	PathCache(unsigned int capacity);
+
+	//looks for a path between 'source' and 'destination' on the given version of the map 'mapId'
+	bool Find(unsigned int mapId, unsigned int mapVersion, Coordinates2D source, Coordinates2D destination, vector<Coordinates2D>& path);
+
+	//stores a shortest path found on the given version of the map 'mapId'
+	void Insert(unsigned int mapId, unsigned int mapVersion, const vector<Coordinates2D>& path);
+
+	//moves the paths of the map 'mapId' that are still shortest after 'changes' from 'oldVersion' to 'newVersion' and removes the rest
+	void ApplyChanges(unsigned int mapId, unsigned int oldVersion, unsigned int newVersion, const vector<MapCellChange>& changes);
+
+	//removes all paths found on the given version of the map 'mapId'
+	void RemoveVersion(unsigned int mapId, unsigned int mapVersion);
+
+	//removes all paths
+	void Clear();
+
+	//returns the hit and miss counts and the current size of the cache
+	PathCacheStatistics GetStatistics();
+
+private:
+	//key of a cached path: the map, the map version and the source and destination fields
+	struct PathCacheKey
+	{
+		unsigned int MapId;
+		unsigned int MapVersion;
+		unsigned long long Fields;
+
+		bool operator==(const PathCacheKey& rightHandSide) const;
+	};
+
+	//hash function for the keys of the cached paths
+	struct PathCacheKeyHash
+	{
+		size_t operator()(const PathCacheKey& key) const;
+	};
+
+	//a cached path together with its key
+	struct PathCacheEntry
+	{
+		PathCacheKey Key;
+		vector<Coordinates2D> Path;
+	};
+
+	typedef list<PathCacheEntry>::iterator EntryIterator;
+
+	//returns a key for a field
+	static unsigned int GetFieldKey(Coordinates2D field);
+
+	//returns a key for a field of the map 'mapId'
+	static unsigned long long GetMapFieldKey(unsigned int mapId, Coordinates2D field);
+
+	//returns a key for a path between 'source' and 'destination' on the given version of the map 'mapId'
+	static PathCacheKey GetPathKey(unsigned int mapId, unsigned int mapVersion, Coordinates2D source, Coordinates2D destination);
+
+	//looks for a cached path that contains 'source' and 'destination' in that order
+	bool FindSubpath(unsigned int mapId, unsigned int mapVersion, Coordinates2D source, Coordinates2D destination, vector<Coordinates2D>& path);
+
+	//inserts a path in the list before 'position' and in the indices
+	void AddEntry(EntryIterator position, const PathCacheEntry& entry);
+
+	//removes a path from the list and from the indices
+	void RemoveEntry(EntryIterator entry);
+
+	unsigned int capacity;
+
+	//paths ordered from the most to the least recently used one
+	list<PathCacheEntry> entries;
+
+	//paths by their keys
+	unordered_map<PathCacheKey, EntryIterator, PathCacheKeyHash> entriesByKey;
+
+	//for each field of each map, the keys of the paths that go through it and the position of the field on each of them
+	unordered_map<unsigned long long, unordered_map<PathCacheKey, unsigned int, PathCacheKeyHash>> pathsByField;
+
+	PathCacheStatistics statistics;
+	mutex cacheMutex;
+};
+
+
+//<summary>
+//Constructor; creates an empty cache that holds at most 'capacity' paths.
+//</summary>
+PathCache::PathCache(unsigned int capacity)
+{
+	this->capacity = capacity;
+	this->statistics.Hits = 0;
+	this->statistics.SubpathHits = 0;
+	this->statistics.Misses = 0;
+	this->statistics.Invalidations = 0;
+	this->statistics.Evictions = 0;
+	this->statistics.Size = 0;
+}
+
+//<summary>
+//Looks for a path between 'source' and 'destination' that was found on the version 'mapVersion' of the map 'mapId',
+//first between the same fields and then as a part of a longer path. The found path becomes the most recently used one.
+//</summary>
+//<param name='mapId'>Id of the map.</param>
+//<param name='mapVersion'>The version of the map on which the path is needed.</param>
+//<param name='path'>The fields of the path are stored here if a path is found.</param>
+//<returns>True if a path was found in the cache.</returns>
+bool PathCache::Find(unsigned int mapId, unsigned int mapVersion, Coordinates2D source, Coordinates2D destination, vector<Coordinates2D>& path)
+{
+	lock_guard<mutex> lock(this->cacheMutex);
+
+	unordered_map<PathCacheKey, EntryIterator, PathCacheKeyHash>::iterator entry = this->entriesByKey.find(GetPathKey(mapId, mapVersion, source, destination));
+	if(entry != this->entriesByKey.end())
+	{
+		this->entries.splice(this->entries.begin(), this->entries, entry->second);
+		path = entry->second->Path;
+		this->statistics.Hits++;
+		return true;
+	}
+
+	if(this->FindSubpath(mapId, mapVersion, source, destination, path))
+	{
+		this->statistics.SubpathHits++;
+		return true;
+	}
+
+	this->statistics.Misses++;
+	return false;
+}
+
+//<summary>
+//Stores 'path' as the path between its first and last field on the version 'mapVersion' of the map 'mapId'.
+//A path stored for the same map, version and fields is replaced. The paths stored for other versions of the map
+//are kept, since queries on older versions may still be running; they are removed by 'ApplyChanges' and 'RemoveVersion'
+//or when they become the least recently used paths. If the cache is full, the least recently used path is removed.
+//</summary>
+//<param name='mapId'>Id of the map.</param>
+//<param name='mapVersion'>The version of the map on which the path was found.</param>
+//<param name='path'>A shortest path, as returned by 'AStarLibrary::AStar'.</param>
+void PathCache::Insert(unsigned int mapId, unsigned int mapVersion, const vector<Coordinates2D>& path)
+{
+	if(path.empty() || this->capacity == 0)
+		return;
+
+	PathCacheEntry entry;
+	entry.Key = GetPathKey(mapId, mapVersion, path.front(), path.back());
+	entry.Path = path;
+
+	lock_guard<mutex> lock(this->cacheMutex);
+
+	unordered_map<PathCacheKey, EntryIterator, PathCacheKeyHash>::iterator existing = this->entriesByKey.find(entry.Key);
+	if(existing != this->entriesByKey.end())
+		this->RemoveEntry(existing->second);
+
+	if(this->entries.size() >= this->capacity)
+	{
+		this->RemoveEntry(--this->entries.end());
+		this->statistics.Evictions++;
+	}
+
+	this->AddEntry(this->entries.begin(), entry);
+}
+
+//<summary>
+//Updates the cache after the fields in 'changes' were changed, which turned the version 'oldVersion' of the map 'mapId'
+//into 'newVersion'. The paths that go through a changed field are removed. The remaining paths keep their cost, so if no field
+//became cheaper, they are still shortest paths and are moved to the new version (keeping their place in the order of use).
+//If some field became cheaper, a path that avoids it may not be the shortest one anymore, so all paths of the old version are removed.
+//</summary>
+//<param name='mapId'>Id of the map.</param>
+//<param name='oldVersion'>The version of the map before the change.</param>
+//<param name='newVersion'>The version of the map after the change.</param>
+//<param name='changes'>The changed fields with their old and new costs.</param>
+void PathCache::ApplyChanges(unsigned int mapId, unsigned int oldVersion, unsigned int newVersion, const vector<MapCellChange>& changes)
+{
+	lock_guard<mutex> lock(this->cacheMutex);
+
+	bool costDecreased = false;
+	for(unsigned int i=0; i<changes.size(); i++)
+	{
+		if(changes[i].NewCost < changes[i].OldCost)
+			costDecreased = true;
+
+		unordered_map<unsigned long long, unordered_map<PathCacheKey, unsigned int, PathCacheKeyHash>>::iterator paths = this->pathsByField.find(GetMapFieldKey(mapId, changes[i].Field));
+		if(paths == this->pathsByField.end())
+			continue;
+
+		//we collect the paths first, since removing them changes the index we are reading
+		vector<EntryIterator> affected;
+		for(unordered_map<PathCacheKey, unsigned int, PathCacheKeyHash>::iterator path = paths->second.begin(); path != paths->second.end(); ++path)
+			if(path->first.MapVersion == oldVersion)
+				affected.push_back(this->entriesByKey[path->first]);
+
+		for(unsigned int j=0; j<affected.size(); j++)
+			this->RemoveEntry(affected[j]);
+		this->statistics.Invalidations += affected.size();
+	}
+
+	EntryIterator entry = this->entries.begin();
+	while(entry != this->entries.end())
+	{
+		EntryIterator current = entry++;
+		if(current->Key.MapId != mapId || current->Key.MapVersion != oldVersion)
+			continue;
+
+		if(costDecreased)
+		{
+			this->RemoveEntry(current);
+			this->statistics.Invalidations++;
+			continue;
+		}
+
+		//the path is indexed by its key, so it is removed and added again with the new version;
+		//a path that a query on the new version already stored is kept instead
+		PathCacheEntry moved = *current;
+		moved.Key.MapVersion = newVersion;
+		this->RemoveEntry(current);
+		if(this->entriesByKey.find(moved.Key) == this->entriesByKey.end())
+			this->AddEntry(entry, moved);
+	}
+}
+
+//<summary>
+//Removes all paths that were found on the version 'mapVersion' of the map 'mapId'; used when a map is replaced as a whole.
+//</summary>
+void PathCache::RemoveVersion(unsigned int mapId, unsigned int mapVersion)
+{
+	lock_guard<mutex> lock(this->cacheMutex);
+
+	EntryIterator entry = this->entries.begin();
+	while(entry != this->entries.end())
+	{
+		EntryIterator current = entry++;
+		if(current->Key.MapId == mapId && current->Key.MapVersion == mapVersion)
+		{
+			this->RemoveEntry(current);
+			this->statistics.Invalidations++;
+		}
+	}
+}
+
+//<summary>
+//Removes all paths from the cache; the statistics are kept.
+//</summary>
+void PathCache::Clear()
+{
+	lock_guard<mutex> lock(this->cacheMutex);
+
+	this->entries.clear();
+	this->entriesByKey.clear();
+	this->pathsByField.clear();
+}
+
+//<summary>
+//Returns a copy of the statistics of the cache.
+//</summary>
+PathCacheStatistics PathCache::GetStatistics()
+{
+	lock_guard<mutex> lock(this->cacheMutex);
+
+	PathCacheStatistics statistics = this->statistics;
+	statistics.Size = this->entries.size();
+	return statistics;
+}
+
+//<summary>
+//Compares two keys of cached paths.
+//</summary>
+bool PathCache::PathCacheKey::operator==(const PathCacheKey& rightHandSide) const
+{
+	return this->MapId == rightHandSide.MapId && this->MapVersion == rightHandSide.MapVersion && this->Fields == rightHandSide.Fields;
+}
+
+//<summary>
+//Mixes the map id, the map version and the fields of 'key' into a single hash value.
+//</summary>
+size_t PathCache::PathCacheKeyHash::operator()(const PathCacheKey& key) const
+{
+	unsigned long long hash = key.Fields;
+	hash = (hash ^ key.MapId) * 0x9E3779B97F4A7C15ULL;
+	hash = (hash ^ key.MapVersion) * 0x9E3779B97F4A7C15ULL;
+	return (size_t)(hash ^ (hash >> 32));
+}
+
+//<summary>
+//Returns a key that is unique for each field with coordinates smaller than 65536.
+//</summary>
+unsigned int PathCache::GetFieldKey(Coordinates2D field)
+{
+	return ((unsigned int)field.X << 16) | ((unsigned int)field.Y & 0xFFFF);
+}
+
+//<summary>
+//Returns a key that is unique for each field with coordinates smaller than 65536 on each map.
+//</summary>
+unsigned long long PathCache::GetMapFieldKey(unsigned int mapId, Coordinates2D field)
+{
+	return ((unsigned long long)mapId << 32) | GetFieldKey(field);
+}
+
+//<summary>
+//Returns a key that is unique for each map, map version and pair of fields with coordinates smaller than 65536.
+//</summary>
+PathCache::PathCacheKey PathCache::GetPathKey(unsigned int mapId, unsigned int mapVersion, Coordinates2D source, Coordinates2D destination)
+{
+	PathCacheKey key;
+	key.MapId = mapId;
+	key.MapVersion = mapVersion;
+	key.Fields = ((unsigned long long)GetFieldKey(source) << 32) | GetFieldKey(destination);
+	return key;
+}
+
+//<summary>
+//Looks for a path of the version 'mapVersion' of the map 'mapId' on which 'source' comes before 'destination'
+//and copies the part between them to 'path'. The path that contains the part becomes the most recently used one.
+//</summary>
+//<returns>True if such a path was found.</returns>
+bool PathCache::FindSubpath(unsigned int mapId, unsigned int mapVersion, Coordinates2D source, Coordinates2D destination, vector<Coordinates2D>& path)
+{
+	unordered_map<unsigned long long, unordered_map<PathCacheKey, unsigned int, PathCacheKeyHash>>::iterator sourcePaths = this->pathsByField.find(GetMapFieldKey(mapId, source));
+	if(sourcePaths == this->pathsByField.end())
+		return false;
+
+	unordered_map<unsigned long long, unordered_map<PathCacheKey, unsigned int, PathCacheKeyHash>>::iterator destinationPaths = this->pathsByField.find(GetMapFieldKey(mapId, destination));
+	if(destinationPaths == this->pathsByField.end())
+		return false;
+
+	//we go through the shorter list of paths and look for each path in the other one
+	bool sourceListShorter = sourcePaths->second.size() <= destinationPaths->second.size();
+	unordered_map<PathCacheKey, unsigned int, PathCacheKeyHash>& shorterList = sourceListShorter ? sourcePaths->second : destinationPaths->second;
+	unordered_map<PathCacheKey, unsigned int, PathCacheKeyHash>& longerList = sourceListShorter ? destinationPaths->second : sourcePaths->second;
+
+	for(unordered_map<PathCacheKey, unsigned int, PathCacheKeyHash>::iterator candidate = shorterList.begin(); candidate != shorterList.end(); ++candidate)
+	{
+		if(candidate->first.MapVersion != mapVersion)
+			continue;
+
+		unordered_map<PathCacheKey, unsigned int, PathCacheKeyHash>::iterator other = longerList.find(candidate->first);
+		if(other == longerList.end())
+			continue;
+
+		unsigned int sourcePosition = sourceListShorter ? candidate->second : other->second;
+		unsigned int destinationPosition = sourceListShorter ? other->second : candidate->second;
+		if(sourcePosition > destinationPosition)
+			continue;
+
+		EntryIterator entry = this->entriesByKey[candidate->first];
+		this->entries.splice(this->entries.begin(), this->entries, entry);
+		path.assign(entry->Path.begin() + sourcePosition, entry->Path.begin() + destinationPosition + 1);
+		return true;
+	}
+
+	return false;
+}
+
+//<summary>
+//Inserts the path 'entry' in the list of paths before 'position' and in both indices.
+//</summary>
+void PathCache::AddEntry(EntryIterator position, const PathCacheEntry& entry)
+{
+	EntryIterator added = this->entries.insert(position, entry);
+	this->entriesByKey[added->Key] = added;
+
+	for(unsigned int i=0; i<added->Path.size(); i++)
+		this->pathsByField[GetMapFieldKey(added->Key.MapId, added->Path[i])][added->Key] = i;
+}
+
+//<summary>
+//Removes the path 'entry' from the list of paths and from both indices.
+//</summary>
+void PathCache::RemoveEntry(EntryIterator entry)
+{
+	for(unsigned int i=0; i<entry->Path.size(); i++)
+	{
+		unordered_map<unsigned long long, unordered_map<PathCacheKey, unsigned int, PathCacheKeyHash>>::iterator paths = this->pathsByField.find(GetMapFieldKey(entry->Key.MapId, entry->Path[i]));
+		paths->second.erase(entry->Key);
+		if(paths->second.empty())
+			this->pathsByField.erase(paths);
+	}
+
+	this->entriesByKey.erase(entry->Key);
+	this->entries.erase(entry);
+}
+
+#endif
\ No newline at end of file
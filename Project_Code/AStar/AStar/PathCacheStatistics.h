@@ -0,0 +1,23 @@
+#ifndef PATH_CACHE_STATISTICS_H
+#define PATH_CACHE_STATISTICS_H
+
+//<summary>
+//Stores statistics of a path cache, including:
+//	- the number of queries answered with a cached path between the same fields.
+//	- the number of queries answered with a part of a longer cached path.
+//	- the number of queries that were not answered from the cache.
+//	- the number of paths removed because the map changed.
+//	- the number of paths removed because the cache was full.
+//	- the number of paths currently in the cache.
+//</summary>
+struct PathCacheStatistics
+{
+	unsigned long long Hits;
+	unsigned long long SubpathHits;
+	unsigned long long Misses;
+	unsigned long long Invalidations;
+	unsigned long long Evictions;
+	unsigned long long Size;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,156 @@
+#ifndef PATH_DECODER_H
+#define PATH_DECODER_H
+
+#include "Coordinates2D.h"
+#include "PathEncoder.h"
+#include <vector>
+#include <cstddef>
+using std::vector;
+
+//<summary>
+//Class that reads the fields of a path encoded by 'PathEncoder' one at a time, directly from the encoded bytes
+//(e.g. from the buffer in which they were received), so the decoded path never has to be stored as a whole.
+//</summary>
+class PathDecoder
+{
+public:
+	PathDecoder(const unsigned char* data, size_t length);
+
+	//reads the next field of the path; returns false after the last field
+	bool Next(Coordinates2D& field);
+
+	//decodes a whole path
+	static void Decode(const unsigned char* data, size_t length, vector<Coordinates2D>& path);
+
+private:
+	//reads a single byte
+	unsigned char ReadByte();
+
+	//reads an integer written by 'PathEncoder::WriteNumber'
+	unsigned int ReadNumber();
+
+	const unsigned char* data;
+	size_t length;
+	size_t position;
+
+	bool started;
+	bool finished;
+	Coordinates2D currentField;
+
+	//the steps of the current token that were not read yet
+	int tokenSteps[PATH_LITERAL_STEPS];
+	int numberOfTokenSteps;
+	int nextTokenStep;
+	bool runToken;
+};
+
+
+//<summary>
+//Constructor; prepares reading the path encoded in 'length' bytes starting at 'data'. The bytes are not copied.
+//</summary>
+PathDecoder::PathDecoder(const unsigned char* data, size_t length)
+{
+	this->data = data;
+	this->length = length;
+	this->position = 0;
+	this->started = false;
+	this->finished = length == 0;
+	this->numberOfTokenSteps = 0;
+	this->nextTokenStep = 0;
+	this->runToken = false;
+}
+
+//<summary>
+//Stores the next field of the path in 'field'.
+//</summary>
+//<returns>False if all fields were already read.</returns>
+bool PathDecoder::Next(Coordinates2D& field)
+{
+	if(this->finished)
+		return false;
+
+	if(!this->started)
+	{
+		this->currentField.X = this->ReadNumber();
+		this->currentField.Y = this->ReadNumber();
+		this->started = true;
+		field = this->currentField;
+		return true;
+	}
+
+	if(this->nextTokenStep == this->numberOfTokenSteps)
+	{
+		unsigned char token = this->ReadByte();
+		this->nextTokenStep = 0;
+		if(token & PATH_RUN_TOKEN)
+		{
+			this->runToken = true;
+			this->tokenSteps[0] = (token >> 5) & 3;
+			this->numberOfTokenSteps = token & 0x1F;
+			if(this->numberOfTokenSteps == 0)
+			{
+				this->finished = true;
+				return false;
+			}
+		}
+		else
+		{
+			this->runToken = false;
+			this->tokenSteps[0] = (token >> 5) & 3;
+			this->tokenSteps[1] = (token >> 3) & 3;
+			this->tokenSteps[2] = (token >> 1) & 3;
+			this->numberOfTokenSteps = PATH_LITERAL_STEPS;
+		}
+	}
+
+	int direction = this->tokenSteps[this->runToken ? 0 : this->nextTokenStep];
+	this->nextTokenStep++;
+
+	this->currentField.X += PATH_DIRECTION_X_OFFSETS[direction];
+	this->currentField.Y += PATH_DIRECTION_Y_OFFSETS[direction];
+	field = this->currentField;
+	return true;
+}
+
+//<summary>
+//Decodes the path encoded in 'length' bytes starting at 'data' into 'path'.
+//</summary>
+void PathDecoder::Decode(const unsigned char* data, size_t length, vector<Coordinates2D>& path)
+{
+	path.clear();
+
+	PathDecoder decoder(data, length);
+	Coordinates2D field;
+	while(decoder.Next(field))
+		path.push_back(field);
+}
+
+//<summary>
+//Reads the next byte; throws an exception if the encoded path ends too early.
+//</summary>
+unsigned char PathDecoder::ReadByte()
+{
+	if(this->position >= this->length)
+		throw "Wrong format";
+
+	return this->data[this->position++];
+}
+
+//<summary>
+//Reads an integer stored with 7 bits per byte, starting with the lowest bits.
+//</summary>
+unsigned int PathDecoder::ReadNumber()
+{
+	unsigned int value = 0;
+	for(int shift=0; shift<35; shift+=7)
+	{
+		unsigned char byte = this->ReadByte();
+		value |= (unsigned int)(byte & 0x7F) << shift;
+		if(!(byte & 0x80))
+			return value;
+	}
+
+	throw "Wrong format";
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,236 @@
+#ifndef PATH_ENCODER_H
+#define PATH_ENCODER_H
+
+#include "Coordinates2D.h"
+#include <cstddef>
+
+//offsets of the four directions of movement (north, east, south and west) in grid coordinates
+const int PATH_DIRECTION_X_OFFSETS[4] = { -1, 0, 1, 0 };
+const int PATH_DIRECTION_Y_OFFSETS[4] = { 0, 1, 0, -1 };
+
+//a run token stores up to PATH_MAXIMUM_RUN steps in the same direction; shorter runs are stored as literals
+const int PATH_MAXIMUM_RUN = 31;
+const int PATH_MINIMUM_RUN = 4;
+
+//a literal token stores this many steps
+const int PATH_LITERAL_STEPS = 3;
+
+//tokens: a run is 1 dd lllll (direction and length 1-31), a literal is 0 aa bb cc 0 (three directions), the end is a run of length 0
+const unsigned char PATH_RUN_TOKEN = 0x80;
+const unsigned char PATH_END_TOKEN = 0x80;
+
+//<summary>
+//Class that encodes a path of adjacent fields (4-connectivity, as in 'AStarLibrary') into a compact binary form:
+//the first field as two variable-length integers, followed by one-byte tokens that store either a run of up to 31 steps
+//in the same direction or three single steps with 2-bit direction codes, and an end token. Straight parts of a path
+//take a byte per 31 fields and the turning parts a byte per three fields, instead of eight bytes per field.
+//An empty path is encoded as zero bytes. The bytes are written directly to a buffer given by the caller.
+//</summary>
+class PathEncoder
+{
+public:
+	PathEncoder();
+
+	//starts encoding a path that begins at 'start' into 'buffer'
+	void Begin(Coordinates2D start, unsigned char* buffer, size_t capacity);
+
+	//adds the next field of the path
+	void Add(Coordinates2D field);
+
+	//writes the steps that are still pending and the end token
+	void Finish();
+
+	//starts writing at the beginning of the buffer again, keeping the pending steps
+	void Rewind();
+
+	//encodes a whole path; returns the number of written bytes
+	static size_t Encode(const Coordinates2D* path, size_t numberOfFields, unsigned char* buffer, size_t capacity);
+
+	//returns the maximum number of bytes needed for a path with 'numberOfFields' fields
+	static size_t GetMaximumEncodedLength(size_t numberOfFields);
+
+	//number of bytes written to the buffer
+	size_t Length;
+
+private:
+	//writes a single byte to the buffer
+	void WriteByte(unsigned char value);
+
+	//writes a non-negative integer with 7 bits per byte
+	void WriteNumber(unsigned int value);
+
+	//writes the tokens for the pending steps that can already be decided
+	void WriteTokens(bool finish);
+
+	unsigned char* buffer;
+	size_t capacity;
+	Coordinates2D lastField;
+
+	//directions of the steps that are not written yet
+	int pendingSteps[PATH_MAXIMUM_RUN];
+	int numberOfPendingSteps;
+};
+
+
+//<summary>
+//Default constructor; creates an encoder without a buffer.
+//</summary>
+PathEncoder::PathEncoder()
+{
+	this->buffer = NULL;
+	this->capacity = 0;
+	this->Length = 0;
+	this->numberOfPendingSteps = 0;
+}
+
+//<summary>
+//Starts encoding a path whose first field is 'start'. The grid coordinates have to be non-negative.
+//</summary>
+//<param name='start'>The first field of the path.</param>
+//<param name='buffer'>Buffer to which the encoded path is written.</param>
+//<param name='capacity'>Size of the buffer in bytes.</param>
+void PathEncoder::Begin(Coordinates2D start, unsigned char* buffer, size_t capacity)
+{
+	this->buffer = buffer;
+	this->capacity = capacity;
+	this->Length = 0;
+	this->numberOfPendingSteps = 0;
+	this->lastField = start;
+
+	this->WriteNumber(start.X);
+	this->WriteNumber(start.Y);
+}
+
+//<summary>
+//Adds the next field of the path, which has to be adjacent to the previous one. The step is kept pending
+//until it is known whether it is a part of a run, so the bytes may only be written by a later call.
+//</summary>
+void PathEncoder::Add(Coordinates2D field)
+{
+	int direction = -1;
+	for(int i=0; i<4; i++)
+		if(field.X - this->lastField.X == PATH_DIRECTION_X_OFFSETS[i] && field.Y - this->lastField.Y == PATH_DIRECTION_Y_OFFSETS[i])
+			direction = i;
+
+	if(direction == -1)
+		throw "Path fields are not adjacent";
+
+	this->pendingSteps[this->numberOfPendingSteps++] = direction;
+	this->lastField = field;
+	this->WriteTokens(false);
+}
+
+//<summary>
+//Writes all pending steps and the end token.
+//</summary>
+void PathEncoder::Finish()
+{
+	this->WriteTokens(true);
+	this->WriteByte(PATH_END_TOKEN);
+}
+
+//<summary>
+//Continues writing at the beginning of the buffer; used when the written bytes were already sent somewhere else.
+//</summary>
+void PathEncoder::Rewind()
+{
+	this->Length = 0;
+}
+
+//<summary>
+//Encodes the path given by 'numberOfFields' fields starting at 'path' into 'buffer'.
+//</summary>
+//<param name='path'>The fields of the path, e.g. the data of 'AStarResult::ShortestPath'.</param>
+//<param name='numberOfFields'>The number of fields of the path.</param>
+//<param name='buffer'>Buffer to which the encoded path is written.</param>
+//<param name='capacity'>Size of the buffer in bytes; 'GetMaximumEncodedLength' bytes are always enough.</param>
+//<returns>The number of written bytes.</returns>
+size_t PathEncoder::Encode(const Coordinates2D* path, size_t numberOfFields, unsigned char* buffer, size_t capacity)
+{
+	if(numberOfFields == 0)
+		return 0;
+
+	PathEncoder encoder;
+	encoder.Begin(path[0], buffer, capacity);
+	for(size_t i=1; i<numberOfFields; i++)
+		encoder.Add(path[i]);
+	encoder.Finish();
+
+	return encoder.Length;
+}
+
+//<summary>
+//Returns the number of bytes that is enough for any path with 'numberOfFields' fields:
+//two coordinates of at most five bytes, at most a token per step and the end token.
+//</summary>
+size_t PathEncoder::GetMaximumEncodedLength(size_t numberOfFields)
+{
+	return numberOfFields == 0 ? 0 : 10 + numberOfFields;
+}
+
+//<summary>
+//Writes 'value' at the end of the buffer.
+//</summary>
+void PathEncoder::WriteByte(unsigned char value)
+{
+	if(this->Length >= this->capacity)
+		throw "Buffer too small";
+
+	this->buffer[this->Length++] = value;
+}
+
+//<summary>
+//Writes 'value' with 7 bits per byte, starting with the lowest bits; the highest bit of a byte is set if more bytes follow.
+//</summary>
+void PathEncoder::WriteNumber(unsigned int value)
+{
+	while(value >= 0x80)
+	{
+		this->WriteByte((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+	this->WriteByte((unsigned char)value);
+}
+
+//<summary>
+//Writes tokens for the pending steps. A run token is written for at least PATH_MINIMUM_RUN steps in the same direction
+//and a literal token for three steps otherwise. While a run could still get longer or a literal is not complete,
+//the steps stay pending, unless 'finish' is true, in which case the remaining steps are written as short runs.
+//</summary>
+void PathEncoder::WriteTokens(bool finish)
+{
+	while(this->numberOfPendingSteps > 0)
+	{
+		int runLength = 1;
+		while(runLength < this->numberOfPendingSteps && this->pendingSteps[runLength] == this->pendingSteps[0])
+			runLength++;
+
+		if(!finish && runLength == this->numberOfPendingSteps && runLength < PATH_MAXIMUM_RUN)
+			break;
+
+		int numberOfWrittenSteps;
+		if(runLength >= PATH_MINIMUM_RUN)
+		{
+			this->WriteByte(PATH_RUN_TOKEN | (this->pendingSteps[0] << 5) | runLength);
+			numberOfWrittenSteps = runLength;
+		}
+		else if(this->numberOfPendingSteps >= PATH_LITERAL_STEPS)
+		{
+			this->WriteByte((this->pendingSteps[0] << 5) | (this->pendingSteps[1] << 3) | (this->pendingSteps[2] << 1));
+			numberOfWrittenSteps = PATH_LITERAL_STEPS;
+		}
+		else if(!finish)
+			break;
+		else
+		{
+			this->WriteByte(PATH_RUN_TOKEN | (this->pendingSteps[0] << 5) | runLength);
+			numberOfWrittenSteps = runLength;
+		}
+
+		for(int i=numberOfWrittenSteps; i<this->numberOfPendingSteps; i++)
+			this->pendingSteps[i - numberOfWrittenSteps] = this->pendingSteps[i];
+		this->numberOfPendingSteps -= numberOfWrittenSteps;
+	}
+}
+
+#endif
\ No newline at end of file
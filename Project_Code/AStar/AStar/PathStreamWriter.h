@@ -0,0 +1,91 @@
+#ifndef PATH_STREAM_WRITER_H
+#define PATH_STREAM_WRITER_H
+
+#include "Coordinates2D.h"
+#include "PathEncoder.h"
+#include <ostream>
+using std::ostream;
+
+//size of the buffer in which the stream writer collects the encoded bytes; a single field never produces more
+const int PATH_STREAM_CHUNK_SIZE = 64;
+
+//<summary>
+//Class that encodes a path with 'PathEncoder' while its fields are produced and writes the bytes to a stream,
+//so that neither the path nor its encoding has to be kept in memory as a whole.
+//</summary>
+class PathStreamWriter
+{
+public:
+	PathStreamWriter(ostream& stream);
+
+	//starts a path that begins at 'start'
+	void Begin(Coordinates2D start);
+
+	//adds the next field of the path
+	void Add(Coordinates2D field);
+
+	//writes the rest of the path
+	void Finish();
+
+	//number of bytes written to the stream
+	size_t NumberOfBytes;
+
+private:
+	//writes the collected bytes to the stream
+	void WriteChunk();
+
+	ostream& stream;
+	PathEncoder encoder;
+	unsigned char chunk[PATH_STREAM_CHUNK_SIZE];
+};
+
+
+//<summary>
+//Constructor; the encoded paths are written to 'stream'.
+//</summary>
+PathStreamWriter::PathStreamWriter(ostream& stream) : stream(stream)
+{
+	this->NumberOfBytes = 0;
+}
+
+//<summary>
+//Starts a path whose first field is 'start'.
+//</summary>
+void PathStreamWriter::Begin(Coordinates2D start)
+{
+	this->encoder.Begin(start, this->chunk, PATH_STREAM_CHUNK_SIZE);
+	this->WriteChunk();
+}
+
+//<summary>
+//Adds the next field of the path, which has to be adjacent to the previous one.
+//</summary>
+void PathStreamWriter::Add(Coordinates2D field)
+{
+	this->encoder.Add(field);
+	this->WriteChunk();
+}
+
+//<summary>
+//Writes the pending steps and the end token of the path.
+//</summary>
+void PathStreamWriter::Finish()
+{
+	this->encoder.Finish();
+	this->WriteChunk();
+}
+
+//<summary>
+//Writes the bytes collected by the encoder to the stream and lets the encoder reuse the buffer.
+//</summary>
+void PathStreamWriter::WriteChunk()
+{
+	if(this->encoder.Length == 0)
+		return;
+
+	this->stream.write((const char*)this->chunk, this->encoder.Length);
+	this->NumberOfBytes += this->encoder.Length;
+	this->encoder.Rewind();
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,388 @@
+#ifndef RASTER_EXPORTER_H
+#define RASTER_EXPORTER_H
+
+#include "AStarVisualWorldMap.h"
+#include "AStarResult.h"
+#include "Coordinates2D.h"
+#include "DrawingConstants.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+using std::vector;
+using std::string;
+using std::ofstream;
+using std::ios;
+using std::numeric_limits;
+
+//colors of the exported images; the same as the ones used by 'DrawingLibrary'
+const unsigned char RASTER_OBSTACLE_COLOR[3] = { 0, 255, 0 };
+const unsigned char RASTER_EXPANDED_COLOR[3] = { 255, 255, 255 };
+const unsigned char RASTER_OPEN_COLOR[3] = { 255, 255, 0 };
+const unsigned char RASTER_FREE_COLOR[3] = { 0, 0, 0 };
+const unsigned char RASTER_GRID_COLOR[3] = { 0, 0, 255 };
+const unsigned char RASTER_PATH_COLOR[3] = { 255, 0, 0 };
+
+//grid lines are only drawn if a field is at least this many pixels wide
+const int RASTER_MINIMUM_GRID_CELL_SIZE = 4;
+
+//the data of a PNG file is split into stored deflate blocks of at most this many bytes
+const int RASTER_MAXIMUM_DEFLATE_BLOCK = 65535;
+
+//the length of a PNG chunk has to fit in 31 bits, so images whose data doesn't fit in a single IDAT chunk of this size are rejected
+const size_t RASTER_MAXIMUM_PNG_CHUNK = 0x7FFFFFFF;
+
+//<summary>
+//Class used for saving the grid, the expanded fields and the shortest path as an image (PPM or PNG) without a window,
+//so that searches can be inspected on machines without a display. The state of the fields is first stored with one byte
+//of flags per field (as in 'VisualWorldMap'), so rendering takes time linear in the size of the map and the number of expanded fields.
+//</summary>
+class RasterExporter
+{
+public:
+	RasterExporter();
+
+	//renders a visual map, as drawn by 'DrawingLibrary'; can be used for exporting the frames of a replayed search
+	void Render(const AStarVisualWorldMap& worldMap);
+
+	//renders a logical grid together with the result of a search on it
+	void Render(const vector<vector<double>>& worldMap, const AStarResult& result);
+
+	//writes the rendered image as a binary PPM file
+	void WritePpm(const char* filename);
+
+	//writes the rendered image as a PNG file
+	void WritePng(const char* filename);
+
+	//width and height of a field in pixels
+	int CellSize;
+
+	//width and height of the image in pixels
+	int Width;
+	int Height;
+
+	//the pixels of the rendered image, row by row, with three bytes (red, green, blue) per pixel
+	vector<unsigned char> Pixels;
+
+private:
+	//draws the fields, the grid lines and the path; 'fieldFlags' has to be filled before
+	void DrawFields(int numberOfRows, int numberOfColumns, const vector<Coordinates2D>& shortestPath);
+
+	//fills a rectangle of pixels with a color
+	void FillRectangle(int top, int left, int height, int width, const unsigned char* color);
+
+	//writes 'value' as four bytes, starting with the highest one
+	static void WriteBigEndian(string& output, unsigned int value);
+
+	//appends a PNG chunk with its length and checksum to 'output'
+	static void WritePngChunk(string& output, const char* type, const string& data);
+
+	//calculates the CRC-32 checksum used by PNG chunks
+	static unsigned int CalculateCrc(const char* data, size_t length);
+
+	//the flags of each field ('FIELD_OBSTACLE', 'FIELD_EXPANDED' and 'FIELD_OPEN')
+	vector<unsigned char> fieldFlags;
+};
+
+
+//<summary>
+//Default constructor; each field takes 8 x 8 pixels.
+//</summary>
+RasterExporter::RasterExporter()
+{
+	this->CellSize = 8;
+	this->Width = 0;
+	this->Height = 0;
+}
+
+//<summary>
+//Renders the obstacles, open and expanded fields and the shortest path stored in 'worldMap'.
+//</summary>
+//<param name='worldMap'>A visual grid with the result of a search.</param>
+void RasterExporter::Render(const AStarVisualWorldMap& worldMap)
+{
+	int numberOfRows = worldMap.NumberOfRows;
+	int numberOfColumns = worldMap.NumberOfColumns;
+
+	this->fieldFlags.resize((size_t)numberOfRows * numberOfColumns);
+	for(int x=0; x<numberOfRows; x++)
+		for(int y=0; y<numberOfColumns; y++)
+			this->fieldFlags[(size_t)x * numberOfColumns + y] = worldMap.GetFieldFlags(x, y);
+
+	this->DrawFields(numberOfRows, numberOfColumns, worldMap.ShortestPathAndExpandedNodes.ShortestPath);
+}
+
+//<summary>
+//Renders 'worldMap' with the expanded fields and the shortest path stored in 'result'; doesn't need a visual grid,
+//so it can be used for maps that are too large for one.
+//</summary>
+//<param name='worldMap'>A logical grid.</param>
+//<param name='result'>The result of a search on the grid.</param>
+void RasterExporter::Render(const vector<vector<double>>& worldMap, const AStarResult& result)
+{
+	int numberOfRows = worldMap.size();
+	int numberOfColumns = worldMap[0].size();
+
+	this->fieldFlags.assign((size_t)numberOfRows * numberOfColumns, 0);
+	for(int x=0; x<numberOfRows; x++)
+		for(int y=0; y<numberOfColumns; y++)
+			if(fabs(worldMap[x][y] - OBSTACLE_DELIMITER) < 0.005)
+				this->fieldFlags[(size_t)x * numberOfColumns + y] = FIELD_OBSTACLE;
+
+	for(unsigned int i=0; i<result.ExpandedNodes.size(); i++)
+		this->fieldFlags[(size_t)result.ExpandedNodes[i].X * numberOfColumns + result.ExpandedNodes[i].Y] |= FIELD_EXPANDED;
+
+	this->DrawFields(numberOfRows, numberOfColumns, result.ShortestPath);
+}
+
+//<summary>
+//Writes the rendered image to 'filename' as a binary PPM (P6) file.
+//</summary>
+void RasterExporter::WritePpm(const char* filename)
+{
+	ofstream document;
+	try
+	{
+		document.exceptions(ofstream::badbit | ofstream::failbit);
+		document.open(filename, ios::out | ios::binary);
+		document << "P6\n" << this->Width << " " << this->Height << "\n255\n";
+		document.write((const char*)&this->Pixels[0], this->Pixels.size());
+		document.close();
+	}
+	catch(...)
+	{
+		if(document.is_open())
+			document.close();
+
+		throw "Error while writing file";
+	}
+}
+
+//<summary>
+//Writes the rendered image to 'filename' as an 8-bit RGB PNG file. The image data is stored in uncompressed
+//deflate blocks, so no compression library is needed; the file is slightly larger than the PPM file.
+//The whole file is built in a single buffer: the rows are copied from 'Pixels' straight into the deflate blocks of the IDAT chunk.
+//Images whose data doesn't fit in a single PNG chunk (about 700 million pixels) are rejected.
+//</summary>
+void RasterExporter::WritePng(const char* filename)
+{
+	//each row starts with a filter type (0, no filter) and the rows are stored in a zlib stream without compression;
+	//the zlib stream takes a 2 byte header, a 5 byte header for each deflate block and a 4 byte checksum
+	size_t rowLength = 3 * (size_t)this->Width;
+	size_t rawLength = (rowLength + 1) * this->Height;
+	size_t numberOfBlocks = rawLength == 0 ? 1 : (rawLength + RASTER_MAXIMUM_DEFLATE_BLOCK - 1) / RASTER_MAXIMUM_DEFLATE_BLOCK;
+	if((size_t)this->Height > RASTER_MAXIMUM_PNG_CHUNK / (rowLength + 1) || rawLength + 5 * numberOfBlocks + 6 > RASTER_MAXIMUM_PNG_CHUNK)
+		throw "Wrong image size";
+	size_t dataLength = 2 + 5 * numberOfBlocks + rawLength + 4;
+
+	string header;
+	WriteBigEndian(header, this->Width);
+	WriteBigEndian(header, this->Height);
+	header += (char)8;		//bit depth
+	header += (char)2;		//color type (RGB)
+	header += (char)0;		//compression method
+	header += (char)0;		//filter method
+	header += (char)0;		//interlace method
+
+	string png;
+	png.reserve(8 + (12 + header.size()) + (12 + dataLength) + 12);
+	png.append("\x89PNG\r\n\x1a\n", 8);
+	WritePngChunk(png, "IHDR", header);
+
+	size_t dataStart = png.size();
+	WriteBigEndian(png, dataLength);
+	png += "IDAT";
+	png += (char)0x78;
+	png += (char)0x01;
+
+	//the bytes of the rows are appended piece by piece (the filter type, then the pixels); a block header is written whenever the current block is full
+	size_t remainingLength = rawLength;
+	size_t remainingInBlock = 0;
+	unsigned int adlerLow = 1, adlerHigh = 0;
+	if(rawLength == 0)
+		png.append("\x01\x00\x00\xFF\xFF", 5);
+	for(int row=0; row<this->Height; row++)
+	{
+		const char filterType = 0;
+		const char* pieces[2] = { &filterType, (const char*)this->Pixels.data() + row * rowLength };
+		size_t pieceLengths[2] = { 1, rowLength };
+		for(int piece=0; piece<2; piece++)
+		{
+			const char* bytes = pieces[piece];
+			size_t length = pieceLengths[piece];
+			while(length > 0)
+			{
+				if(remainingInBlock == 0)
+				{
+					size_t blockLength = remainingLength < (size_t)RASTER_MAXIMUM_DEFLATE_BLOCK ? remainingLength : RASTER_MAXIMUM_DEFLATE_BLOCK;
+					png += (char)(blockLength == remainingLength ? 1 : 0);
+					png += (char)(blockLength & 0xFF);
+					png += (char)(blockLength >> 8);
+					png += (char)(~blockLength & 0xFF);
+					png += (char)((~blockLength >> 8) & 0xFF);
+					remainingInBlock = blockLength;
+				}
+
+				size_t copiedLength = length < remainingInBlock ? length : remainingInBlock;
+				png.append(bytes, copiedLength);
+				for(size_t i=0; i<copiedLength; i++)
+				{
+					adlerLow = (adlerLow + (unsigned char)bytes[i]) % 65521;
+					adlerHigh = (adlerHigh + adlerLow) % 65521;
+				}
+
+				bytes += copiedLength;
+				length -= copiedLength;
+				remainingInBlock -= copiedLength;
+				remainingLength -= copiedLength;
+			}
+		}
+	}
+	WriteBigEndian(png, (adlerHigh << 16) | adlerLow);
+	WriteBigEndian(png, CalculateCrc(png.data() + dataStart + 4, dataLength + 4));
+
+	WritePngChunk(png, "IEND", string());
+
+	ofstream document;
+	try
+	{
+		document.exceptions(ofstream::badbit | ofstream::failbit);
+		document.open(filename, ios::out | ios::binary);
+		document.write(png.data(), png.size());
+		document.close();
+	}
+	catch(...)
+	{
+		if(document.is_open())
+			document.close();
+
+		throw "Error while writing file";
+	}
+}
+
+//<summary>
+//Draws the fields (obstacles in green, expanded fields in white, open fields in yellow and the rest in black),
+//the grid lines (in blue) and the shortest path (as a red line through the centers of its fields).
+//</summary>
+//<param name='numberOfRows'>The number of rows of the grid.</param>
+//<param name='numberOfColumns'>The number of columns of the grid.</param>
+//<param name='shortestPath'>The shortest path found on the grid.</param>
+void RasterExporter::DrawFields(int numberOfRows, int numberOfColumns, const vector<Coordinates2D>& shortestPath)
+{
+	//the size of the image is calculated in 64 bits, so that big maps or cells are rejected instead of overflowing
+	long long width = (long long)numberOfColumns * this->CellSize;
+	long long height = (long long)numberOfRows * this->CellSize;
+	if(this->CellSize < 1 || width > numeric_limits<int>::max() || height > numeric_limits<int>::max() ||
+		(height > 0 && (unsigned long long)width > numeric_limits<size_t>::max() / 3 / height))
+		throw "Wrong image size";
+
+	this->Width = (int)width;
+	this->Height = (int)height;
+	this->Pixels.assign(3 * (size_t)this->Width * this->Height, 0);
+
+	bool drawGrid = this->CellSize >= RASTER_MINIMUM_GRID_CELL_SIZE;
+	for(int x=0; x<numberOfRows; x++)
+	{
+		for(int y=0; y<numberOfColumns; y++)
+		{
+			unsigned char flags = this->fieldFlags[(size_t)x * numberOfColumns + y];
+			const unsigned char* color = RASTER_FREE_COLOR;
+			if(flags & FIELD_OBSTACLE)
+				color = RASTER_OBSTACLE_COLOR;
+			else if(flags & FIELD_EXPANDED)
+				color = RASTER_EXPANDED_COLOR;
+			else if(flags & FIELD_OPEN)
+				color = RASTER_OPEN_COLOR;
+
+			this->FillRectangle(x * this->CellSize, y * this->CellSize, this->CellSize, this->CellSize, color);
+			if(drawGrid)
+			{
+				this->FillRectangle(x * this->CellSize, y * this->CellSize, 1, this->CellSize, RASTER_GRID_COLOR);
+				this->FillRectangle(x * this->CellSize, y * this->CellSize, this->CellSize, 1, RASTER_GRID_COLOR);
+			}
+		}
+	}
+
+	if(drawGrid)
+	{
+		this->FillRectangle(this->Height - 1, 0, 1, this->Width, RASTER_GRID_COLOR);
+		this->FillRectangle(0, this->Width - 1, this->Height, 1, RASTER_GRID_COLOR);
+	}
+
+	//the fields of a path are adjacent, so each segment is a horizontal or vertical line between two centers
+	int lineWidth = this->CellSize / 4 > 0 ? this->CellSize / 4 : 1;
+	int centerOffset = (this->CellSize - lineWidth) / 2;
+	for(int i=0; i+1<(int)shortestPath.size(); i++)
+	{
+		Coordinates2D first = shortestPath[i];
+		Coordinates2D second = shortestPath[i+1];
+		int top = (first.X < second.X ? first.X : second.X) * this->CellSize + centerOffset;
+		int left = (first.Y < second.Y ? first.Y : second.Y) * this->CellSize + centerOffset;
+		int height = abs(first.X - second.X) * this->CellSize + lineWidth;
+		int width = abs(first.Y - second.Y) * this->CellSize + lineWidth;
+		this->FillRectangle(top, left, height, width, RASTER_PATH_COLOR);
+	}
+	if(shortestPath.size() == 1)
+		this->FillRectangle(shortestPath[0].X * this->CellSize + centerOffset, shortestPath[0].Y * this->CellSize + centerOffset, lineWidth, lineWidth, RASTER_PATH_COLOR);
+}
+
+//<summary>
+//Fills the pixels in the rectangle with upper left corner ('top', 'left') and size 'height' x 'width' with 'color'.
+//</summary>
+void RasterExporter::FillRectangle(int top, int left, int height, int width, const unsigned char* color)
+{
+	for(int row=top; row<top+height; row++)
+	{
+		unsigned char* pixel = &this->Pixels[3 * ((size_t)row * this->Width + left)];
+		for(int column=0; column<width; column++)
+		{
+			pixel[0] = color[0];
+			pixel[1] = color[1];
+			pixel[2] = color[2];
+			pixel += 3;
+		}
+	}
+}
+
+//<summary>
+//Appends 'value' to 'output' as four bytes, starting with the highest one.
+//</summary>
+void RasterExporter::WriteBigEndian(string& output, unsigned int value)
+{
+	output += (char)((value >> 24) & 0xFF);
+	output += (char)((value >> 16) & 0xFF);
+	output += (char)((value >> 8) & 0xFF);
+	output += (char)(value & 0xFF);
+}
+
+//<summary>
+//Appends a PNG chunk to 'output': the length of the data, the type, the data and the checksum of the type and the data.
+//</summary>
+void RasterExporter::WritePngChunk(string& output, const char* type, const string& data)
+{
+	WriteBigEndian(output, data.size());
+	size_t chunkStart = output.size();
+	output.append(type, 4);
+	output += data;
+	WriteBigEndian(output, CalculateCrc(output.data() + chunkStart, 4 + data.size()));
+}
+
+//<summary>
+//Calculates the CRC-32 checksum of 'data' bit by bit; the images are written rarely, so there is no need for a table.
+//</summary>
+unsigned int RasterExporter::CalculateCrc(const char* data, size_t length)
+{
+	unsigned int crc = 0xFFFFFFFF;
+	for(size_t i=0; i<length; i++)
+	{
+		crc ^= (unsigned char)data[i];
+		for(int bit=0; bit<8; bit++)
+			crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+	}
+
+	return crc ^ 0xFFFFFFFF;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,494 @@
+#ifndef REAL_TIME_SEARCH_H
+#define REAL_TIME_SEARCH_H
+
+#include "Coordinates2D.h"
+#include "SearchTrace.h"
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <functional>
+#include <limits>
+#include <cmath>
+using std::vector;
+using std::push_heap;
+using std::pop_heap;
+using std::pair;
+using std::make_pair;
+using std::greater;
+using std::numeric_limits;
+
+//<summary>
+//Class used for planning while the robot is moving, so that the control loop never waits for a full search.
+//Each tick runs an A* search from the current field that is limited to 'Lookahead' expansions, updates the
+//heuristic of the expanded fields with a Dijkstra search from the search frontier and returns the first move
+//towards the most promising frontier field (LSS-LRTA*). The learned heuristic values are kept for each
+//destination as long as the map doesn't change, so repeated trips to the same destination get better.
+//All memory is allocated by 'SetWorldMap', so a tick never allocates or frees memory: the learned values of a destination
+//are kept in an open addressing table with room for 'MaximumLearnedFields' fields, there are 'MaximumNumberOfDestinations'
+//such tables, and the least recently used destination (or a destination whose table is full) is forgotten in constant time.
+//</summary>
+class RealTimeSearch
+{
+public:
+	RealTimeSearch();
+
+	//stores the map and forgets the heuristic values learned on the previous map
+	void SetWorldMap(const vector<vector<double>>& worldMap);
+
+	//runs one bounded search from 'current' and returns the field to which the robot should move next
+	Coordinates2D NextMove(Coordinates2D current, Coordinates2D destination);
+
+	//maximum number of fields expanded in a single tick; the memory of the search is reserved for it by 'SetWorldMap'
+	int Lookahead;
+
+	//maximum number of destinations for which the learned heuristic values are kept; used by 'SetWorldMap'
+	unsigned int MaximumNumberOfDestinations;
+
+	//maximum number of fields whose heuristic is learned for a destination; used by 'SetWorldMap'
+	unsigned int MaximumLearnedFields;
+
+	//used for storing the map of the environment
+	vector<vector<double>> WorldMap;
+
+	//optional trace; if it is set, the events of the bounded searches of all ticks are recorded in it
+	SearchTrace* Trace;
+
+private:
+	typedef pair<double, int> QueueEntry;
+
+	//entry of a table of learned heuristic values; it is only valid if its generation is the current generation of its table
+	struct LearnedField
+	{
+		int Index;
+		unsigned long long Generation;
+		double Value;
+	};
+
+	//makes the table of the destination 'destinationIndex' the current table, forgetting the least recently used destination if it has no table
+	void SelectLearnedHeuristic(int destinationIndex);
+
+	//forgets all values of a table by giving it a new generation
+	void ForgetLearnedHeuristic(int table);
+
+	//returns the learned heuristic of a field or the Euclidean distance if nothing was learned yet
+	double GetHeuristic(int index, int destinationIndex);
+
+	//stores the learned heuristic of a field in the current table
+	void SetLearnedHeuristic(int index, double value);
+
+	//returns the position of a field in the current table: its entry or the empty entry where it has to be stored
+	LearnedField& FindLearnedField(int index);
+
+	//inserts an entry on the heap 'queue' and removes the entry with the lowest cost from it
+	static void Push(vector<QueueEntry>& queue, QueueEntry entry);
+	static QueueEntry Pop(vector<QueueEntry>& queue);
+
+	//returns the indices of the fields adjacent to 'index'
+	int GetAdjacent(int index, int* adjacent);
+
+	int numberOfRows;
+	int numberOfColumns;
+
+	//tables of learned heuristic values, one after the other; each has 2^tableShift entries, which is at least twice
+	//'MaximumLearnedFields', so that the probe sequences stay short
+	vector<LearnedField> learnedFields;
+	int tableShift;
+	unsigned long long numberOfGenerations;
+
+	//for each table: its current generation, its number of valid entries, its destination (-1 if it has none)
+	//and its neighbours in the list of tables ordered from the most to the least recently used
+	vector<unsigned long long> tableGenerations;
+	vector<unsigned int> tableSizes;
+	vector<int> tableDestinations;
+	vector<int> previousTables;
+	vector<int> nextTables;
+	int mostRecentlyUsedTable;
+	int leastRecentlyUsedTable;
+
+	//table of each destination, indexed by the index of the field (-1 if it has none), and the table of the current tick
+	vector<int> destinationTables;
+	int currentTable;
+
+	//state of the bounded search; only the touched entries are reset after a tick
+	vector<double> cost;
+	vector<int> parent;
+	vector<char> status;
+	vector<int> touched;
+
+	//heaps of the bounded search and of the heuristic update and the fields expanded in a tick;
+	//they are cleared at the start of each tick, so their memory is reused
+	vector<QueueEntry> open;
+	vector<QueueEntry> frontier;
+	vector<int> closed;
+};
+
+//values of 'status' for the fields of the bounded search
+const char REAL_TIME_UNSEEN = 0;
+const char REAL_TIME_OPEN = 1;
+const char REAL_TIME_CLOSED = 2;
+
+
+//<summary>
+//Default constructor; expands at most 64 fields per tick ('Lookahead' should be at least 1) and keeps
+//the learned heuristic values of at most 8192 fields for each of at most 16 destinations (about 6 MB).
+//</summary>
+RealTimeSearch::RealTimeSearch()
+{
+	this->Lookahead = 64;
+	this->MaximumNumberOfDestinations = 16;
+	this->MaximumLearnedFields = 8192;
+	this->numberOfRows = 0;
+	this->numberOfColumns = 0;
+	this->tableShift = 0;
+	this->numberOfGenerations = 0;
+	this->mostRecentlyUsedTable = -1;
+	this->leastRecentlyUsedTable = -1;
+	this->currentTable = -1;
+	this->Trace = NULL;
+}
+
+//<summary>
+//Stores 'worldMap', forgets all learned heuristic values, since they are only valid for the map they were learned on,
+//and allocates all memory used by the ticks for the current 'Lookahead', 'MaximumNumberOfDestinations' and 'MaximumLearnedFields'.
+//</summary>
+//<param name='worldMap'>A logical grid.</param>
+void RealTimeSearch::SetWorldMap(const vector<vector<double>>& worldMap)
+{
+	this->WorldMap = worldMap;
+	this->numberOfRows = worldMap.size();
+	this->numberOfColumns = worldMap[0].size();
+
+	int numberOfFields = this->numberOfRows * this->numberOfColumns;
+	this->cost.assign(numberOfFields, numeric_limits<double>::infinity());
+	this->parent.assign(numberOfFields, -1);
+	this->status.assign(numberOfFields, REAL_TIME_UNSEEN);
+	this->touched.clear();
+
+	//each expanded field adds at most 4 fields to the open heap and improves the heuristic of at most 4 fields during the update
+	this->touched.reserve(4 * this->Lookahead + 1);
+	this->open.reserve(4 * this->Lookahead + 1);
+	this->frontier.reserve(8 * this->Lookahead + 1);
+	this->closed.reserve(this->Lookahead);
+
+	if(this->MaximumNumberOfDestinations < 1)
+		this->MaximumNumberOfDestinations = 1;
+	if(this->MaximumLearnedFields < (unsigned int)this->Lookahead)
+		this->MaximumLearnedFields = this->Lookahead;
+
+	this->tableShift = 1;
+	while((1u << this->tableShift) < 2 * this->MaximumLearnedFields)
+		this->tableShift++;
+
+	LearnedField emptyField = { -1, 0, 0.0 };
+	int numberOfTables = this->MaximumNumberOfDestinations;
+	this->learnedFields.assign((size_t)numberOfTables << this->tableShift, emptyField);
+	this->numberOfGenerations = 0;
+	this->tableGenerations.assign(numberOfTables, 0);
+	this->tableSizes.assign(numberOfTables, 0);
+	this->tableDestinations.assign(numberOfTables, -1);
+	this->previousTables.resize(numberOfTables);
+	this->nextTables.resize(numberOfTables);
+	for(int i=0; i<numberOfTables; i++)
+	{
+		this->ForgetLearnedHeuristic(i);
+		this->previousTables[i] = i - 1;
+		this->nextTables[i] = i + 1 < numberOfTables ? i + 1 : -1;
+	}
+	this->mostRecentlyUsedTable = 0;
+	this->leastRecentlyUsedTable = numberOfTables - 1;
+
+	this->destinationTables.assign(numberOfFields, -1);
+	this->currentTable = -1;
+}
+
+//<summary>
+//Runs one tick of the search: a bounded A* search from 'current', the heuristic update of the expanded
+//fields and the choice of the next move. The work done is proportional to 'Lookahead', regardless of the map size.
+//</summary>
+//<param name='current'>The field on which the robot is.</param>
+//<param name='destination'>The destination field.</param>
+//<returns>The adjacent field to which the robot should move, or 'current' if it is the destination or if the destination can't be reached.</returns>
+Coordinates2D RealTimeSearch::NextMove(Coordinates2D current, Coordinates2D destination)
+{
+	if(current == destination)
+		return current;
+
+	int currentIndex = current.X * this->numberOfColumns + current.Y;
+	int destinationIndex = destination.X * this->numberOfColumns + destination.Y;
+
+	this->SelectLearnedHeuristic(destinationIndex);
+
+	//a tick learns the heuristic of at most 'Lookahead' new fields; if the table could overflow, the destination starts over
+	if(this->tableSizes[this->currentTable] + this->Lookahead > this->MaximumLearnedFields)
+		this->ForgetLearnedHeuristic(this->currentTable);
+
+	//we expand at most 'Lookahead' fields with A*; the destination is never expanded, it stays on the frontier
+	vector<QueueEntry>& open = this->open;
+	vector<int>& closed = this->closed;
+	open.clear();
+	closed.clear();
+	this->cost[currentIndex] = 0.0;
+	this->status[currentIndex] = REAL_TIME_OPEN;
+	this->touched.push_back(currentIndex);
+	Push(open, make_pair(this->GetHeuristic(currentIndex, destinationIndex), currentIndex));
+	if(this->Trace != NULL)
+		this->Trace->Push(current.X, current.Y, open.front().first);
+
+	int adjacent[4];
+	while(!open.empty() && (int)closed.size() < this->Lookahead)
+	{
+		int index = open.front().second;
+		if(this->status[index] == REAL_TIME_CLOSED)
+		{
+			Pop(open);
+			continue;
+		}
+		if(index == destinationIndex)
+			break;
+
+		Pop(open);
+		this->status[index] = REAL_TIME_CLOSED;
+		closed.push_back(index);
+		if(this->Trace != NULL)
+			this->Trace->Pop(index / this->numberOfColumns, index % this->numberOfColumns);
+
+		int numberOfAdjacent = this->GetAdjacent(index, adjacent);
+		for(int i=0; i<numberOfAdjacent; i++)
+		{
+			int neighbour = adjacent[i];
+			if(this->status[neighbour] == REAL_TIME_CLOSED)
+				continue;
+
+			double newCost = this->cost[index] + this->WorldMap[neighbour / this->numberOfColumns][neighbour % this->numberOfColumns];
+			if(newCost < this->cost[neighbour])
+			{
+				bool seen = this->status[neighbour] != REAL_TIME_UNSEEN;
+				if(!seen)
+					this->touched.push_back(neighbour);
+
+				this->cost[neighbour] = newCost;
+				this->parent[neighbour] = index;
+				this->status[neighbour] = REAL_TIME_OPEN;
+				double totalCost = newCost + this->GetHeuristic(neighbour, destinationIndex);
+				Push(open, make_pair(totalCost, neighbour));
+
+				//a field that is already open gets a new queue entry with a lower cost, which acts as a decrease-key
+				if(this->Trace != NULL)
+				{
+					if(seen)
+						this->Trace->DecreaseKey(neighbour / this->numberOfColumns, neighbour % this->numberOfColumns, totalCost);
+					else
+						this->Trace->Push(neighbour / this->numberOfColumns, neighbour % this->numberOfColumns, totalCost);
+				}
+			}
+		}
+	}
+
+	//we choose the frontier field with the lowest f(x) = g(x) + h(x); the update below only changes
+	//the heuristic of the expanded fields, so it doesn't affect this choice
+	int bestIndex = -1;
+	double bestTotalCost = numeric_limits<double>::infinity();
+	vector<QueueEntry>& frontier = this->frontier;
+	frontier.clear();
+	for(unsigned int i=0; i<this->touched.size(); i++)
+	{
+		int index = this->touched[i];
+		if(this->status[index] != REAL_TIME_OPEN)
+			continue;
+
+		double fieldHeuristic = this->GetHeuristic(index, destinationIndex);
+		Push(frontier, make_pair(fieldHeuristic, index));
+		if(this->cost[index] + fieldHeuristic < bestTotalCost)
+		{
+			bestTotalCost = this->cost[index] + fieldHeuristic;
+			bestIndex = index;
+		}
+	}
+
+	//we update the heuristic of the expanded fields with a Dijkstra search from the frontier,
+	//so that h(x) becomes the cost of reaching the frontier plus the heuristic of the frontier field
+	for(unsigned int i=0; i<closed.size(); i++)
+		this->SetLearnedHeuristic(closed[i], numeric_limits<double>::infinity());
+
+	while(!frontier.empty())
+	{
+		QueueEntry entry = Pop(frontier);
+		if(entry.first > this->GetHeuristic(entry.second, destinationIndex))
+			continue;
+
+		int numberOfAdjacent = this->GetAdjacent(entry.second, adjacent);
+		double stepCost = this->WorldMap[entry.second / this->numberOfColumns][entry.second % this->numberOfColumns];
+		for(int i=0; i<numberOfAdjacent; i++)
+		{
+			int neighbour = adjacent[i];
+			if(this->status[neighbour] == REAL_TIME_CLOSED && this->GetHeuristic(neighbour, destinationIndex) > stepCost + entry.first)
+			{
+				this->SetLearnedHeuristic(neighbour, stepCost + entry.first);
+				Push(frontier, make_pair(stepCost + entry.first, neighbour));
+			}
+		}
+	}
+
+	//we move one field along the path to the chosen frontier field
+	Coordinates2D nextMove = current;
+	if(bestIndex != -1 && bestIndex != currentIndex)
+	{
+		int index = bestIndex;
+		while(this->parent[index] != currentIndex)
+			index = this->parent[index];
+		nextMove = Coordinates2D(index / this->numberOfColumns, index % this->numberOfColumns);
+	}
+
+	//we reset the search state for the next tick
+	for(unsigned int i=0; i<this->touched.size(); i++)
+	{
+		this->cost[this->touched[i]] = numeric_limits<double>::infinity();
+		this->parent[this->touched[i]] = -1;
+		this->status[this->touched[i]] = REAL_TIME_UNSEEN;
+	}
+	this->touched.clear();
+
+	return nextMove;
+}
+
+//<summary>
+//Makes the table of the destination with index 'destinationIndex' the current table and moves it to the front of the list
+//of tables. If the destination has no table, the least recently used table is given to it and the values learned
+//for its previous destination are forgotten.
+//</summary>
+void RealTimeSearch::SelectLearnedHeuristic(int destinationIndex)
+{
+	int table = this->destinationTables[destinationIndex];
+	if(table == -1)
+	{
+		table = this->leastRecentlyUsedTable;
+		if(this->tableDestinations[table] != -1)
+			this->destinationTables[this->tableDestinations[table]] = -1;
+
+		this->ForgetLearnedHeuristic(table);
+		this->tableDestinations[table] = destinationIndex;
+		this->destinationTables[destinationIndex] = table;
+	}
+
+	if(table != this->mostRecentlyUsedTable)
+	{
+		//we unlink the table, which isn't the first one, and link it again at the front
+		this->nextTables[this->previousTables[table]] = this->nextTables[table];
+		if(this->nextTables[table] != -1)
+			this->previousTables[this->nextTables[table]] = this->previousTables[table];
+		else
+			this->leastRecentlyUsedTable = this->previousTables[table];
+
+		this->previousTables[table] = -1;
+		this->nextTables[table] = this->mostRecentlyUsedTable;
+		this->previousTables[this->mostRecentlyUsedTable] = table;
+		this->mostRecentlyUsedTable = table;
+	}
+
+	this->currentTable = table;
+}
+
+//<summary>
+//Forgets all values of the table 'table' in constant time: it gets a generation that no entry has, so all of its entries become empty.
+//</summary>
+void RealTimeSearch::ForgetLearnedHeuristic(int table)
+{
+	this->tableGenerations[table] = ++this->numberOfGenerations;
+	this->tableSizes[table] = 0;
+}
+
+//<summary>
+//Returns the learned heuristic of the field with index 'index' or, if nothing was learned for the field,
+//the Euclidean distance to the destination (as in 'AStarLibrary').
+//</summary>
+double RealTimeSearch::GetHeuristic(int index, int destinationIndex)
+{
+	LearnedField& learned = this->FindLearnedField(index);
+	if(learned.Generation == this->tableGenerations[this->currentTable])
+		return learned.Value;
+
+	double differenceX = index / this->numberOfColumns - destinationIndex / this->numberOfColumns;
+	double differenceY = index % this->numberOfColumns - destinationIndex % this->numberOfColumns;
+	return sqrt(differenceX * differenceX + differenceY * differenceY);
+}
+
+//<summary>
+//Stores 'value' as the learned heuristic of the field with index 'index' in the current table.
+//</summary>
+void RealTimeSearch::SetLearnedHeuristic(int index, double value)
+{
+	LearnedField& learned = this->FindLearnedField(index);
+	if(learned.Generation != this->tableGenerations[this->currentTable])
+	{
+		learned.Index = index;
+		learned.Generation = this->tableGenerations[this->currentTable];
+		this->tableSizes[this->currentTable]++;
+	}
+
+	learned.Value = value;
+}
+
+//<summary>
+//Finds the field with index 'index' in the current table with linear probing; the entries are never removed one by one,
+//only the whole table is forgotten, so the first empty entry ends the probe sequence.
+//</summary>
+//<returns>The entry of the field or, if the field isn't in the table, the empty entry where it has to be stored.</returns>
+RealTimeSearch::LearnedField& RealTimeSearch::FindLearnedField(int index)
+{
+	unsigned int mask = (1u << this->tableShift) - 1;
+	unsigned long long generation = this->tableGenerations[this->currentTable];
+	LearnedField* table = &this->learnedFields[(size_t)this->currentTable << this->tableShift];
+
+	//multiplicative hashing spreads the indices of neighbouring rows, which differ by the number of columns
+	unsigned int position = ((unsigned int)index * 2654435761u) >> (32 - this->tableShift);
+	while(table[position].Generation == generation && table[position].Index != index)
+		position = (position + 1) & mask;
+
+	return table[position];
+}
+
+//<summary>
+//Inserts 'entry' on the heap 'queue', in which the entry with the lowest cost is on top.
+//</summary>
+void RealTimeSearch::Push(vector<QueueEntry>& queue, QueueEntry entry)
+{
+	queue.push_back(entry);
+	push_heap(queue.begin(), queue.end(), greater<QueueEntry>());
+}
+
+//<summary>
+//Removes the entry with the lowest cost from the heap 'queue'.
+//</summary>
+//<returns>The removed entry.</returns>
+RealTimeSearch::QueueEntry RealTimeSearch::Pop(vector<QueueEntry>& queue)
+{
+	pop_heap(queue.begin(), queue.end(), greater<QueueEntry>());
+	QueueEntry entry = queue.back();
+	queue.pop_back();
+	return entry;
+}
+
+//<summary>
+//Stores the indices of the fields adjacent to the field with index 'index' in 'adjacent'.
+//Assumes that we can't make diagonal movements.
+//</summary>
+//<returns>The number of adjacent fields.</returns>
+int RealTimeSearch::GetAdjacent(int index, int* adjacent)
+{
+	int x = index / this->numberOfColumns;
+	int y = index % this->numberOfColumns;
+	int numberOfAdjacent = 0;
+
+	if(x+1 < this->numberOfRows)
+		adjacent[numberOfAdjacent++] = index + this->numberOfColumns;
+	if(x-1 >= 0)
+		adjacent[numberOfAdjacent++] = index - this->numberOfColumns;
+	if(y-1 >= 0)
+		adjacent[numberOfAdjacent++] = index - 1;
+	if(y+1 < this->numberOfColumns)
+		adjacent[numberOfAdjacent++] = index + 1;
+
+	return numberOfAdjacent;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,193 @@
+#ifndef SEARCH_REPLAY_H
+#define SEARCH_REPLAY_H
+
+#include "SearchTraceEvent.h"
+#include "SearchTraceReader.h"
+#include "AStarVisualWorldMap.h"
+#include <vector>
+using std::vector;
+
+//if no speed is set, a replay takes this many seconds
+const double REPLAY_DEFAULT_DURATION = 5.0;
+
+//<summary>
+//Class that replays a recorded search on a visual grid: pushed fields are shown as open, popped fields as expanded.
+//The replay can go event by event (e.g. for exporting frames) or follow the recorded timestamps at an adjustable speed,
+//so that the parts of a search that took long are also shown for longer. The trace doesn't store the size of the map
+//it was recorded on, so the events of fields outside the grid (e.g. of a trace recorded on a larger map) are skipped.
+//</summary>
+class SearchReplay
+{
+public:
+	SearchReplay();
+
+	//loads the events of a trace and starts the replay from the beginning
+	void Load(const unsigned char* data, size_t length);
+
+	//clears the fields of all events and starts the replay from the beginning
+	void Restart(AStarVisualWorldMap& worldMap);
+
+	//shows the next 'numberOfEvents' events; returns the number of shown events
+	unsigned int Step(AStarVisualWorldMap& worldMap, unsigned int numberOfEvents);
+
+	//shows the events recorded in the next 'seconds' seconds of the replay, multiplied by 'Speed'
+	unsigned int Advance(AStarVisualWorldMap& worldMap, double seconds);
+
+	//returns true if all events were shown
+	bool Finished() const;
+
+	//returns the number of events in the trace
+	unsigned int GetNumberOfEvents() const;
+
+	//returns the number of events that were shown
+	unsigned int GetPosition() const;
+
+	//nanoseconds of the recorded search shown per nanosecond of the replay
+	double Speed;
+
+private:
+	//shows a single event on the grid
+	void ShowEvent(AStarVisualWorldMap& worldMap, const SearchTraceEvent& event);
+
+	//checks whether the field of an event lies on the grid
+	static bool FieldOnMap(const AStarVisualWorldMap& worldMap, const SearchTraceEvent& event);
+
+	vector<SearchTraceEvent> events;
+	unsigned int position;
+
+	//the time of the recorded search up to which the events were shown
+	double currentTime;
+};
+
+
+//<summary>
+//Default constructor; creates a replay without events.
+//</summary>
+SearchReplay::SearchReplay()
+{
+	this->Speed = 1.0;
+	this->position = 0;
+	this->currentTime = 0.0;
+}
+
+//<summary>
+//Loads the events encoded in 'length' bytes starting at 'data' (as recorded by 'SearchTrace'). The speed is set so that
+//the whole replay takes 'REPLAY_DEFAULT_DURATION' seconds.
+//</summary>
+void SearchReplay::Load(const unsigned char* data, size_t length)
+{
+	this->events.clear();
+	SearchTraceReader::Decode(data, length, this->events);
+	this->position = 0;
+	this->currentTime = 0.0;
+
+	double duration = this->events.empty() ? 0.0 : (double)this->events.back().Timestamp;
+	this->Speed = duration > 0.0 ? duration / (REPLAY_DEFAULT_DURATION * 1e9) : 1.0;
+}
+
+//<summary>
+//Clears the open and expanded state of all fields that appear in the trace (e.g. the expanded fields of the search result
+//shown before the replay) and starts the replay from the beginning.
+//</summary>
+void SearchReplay::Restart(AStarVisualWorldMap& worldMap)
+{
+	for(unsigned int i=0; i<this->events.size(); i++)
+	{
+		if(!FieldOnMap(worldMap, this->events[i]))
+			continue;
+
+		worldMap.SetOpen(this->events[i].Field.X, this->events[i].Field.Y, false);
+		worldMap.SetExpanded(this->events[i].Field.X, this->events[i].Field.Y, false);
+	}
+
+	this->position = 0;
+	this->currentTime = 0.0;
+}
+
+//<summary>
+//Shows the next 'numberOfEvents' events on 'worldMap', or the remaining ones if there are fewer.
+//</summary>
+//<returns>The number of events that were shown.</returns>
+unsigned int SearchReplay::Step(AStarVisualWorldMap& worldMap, unsigned int numberOfEvents)
+{
+	unsigned int shown = 0;
+	while(shown < numberOfEvents && this->position < this->events.size())
+	{
+		this->ShowEvent(worldMap, this->events[this->position++]);
+		shown++;
+	}
+
+	if(this->position > 0)
+		this->currentTime = (double)this->events[this->position - 1].Timestamp;
+	return shown;
+}
+
+//<summary>
+//Moves the replay 'seconds' seconds forward and shows all events recorded up to the new time of the replay.
+//</summary>
+//<returns>The number of events that were shown.</returns>
+unsigned int SearchReplay::Advance(AStarVisualWorldMap& worldMap, double seconds)
+{
+	this->currentTime += seconds * 1e9 * this->Speed;
+
+	unsigned int shown = 0;
+	while(this->position < this->events.size() && (double)this->events[this->position].Timestamp <= this->currentTime)
+	{
+		this->ShowEvent(worldMap, this->events[this->position++]);
+		shown++;
+	}
+
+	return shown;
+}
+
+//<summary>
+//Returns true if all events of the trace were shown.
+//</summary>
+bool SearchReplay::Finished() const
+{
+	return this->position >= this->events.size();
+}
+
+//<summary>
+//Returns the number of events in the loaded trace.
+//</summary>
+unsigned int SearchReplay::GetNumberOfEvents() const
+{
+	return this->events.size();
+}
+
+//<summary>
+//Returns the number of events that were shown since the replay was started.
+//</summary>
+unsigned int SearchReplay::GetPosition() const
+{
+	return this->position;
+}
+
+//<summary>
+//Shows 'event' on 'worldMap': pushed fields become open and popped fields stop being open and become expanded.
+//Events of fields outside the grid are counted as shown, but don't change it.
+//</summary>
+void SearchReplay::ShowEvent(AStarVisualWorldMap& worldMap, const SearchTraceEvent& event)
+{
+	if(!FieldOnMap(worldMap, event))
+		return;
+
+	if(event.Type == TRACE_POP)
+	{
+		worldMap.SetOpen(event.Field.X, event.Field.Y, false);
+		worldMap.SetExpanded(event.Field.X, event.Field.Y, true);
+	}
+	else
+		worldMap.SetOpen(event.Field.X, event.Field.Y, true);
+}
+
+//<summary>
+//Returns true if the field of 'event' lies on the grid of 'worldMap'.
+//</summary>
+bool SearchReplay::FieldOnMap(const AStarVisualWorldMap& worldMap, const SearchTraceEvent& event)
+{
+	return event.Field.X >= 0 && event.Field.X < worldMap.NumberOfRows && event.Field.Y >= 0 && event.Field.Y < worldMap.NumberOfColumns;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,196 @@
+#ifndef SEARCH_TRACE_H
+#define SEARCH_TRACE_H
+
+#include "SearchTraceEvent.h"
+#include <vector>
+#include <fstream>
+#include <chrono>
+#include <cstring>
+using std::vector;
+using std::ofstream;
+using std::ios;
+using std::chrono::steady_clock;
+using std::chrono::duration_cast;
+using std::chrono::nanoseconds;
+
+//first four bytes of a trace file ("STRC")
+const unsigned int SEARCH_TRACE_MAGIC = 0x43525453;
+
+//the type of an event is stored in the two lowest bits of its first byte; if 'TRACE_SMALL_STEP' is set,
+//the offsets to the field of the previous event (from -1 to 1, plus one) are stored in the next two pairs of bits
+const unsigned char TRACE_TYPE_MASK = 0x03;
+const unsigned char TRACE_SMALL_STEP = 0x04;
+
+//<summary>
+//Class that records the push, pop and decrease-key events of a search in a compact binary form. Each event takes
+//a byte for its type, the offset to the previous field and the time since the previous event as variable length numbers,
+//and four bytes for the priority of pushed fields, so a typical event takes 3 to 9 bytes.
+//The searches only record events if a trace is given to them, so searches without a trace are not slowed down.
+//</summary>
+class SearchTrace
+{
+public:
+	SearchTrace();
+
+	//removes all events; the time of the next event becomes the start of the trace
+	void Clear();
+
+	//records that a field was put on the open list
+	void Push(int x, int y, double priority);
+
+	//records that a field was taken from the open list
+	void Pop(int x, int y);
+
+	//records that the cost of a field on the open list was lowered
+	void DecreaseKey(int x, int y, double priority);
+
+	//writes the trace to a file
+	void WriteToFile(const char* filename);
+
+	//the encoded events
+	vector<unsigned char> Data;
+
+	//the number of recorded events
+	unsigned int NumberOfEvents;
+
+private:
+	//encodes an event
+	void AddEvent(unsigned char type, int x, int y, double priority);
+
+	//writes a non-negative number in groups of seven bits, starting with the lowest one
+	void WriteNumber(unsigned long long number);
+
+	steady_clock::time_point startTime;
+	unsigned long long lastTimestamp;
+	int lastX;
+	int lastY;
+};
+
+
+//<summary>
+//Default constructor; creates an empty trace.
+//</summary>
+SearchTrace::SearchTrace()
+{
+	this->Clear();
+}
+
+//<summary>
+//Removes all events from the trace.
+//</summary>
+void SearchTrace::Clear()
+{
+	this->Data.clear();
+	this->NumberOfEvents = 0;
+	this->lastTimestamp = 0;
+	this->lastX = 0;
+	this->lastY = 0;
+}
+
+//<summary>
+//Records that the field with grid coordinates 'x' and 'y' was put on the open list with total cost 'priority'.
+//</summary>
+void SearchTrace::Push(int x, int y, double priority)
+{
+	this->AddEvent(TRACE_PUSH, x, y, priority);
+}
+
+//<summary>
+//Records that the field with grid coordinates 'x' and 'y' was taken from the open list to be expanded.
+//</summary>
+void SearchTrace::Pop(int x, int y)
+{
+	this->AddEvent(TRACE_POP, x, y, 0.0);
+}
+
+//<summary>
+//Records that the total cost of the field with grid coordinates 'x' and 'y' on the open list was lowered to 'priority'.
+//</summary>
+void SearchTrace::DecreaseKey(int x, int y, double priority)
+{
+	this->AddEvent(TRACE_DECREASE_KEY, x, y, priority);
+}
+
+//<summary>
+//Writes the trace to 'filename': the magic number and the number of events as four bytes each, followed by the encoded events.
+//</summary>
+void SearchTrace::WriteToFile(const char* filename)
+{
+	ofstream document;
+	try
+	{
+		document.exceptions(ofstream::badbit | ofstream::failbit);
+		document.open(filename, ios::out | ios::binary);
+
+		unsigned char header[8];
+		for(int i=0; i<4; i++)
+		{
+			header[i] = (SEARCH_TRACE_MAGIC >> (8 * i)) & 0xFF;
+			header[4 + i] = (this->NumberOfEvents >> (8 * i)) & 0xFF;
+		}
+		document.write((const char*)header, 8);
+		if(!this->Data.empty())
+			document.write((const char*)&this->Data[0], this->Data.size());
+		document.close();
+	}
+	catch(...)
+	{
+		if(document.is_open())
+			document.close();
+
+		throw "Error while writing file";
+	}
+}
+
+//<summary>
+//Appends an event to the encoded events. The first event of a trace starts the clock of the trace.
+//</summary>
+void SearchTrace::AddEvent(unsigned char type, int x, int y, double priority)
+{
+	steady_clock::time_point now = steady_clock::now();
+	if(this->NumberOfEvents == 0)
+		this->startTime = now;
+	unsigned long long timestamp = duration_cast<nanoseconds>(now - this->startTime).count();
+
+	int xOffset = x - this->lastX;
+	int yOffset = y - this->lastY;
+	if(this->NumberOfEvents > 0 && xOffset >= -1 && xOffset <= 1 && yOffset >= -1 && yOffset <= 1)
+		this->Data.push_back(type | TRACE_SMALL_STEP | ((xOffset + 1) << 3) | ((yOffset + 1) << 5));
+	else
+	{
+		//the offsets are stored with the sign in the lowest bit, so that small negative offsets stay short
+		this->Data.push_back(type);
+		this->WriteNumber(xOffset < 0 ? ((unsigned long long)(-(long long)xOffset) << 1) - 1 : (unsigned long long)xOffset << 1);
+		this->WriteNumber(yOffset < 0 ? ((unsigned long long)(-(long long)yOffset) << 1) - 1 : (unsigned long long)yOffset << 1);
+	}
+
+	this->WriteNumber(timestamp - this->lastTimestamp);
+
+	if(type != TRACE_POP)
+	{
+		float value = (float)priority;
+		unsigned char bytes[4];
+		memcpy(bytes, &value, 4);
+		this->Data.insert(this->Data.end(), bytes, bytes + 4);
+	}
+
+	this->lastTimestamp = timestamp;
+	this->lastX = x;
+	this->lastY = y;
+	this->NumberOfEvents++;
+}
+
+//<summary>
+//Writes 'number' in groups of seven bits, starting with the lowest one; the highest bit of each byte is set if more bytes follow.
+//</summary>
+void SearchTrace::WriteNumber(unsigned long long number)
+{
+	while(number >= 0x80)
+	{
+		this->Data.push_back((unsigned char)(number | 0x80));
+		number >>= 7;
+	}
+	this->Data.push_back((unsigned char)number);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,30 @@
+#ifndef SEARCH_TRACE_EVENT_H
+#define SEARCH_TRACE_EVENT_H
+
+#include "Coordinates2D.h"
+
+//types of the events recorded in a search trace
+const unsigned char TRACE_PUSH = 0;
+const unsigned char TRACE_POP = 1;
+const unsigned char TRACE_DECREASE_KEY = 2;
+
+//<summary>
+//Stores a single event of a search: a field that was put on the open list, taken from it (expanded)
+//or whose cost on the open list was lowered.
+//</summary>
+struct SearchTraceEvent
+{
+	//one of 'TRACE_PUSH', 'TRACE_POP' and 'TRACE_DECREASE_KEY'
+	unsigned char Type;
+
+	//the field of the event
+	Coordinates2D Field;
+
+	//the total cost (f value) of the field on the open list; not used for pops
+	float Priority;
+
+	//time of the event in nanoseconds since the first event of the trace
+	unsigned long long Timestamp;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,194 @@
+#ifndef SEARCH_TRACE_READER_H
+#define SEARCH_TRACE_READER_H
+
+#include "SearchTraceEvent.h"
+#include "SearchTrace.h"
+#include <vector>
+#include <fstream>
+#include <cstddef>
+#include <cstring>
+using std::vector;
+using std::ifstream;
+using std::ios;
+
+//<summary>
+//Class that reads the events of a trace recorded by 'SearchTrace' one at a time, directly from the encoded bytes.
+//</summary>
+class SearchTraceReader
+{
+public:
+	SearchTraceReader(const unsigned char* data, size_t length);
+
+	//reads the next event; returns false after the last event
+	bool Next(SearchTraceEvent& event);
+
+	//reads the encoded events of a trace file written by 'SearchTrace::WriteToFile'
+	static vector<unsigned char> ReadFromFile(const char* filename);
+
+	//decodes all events of a trace
+	static void Decode(const unsigned char* data, size_t length, vector<SearchTraceEvent>& events);
+
+private:
+	//reads a single byte
+	unsigned char ReadByte();
+
+	//reads a number written by 'SearchTrace::WriteNumber'
+	unsigned long long ReadNumber();
+
+	//reads an offset written with the sign in the lowest bit
+	int ReadOffset();
+
+	const unsigned char* data;
+	size_t length;
+	size_t position;
+
+	SearchTraceEvent lastEvent;
+};
+
+
+//<summary>
+//Constructor; prepares reading the events encoded in 'length' bytes starting at 'data'. The bytes are not copied.
+//</summary>
+SearchTraceReader::SearchTraceReader(const unsigned char* data, size_t length)
+{
+	this->data = data;
+	this->length = length;
+	this->position = 0;
+	this->lastEvent.Field = Coordinates2D(0, 0);
+	this->lastEvent.Timestamp = 0;
+}
+
+//<summary>
+//Stores the next event of the trace in 'event'.
+//</summary>
+//<returns>False if all events were already read.</returns>
+bool SearchTraceReader::Next(SearchTraceEvent& event)
+{
+	if(this->position >= this->length)
+		return false;
+
+	unsigned char first = this->ReadByte();
+	event.Type = first & TRACE_TYPE_MASK;
+	if(event.Type != TRACE_PUSH && event.Type != TRACE_POP && event.Type != TRACE_DECREASE_KEY)
+		throw "Wrong format";
+
+	event.Field = this->lastEvent.Field;
+	if(first & TRACE_SMALL_STEP)
+	{
+		event.Field.X += ((first >> 3) & 0x03) - 1;
+		event.Field.Y += ((first >> 5) & 0x03) - 1;
+	}
+	else
+	{
+		event.Field.X += this->ReadOffset();
+		event.Field.Y += this->ReadOffset();
+	}
+
+	event.Timestamp = this->lastEvent.Timestamp + this->ReadNumber();
+
+	event.Priority = 0.0f;
+	if(event.Type != TRACE_POP)
+	{
+		if(this->length - this->position < 4)
+			throw "Wrong format";
+		memcpy(&event.Priority, this->data + this->position, 4);
+		this->position += 4;
+	}
+
+	this->lastEvent = event;
+	return true;
+}
+
+//<summary>
+//Reads the trace file 'filename' and returns its encoded events.
+//</summary>
+vector<unsigned char> SearchTraceReader::ReadFromFile(const char* filename)
+{
+	vector<unsigned char> data;
+	ifstream document;
+	try
+	{
+		document.exceptions(ifstream::badbit | ifstream::failbit);
+		document.open(filename, ios::in | ios::binary);
+		document.seekg(0, ios::end);
+		size_t fileLength = (size_t)document.tellg();
+		document.seekg(0, ios::beg);
+		if(fileLength < 8)
+			throw "Wrong format";
+
+		unsigned char header[8];
+		document.read((char*)header, 8);
+		unsigned int magic = header[0] | (header[1] << 8) | (header[2] << 16) | ((unsigned int)header[3] << 24);
+		if(magic != SEARCH_TRACE_MAGIC)
+			throw "Wrong format";
+
+		data.resize(fileLength - 8);
+		if(!data.empty())
+			document.read((char*)&data[0], data.size());
+		document.close();
+	}
+	catch(const char*)
+	{
+		document.close();
+		throw;
+	}
+	catch(...)
+	{
+		if(document.is_open())
+			document.close();
+
+		throw "Error while reading file";
+	}
+
+	return data;
+}
+
+//<summary>
+//Decodes all events encoded in 'length' bytes starting at 'data' and appends them to 'events'.
+//</summary>
+void SearchTraceReader::Decode(const unsigned char* data, size_t length, vector<SearchTraceEvent>& events)
+{
+	SearchTraceReader reader(data, length);
+	SearchTraceEvent event;
+	while(reader.Next(event))
+		events.push_back(event);
+}
+
+//<summary>
+//Reads a single byte; throws an exception if the data ends too early.
+//</summary>
+unsigned char SearchTraceReader::ReadByte()
+{
+	if(this->position >= this->length)
+		throw "Wrong format";
+
+	return this->data[this->position++];
+}
+
+//<summary>
+//Reads a number stored in groups of seven bits, starting with the lowest one.
+//</summary>
+unsigned long long SearchTraceReader::ReadNumber()
+{
+	unsigned long long number = 0;
+	for(int shift=0; shift<64; shift+=7)
+	{
+		unsigned char byte = this->ReadByte();
+		number |= (unsigned long long)(byte & 0x7F) << shift;
+		if(!(byte & 0x80))
+			return number;
+	}
+
+	throw "Wrong format";
+}
+
+//<summary>
+//Reads an offset stored with its sign in the lowest bit.
+//</summary>
+int SearchTraceReader::ReadOffset()
+{
+	unsigned long long number = this->ReadNumber();
+	return (number & 1) ? -(int)((number + 1) >> 1) : (int)(number >> 1);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,306 @@
+#ifndef TILED_WORLD_MAP_H
+#define TILED_WORLD_MAP_H
+
+#include "TiledWorldMapWriter.h"
+#include <vector>
+#include <fstream>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+using std::vector;
+using std::ifstream;
+using std::ios;
+
+//<summary>
+//Class used for grids that are too large to be kept in memory. The grid is stored in a binary file as square tiles
+//and the tiles are mapped into memory only when a field on them is read. At most 'maximumResidentTiles' tiles
+//are mapped at the same time; when another tile is needed, the least recently used one is unmapped.
+//Reading a field on the same tile as the previous read only costs a comparison, which is the common case
+//in A*, since the expanded fields are close to each other. The class is not thread-safe.
+//</summary>
+class TiledWorldMap
+{
+public:
+	TiledWorldMap();
+	~TiledWorldMap();
+
+	//writes a grid that is in memory to a tiled map file; larger grids can be written row by row with 'TiledWorldMapWriter'
+	static void WriteToFile(const vector<vector<double>>& worldMap, const char* filename);
+
+	//opens a tiled map file, keeping at most 'maximumResidentTiles' tiles in memory
+	void Open(const char* filename, int maximumResidentTiles);
+
+	//unmaps all tiles and closes the file
+	void Close();
+
+	//returns the cost of the field with grid coordinates 'x' and 'y'
+	double GetCost(int x, int y);
+
+	int NumberOfRows;
+	int NumberOfColumns;
+
+	//number of times a tile was mapped into memory
+	unsigned long long NumberOfTileLoads;
+
+private:
+	//returns the fields of the tile 'tile', mapping it if it is not resident
+	const double* LoadTile(int tile);
+
+	//maps the tile 'tile' into memory
+	const double* MapTile(int tile);
+
+	//unmaps a tile returned by 'MapTile'
+	void UnmapTile(const double* tileData);
+
+	int numberOfTileColumns;
+
+	//slot in which each tile is resident or -1 if the tile is not resident
+	vector<int> tileSlots;
+
+	//tile, fields and time of the last use of each slot
+	vector<int> slotTiles;
+	vector<const double*> slotData;
+	vector<unsigned long long> slotLastUse;
+	unsigned long long useCounter;
+
+	//the tile read last, so that reads on the same tile skip the lookup
+	int lastTile;
+	const double* lastTileData;
+
+#ifdef _WIN32
+	HANDLE file;
+	HANDLE mapping;
+#else
+	int file;
+#endif
+};
+
+
+//<summary>
+//Default constructor; creates a map without a file.
+//</summary>
+TiledWorldMap::TiledWorldMap()
+{
+	this->NumberOfRows = 0;
+	this->NumberOfColumns = 0;
+	this->NumberOfTileLoads = 0;
+	this->numberOfTileColumns = 0;
+	this->useCounter = 0;
+	this->lastTile = -1;
+	this->lastTileData = NULL;
+#ifdef _WIN32
+	this->file = INVALID_HANDLE_VALUE;
+	this->mapping = NULL;
+#else
+	this->file = -1;
+#endif
+}
+
+//<summary>
+//Destructor; unmaps all tiles and closes the file.
+//</summary>
+TiledWorldMap::~TiledWorldMap()
+{
+	this->Close();
+}
+
+//<summary>
+//Writes 'worldMap' to the file 'filename' as a header followed by the tiles, row by row.
+//Each tile stores its fields row by row; the fields of the tiles on the lower and right edge that lie outside the grid are zeros.
+//</summary>
+//<param name='worldMap'>A logical grid.</param>
+//<param name='filename'>Name of the created file.</param>
+void TiledWorldMap::WriteToFile(const vector<vector<double>>& worldMap, const char* filename)
+{
+	TiledWorldMapWriter writer;
+	writer.Open(filename, worldMap.size(), worldMap[0].size());
+	for(unsigned int x=0; x<worldMap.size(); x++)
+		writer.WriteRow(worldMap[x]);
+	writer.Close();
+}
+
+//<summary>
+//Opens the tiled map file 'filename'. No tile is mapped until one of its fields is read.
+//The length of the file has to match the size of the grid in the header, so that every tile can be mapped.
+//</summary>
+//<param name='filename'>Name of a file created by 'WriteToFile' or 'TiledWorldMapWriter'.</param>
+//<param name='maximumResidentTiles'>The maximum number of tiles kept in memory; at least 1.</param>
+void TiledWorldMap::Open(const char* filename, int maximumResidentTiles)
+{
+	this->Close();
+
+	//we read the header with a stream and use the file only for mapping the tiles
+	ifstream document;
+	unsigned int magic;
+	int dimensions[3];
+	long long fileLength;
+	try
+	{
+		document.exceptions(ifstream::badbit | ifstream::failbit);
+		document.open(filename, ios::in | ios::binary);
+		document.read((char*)&magic, sizeof(magic));
+		document.read((char*)dimensions, sizeof(dimensions));
+		document.seekg(0, ios::end);
+		fileLength = document.tellg();
+		document.close();
+	}
+	catch(...)
+	{
+		if(document.is_open())
+			document.close();
+
+		throw "Error while reading file";
+	}
+
+	if(magic != TILED_MAP_MAGIC || dimensions[2] != TILED_MAP_TILE_SHIFT || dimensions[0] < 1 || dimensions[1] < 1 || maximumResidentTiles < 1)
+		throw "Wrong format";
+
+	long long numberOfTiles = (long long)((dimensions[0] + TILED_MAP_TILE_MASK) >> TILED_MAP_TILE_SHIFT) * ((dimensions[1] + TILED_MAP_TILE_MASK) >> TILED_MAP_TILE_SHIFT);
+	if(fileLength != TILED_MAP_HEADER_BYTES + numberOfTiles * TILED_MAP_TILE_BYTES)
+		throw "Wrong format";
+
+#ifdef _WIN32
+	this->file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(this->file != INVALID_HANDLE_VALUE)
+		this->mapping = CreateFileMappingA(this->file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if(this->mapping == NULL)
+	{
+		this->Close();
+		throw "Error while reading file";
+	}
+#else
+	this->file = open(filename, O_RDONLY);
+	if(this->file < 0)
+		throw "Error while reading file";
+#endif
+
+	this->NumberOfRows = dimensions[0];
+	this->NumberOfColumns = dimensions[1];
+	this->NumberOfTileLoads = 0;
+
+	int numberOfTileRows = (this->NumberOfRows + TILED_MAP_TILE_MASK) >> TILED_MAP_TILE_SHIFT;
+	this->numberOfTileColumns = (this->NumberOfColumns + TILED_MAP_TILE_MASK) >> TILED_MAP_TILE_SHIFT;
+	this->tileSlots.assign(numberOfTileRows * this->numberOfTileColumns, -1);
+
+	this->slotTiles.assign(maximumResidentTiles, -1);
+	this->slotData.assign(maximumResidentTiles, NULL);
+	this->slotLastUse.assign(maximumResidentTiles, 0);
+	this->useCounter = 0;
+	this->lastTile = -1;
+	this->lastTileData = NULL;
+}
+
+//<summary>
+//Unmaps all resident tiles and closes the file.
+//</summary>
+void TiledWorldMap::Close()
+{
+	for(unsigned int slot=0; slot<this->slotData.size(); slot++)
+		if(this->slotData[slot] != NULL)
+			this->UnmapTile(this->slotData[slot]);
+
+	this->tileSlots.clear();
+	this->slotTiles.clear();
+	this->slotData.clear();
+	this->slotLastUse.clear();
+	this->lastTile = -1;
+	this->lastTileData = NULL;
+
+#ifdef _WIN32
+	if(this->mapping != NULL)
+		CloseHandle(this->mapping);
+	if(this->file != INVALID_HANDLE_VALUE)
+		CloseHandle(this->file);
+	this->mapping = NULL;
+	this->file = INVALID_HANDLE_VALUE;
+#else
+	if(this->file >= 0)
+		close(this->file);
+	this->file = -1;
+#endif
+}
+
+//<summary>
+//Returns the cost of the field with grid coordinates 'x' and 'y'; the coordinates are not checked.
+//</summary>
+double TiledWorldMap::GetCost(int x, int y)
+{
+	int tile = (x >> TILED_MAP_TILE_SHIFT) * this->numberOfTileColumns + (y >> TILED_MAP_TILE_SHIFT);
+	if(tile != this->lastTile)
+	{
+		this->lastTileData = this->LoadTile(tile);
+		this->lastTile = tile;
+	}
+
+	return this->lastTileData[((x & TILED_MAP_TILE_MASK) << TILED_MAP_TILE_SHIFT) + (y & TILED_MAP_TILE_MASK)];
+}
+
+//<summary>
+//Returns the fields of the tile 'tile'. If the tile is not resident, it is mapped into a free slot
+//or, if there is no free slot, into the slot of the least recently used tile.
+//</summary>
+const double* TiledWorldMap::LoadTile(int tile)
+{
+	int slot = this->tileSlots[tile];
+	if(slot == -1)
+	{
+		//there are few slots and mapping a tile is much slower than going through them, so we don't keep them ordered
+		slot = 0;
+		for(unsigned int i=1; i<this->slotLastUse.size(); i++)
+			if(this->slotLastUse[i] < this->slotLastUse[slot])
+				slot = i;
+
+		if(this->slotData[slot] != NULL)
+		{
+			this->UnmapTile(this->slotData[slot]);
+			this->tileSlots[this->slotTiles[slot]] = -1;
+		}
+
+		this->slotData[slot] = this->MapTile(tile);
+		this->slotTiles[slot] = tile;
+		this->tileSlots[tile] = slot;
+		this->NumberOfTileLoads++;
+	}
+
+	this->slotLastUse[slot] = ++this->useCounter;
+	return this->slotData[slot];
+}
+
+//<summary>
+//Maps the tile 'tile' of the file into memory as read-only.
+//</summary>
+const double* TiledWorldMap::MapTile(int tile)
+{
+	long long offset = TILED_MAP_HEADER_BYTES + tile * TILED_MAP_TILE_BYTES;
+
+#ifdef _WIN32
+	void* tileData = MapViewOfFile(this->mapping, FILE_MAP_READ, (DWORD)(offset >> 32), (DWORD)(offset & 0xFFFFFFFF), (SIZE_T)TILED_MAP_TILE_BYTES);
+	if(tileData == NULL)
+		throw "Error while reading file";
+#else
+	void* tileData = mmap(NULL, TILED_MAP_TILE_BYTES, PROT_READ, MAP_SHARED, this->file, offset);
+	if(tileData == MAP_FAILED)
+		throw "Error while reading file";
+#endif
+
+	return (const double*)tileData;
+}
+
+//<summary>
+//Unmaps a tile that was mapped by 'MapTile'.
+//</summary>
+void TiledWorldMap::UnmapTile(const double* tileData)
+{
+#ifdef _WIN32
+	UnmapViewOfFile(tileData);
+#else
+	munmap((void*)tileData, TILED_MAP_TILE_BYTES);
+#endif
+}
+
+#endif
\ No newline at end of file
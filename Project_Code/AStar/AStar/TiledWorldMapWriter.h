@@ -0,0 +1,197 @@
+#ifndef TILED_WORLD_MAP_WRITER_H
+#define TILED_WORLD_MAP_WRITER_H
+
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+using std::vector;
+using std::fill;
+using std::ofstream;
+using std::ios;
+
+//the side of a tile in a tiled map file is 2^TILED_MAP_TILE_SHIFT fields; a tile takes 128 KB, which is a multiple
+//of both the page size and the allocation granularity on Windows, so each tile can be mapped on its own
+const int TILED_MAP_TILE_SHIFT = 7;
+const int TILED_MAP_TILE_SIZE = 1 << TILED_MAP_TILE_SHIFT;
+const int TILED_MAP_TILE_MASK = TILED_MAP_TILE_SIZE - 1;
+const long long TILED_MAP_TILE_BYTES = (long long)TILED_MAP_TILE_SIZE * TILED_MAP_TILE_SIZE * sizeof(double);
+
+//the tiles start after a header of this size, so that their offsets stay aligned
+const long long TILED_MAP_HEADER_BYTES = 65536;
+
+//identifies tiled map files ("TMP1")
+const unsigned int TILED_MAP_MAGIC = 0x31504D54;
+
+//<summary>
+//Class used for creating tiled map files without having the whole grid in memory. The rows of the grid are written
+//one at a time; the writer keeps only the rows of the current band of tiles (TILED_MAP_TILE_SIZE rows) and writes
+//the tiles of the band once it is full, so the file is written sequentially and the memory used doesn't depend on the number of rows.
+//</summary>
+class TiledWorldMapWriter
+{
+public:
+	TiledWorldMapWriter();
+	~TiledWorldMapWriter();
+
+	//creates the file 'filename' for a grid with the given size and writes its header
+	void Open(const char* filename, int numberOfRows, int numberOfColumns);
+
+	//writes the next row of the grid
+	void WriteRow(const vector<double>& row);
+
+	//writes the last band of tiles and closes the file; all rows have to be written before
+	void Close();
+
+private:
+	//writes the tiles of the current band and empties it
+	void WriteBand();
+
+	ofstream document;
+	int numberOfRows;
+	int numberOfColumns;
+	int numberOfTileColumns;
+	int numberOfWrittenRows;
+
+	//rows of the current band of tiles, each padded with zeros to a whole number of tiles
+	vector<double> band;
+	int numberOfBandRows;
+};
+
+
+//<summary>
+//Default constructor; creates a writer without a file.
+//</summary>
+TiledWorldMapWriter::TiledWorldMapWriter()
+{
+	this->numberOfRows = 0;
+	this->numberOfColumns = 0;
+	this->numberOfTileColumns = 0;
+	this->numberOfWrittenRows = 0;
+	this->numberOfBandRows = 0;
+}
+
+//<summary>
+//Destructor; closes the file without writing the rest of it, so a file that wasn't finished with 'Close' is rejected by 'TiledWorldMap::Open'.
+//</summary>
+TiledWorldMapWriter::~TiledWorldMapWriter()
+{
+	this->document.exceptions(ofstream::goodbit);
+	if(this->document.is_open())
+		this->document.close();
+}
+
+//<summary>
+//Creates the file 'filename' and writes the header for a grid with 'numberOfRows' rows and 'numberOfColumns' columns.
+//</summary>
+//<param name='filename'>Name of the created file.</param>
+//<param name='numberOfRows'>The number of rows of the grid; at least 1.</param>
+//<param name='numberOfColumns'>The number of columns of the grid; at least 1.</param>
+void TiledWorldMapWriter::Open(const char* filename, int numberOfRows, int numberOfColumns)
+{
+	if(this->document.is_open())
+		this->document.close();
+
+	if(numberOfRows < 1 || numberOfColumns < 1)
+		throw "Wrong map size";
+
+	this->numberOfRows = numberOfRows;
+	this->numberOfColumns = numberOfColumns;
+	this->numberOfTileColumns = (numberOfColumns + TILED_MAP_TILE_MASK) >> TILED_MAP_TILE_SHIFT;
+	this->numberOfWrittenRows = 0;
+	this->band.assign((size_t)TILED_MAP_TILE_SIZE * (this->numberOfTileColumns << TILED_MAP_TILE_SHIFT), 0.0);
+	this->numberOfBandRows = 0;
+
+	try
+	{
+		this->document.exceptions(ofstream::badbit | ofstream::failbit);
+		this->document.open(filename, ios::out | ios::binary);
+
+		vector<char> header(TILED_MAP_HEADER_BYTES, 0);
+		int dimensions[3] = { numberOfRows, numberOfColumns, TILED_MAP_TILE_SHIFT };
+		memcpy(&header[0], &TILED_MAP_MAGIC, sizeof(TILED_MAP_MAGIC));
+		memcpy(&header[sizeof(TILED_MAP_MAGIC)], dimensions, sizeof(dimensions));
+		this->document.write(&header[0], header.size());
+	}
+	catch(...)
+	{
+		if(this->document.is_open())
+			this->document.close();
+
+		throw "Error while writing file";
+	}
+}
+
+//<summary>
+//Writes the next row of the grid; the tiles are written to the file once all rows of their band are known.
+//</summary>
+//<param name='row'>The costs of the fields of the row; it has to have as many fields as the grid has columns.</param>
+void TiledWorldMapWriter::WriteRow(const vector<double>& row)
+{
+	if(!this->document.is_open() || this->numberOfWrittenRows >= this->numberOfRows || (int)row.size() != this->numberOfColumns)
+		throw "Wrong map size";
+
+	//the rows are kept in the band with a stride of a whole number of tiles, so the padding of the last tile column stays zero
+	memcpy(&this->band[(size_t)this->numberOfBandRows * (this->numberOfTileColumns << TILED_MAP_TILE_SHIFT)], &row[0], row.size() * sizeof(double));
+	this->numberOfBandRows++;
+	this->numberOfWrittenRows++;
+
+	if(this->numberOfBandRows == TILED_MAP_TILE_SIZE)
+		this->WriteBand();
+}
+
+//<summary>
+//Writes the last (possibly incomplete) band of tiles and closes the file; the rows of that band that lie outside the grid are zeros.
+//</summary>
+void TiledWorldMapWriter::Close()
+{
+	if(!this->document.is_open())
+		return;
+
+	if(this->numberOfWrittenRows != this->numberOfRows)
+	{
+		this->document.close();
+		throw "Wrong map size";
+	}
+
+	if(this->numberOfBandRows > 0)
+		this->WriteBand();
+
+	try
+	{
+		this->document.close();
+	}
+	catch(...)
+	{
+		throw "Error while writing file";
+	}
+}
+
+//<summary>
+//Writes the tiles of the current band from left to right, each of them row by row, and fills the band with zeros.
+//</summary>
+void TiledWorldMapWriter::WriteBand()
+{
+	int bandStride = this->numberOfTileColumns << TILED_MAP_TILE_SHIFT;
+	vector<double> tile(TILED_MAP_TILE_SIZE * TILED_MAP_TILE_SIZE);
+
+	try
+	{
+		for(int tileColumn=0; tileColumn<this->numberOfTileColumns; tileColumn++)
+		{
+			for(int i=0; i<TILED_MAP_TILE_SIZE; i++)
+				memcpy(&tile[i << TILED_MAP_TILE_SHIFT], &this->band[(size_t)i * bandStride + (tileColumn << TILED_MAP_TILE_SHIFT)], TILED_MAP_TILE_SIZE * sizeof(double));
+			this->document.write((const char*)&tile[0], TILED_MAP_TILE_BYTES);
+		}
+	}
+	catch(...)
+	{
+		this->document.close();
+		throw "Error while writing file";
+	}
+
+	fill(this->band.begin(), this->band.end(), 0.0);
+	this->numberOfBandRows = 0;
+}
+
+#endif
\ No newline at end of file
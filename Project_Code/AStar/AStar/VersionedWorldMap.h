@@ -0,0 +1,128 @@
+#ifndef VERSIONED_WORLD_MAP_H
+#define VERSIONED_WORLD_MAP_H
+
+#include "WorldMapSnapshot.h"
+#include "MapCellUpdate.h"
+#include "MapCellChange.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+using std::vector;
+using std::shared_ptr;
+using std::mutex;
+using std::lock_guard;
+
+//<summary>
+//Class that stores a grid which can be changed while other threads search paths on it (read-copy-update).
+//Readers take the current snapshot and keep using it for as long as they need; an update builds a new snapshot
+//next to the current one, copying only the tiles that contain updated fields, and then publishes it in a single step.
+//Readers therefore never wait for an update and never see a partially applied batch of updates.
+//</summary>
+class VersionedWorldMap
+{
+public:
+	VersionedWorldMap();
+
+	//replaces the whole grid
+	void Load(const vector<vector<double>>& worldMap, unsigned int version);
+
+	//returns the current version of the grid
+	shared_ptr<const WorldMapSnapshot> GetSnapshot();
+
+	//applies a batch of updates and publishes the result as version 'newVersion'
+	vector<MapCellChange> ApplyUpdates(const vector<MapCellUpdate>& updates, unsigned int newVersion);
+
+private:
+	//the published snapshot; the lock only protects the pointer, never the building of a snapshot
+	shared_ptr<const WorldMapSnapshot> current;
+	mutex currentMutex;
+
+	//makes sure that only one update is applied at a time
+	mutex updateMutex;
+};
+
+
+//<summary>
+//Default constructor; creates an empty grid with version 0.
+//</summary>
+VersionedWorldMap::VersionedWorldMap()
+{
+	this->current = shared_ptr<const WorldMapSnapshot>(new WorldMapSnapshot());
+}
+
+//<summary>
+//Replaces the whole grid with 'worldMap', which becomes the version 'version'.
+//</summary>
+//<param name='worldMap'>A logical grid.</param>
+//<param name='version'>The version of the grid.</param>
+void VersionedWorldMap::Load(const vector<vector<double>>& worldMap, unsigned int version)
+{
+	shared_ptr<const WorldMapSnapshot> snapshot(new WorldMapSnapshot(worldMap, version));
+
+	lock_guard<mutex> updateLock(this->updateMutex);
+	lock_guard<mutex> lock(this->currentMutex);
+	this->current = snapshot;
+}
+
+//<summary>
+//Returns the current snapshot of the grid. The snapshot stays valid (and unchanged) as long as the returned pointer is kept.
+//</summary>
+shared_ptr<const WorldMapSnapshot> VersionedWorldMap::GetSnapshot()
+{
+	lock_guard<mutex> lock(this->currentMutex);
+	return this->current;
+}
+
+//<summary>
+//Applies all updates in 'updates' to a copy of the current snapshot and publishes the copy as version 'newVersion'.
+//Only the tiles that contain updated fields are copied; the rest are shared with the previous snapshot.
+//Either all updates are applied or, if a field is outside of the grid, none of them.
+//</summary>
+//<param name='updates'>The fields to update together with their new costs.</param>
+//<param name='newVersion'>The version of the updated grid; should be larger than the current version.</param>
+//<returns>The fields whose cost changed, with their old and new costs.</returns>
+vector<MapCellChange> VersionedWorldMap::ApplyUpdates(const vector<MapCellUpdate>& updates, unsigned int newVersion)
+{
+	lock_guard<mutex> updateLock(this->updateMutex);
+
+	shared_ptr<const WorldMapSnapshot> previous = this->GetSnapshot();
+	for(unsigned int i=0; i<updates.size(); i++)
+		if(updates[i].Field.X < 0 || updates[i].Field.X >= previous->NumberOfRows || updates[i].Field.Y < 0 || updates[i].Field.Y >= previous->NumberOfColumns)
+			throw "Field out of bounds";
+
+	//the new snapshot starts with the tiles of the previous one; a tile is copied the first time one of its fields is updated
+	shared_ptr<WorldMapSnapshot> snapshot(new WorldMapSnapshot(*previous));
+	snapshot->Version = newVersion;
+	vector<bool> tileCopied(snapshot->tiles.size(), false);
+
+	vector<MapCellChange> changes;
+	for(unsigned int i=0; i<updates.size(); i++)
+	{
+		int x = updates[i].Field.X;
+		int y = updates[i].Field.Y;
+		int tile = (x >> MAP_TILE_SHIFT) * snapshot->numberOfTileColumns + (y >> MAP_TILE_SHIFT);
+		double oldCost = snapshot->GetCost(x, y);
+		if(oldCost == updates[i].Cost)
+			continue;
+
+		if(!tileCopied[tile])
+		{
+			snapshot->tiles[tile] = shared_ptr<vector<double>>(new vector<double>(*snapshot->tiles[tile]));
+			tileCopied[tile] = true;
+		}
+
+		MapCellChange change;
+		change.Field = updates[i].Field;
+		change.OldCost = oldCost;
+		change.NewCost = updates[i].Cost;
+		changes.push_back(change);
+
+		(*snapshot->tiles[tile])[((x & MAP_TILE_MASK) << MAP_TILE_SHIFT) + (y & MAP_TILE_MASK)] = updates[i].Cost;
+	}
+
+	lock_guard<mutex> lock(this->currentMutex);
+	this->current = snapshot;
+	return changes;
+}
+
+#endif
\ No newline at end of file
@@ -2,81 +2,208 @@
 #define VISUAL_WORLD_MAP_H
 
 #include "Coordinates2D.h"
-#include "VisualNodeInfo.h"
+#include "VisualCoordinates.h"
 #include "DrawingConstants.h"
 #include <vector>
+#include <cmath>
 using std::vector;
 
+//flags describing the state of a visual field
+const unsigned char FIELD_OBSTACLE = 1;
+const unsigned char FIELD_EXPANDED = 2;
+const unsigned char FIELD_OPEN = 8;
+
+//set while a field is in the list of changed fields, so that it is added only once
+const unsigned char FIELD_CHANGED = 4;
+
 //<summary>
-//Class that stores a visual grid.
+//Class that stores a visual grid. Each field is stored as a single byte of flags; the position of a field in the window
+//is calculated from its row and column, since all fields have the same size. The grid keeps track of the fields
+//that changed since the last time it was drawn, so that only those need to be drawn again.
 //</summary>
 class VisualWorldMap
 {
 public:
+	VisualWorldMap();
+
 	//sets the fields of the grid
-	void SetVisualMap(vector<vector<double>> worldMap);
-	
-	//stores the grid
-	vector<vector<VisualNodeInfo>> Vertices;
+	void SetVisualMap(const vector<vector<double>>& worldMap);
+
+	//makes a field an obstacle or a free field
+	void SetObstacle(int row, int column, bool isObstacle);
+
+	//returns true if the field is an obstacle
+	bool IsObstacle(int row, int column) const;
+
+	//returns the flags of the field
+	unsigned char GetFieldFlags(int row, int column) const;
+
+	//returns the top left corner of the field in window coordinates
+	VisualCoordinates GetFieldCorner(int row, int column) const;
+
+	//returns the center of the field in window coordinates
+	VisualCoordinates GetFieldCenter(int row, int column) const;
+
+	//returns true if all fields have to be drawn again, e.g. after the grid was set
+	bool AllFieldsChanged() const;
+
+	//returns the indices (row * number of columns + column) of the fields that changed since the last call to 'ClearChanges'
+	const vector<unsigned int>& GetChangedFields() const;
+
+	//marks all fields as drawn
+	void ClearChanges();
+
+	//the size of the grid
+	int NumberOfRows;
+	int NumberOfColumns;
+
+	//the size of a field in window coordinates
+	float FieldWidth;
+	float FieldHeight;
+
+protected:
+	//sets or clears 'flag' for the field and remembers the field if it changed
+	void SetFieldFlag(int row, int column, unsigned char flag, bool value);
+
+	vector<unsigned char> fieldFlags;
+	vector<unsigned int> changedFields;
+	bool allFieldsChanged;
 };
 
 
 //<summary>
-//Sets a visual grid from the grid given by 'worldMap'.
+//Default constructor; creates an empty grid.
+//</summary>
+VisualWorldMap::VisualWorldMap()
+{
+	this->NumberOfRows = 0;
+	this->NumberOfColumns = 0;
+	this->FieldWidth = 0.0f;
+	this->FieldHeight = 0.0f;
+	this->allFieldsChanged = true;
+}
+
+//<summary>
+//Sets a visual grid from the grid given by 'worldMap'; all fields are marked as changed.
 //</summary>
 //<param name='worldMap'>A logical grid that is used for making a visual grid.</param>
-void VisualWorldMap::SetVisualMap(vector<vector<double>> worldMap)
+void VisualWorldMap::SetVisualMap(const vector<vector<double>>& worldMap)
 {
-	unsigned int numberOfRows = worldMap.size();
-	unsigned int numberOfColumns = worldMap[0].size();
+	this->NumberOfRows = worldMap.size();
+	this->NumberOfColumns = worldMap[0].size();
 
 	//we calculate the width of a field as the window width (not width in pixels)
 	//divided by the number of columns
-	float fieldWidth = X_RANGE / numberOfColumns;
+	this->FieldWidth = X_RANGE / this->NumberOfColumns;
 
 	//we calculate the height of a field as the window height (not height in pixels)
 	//divided by the number of rows
-	float fieldHeight = Y_RANGE / numberOfRows;
+	this->FieldHeight = Y_RANGE / this->NumberOfRows;
+
+	this->fieldFlags.assign(this->NumberOfRows * this->NumberOfColumns, 0);
+	for(int i=0; i<this->NumberOfRows; i++)
+		for(int j=0; j<this->NumberOfColumns; j++)
+			if(fabs(worldMap[i][j] - OBSTACLE_DELIMITER) < 0.005)
+				this->fieldFlags[i * this->NumberOfColumns + j] = FIELD_OBSTACLE;
+
+	this->changedFields.clear();
+	this->allFieldsChanged = true;
+}
+
+//<summary>
+//Makes the field with grid coordinates 'row' and 'column' an obstacle or a free field.
+//</summary>
+void VisualWorldMap::SetObstacle(int row, int column, bool isObstacle)
+{
+	this->SetFieldFlag(row, column, FIELD_OBSTACLE, isObstacle);
+}
+
+//<summary>
+//Returns true if the field with grid coordinates 'row' and 'column' is an obstacle and false otherwise.
+//</summary>
+bool VisualWorldMap::IsObstacle(int row, int column) const
+{
+	return (this->fieldFlags[row * this->NumberOfColumns + column] & FIELD_OBSTACLE) != 0;
+}
+
+//<summary>
+//Returns the flags of the field with grid coordinates 'row' and 'column', without 'FIELD_CHANGED'.
+//</summary>
+unsigned char VisualWorldMap::GetFieldFlags(int row, int column) const
+{
+	return this->fieldFlags[row * this->NumberOfColumns + column] & ~FIELD_CHANGED;
+}
+
+//<summary>
+//Returns the top left corner of the field with grid coordinates 'row' and 'column' in window coordinates;
+//rows go from the top to the bottom of the window and columns from the left to the right.
+//</summary>
+VisualCoordinates VisualWorldMap::GetFieldCorner(int row, int column) const
+{
+	VisualCoordinates corner;
+	corner.X = LEFT_X_POINT + column * this->FieldWidth;
+	corner.Y = UPPER_Y_POINT - row * this->FieldHeight;
+	return corner;
+}
+
+//<summary>
+//Returns the center of the field with grid coordinates 'row' and 'column' in window coordinates.
+//</summary>
+VisualCoordinates VisualWorldMap::GetFieldCenter(int row, int column) const
+{
+	VisualCoordinates center = this->GetFieldCorner(row, column);
+	center.X += this->FieldWidth / 2.0f;
+	center.Y -= this->FieldHeight / 2.0f;
+	return center;
+}
+
+//<summary>
+//Returns true if all fields have to be drawn again; in that case, the list of changed fields is empty.
+//</summary>
+bool VisualWorldMap::AllFieldsChanged() const
+{
+	return this->allFieldsChanged;
+}
 
-	float currentY = UPPER_Y_POINT;
+//<summary>
+//Returns the indices of the fields that changed since the last call to 'ClearChanges'; each field appears once.
+//</summary>
+const vector<unsigned int>& VisualWorldMap::GetChangedFields() const
+{
+	return this->changedFields;
+}
 
-	//for each field in the logical grid, we create a field in the visual grid,
-	//storing the vertices of the field in the following order: top left, top right, bottom right, bottom left
-	for(unsigned int i=0; i<numberOfRows; i++)
+//<summary>
+//Marks all fields as drawn; should be called after the changes were drawn.
+//</summary>
+void VisualWorldMap::ClearChanges()
+{
+	for(unsigned int i=0; i<this->changedFields.size(); i++)
+		this->fieldFlags[this->changedFields[i]] &= ~FIELD_CHANGED;
+
+	this->changedFields.clear();
+	this->allFieldsChanged = false;
+}
+
+//<summary>
+//Sets 'flag' of the field with grid coordinates 'row' and 'column' if 'value' is true and clears it otherwise.
+//If the flags of the field changed, the field is added to the list of changed fields.
+//</summary>
+void VisualWorldMap::SetFieldFlag(int row, int column, unsigned char flag, bool value)
+{
+	unsigned int index = row * this->NumberOfColumns + column;
+	unsigned char flags = value ? this->fieldFlags[index] | flag : this->fieldFlags[index] & ~flag;
+	if(flags == this->fieldFlags[index])
+		return;
+
+	//if all fields will be drawn anyway, there is no need to remember single ones
+	if(!this->allFieldsChanged && !(flags & FIELD_CHANGED))
 	{
-		float currentX = LEFT_X_POINT;
-		vector<VisualNodeInfo> tempVector;
-		for(unsigned int j=0; j<numberOfColumns; j++)
-		{
-			VisualNodeInfo fieldInfo;
-			fieldInfo.IsObstacle = abs(worldMap[i][j] - OBSTACLE_DELIMITER) < 0.005 ? true : false;
-
-			//top left
-			fieldInfo.Vertices[0].X = currentX;
-			fieldInfo.Vertices[0].Y = currentY;
-
-			//top right
-			fieldInfo.Vertices[1].X = currentX + fieldWidth;
-			fieldInfo.Vertices[1].Y = currentY;
-
-			//bottom right
-			fieldInfo.Vertices[2].X = currentX + fieldWidth;
-			fieldInfo.Vertices[2].Y = currentY - fieldHeight;
-
-			//bottom left
-			fieldInfo.Vertices[3].X = currentX;
-			fieldInfo.Vertices[3].Y = currentY - fieldHeight;
-
-			fieldInfo.VertexCenter.X = (currentX + (currentX + fieldWidth)) / 2.0f;
-			fieldInfo.VertexCenter.Y = (currentY + (currentY - fieldHeight)) / 2.0f;
-
-			currentX += fieldWidth;
-			tempVector.push_back(fieldInfo);
-		}
-
-		currentY -= fieldHeight;
-		this->Vertices.push_back(tempVector);
+		flags |= FIELD_CHANGED;
+		this->changedFields.push_back(index);
 	}
+
+	this->fieldFlags[index] = flags;
 }
 
 #endif
\ No newline at end of file
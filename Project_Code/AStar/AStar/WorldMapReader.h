@@ -0,0 +1,120 @@
+#ifndef WORLD_MAP_READER_H
+#define WORLD_MAP_READER_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cctype>
+using std::vector;
+using std::ifstream;
+using std::string;
+using std::stringstream;
+
+//<summary>
+//Class used for reading grids from text files in which the numbers are separated by a delimiter.
+//</summary>
+class WorldMapReader
+{
+public:
+	//reads a grid from a file
+	static vector<vector<double>> ReadFromFile(const char* filename, const char delimiter);
+};
+
+
+//<summary>
+//Reads a grid from the file with name 'filename'; each line of the file is a row of the grid.
+//</summary>
+//<param name='filename'>Name of a file containing numerical data.</param>
+//<param name='delimiter'>Delimiter used to separate numbers in the file.</param>
+//<returns>The grid stored in the file.</returns>
+vector<vector<double>> WorldMapReader::ReadFromFile(const char* filename, const char delimiter)
+{
+	//the grid read from the file
+	vector<vector<double>> worldMap;
+
+	//stream for reading data from the file
+	ifstream document;
+
+	//string for storing a line from the file
+	string lineReader;
+
+	//stream for converting strings to numbers
+	stringstream converter;
+
+	//variable for storing a converted string to number
+	double tempNumber;
+	
+	try
+	{
+		document.exceptions(ifstream::badbit | ifstream::failbit);
+		document.open(filename);
+
+		while(!document.eof())
+		{
+			getline(document,lineReader);
+			vector<double> currentRow;
+
+			//we make sure that the file does not contain letters
+			for(unsigned int character=0; character<lineReader.size(); character++)
+			{
+				if(isalpha(lineReader[character]))
+					throw "Wrong format";
+			}
+
+			//used for storing the previous position of a delimiter in the string;
+			//initially assigned to 0 because we haven't found a delimiter yet
+			int delimiterIndex = 0;
+
+			//used for looping through the file line
+			//which was read in the current iteration
+			unsigned int i = 0;
+
+			//we loop through the file line and extract numbers
+			while(i<lineReader.size())
+			{
+				//if we find a delimiter, we extract a number,
+				//convert it to 'float' and then store it in the data matrix
+				if(lineReader[i] == delimiter)
+				{
+					converter << lineReader.substr(delimiterIndex, i-delimiterIndex);
+					converter >> tempNumber;
+					currentRow.push_back(tempNumber);
+
+					delimiterIndex = i+1;
+
+					//we check for repetitive occurences of a delimiter
+					while(lineReader[delimiterIndex] == delimiter)
+					{
+						delimiterIndex++;
+						i++;
+					}
+					converter.clear();
+				}
+				i++;
+			}
+
+			//we extract the last number in the line
+			converter << lineReader.substr(delimiterIndex, lineReader.size()-delimiterIndex);
+			converter >> tempNumber;
+			currentRow.push_back(tempNumber);
+			converter.clear();
+
+			worldMap.push_back(currentRow);
+		}
+
+		document.close();
+	}
+	catch(...)
+	{
+		//we close the file stream in case it is open
+		if(document.is_open())
+			document.close();
+
+		throw "Error while reading file";
+	}
+
+	return worldMap;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,98 @@
+#ifndef WORLD_MAP_SNAPSHOT_H
+#define WORLD_MAP_SNAPSHOT_H
+
+#include <vector>
+#include <memory>
+using std::vector;
+using std::shared_ptr;
+
+//the side of a tile is 2^MAP_TILE_SHIFT fields
+const int MAP_TILE_SHIFT = 5;
+const int MAP_TILE_SIZE = 1 << MAP_TILE_SHIFT;
+const int MAP_TILE_MASK = MAP_TILE_SIZE - 1;
+
+//<summary>
+//Class that stores a version of a grid that never changes after it is published. The grid is split into square tiles,
+//and snapshots share the tiles they have in common, so a new version only needs copies of the tiles that were changed.
+//</summary>
+class WorldMapSnapshot
+{
+public:
+	WorldMapSnapshot();
+	WorldMapSnapshot(const vector<vector<double>>& worldMap, unsigned int version);
+
+	//returns the cost of the field with grid coordinates 'x' and 'y'
+	double GetCost(int x, int y) const;
+
+	//returns the grid as nested vectors, as used in 'AStarLibrary::WorldMap'
+	vector<vector<double>> ToWorldMap() const;
+
+	int NumberOfRows;
+	int NumberOfColumns;
+	unsigned int Version;
+
+private:
+	friend class VersionedWorldMap;
+
+	//number of tiles in a row of tiles
+	int numberOfTileColumns;
+
+	//tiles stored row by row; each tile stores its fields row by row
+	vector<shared_ptr<vector<double>>> tiles;
+};
+
+
+//<summary>
+//Default constructor; creates an empty snapshot.
+//</summary>
+WorldMapSnapshot::WorldMapSnapshot()
+{
+	this->NumberOfRows = 0;
+	this->NumberOfColumns = 0;
+	this->Version = 0;
+	this->numberOfTileColumns = 0;
+}
+
+//<summary>
+//Splits 'worldMap' into tiles; the fields of the tiles on the lower and right edge that lie outside the grid are never read.
+//</summary>
+//<param name='worldMap'>A logical grid.</param>
+//<param name='version'>The version of the grid.</param>
+WorldMapSnapshot::WorldMapSnapshot(const vector<vector<double>>& worldMap, unsigned int version)
+{
+	this->NumberOfRows = worldMap.size();
+	this->NumberOfColumns = worldMap[0].size();
+	this->Version = version;
+
+	int numberOfTileRows = (this->NumberOfRows + MAP_TILE_MASK) >> MAP_TILE_SHIFT;
+	this->numberOfTileColumns = (this->NumberOfColumns + MAP_TILE_MASK) >> MAP_TILE_SHIFT;
+
+	for(int i=0; i<numberOfTileRows * this->numberOfTileColumns; i++)
+		this->tiles.push_back(shared_ptr<vector<double>>(new vector<double>(MAP_TILE_SIZE * MAP_TILE_SIZE, 0.0)));
+
+	for(int x=0; x<this->NumberOfRows; x++)
+		for(int y=0; y<this->NumberOfColumns; y++)
+			(*this->tiles[(x >> MAP_TILE_SHIFT) * this->numberOfTileColumns + (y >> MAP_TILE_SHIFT)])[((x & MAP_TILE_MASK) << MAP_TILE_SHIFT) + (y & MAP_TILE_MASK)] = worldMap[x][y];
+}
+
+//<summary>
+//Returns the cost of the field with grid coordinates 'x' and 'y'; the coordinates are not checked.
+//</summary>
+double WorldMapSnapshot::GetCost(int x, int y) const
+{
+	return (*this->tiles[(x >> MAP_TILE_SHIFT) * this->numberOfTileColumns + (y >> MAP_TILE_SHIFT)])[((x & MAP_TILE_MASK) << MAP_TILE_SHIFT) + (y & MAP_TILE_MASK)];
+}
+
+//<summary>
+//Copies the snapshot to nested vectors.
+//</summary>
+vector<vector<double>> WorldMapSnapshot::ToWorldMap() const
+{
+	vector<vector<double>> worldMap(this->NumberOfRows, vector<double>(this->NumberOfColumns));
+	for(int x=0; x<this->NumberOfRows; x++)
+		for(int y=0; y<this->NumberOfColumns; y++)
+			worldMap[x][y] = this->GetCost(x, y);
+	return worldMap;
+}
+
+#endif
\ No newline at end of file
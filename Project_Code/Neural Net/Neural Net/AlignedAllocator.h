@@ -0,0 +1,97 @@
+#ifndef ALIGNED_ALLOCATOR_H
+#define ALIGNED_ALLOCATOR_H
+
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+//alignment (in bytes) of the memory returned by 'AlignedAllocator'; a cache line and the width of the widest vector registers
+const size_t NEURAL_NETWORK_ALIGNMENT = 64;
+
+//<summary>
+//Allocator for vectors whose data has to start at a multiple of NEURAL_NETWORK_ALIGNMENT bytes, so that the rows of
+//the weight matrices can be read with aligned loads. A few more bytes are allocated and the address returned by
+//'operator new' is stored right before the aligned block, so that it can be freed later; the memory comes from
+//'operator new' rather than 'malloc', so that it is included when the allocations of the program are counted.
+//</summary>
+template <typename T>
+class AlignedAllocator
+{
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+
+	template <typename U>
+	struct rebind
+	{
+		typedef AlignedAllocator<U> other;
+	};
+
+	AlignedAllocator() { }
+
+	template <typename U>
+	AlignedAllocator(const AlignedAllocator<U>&) { }
+
+	pointer allocate(size_type numberOfElements, const void* hint = 0);
+	void deallocate(pointer block, size_type numberOfElements);
+
+	void construct(pointer element, const T& value) { new((void*)element) T(value); }
+	void destroy(pointer element) { element->~T(); }
+
+	pointer address(reference element) const { return &element; }
+	const_pointer address(const_reference element) const { return &element; }
+	size_type max_size() const { return ((size_type)-1 - NEURAL_NETWORK_ALIGNMENT - sizeof(void*)) / sizeof(T); }
+};
+
+template <typename T, typename U>
+bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return true; }
+
+template <typename T, typename U>
+bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return false; }
+
+//vectors whose data starts at a multiple of NEURAL_NETWORK_ALIGNMENT bytes
+typedef std::vector<double, AlignedAllocator<double>> AlignedVector;
+typedef std::vector<signed char, AlignedAllocator<signed char>> AlignedInt8Vector;
+typedef std::vector<unsigned char, AlignedAllocator<unsigned char>> AlignedUint8Vector;
+
+//the aligned vector of values of type 'T' is 'AlignedVectorOf<T>::Type'; Visual Studio 2012 doesn't support alias templates
+template <typename T>
+struct AlignedVectorOf
+{
+	typedef std::vector<T, AlignedAllocator<T>> Type;
+};
+
+
+//<summary>
+//Allocates memory for 'numberOfElements' elements starting at a multiple of NEURAL_NETWORK_ALIGNMENT bytes.
+//</summary>
+template <typename T>
+T* AlignedAllocator<T>::allocate(size_type numberOfElements, const void* /*hint*/)
+{
+	if(numberOfElements > this->max_size())
+		throw std::bad_alloc();
+
+	void* memory = ::operator new(numberOfElements * sizeof(T) + NEURAL_NETWORK_ALIGNMENT + sizeof(void*));
+
+	size_t address = ((size_t)memory + sizeof(void*) + NEURAL_NETWORK_ALIGNMENT - 1) & ~(NEURAL_NETWORK_ALIGNMENT - 1);
+	((void**)address)[-1] = memory;
+	return (T*)address;
+}
+
+//<summary>
+//Frees memory returned by 'allocate'.
+//</summary>
+template <typename T>
+void AlignedAllocator<T>::deallocate(pointer block, size_type /*numberOfElements*/)
+{
+	if(block != NULL)
+		::operator delete(((void**)block)[-1]);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "AllocationCounter.h"
+#include <new>
+#include <cstdlib>
+
+//without NEURAL_NETWORK_COUNT_ALLOCATIONS, the file is empty and the standard operators are used
+#ifdef NEURAL_NETWORK_COUNT_ALLOCATIONS
+
+//the operators are replaced in their own file, so that the compiler doesn't see the calls to 'malloc' and 'free'
+//when it inlines them into the code that uses 'new' and 'delete'; all forms of the operators are replaced,
+//so every block is allocated and freed with 'malloc' and 'free'
+atomic<unsigned long long> numberOfAllocations(0);
+
+//<summary>
+//Counts an allocation and allocates 'size' bytes (at least one) with 'malloc'.
+//</summary>
+//<returns>The allocated block or NULL if there is not enough memory.</returns>
+static void* countedAllocate(size_t size) throw()
+{
+	numberOfAllocations++;
+	return malloc(size > 0 ? size : 1);
+}
+
+void* operator new(size_t size)
+{
+	void* memory = countedAllocate(size);
+	if(memory == NULL)
+		throw std::bad_alloc();
+	return memory;
+}
+
+void* operator new[](size_t size)
+{
+	void* memory = countedAllocate(size);
+	if(memory == NULL)
+		throw std::bad_alloc();
+	return memory;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) throw()
+{
+	return countedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) throw()
+{
+	return countedAllocate(size);
+}
+
+void operator delete(void* memory) throw()
+{
+	free(memory);
+}
+
+void operator delete[](void* memory) throw()
+{
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) throw()
+{
+	free(memory);
+}
+
+void operator delete[](void* memory, size_t) throw()
+{
+	free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) throw()
+{
+	free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) throw()
+{
+	free(memory);
+}
+
+#endif
\ No newline at end of file
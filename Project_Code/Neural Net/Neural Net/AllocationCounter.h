@@ -0,0 +1,25 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+//the allocations are only counted in builds for the benchmarks, which define NEURAL_NETWORK_COUNT_ALLOCATIONS
+//(e.g. with /D NEURAL_NETWORK_COUNT_ALLOCATIONS); otherwise 'new' and 'delete' aren't replaced, so the training doesn't pay for the counting
+#ifdef NEURAL_NETWORK_COUNT_ALLOCATIONS
+
+#include <atomic>
+using std::atomic;
+
+//number of blocks allocated with 'new' (including the vectors of the network) since the program started;
+//used by the benchmarks for checking that the training doesn't allocate memory once it is running.
+//The replaced 'new' and 'delete' operators that count the blocks are defined in 'AllocationCounter.cpp'.
+extern atomic<unsigned long long> numberOfAllocations;
+const bool ALLOCATIONS_ARE_COUNTED = true;
+
+#else
+
+//the benchmarks don't report any allocations if they aren't counted
+const unsigned long long numberOfAllocations = 0;
+const bool ALLOCATIONS_ARE_COUNTED = false;
+
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,107 @@
+#ifndef BINARY_PATTERN_H
+#define BINARY_PATTERN_H
+
+#include "PatternView.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+//the largest number of values of a binary pattern (16x16 pixels) and the number of 32-bit words that store them
+const int BINARY_PATTERN_BITS = 256;
+const int BINARY_PATTERN_WORDS = BINARY_PATTERN_BITS / 32;
+
+//<summary>
+//Pattern whose values are all 0 or 1, e.g. a 16x16 black and white image, stored as one bit per value.
+//The indices of the set bits are found by repeatedly taking the lowest set bit of each word, so patterns with
+//few set bits are processed quickly; the words are 32 bits wide so that the same instructions work in 32-bit programs.
+//</summary>
+struct BinaryPattern
+{
+	//a pattern with no set bits
+	BinaryPattern();
+
+	//sets the bits of the values of 'pattern' that are at least 0.5; 'pattern' can have at most BINARY_PATTERN_BITS values
+	explicit BinaryPattern(PatternView pattern);
+
+	//returns true if all values of 'pattern' are 0 or 1 and there are at most BINARY_PATTERN_BITS of them
+	static bool IsBinary(PatternView pattern);
+
+	bool Get(int index) const;
+	void Set(int index, bool value);
+
+	//stores the indices of the set bits in 'indices' in increasing order and returns their number
+	int GetSetBits(int* indices) const;
+
+	unsigned int Words[BINARY_PATTERN_WORDS];
+};
+
+BinaryPattern::BinaryPattern()
+{
+	for(int i=0; i<BINARY_PATTERN_WORDS; i++)
+		this->Words[i] = 0;
+}
+
+BinaryPattern::BinaryPattern(PatternView pattern)
+{
+	if(pattern.NumberOfValues > BINARY_PATTERN_BITS)
+		throw "Pattern too long";
+
+	for(int i=0; i<BINARY_PATTERN_WORDS; i++)
+		this->Words[i] = 0;
+	for(int i=0; i<pattern.NumberOfValues; i++)
+		if(pattern[i] >= 0.5)
+			this->Words[i / 32] |= 1u << (i % 32);
+}
+
+bool BinaryPattern::IsBinary(PatternView pattern)
+{
+	if(pattern.NumberOfValues > BINARY_PATTERN_BITS)
+		return false;
+
+	for(int i=0; i<pattern.NumberOfValues; i++)
+		if(pattern[i] != 0.0 && pattern[i] != 1.0)
+			return false;
+	return true;
+}
+
+bool BinaryPattern::Get(int index) const
+{
+	return (this->Words[index / 32] & (1u << (index % 32))) != 0;
+}
+
+void BinaryPattern::Set(int index, bool value)
+{
+	if(value)
+		this->Words[index / 32] |= 1u << (index % 32);
+	else
+		this->Words[index / 32] &= ~(1u << (index % 32));
+}
+
+//<summary>
+//Finds the indices of the set bits; each iteration takes the lowest set bit of a word and clears it.
+//</summary>
+//<param name='indices'>Array with room for BINARY_PATTERN_BITS indices.</param>
+//<returns>The number of set bits.</returns>
+int BinaryPattern::GetSetBits(int* indices) const
+{
+	int numberOfSetBits = 0;
+	for(int i=0; i<BINARY_PATTERN_WORDS; i++)
+	{
+		unsigned int word = this->Words[i];
+		while(word != 0)
+		{
+#ifdef _MSC_VER
+			unsigned long bit;
+			_BitScanForward(&bit, word);
+#else
+			int bit = __builtin_ctz(word);
+#endif
+			indices[numberOfSetBits++] = i * 32 + bit;
+			word &= word - 1;
+		}
+	}
+
+	return numberOfSetBits;
+}
+
+#endif
\ No newline at end of file
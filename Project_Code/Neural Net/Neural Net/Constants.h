@@ -9,9 +9,11 @@ class Constants
 public:
 	static string HiddenWeightsFilename;
 	static string OutputWeightsFilename;
+	static string ModelFilename;
 };
 
 string Constants::HiddenWeightsFilename = "Hidden Weights.txt";
 string Constants::OutputWeightsFilename = "Output Weights.txt";
+string Constants::ModelFilename = "Model.bin";
 
 #endif
\ No newline at end of file
@@ -1,16 +1,29 @@
 #include "NeuralNetworkTrainer.h"
 #include "NeuralNetworkClassifier.h"
+#include "NeuralNetworkQuantizedClassifier.h"
+#include "NeuralNetworkMappedClassifier.h"
+#include "AllocationCounter.h"
 #include <fstream>
 #include <vector>
 #include <string>
 #include <sstream>
 #include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <cstdlib>
 
 using std::cout;
 using std::ifstream;
 using std::vector;
 using std::string;
 using std::stringstream;
+using std::max;
+using std::sort;
+using std::chrono::high_resolution_clock;
+using std::chrono::duration_cast;
+using std::chrono::nanoseconds;
 
 const int NUMBER_OF_INPUT_NEURONS = 256;
 const int NUMBER_OF_HIDDEN_NEURONS = 40;
@@ -19,14 +32,63 @@ const int NUMBER_OF_OUTPUT_NEURONS = 12;
 NeuralNetworkInput trainData;
 
 void readDataFromFile(const char* filename, const char delimiter);
+void benchmarkClassification(int numberOfRepetitions);
+void benchmarkKernels();
+void benchmarkBatchSizes(int numberOfEpochs);
+void benchmarkThreads(int numberOfEpochs, int batchSize);
+void benchmarkBinaryInputs(int numberOfEpochs);
+void benchmarkQuantization(int numberOfEpochs);
+void benchmarkPrecision(int numberOfEpochs);
+void benchmarkLogistic(double targetError, int maximumNumberOfEpochs);
+void benchmarkModelFile(int numberOfLoads);
+template <typename Scalar>
+double trainWithPrecision(NeuralNetworkTrainer<Scalar>& network, const NeuralNetworkInput& data, int numberOfEpochs, double& error);
+int getDesiredClass(const vector<double>& expectedOutputs);
+template <typename Scalar>
+void setRandomWeights(NeuralNetworkTrainer<Scalar>& network);
 
 int main()
 {
 	readDataFromFile("trainingData.txt", ' ');
-	NeuralNetworkTrainer neuralNetwork(NUMBER_OF_INPUT_NEURONS, NUMBER_OF_HIDDEN_NEURONS, NUMBER_OF_OUTPUT_NEURONS);
+
+	//the pixels of the images are 0 or 1, so the patterns are also stored as bits; the training without batches
+	//then only goes through the weights of the set pixels in the first layer
+	trainData.PackBinaryData();
+
+	NeuralNetworkTrainer<double> neuralNetwork(NUMBER_OF_INPUT_NEURONS, NUMBER_OF_HIDDEN_NEURONS, NUMBER_OF_OUTPUT_NEURONS);
 	trainData.ErrorThreshold = 0.05;
 	trainData.LearningRate = 0.1;
 	trainData.NumberOfMaximumIterations = 5000;
+	trainData.BatchSize = 1;
+	trainData.NumberOfThreads = 1;
+	trainData.Hogwild = false;
+
+	//uncomment the line below to measure the time needed for classifying a single pattern with the saved weights
+	//benchmarkClassification(100);
+
+	//uncomment the line below to compare the vector kernels with the scalar ones on networks of different sizes
+	//benchmarkKernels();
+
+	//uncomment the line below to compare the training speed with different batch sizes
+	//benchmarkBatchSizes(20);
+
+	//uncomment the line below to measure how the training scales with the number of threads
+	//benchmarkThreads(20, 64);
+
+	//uncomment the line below to compare the training and classification of the patterns stored as bits with the dense ones
+	//benchmarkBinaryInputs(20);
+
+	//uncomment the line below to compare the 8-bit classifier with the double precision one on patterns left out of the training
+	//benchmarkQuantization(200);
+
+	//uncomment the line below to compare the training and classification with floats and with doubles
+	//benchmarkPrecision(20);
+
+	//uncomment the line below to compare the approximations of the logistic function and the training time with each of them
+	//benchmarkLogistic(20.0, 500);
+
+	//uncomment the line below to compare loading the weights from the text files with loading them from a model file
+	//benchmarkModelFile(100);
 
 	cout << "Training started...\n";
 	neuralNetwork.Train(trainData);
@@ -34,7 +96,7 @@ int main()
 
 	getchar();
 
-	//NeuralNetworkClassifier classifier(NUMBER_OF_INPUT_NEURONS, NUMBER_OF_HIDDEN_NEURONS, NUMBER_OF_OUTPUT_NEURONS);
+	//NeuralNetworkClassifier<> classifier(NUMBER_OF_INPUT_NEURONS, NUMBER_OF_HIDDEN_NEURONS, NUMBER_OF_OUTPUT_NEURONS);
 	//double correctlyClassified = 0;
 	//for(int i=0; i<trainData.Data.size(); i++)
 	//{
@@ -173,4 +235,714 @@ void readDataFromFile(const char* filename, const char delimiter)
 
 		throw "Error while reading file";
 	}
+}
+
+//<summary>
+//Classifies all patterns of 'trainData' 'numberOfRepetitions' times with the weights saved in the weight files
+//and prints the average time per pattern.
+//</summary>
+//<param name='numberOfRepetitions'>Number of times each pattern is classified.</param>
+void benchmarkClassification(int numberOfRepetitions)
+{
+	NeuralNetworkClassifier<> classifier(NUMBER_OF_INPUT_NEURONS, NUMBER_OF_HIDDEN_NEURONS, NUMBER_OF_OUTPUT_NEURONS);
+
+	//the sum of the classes is printed so that the compiler can't leave the classification out
+	int classSum = 0;
+	high_resolution_clock::time_point start = high_resolution_clock::now();
+	for(int repetition=0; repetition<numberOfRepetitions; repetition++)
+		for(unsigned int i=0; i<trainData.Data.size(); i++)
+			classSum += classifier.Classify(trainData.Data[i]);
+	double microseconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e3;
+
+	cout << "average time per pattern = " << microseconds / (numberOfRepetitions * trainData.Data.size()) << " us (class sum " << classSum << ")\n";
+}
+
+//<summary>
+//For the digit network and two larger networks, compares the outputs and the corrected weights of each instruction set
+//supported by the processor with the scalar kernels and prints the time of a forward pass and of a training step.
+//</summary>
+void benchmarkKernels()
+{
+	const int numberOfPatterns = 64;
+	const char* instructionSetNames[] = { "scalar", "AVX2", "AVX-512" };
+	int sizes[][3] = { { 256, 40, 12 }, { 1024, 256, 64 }, { 4096, 1024, 256 } };
+
+	for(int size=0; size<3; size++)
+	{
+		int numberOfInputNeurons = sizes[size][0];
+		int numberOfHiddenNeurons = sizes[size][1];
+		int numberOfOutputNeurons = sizes[size][2];
+
+		//binary patterns and random weights between -0.05 and 0.05, the same for all instruction sets
+		srand(1);
+		vector<vector<double>> patterns(numberOfPatterns, vector<double>(numberOfInputNeurons));
+		vector<vector<double>> expectedOutputs(numberOfPatterns, vector<double>(numberOfOutputNeurons, 0.0));
+		for(int i=0; i<numberOfPatterns; i++)
+		{
+			for(int j=0; j<numberOfInputNeurons; j++)
+				patterns[i][j] = rand() % 2;
+			expectedOutputs[i][rand() % numberOfOutputNeurons] = 1.0;
+		}
+
+		NeuralNetworkTrainer<double> initialNetwork(numberOfInputNeurons, numberOfHiddenNeurons, numberOfOutputNeurons);
+		setRandomWeights(initialNetwork);
+
+		vector<double> scalarOutputs;
+		AlignedVector scalarWeights;
+		int bestInstructionSet = NeuralNetworkKernels::GetBestInstructionSet();
+		for(int instructionSet=KERNELS_SCALAR; instructionSet<=bestInstructionSet; instructionSet++)
+		{
+			if(!NeuralNetworkKernels::Select(instructionSet))
+				continue;
+
+			//the outputs of all patterns and the weights after training on all of them are compared with the scalar kernels
+			NeuralNetworkTrainer<double> network = initialNetwork;
+			vector<double> outputs;
+			for(int i=0; i<numberOfPatterns; i++)
+			{
+				network.FeedForward(patterns[i]);
+				outputs.insert(outputs.end(), network.outputValues.begin(), network.outputValues.end());
+				network.Backpropagate(expectedOutputs[i], 0.1);
+			}
+
+			double maximumDifference = 0.0;
+			if(instructionSet == KERNELS_SCALAR)
+			{
+				scalarOutputs = outputs;
+				scalarWeights = network.hiddenWeights;
+			}
+			else
+			{
+				for(unsigned int i=0; i<outputs.size(); i++)
+					maximumDifference = max(maximumDifference, fabs(outputs[i] - scalarOutputs[i]));
+				for(unsigned int i=0; i<scalarWeights.size(); i++)
+					maximumDifference = max(maximumDifference, fabs(network.hiddenWeights[i] - scalarWeights[i]));
+			}
+
+			int repetitions = max(1, 4000000 / (numberOfInputNeurons * numberOfHiddenNeurons));
+			high_resolution_clock::time_point start = high_resolution_clock::now();
+			for(int repetition=0; repetition<repetitions; repetition++)
+				network.FeedForward(patterns[repetition % numberOfPatterns]);
+			double forwardTime = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e3 / repetitions;
+
+			start = high_resolution_clock::now();
+			for(int repetition=0; repetition<repetitions; repetition++)
+			{
+				network.FeedForward(patterns[repetition % numberOfPatterns]);
+				network.Backpropagate(expectedOutputs[repetition % numberOfPatterns], 0.1);
+			}
+			double trainingTime = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e3 / repetitions;
+
+			cout << numberOfInputNeurons << "-" << numberOfHiddenNeurons << "-" << numberOfOutputNeurons << ", " << instructionSetNames[instructionSet]
+				 << ": forward pass = " << forwardTime << " us, training step = " << trainingTime << " us"
+				 << ", maximum difference from scalar = " << maximumDifference << "\n";
+		}
+	}
+
+	NeuralNetworkKernels::Select(NeuralNetworkKernels::GetBestInstructionSet());
+}
+
+//<summary>
+//Trains the digit network on 'trainData' for 'numberOfEpochs' epochs with different batch sizes, starting from the same
+//weights each time, and prints the number of patterns processed per second, the error of the last epoch and the number
+//of memory allocations (only in builds with NEURAL_NETWORK_COUNT_ALLOCATIONS). The corrections of a batch are added up, so the learning rate has a bigger effect with bigger batches.
+//</summary>
+//<param name='numberOfEpochs'>Number of times the network goes through all training patterns.</param>
+void benchmarkBatchSizes(int numberOfEpochs)
+{
+	int batchSizes[] = { 1, 4, 16, 64, 256 };
+
+	srand(1);
+	NeuralNetworkTrainer<double> initialNetwork(NUMBER_OF_INPUT_NEURONS, NUMBER_OF_HIDDEN_NEURONS, NUMBER_OF_OUTPUT_NEURONS);
+	setRandomWeights(initialNetwork);
+
+	NeuralNetworkInput batchData = trainData;
+	double patternsPerSecondWithoutBatches = 0.0;
+	for(int size=0; size<5; size++)
+	{
+		NeuralNetworkTrainer<double> network = initialNetwork;
+		batchData.BatchSize = batchSizes[size];
+
+		//the first epoch allocates the matrices of the batch, the other ones shouldn't allocate anything
+		double error = 0.0;
+		unsigned long long allocationsAtStart = numberOfAllocations, allocationsAfterFirstEpoch = 0;
+		high_resolution_clock::time_point start = high_resolution_clock::now();
+		for(int epoch=0; epoch<numberOfEpochs; epoch++)
+		{
+			error = network.TrainEpoch(batchData) / 2.0;
+			if(epoch == 0)
+				allocationsAfterFirstEpoch = numberOfAllocations;
+		}
+		double seconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e9;
+
+		double patternsPerSecond = numberOfEpochs * batchData.Data.size() / seconds;
+		if(size == 0)
+			patternsPerSecondWithoutBatches = patternsPerSecond;
+
+		cout << "batch size " << batchSizes[size] << ": " << patternsPerSecond << " patterns/s (" << patternsPerSecond / patternsPerSecondWithoutBatches
+			 << "x), error after " << numberOfEpochs << " epochs = " << error;
+		if(ALLOCATIONS_ARE_COUNTED)
+			cout << ", allocations in the first epoch = " << allocationsAfterFirstEpoch - allocationsAtStart << ", in the other epochs = " << numberOfAllocations - allocationsAfterFirstEpoch;
+		cout << "\n";
+	}
+}
+
+//<summary>
+//Trains the digit network on 'trainData' for 1 + 'numberOfEpochs' epochs with 1 to 32 threads, with and without Hogwild,
+//starting from the same weights each time, and prints the number of patterns processed per second, the speedup
+//compared to one thread, the error of the last epoch and the number of memory allocations per epoch (only in builds with
+//NEURAL_NETWORK_COUNT_ALLOCATIONS); the threads of a network
+//are started by its untimed first epoch and reused by the next ones, so the timed epochs shouldn't allocate memory.
+//The speedups are only meaningful on a machine with at least as many hardware threads as the largest thread count;
+//the scaling report for 1 to 32 threads ('Scaling Report.txt') has to come from a run on a machine with at least 32 hardware threads.
+//</summary>
+//<param name='numberOfEpochs'>Number of times the network goes through all training patterns.</param>
+//<param name='batchSize'>Number of patterns in a batch; at least 32, so that all threads get patterns of each batch.</param>
+void benchmarkThreads(int numberOfEpochs, int batchSize)
+{
+	int threadCounts[] = { 1, 2, 4, 8, 16, 32 };
+	const char* modeNames[] = { "deterministic", "Hogwild" };
+	cout << "hardware threads: " << std::thread::hardware_concurrency() << "\n";
+
+	srand(1);
+	NeuralNetworkTrainer<double> initialNetwork(NUMBER_OF_INPUT_NEURONS, NUMBER_OF_HIDDEN_NEURONS, NUMBER_OF_OUTPUT_NEURONS);
+	setRandomWeights(initialNetwork);
+
+	NeuralNetworkInput threadData = trainData;
+	threadData.BatchSize = batchSize;
+	for(int mode=0; mode<2; mode++)
+	{
+		threadData.Hogwild = mode == 1;
+		double patternsPerSecondWithOneThread = 0.0;
+		for(int count=0; count<6; count++)
+		{
+			NeuralNetworkTrainer<double> network = initialNetwork;
+			threadData.NumberOfThreads = threadCounts[count];
+
+			//the matrices of the batches are allocated in an untimed first epoch
+			double error = network.TrainEpoch(threadData) / 2.0;
+			unsigned long long allocationsAtStart = numberOfAllocations;
+			high_resolution_clock::time_point start = high_resolution_clock::now();
+			for(int epoch=0; epoch<numberOfEpochs; epoch++)
+				error = network.TrainEpoch(threadData) / 2.0;
+			double seconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e9;
+			unsigned long long allocationsPerEpoch = (numberOfAllocations - allocationsAtStart) / numberOfEpochs;
+
+			double patternsPerSecond = numberOfEpochs * threadData.Data.size() / seconds;
+			if(count == 0)
+				patternsPerSecondWithOneThread = patternsPerSecond;
+
+			cout << modeNames[mode] << ", " << threadCounts[count] << " threads: " << patternsPerSecond << " patterns/s ("
+				 << patternsPerSecond / patternsPerSecondWithOneThread << "x), error after " << numberOfEpochs + 1 << " epochs = " << error;
+			if(ALLOCATIONS_ARE_COUNTED)
+				cout << ", allocations per epoch = " << allocationsPerEpoch;
+			cout << "\n";
+		}
+	}
+}
+
+//<summary>
+//Compares the patterns of 'trainData' stored as bits with the dense patterns for each instruction set supported by the processor:
+//prints the time of a forward pass and of a training epoch without batches, the maximum difference between the outputs and
+//between the weights after 'numberOfEpochs' epochs, and the average number of set pixels.
+//</summary>
+//<param name='numberOfEpochs'>Number of times the network goes through all training patterns.</param>
+void benchmarkBinaryInputs(int numberOfEpochs)
+{
+	const char* instructionSetNames[] = { "scalar", "AVX2", "AVX-512" };
+
+	NeuralNetworkInput denseData = trainData;
+	denseData.BatchSize = 1;
+	denseData.NumberOfThreads = 1;
+	denseData.BinaryData.clear();
+
+	NeuralNetworkInput binaryData = denseData;
+	if(!binaryData.PackBinaryData())
+	{
+		cout << "the training patterns are not binary\n";
+		return;
+	}
+
+	int numberOfPatterns = denseData.Data.size();
+	int numberOfSetPixels = 0;
+	for(int i=0; i<numberOfPatterns; i++)
+		for(int j=0; j<NUMBER_OF_INPUT_NEURONS; j++)
+			numberOfSetPixels += denseData.Data[i][j] == 1.0 ? 1 : 0;
+	cout << "average number of set pixels = " << (double)numberOfSetPixels / numberOfPatterns << " of " << NUMBER_OF_INPUT_NEURONS << "\n";
+
+	srand(1);
+	NeuralNetworkTrainer<double> initialNetwork(NUMBER_OF_INPUT_NEURONS, NUMBER_OF_HIDDEN_NEURONS, NUMBER_OF_OUTPUT_NEURONS);
+	setRandomWeights(initialNetwork);
+	initialNetwork.UpdateInputWeights();
+
+	int bestInstructionSet = NeuralNetworkKernels::GetBestInstructionSet();
+	for(int instructionSet=KERNELS_SCALAR; instructionSet<=bestInstructionSet; instructionSet++)
+	{
+		if(!NeuralNetworkKernels::Select(instructionSet))
+			continue;
+
+		//forward passes of all patterns with the initial weights
+		NeuralNetworkTrainer<double> network = initialNetwork;
+		double maximumOutputDifference = 0.0;
+		for(int i=0; i<numberOfPatterns; i++)
+		{
+			network.FeedForward(denseData.Data[i]);
+			vector<double> denseOutputs(network.outputValues.begin(), network.outputValues.end());
+			network.FeedForward(binaryData.BinaryData[i]);
+			for(int j=0; j<NUMBER_OF_OUTPUT_NEURONS; j++)
+				maximumOutputDifference = max(maximumOutputDifference, fabs(network.outputValues[j] - denseOutputs[j]));
+		}
+
+		const int repetitions = 20;
+		double forwardTimes[2];
+		for(int binary=0; binary<2; binary++)
+		{
+			high_resolution_clock::time_point start = high_resolution_clock::now();
+			for(int repetition=0; repetition<repetitions; repetition++)
+				for(int i=0; i<numberOfPatterns; i++)
+				{
+					if(binary == 1)
+						network.FeedForward(binaryData.BinaryData[i]);
+					else
+						network.FeedForward(denseData.Data[i]);
+				}
+			forwardTimes[binary] = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e3 / (repetitions * numberOfPatterns);
+		}
+
+		//training from the same weights with both kinds of patterns
+		NeuralNetworkTrainer<double> denseNetwork = initialNetwork;
+		NeuralNetworkTrainer<double> binaryNetwork = initialNetwork;
+		double epochTimes[2];
+		for(int binary=0; binary<2; binary++)
+		{
+			high_resolution_clock::time_point start = high_resolution_clock::now();
+			for(int epoch=0; epoch<numberOfEpochs; epoch++)
+			{
+				if(binary == 1)
+					binaryNetwork.TrainEpoch(binaryData);
+				else
+					denseNetwork.TrainEpoch(denseData);
+			}
+			epochTimes[binary] = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e6 / numberOfEpochs;
+		}
+
+		double maximumWeightDifference = 0.0;
+		for(unsigned int i=0; i<denseNetwork.hiddenWeights.size(); i++)
+			maximumWeightDifference = max(maximumWeightDifference, fabs(denseNetwork.hiddenWeights[i] - binaryNetwork.hiddenWeights[i]));
+		for(unsigned int i=0; i<denseNetwork.outputWeights.size(); i++)
+			maximumWeightDifference = max(maximumWeightDifference, fabs(denseNetwork.outputWeights[i] - binaryNetwork.outputWeights[i]));
+
+		cout << instructionSetNames[instructionSet] << ": forward pass = " << forwardTimes[0] << " us dense, " << forwardTimes[1] << " us binary ("
+			 << forwardTimes[0] / forwardTimes[1] << "x); training epoch = " << epochTimes[0] << " ms dense, " << epochTimes[1] << " ms binary ("
+			 << epochTimes[0] / epochTimes[1] << "x); maximum output difference = " << maximumOutputDifference
+			 << ", maximum weight difference after " << numberOfEpochs << " epochs = " << maximumWeightDifference << "\n";
+	}
+
+	NeuralNetworkKernels::Select(NeuralNetworkKernels::GetBestInstructionSet());
+}
+
+//<summary>
+//Trains the digit network for 'numberOfEpochs' epochs on four fifths of 'trainData' and classifies the remaining fifth
+//with the double precision classifier and with the 8-bit classifier, using both dense and binary patterns. For each classifier,
+//prints the accuracy on the held-out patterns, the median time of classifying a single pattern and the number of patterns
+//classified per second in a loop over all held-out patterns; also prints how often the two classifiers agree.
+//</summary>
+//<param name='numberOfEpochs'>Number of times the network goes through the training patterns.</param>
+void benchmarkQuantization(int numberOfEpochs)
+{
+	//every fifth pattern is held out, so that both parts contain all digits
+	NeuralNetworkInput trainingPart = trainData;
+	NeuralNetworkInput heldOutPart = trainData;
+	trainingPart.Data.clear();
+	trainingPart.ExpectedOutputs.clear();
+	heldOutPart.Data.clear();
+	heldOutPart.ExpectedOutputs.clear();
+	for(unsigned int i=0; i<trainData.Data.size(); i++)
+	{
+		NeuralNetworkInput& part = i % 5 == 4 ? heldOutPart : trainingPart;
+		part.Data.push_back(trainData.Data[i]);
+		part.ExpectedOutputs.push_back(trainData.ExpectedOutputs[i]);
+	}
+	trainingPart.BatchSize = 1;
+	trainingPart.NumberOfThreads = 1;
+	trainingPart.PackBinaryData();
+	if(!heldOutPart.PackBinaryData())
+	{
+		cout << "the training patterns are not binary\n";
+		return;
+	}
+
+	srand(1);
+	NeuralNetworkTrainer<double> network(NUMBER_OF_INPUT_NEURONS, NUMBER_OF_HIDDEN_NEURONS, NUMBER_OF_OUTPUT_NEURONS);
+	setRandomWeights(network);
+	double error = 0.0;
+	for(int epoch=0; epoch<numberOfEpochs; epoch++)
+		error = network.TrainEpoch(trainingPart) / 2.0;
+
+	NeuralNetworkClassifier<double> classifier(network);
+	NeuralNetworkQuantizedClassifier quantizedClassifier(network);
+	cout << trainingPart.Data.size() << " training patterns, " << heldOutPart.Data.size() << " held-out patterns, error after " << numberOfEpochs << " epochs = " << error << "\n";
+	cout << "weights: " << (classifier.hiddenWeights.size() + classifier.outputWeights.size()) * sizeof(double) << " bytes as doubles, "
+		 << quantizedClassifier.hiddenWeights.size() + quantizedClassifier.outputWeights.size() << " bytes quantized (hidden scale "
+		 << quantizedClassifier.hiddenScale << ", output scale " << quantizedClassifier.outputScale << ")\n";
+
+	const char* classifierNames[] = { "double, dense", "double, binary", "8-bit, dense", "8-bit, binary" };
+	int numberOfPatterns = heldOutPart.Data.size();
+	vector<int> doubleClasses(numberOfPatterns);
+	for(int i=0; i<numberOfPatterns; i++)
+		doubleClasses[i] = classifier.Classify(heldOutPart.Data[i]);
+
+	const int repetitions = 20;
+	vector<double> times(numberOfPatterns * repetitions);
+	for(int type=0; type<4; type++)
+	{
+		int correctlyClassified = 0, sameAsDouble = 0;
+		for(int i=0; i<numberOfPatterns; i++)
+		{
+			int maxClass;
+			if(type == 0)
+				maxClass = classifier.Classify(heldOutPart.Data[i]);
+			else if(type == 1)
+				maxClass = classifier.Classify(heldOutPart.BinaryData[i]);
+			else if(type == 2)
+				maxClass = quantizedClassifier.Classify(heldOutPart.Data[i]);
+			else
+				maxClass = quantizedClassifier.Classify(heldOutPart.BinaryData[i]);
+
+			if(maxClass == getDesiredClass(heldOutPart.ExpectedOutputs[i]))
+				correctlyClassified++;
+			if(maxClass == doubleClasses[i])
+				sameAsDouble++;
+		}
+
+		//the latency is timed for each pattern separately, which includes the time of reading the clock;
+		//the throughput is timed over whole loops through the held-out patterns
+		int classSum = 0;
+		for(int repetition=0; repetition<repetitions; repetition++)
+			for(int i=0; i<numberOfPatterns; i++)
+			{
+				high_resolution_clock::time_point start = high_resolution_clock::now();
+				if(type == 0)
+					classSum += classifier.Classify(heldOutPart.Data[i]);
+				else if(type == 1)
+					classSum += classifier.Classify(heldOutPart.BinaryData[i]);
+				else if(type == 2)
+					classSum += quantizedClassifier.Classify(heldOutPart.Data[i]);
+				else
+					classSum += quantizedClassifier.Classify(heldOutPart.BinaryData[i]);
+				times[repetition * numberOfPatterns + i] = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e3;
+			}
+		sort(times.begin(), times.end());
+
+		high_resolution_clock::time_point start = high_resolution_clock::now();
+		for(int repetition=0; repetition<repetitions; repetition++)
+			for(int i=0; i<numberOfPatterns; i++)
+			{
+				if(type == 0)
+					classSum += classifier.Classify(heldOutPart.Data[i]);
+				else if(type == 1)
+					classSum += classifier.Classify(heldOutPart.BinaryData[i]);
+				else if(type == 2)
+					classSum += quantizedClassifier.Classify(heldOutPart.Data[i]);
+				else
+					classSum += quantizedClassifier.Classify(heldOutPart.BinaryData[i]);
+			}
+		double seconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e9;
+
+		cout << classifierNames[type] << ": held-out accuracy = " << (double)correctlyClassified / numberOfPatterns
+			 << ", same class as double = " << (double)sameAsDouble / numberOfPatterns << ", median latency = " << times[times.size() / 2]
+			 << " us, throughput = " << repetitions * numberOfPatterns / seconds << " patterns/s (class sum " << classSum << ")\n";
+	}
+}
+
+//<summary>
+//Trains the digit network on 'trainData' for 'numberOfEpochs' epochs with doubles, with floats and with floats whose sums
+//are added up in doubles, without batches and with batches of 64, starting from the same weights each time, and prints
+//the number of patterns processed per second and the error of the last epoch. The patterns are used as dense ones, since
+//the binary patterns aren't used with double sums. Then classifies the training patterns with the weights of the double
+//network, once converted to floats and once as doubles, and prints the time per pattern and how often the two agree.
+//</summary>
+//<param name='numberOfEpochs'>Number of times the network goes through all training patterns.</param>
+void benchmarkPrecision(int numberOfEpochs)
+{
+	int batchSizes[] = { 1, 64 };
+
+	srand(1);
+	NeuralNetworkTrainer<double> initialNetwork(NUMBER_OF_INPUT_NEURONS, NUMBER_OF_HIDDEN_NEURONS, NUMBER_OF_OUTPUT_NEURONS);
+	setRandomWeights(initialNetwork);
+
+	NeuralNetworkInput precisionData = trainData;
+	precisionData.BinaryData.clear();
+	precisionData.NumberOfThreads = 1;
+
+	NeuralNetworkTrainer<double> trainedNetwork = initialNetwork;
+	for(int size=0; size<2; size++)
+	{
+		precisionData.BatchSize = batchSizes[size];
+
+		double doubleError, floatError, floatWithDoubleSumsError;
+		NeuralNetworkTrainer<double> doubleNetwork = initialNetwork;
+		double doublePatternsPerSecond = trainWithPrecision(doubleNetwork, precisionData, numberOfEpochs, doubleError);
+
+		NeuralNetworkTrainer<float> floatNetwork(NUMBER_OF_INPUT_NEURONS, NUMBER_OF_HIDDEN_NEURONS, NUMBER_OF_OUTPUT_NEURONS);
+		floatNetwork.CopyWeights(initialNetwork);
+		double floatPatternsPerSecond = trainWithPrecision(floatNetwork, precisionData, numberOfEpochs, floatError);
+
+		precisionData.AccumulateInDouble = true;
+		floatNetwork.CopyWeights(initialNetwork);
+		double floatWithDoubleSumsPatternsPerSecond = trainWithPrecision(floatNetwork, precisionData, numberOfEpochs, floatWithDoubleSumsError);
+		precisionData.AccumulateInDouble = false;
+
+		cout << "batch size " << batchSizes[size] << ", error after " << numberOfEpochs << " epochs:\n";
+		cout << "  double: " << doublePatternsPerSecond << " patterns/s, error = " << doubleError << "\n";
+		cout << "  float: " << floatPatternsPerSecond << " patterns/s (" << floatPatternsPerSecond / doublePatternsPerSecond << "x), error = " << floatError << "\n";
+		cout << "  float with double sums: " << floatWithDoubleSumsPatternsPerSecond << " patterns/s (" << floatWithDoubleSumsPatternsPerSecond / doublePatternsPerSecond
+			 << "x), error = " << floatWithDoubleSumsError << "\n";
+
+		if(size == 0)
+			trainedNetwork = doubleNetwork;
+	}
+
+	NeuralNetworkClassifier<double> doubleClassifier(trainedNetwork);
+	NeuralNetworkClassifier<float> floatClassifier(trainedNetwork);
+	int numberOfPatterns = trainData.Data.size();
+	int sameClass = 0;
+	double maximumOutputDifference = 0.0;
+	for(int i=0; i<numberOfPatterns; i++)
+	{
+		if(doubleClassifier.Classify(trainData.Data[i]) == floatClassifier.Classify(trainData.Data[i]))
+			sameClass++;
+		for(int j=0; j<NUMBER_OF_OUTPUT_NEURONS; j++)
+			if(fabs(doubleClassifier.outputValues[j] - floatClassifier.outputValues[j]) > maximumOutputDifference)
+				maximumOutputDifference = fabs(doubleClassifier.outputValues[j] - floatClassifier.outputValues[j]);
+	}
+
+	const int repetitions = 20;
+	int classSum = 0;
+	high_resolution_clock::time_point start = high_resolution_clock::now();
+	for(int repetition=0; repetition<repetitions; repetition++)
+		for(int i=0; i<numberOfPatterns; i++)
+			classSum += doubleClassifier.Classify(trainData.Data[i]);
+	double doubleMicroseconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e3 / (repetitions * numberOfPatterns);
+
+	start = high_resolution_clock::now();
+	for(int repetition=0; repetition<repetitions; repetition++)
+		for(int i=0; i<numberOfPatterns; i++)
+			classSum += floatClassifier.Classify(trainData.Data[i]);
+	double floatMicroseconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e3 / (repetitions * numberOfPatterns);
+
+	cout << "classification with the weights of the double network: double " << doubleMicroseconds << " us, float " << floatMicroseconds
+		 << " us per pattern, same class = " << (double)sameClass / numberOfPatterns << ", largest output difference = " << maximumOutputDifference
+		 << " (class sum " << classSum << ")\n";
+}
+
+//<summary>
+//Compares the ways of calculating the logistic function: prints the largest difference from the exact function for
+//sums between -20 and 20 and the time per value with doubles and floats, and then trains the digit network with each of them
+//from the same weights until the error is at most 'targetError'. The accuracy of the trained networks is measured with
+//the exact function, so that it shows how good the weights are rather than how good the approximation is.
+//</summary>
+//<param name='targetError'>The error (half of the summed squared error of an epoch) at which the training stops.</param>
+//<param name='maximumNumberOfEpochs'>The training stops after this many epochs even if the error is higher.</param>
+void benchmarkLogistic(double targetError, int maximumNumberOfEpochs)
+{
+	int approximations[] = { LOGISTIC_EXACT, LOGISTIC_RATIONAL, LOGISTIC_TABLE };
+	const char* approximationNames[] = { "exact", "rational", "table" };
+
+	const int numberOfSums = 40 * 1024 + 1;
+	AlignedVector exactValues(numberOfSums), doubleValues(numberOfSums);
+	AlignedVectorOf<float>::Type floatValues(numberOfSums);
+	for(int i=0; i<numberOfSums; i++)
+		exactValues[i] = 1.0 / (1 + exp(-(i - numberOfSums / 2) / 1024.0));
+
+	const int repetitions = 200;
+	for(int type=0; type<3; type++)
+	{
+		double doubleError = 0.0, floatError = 0.0;
+		for(int i=0; i<numberOfSums; i++)
+		{
+			doubleValues[i] = (i - numberOfSums / 2) / 1024.0;
+			floatValues[i] = (float)doubleValues[i];
+		}
+		NeuralNetworkKernels::Logistic(&doubleValues[0], numberOfSums, approximations[type]);
+		NeuralNetworkKernels::Logistic(&floatValues[0], numberOfSums, approximations[type]);
+		for(int i=0; i<numberOfSums; i++)
+		{
+			if(fabs(doubleValues[i] - exactValues[i]) > doubleError)
+				doubleError = fabs(doubleValues[i] - exactValues[i]);
+			if(fabs(floatValues[i] - exactValues[i]) > floatError)
+				floatError = fabs(floatValues[i] - exactValues[i]);
+		}
+
+		//the values are replaced by the results, so each repetition calculates the function of values between 0 and 1
+		high_resolution_clock::time_point start = high_resolution_clock::now();
+		for(int repetition=0; repetition<repetitions; repetition++)
+			NeuralNetworkKernels::Logistic(&doubleValues[0], numberOfSums, approximations[type]);
+		double doubleNanoseconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / ((double)repetitions * numberOfSums);
+
+		start = high_resolution_clock::now();
+		for(int repetition=0; repetition<repetitions; repetition++)
+			NeuralNetworkKernels::Logistic(&floatValues[0], numberOfSums, approximations[type]);
+		double floatNanoseconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / ((double)repetitions * numberOfSums);
+
+		cout << approximationNames[type] << ": largest error = " << doubleError << " (double), " << floatError << " (float), time per value = "
+			 << doubleNanoseconds << " ns (double), " << floatNanoseconds << " ns (float) (checksum " << doubleValues[0] + floatValues[0] << ")\n";
+	}
+
+	srand(1);
+	NeuralNetworkTrainer<double> initialNetwork(NUMBER_OF_INPUT_NEURONS, NUMBER_OF_HIDDEN_NEURONS, NUMBER_OF_OUTPUT_NEURONS);
+	setRandomWeights(initialNetwork);
+
+	NeuralNetworkInput logisticData = trainData;
+	for(int type=0; type<3; type++)
+	{
+		NeuralNetworkTrainer<double> network = initialNetwork;
+		logisticData.LogisticApproximation = approximations[type];
+
+		double error = 0.0;
+		int epoch = 0;
+		high_resolution_clock::time_point start = high_resolution_clock::now();
+		while(epoch < maximumNumberOfEpochs)
+		{
+			error = network.TrainEpoch(logisticData) / 2.0;
+			epoch++;
+			if(error <= targetError)
+				break;
+		}
+		double seconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e9;
+
+		NeuralNetworkClassifier<double> classifier(network);
+		int correctlyClassified = 0;
+		for(unsigned int i=0; i<trainData.Data.size(); i++)
+			if(classifier.Classify(trainData.Data[i]) == getDesiredClass(trainData.ExpectedOutputs[i]))
+				correctlyClassified++;
+
+		cout << approximationNames[type] << ": " << epoch << " epochs, " << seconds << " s (" << seconds / epoch * 1000 << " ms per epoch), error = " << error
+			 << ", accuracy with the exact function = " << (double)correctlyClassified / trainData.Data.size() << "\n";
+	}
+}
+
+//<summary>
+//Converts the weights saved in the text files to a model file and prints the average time of creating a classifier from
+//the text files, from the model file with a copy of the weights and from the mapped model file, as well as the time per
+//pattern and how often the classifiers agree. Also saves random weights to a model file and checks that they are read back exactly.
+//</summary>
+//<param name='numberOfLoads'>Number of times each classifier is created.</param>
+void benchmarkModelFile(int numberOfLoads)
+{
+	const string modelFilename = "Converted Model.bin";
+	NeuralNetworkClassifier<double>::ConvertTextWeights(NUMBER_OF_INPUT_NEURONS, NUMBER_OF_HIDDEN_NEURONS, NUMBER_OF_OUTPUT_NEURONS, modelFilename);
+
+	//the sums of the output values are printed so that the compiler can't leave the loading out
+	double outputSum = 0.0;
+	high_resolution_clock::time_point start = high_resolution_clock::now();
+	for(int i=0; i<numberOfLoads; i++)
+	{
+		NeuralNetworkClassifier<double> classifier(NUMBER_OF_INPUT_NEURONS, NUMBER_OF_HIDDEN_NEURONS, NUMBER_OF_OUTPUT_NEURONS);
+		outputSum += classifier.outputWeights[0];
+	}
+	double textMicroseconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e3 / numberOfLoads;
+
+	start = high_resolution_clock::now();
+	for(int i=0; i<numberOfLoads; i++)
+	{
+		NeuralNetworkModel model(modelFilename);
+		NeuralNetworkClassifier<double> classifier(model);
+		outputSum += classifier.outputWeights[0];
+	}
+	double copyMicroseconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e3 / numberOfLoads;
+
+	start = high_resolution_clock::now();
+	for(int i=0; i<numberOfLoads; i++)
+	{
+		NeuralNetworkMappedClassifier<double> classifier(modelFilename);
+		outputSum += classifier.Classify(trainData.Data[0]);
+	}
+	double mappedMicroseconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e3 / numberOfLoads;
+
+	cout << "creating a classifier: text files " << textMicroseconds << " us, model file copied " << copyMicroseconds << " us, model file mapped (and one pattern classified) "
+		 << mappedMicroseconds << " us (sum " << outputSum << ")\n";
+
+	NeuralNetworkClassifier<double> textClassifier(NUMBER_OF_INPUT_NEURONS, NUMBER_OF_HIDDEN_NEURONS, NUMBER_OF_OUTPUT_NEURONS);
+	NeuralNetworkMappedClassifier<double> mappedClassifier(modelFilename);
+	NeuralNetworkModel model(modelFilename);
+	NeuralNetworkClassifier<float> floatClassifier(model);
+	int numberOfPatterns = trainData.Data.size();
+	int sameAsMapped = 0, sameAsFloat = 0;
+	for(int i=0; i<numberOfPatterns; i++)
+	{
+		int textClass = textClassifier.Classify(trainData.Data[i]);
+		if(mappedClassifier.Classify(trainData.Data[i]) == textClass)
+			sameAsMapped++;
+		if(floatClassifier.Classify(trainData.Data[i]) == textClass)
+			sameAsFloat++;
+	}
+
+	int classSum = 0;
+	start = high_resolution_clock::now();
+	for(int i=0; i<numberOfPatterns; i++)
+		classSum += textClassifier.Classify(trainData.Data[i]);
+	double textClassifierMicroseconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e3 / numberOfPatterns;
+	start = high_resolution_clock::now();
+	for(int i=0; i<numberOfPatterns; i++)
+		classSum += mappedClassifier.Classify(trainData.Data[i]);
+	double mappedClassifierMicroseconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e3 / numberOfPatterns;
+
+	cout << "same class as with the text files: mapped " << (double)sameAsMapped / numberOfPatterns << ", float copy " << (double)sameAsFloat / numberOfPatterns
+		 << "; time per pattern: text files " << textClassifierMicroseconds << " us, mapped " << mappedClassifierMicroseconds << " us (class sum " << classSum << ")\n";
+
+	srand(1);
+	NeuralNetworkTrainer<double> randomNetwork(NUMBER_OF_INPUT_NEURONS, NUMBER_OF_HIDDEN_NEURONS, NUMBER_OF_OUTPUT_NEURONS);
+	setRandomWeights(randomNetwork);
+	NeuralNetworkModel::Save(randomNetwork, modelFilename);
+	NeuralNetworkModel savedModel(modelFilename);
+	NeuralNetworkClassifier<double> savedClassifier(savedModel);
+	double largestDifference = 0.0;
+	for(unsigned int i=0; i<randomNetwork.hiddenWeights.size(); i++)
+		largestDifference = max(largestDifference, fabs(randomNetwork.hiddenWeights[i] - savedClassifier.hiddenWeights[i]));
+	for(unsigned int i=0; i<randomNetwork.outputWeights.size(); i++)
+		largestDifference = max(largestDifference, fabs(randomNetwork.outputWeights[i] - savedClassifier.outputWeights[i]));
+	cout << "largest difference between saved and loaded weights = " << largestDifference << "\n";
+}
+
+//<summary>
+//Trains 'network' on 'data' for 'numberOfEpochs' epochs.
+//</summary>
+//<param name='error'>Set to the error of the last epoch.</param>
+//<returns>The number of patterns processed per second.</returns>
+template <typename Scalar>
+double trainWithPrecision(NeuralNetworkTrainer<Scalar>& network, const NeuralNetworkInput& data, int numberOfEpochs, double& error)
+{
+	error = 0.0;
+	high_resolution_clock::time_point start = high_resolution_clock::now();
+	for(int epoch=0; epoch<numberOfEpochs; epoch++)
+		error = network.TrainEpoch(data) / 2.0;
+	double seconds = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e9;
+
+	return numberOfEpochs * data.Data.size() / seconds;
+}
+
+//<summary>
+//Returns the index of the expected output that is 1, i.e. the digit of a training pattern, or -1 if there is none.
+//</summary>
+int getDesiredClass(const vector<double>& expectedOutputs)
+{
+	for(unsigned int j=0; j<expectedOutputs.size(); j++)
+		if(fabs(expectedOutputs[j] - 1.0) < 0.005)
+			return j;
+	return -1;
+}
+
+//<summary>
+//Sets the weights of 'network' to random numbers between -0.05 and 0.05.
+//</summary>
+template <typename Scalar>
+void setRandomWeights(NeuralNetworkTrainer<Scalar>& network)
+{
+	for(int i=0; i<network.numberOfHiddenNeurons; i++)
+		for(int j=0; j<network.numberOfInputNeurons; j++)
+			network.hiddenWeights[i * network.inputStride + j] = (Scalar)(((double)rand() / RAND_MAX - 0.5) / 10.0);
+	for(int i=0; i<network.numberOfOutputNeurons; i++)
+		for(int j=0; j<network.numberOfHiddenNeurons; j++)
+			network.outputWeights[i * network.hiddenStride + j] = (Scalar)(((double)rand() / RAND_MAX - 0.5) / 10.0);
 }
\ No newline at end of file
@@ -1,101 +1,219 @@
 #ifndef NEURAL_NETWORK_BASE_H
 #define NEURAL_NETWORK_BASE_H
 
-#include "Neuron.h"
+#include "AlignedAllocator.h"
+#include "PatternView.h"
+#include "BinaryPattern.h"
+#include "NeuralNetworkKernels.h"
 #include "Constants.h"
 #include <vector>
+#include <cmath>
 #include <stddef.h>
 
 using std::vector;
 
+//<summary>
+//Network with one hidden layer. The weights of each layer are stored in a single row-major matrix with one row per neuron
+//of the layer, containing the weights of the connections from all neurons of the previous layer; the rows are padded with zeros
+//to a multiple of NEURAL_NETWORK_ALIGNMENT bytes, so each row starts aligned and each dot product reads consecutive memory.
+//The weights and the values of the neurons are of type 'Scalar', 'float' or 'double'; with floats, twice as many values fit
+//into a vector register and into the cache. The patterns and the expected outputs are always given as doubles.
+//</summary>
+template <typename Scalar>
 class NeuralNetworkBase
 {
 public:
+	typedef typename AlignedVectorOf<Scalar>::Type ScalarVector;
+
 	NeuralNetworkBase(int numberOfInputNeurons, int numberOfHiddenNeurons, int numberOfOutputNeurons);
 	~NeuralNetworkBase();
-	void FeedForward(vector<double> pattern);
+	void FeedForward(PatternView pattern);
+
+	//feeds a pattern of zeros and ones forward using 'inputWeights'; 'inputValues' are not changed
+	void FeedForward(const BinaryPattern& pattern);
+
+	//copies the hidden weights to 'inputWeights'; has to be called after the hidden weights change, before binary patterns are fed forward
+	void UpdateInputWeights();
+
+	//copies the weights of a network of the same size, converting them to 'Scalar' if the network uses another type
+	template <typename OtherScalar>
+	void CopyWeights(const NeuralNetworkBase<OtherScalar>& network);
+
+	//the weight of the connection from the input neuron 'j' to the hidden neuron 'i' is 'hiddenWeights[i * inputStride + j]'
+	ScalarVector hiddenWeights;
+
+	//the weight of the connection from the hidden neuron 'j' to the output neuron 'i' is 'outputWeights[i * hiddenStride + j]'
+	ScalarVector outputWeights;
 
-	vector<Neuron> inputNeurons;
-	vector<Neuron> hiddenNeurons;
-	vector<Neuron> outputNeurons;
+	//the hidden weights stored by input neurons: the weight of the connection from the input neuron 'i' to the hidden neuron 'j'
+	//is 'inputWeights[i * hiddenStride + j]', so the weights from a set input of a binary pattern to all hidden neurons form a row
+	ScalarVector inputWeights;
+
+	//indices of the set inputs of the last binary pattern that was fed forward
+	vector<int> activeInputs;
+	int numberOfActiveInputs;
+
+	//values of the neurons of each layer; the padding at the end is always zero
+	ScalarVector inputValues;
+	ScalarVector hiddenValues;
+	ScalarVector outputValues;
 
 	int numberOfInputNeurons;
 	int numberOfHiddenNeurons;
 	int numberOfOutputNeurons;
 
+	//number of values in a row of 'hiddenWeights' and 'outputWeights'
+	int inputStride;
+	int hiddenStride;
+
+	//if true, the sums of the neurons of a float network are added up in double precision by 'FeedForward(PatternView)'
+	//and by the batch training, which makes the sums as accurate as with doubles while the weights still take half the memory;
+	//the binary patterns are always added up in the precision of the network
+	bool accumulateInDouble;
+
+	//how the logistic function of the neurons is calculated, one of the 'LOGISTIC_' constants of 'NeuralNetworkKernels.h';
+	//LOGISTIC_EXACT by default
+	int logisticApproximation;
+
+protected:
+	//calculates the values of the output neurons from the values of the hidden neurons
+	void CalculateOutputValues();
+
+	//returns the dot product of two rows, added up in double precision if 'accumulateInDouble' is true
+	double SumOfProducts(const Scalar* first, const Scalar* second, int numberOfValues);
+
 private:
-	void InsertCurrentNetworkInput(vector<double> pattern);
-	double LogisticFunction(double x);
+	void InsertCurrentNetworkInput(PatternView pattern);
+	int GetAlignedStride(int numberOfValues);
 };
 
-NeuralNetworkBase::NeuralNetworkBase(int numberOfInputNeurons, int numberOfHiddenNeurons, int numberOfOutputNeurons)
+template <typename Scalar>
+NeuralNetworkBase<Scalar>::NeuralNetworkBase(int numberOfInputNeurons, int numberOfHiddenNeurons, int numberOfOutputNeurons)
 {
 	this->numberOfInputNeurons = numberOfInputNeurons;
 	this->numberOfHiddenNeurons = numberOfHiddenNeurons;
 	this->numberOfOutputNeurons = numberOfOutputNeurons;
 
-	for(int i=0; i<this->numberOfInputNeurons; i++)
-	{
-		Neuron newNeuron;
-		for(int j=0; j<this->numberOfHiddenNeurons; j++)
-			newNeuron.Weights.push_back(0.0);
-		this->inputNeurons.push_back(newNeuron);
-	}
+	this->inputStride = this->GetAlignedStride(numberOfInputNeurons);
+	this->hiddenStride = this->GetAlignedStride(numberOfHiddenNeurons);
 
-	for(int i=0; i<this->numberOfHiddenNeurons; i++)
-	{
-		Neuron newNeuron;
-		for(int j=0; j<this->numberOfOutputNeurons; j++)
-			newNeuron.Weights.push_back(0.0);
-		this->hiddenNeurons.push_back(newNeuron);
-	}
+	this->hiddenWeights.assign(this->numberOfHiddenNeurons * this->inputStride, 0);
+	this->outputWeights.assign(this->numberOfOutputNeurons * this->hiddenStride, 0);
 
-	for(int i=0; i<this->numberOfOutputNeurons; i++)
-	{
-		Neuron newNeuron;
-		this->outputNeurons.push_back(newNeuron);
-	}
+	this->inputValues.assign(this->inputStride, 0);
+	this->hiddenValues.assign(this->hiddenStride, 0);
+	this->outputValues.assign(this->numberOfOutputNeurons, 0);
+
+	this->inputWeights.assign(this->numberOfInputNeurons * this->hiddenStride, 0);
+	this->activeInputs.assign(BINARY_PATTERN_BITS, 0);
+	this->numberOfActiveInputs = 0;
+
+	this->accumulateInDouble = false;
+	this->logisticApproximation = LOGISTIC_EXACT;
 }
 
-NeuralNetworkBase::~NeuralNetworkBase()
+template <typename Scalar>
+NeuralNetworkBase<Scalar>::~NeuralNetworkBase()
 {
-	//delete [] this->inputNeurons;
-	//delete [] this->hiddenNeurons;
-	//delete [] this->outputNeurons;
 }
 
-void NeuralNetworkBase::FeedForward(vector<double> pattern)
+template <typename Scalar>
+void NeuralNetworkBase<Scalar>::FeedForward(PatternView pattern)
 {
 	this->InsertCurrentNetworkInput(pattern);
 
-	double result;
+	//the padding of the rows and of the values is zero, so the dot products can run over the whole rows;
+	//the logistic function is applied to all sums at once, so that the approximations are calculated with vector instructions
+	for(int i=0; i<this->numberOfHiddenNeurons; i++)
+		this->hiddenValues[i] = (Scalar)this->SumOfProducts(&this->hiddenWeights[i * this->inputStride], &this->inputValues[0], this->inputStride);
+	NeuralNetworkKernels::Logistic(&this->hiddenValues[0], this->numberOfHiddenNeurons, this->logisticApproximation);
+
+	this->CalculateOutputValues();
+}
+
+//<summary>
+//Feeds a binary pattern forward. The inputs are 0 or 1, so the sum of a hidden neuron is the sum of its weights from
+//the set inputs; the rows of 'inputWeights' of the set inputs are added, which calculates the sums of all hidden neurons
+//at once and skips the inputs that are 0. With the scalar kernels, the sums are the same as with 'FeedForward(PatternView)'.
+//</summary>
+//<param name='pattern'>A pattern with at most 'numberOfInputNeurons' values.</param>
+template <typename Scalar>
+void NeuralNetworkBase<Scalar>::FeedForward(const BinaryPattern& pattern)
+{
+	this->numberOfActiveInputs = pattern.GetSetBits(&this->activeInputs[0]);
+
+	for(int i=0; i<this->hiddenStride; i++)
+		this->hiddenValues[i] = 0;
+	for(int i=0; i<this->numberOfActiveInputs; i++)
+		NeuralNetworkKernels::AddScaled(&this->hiddenValues[0], &this->inputWeights[this->activeInputs[i] * this->hiddenStride], (Scalar)1, this->hiddenStride);
+
+	NeuralNetworkKernels::Logistic(&this->hiddenValues[0], this->numberOfHiddenNeurons, this->logisticApproximation);
+
+	this->CalculateOutputValues();
+}
+
+template <typename Scalar>
+void NeuralNetworkBase<Scalar>::UpdateInputWeights()
+{
 	for(int i=0; i<this->numberOfHiddenNeurons; i++)
-	{
-		result = 0.0;
 		for(int j=0; j<this->numberOfInputNeurons; j++)
-			result = result + (this->inputNeurons[j].Value * this->inputNeurons[j].Weights[i]);
-		this->hiddenNeurons[i].Value = this->LogisticFunction(result);
-	}
+			this->inputWeights[j * this->hiddenStride + i] = this->hiddenWeights[i * this->inputStride + j];
+}
+
+//<summary>
+//Copies the weights of 'network', e.g. for classifying with floats after training with doubles. The rows of the two networks
+//can have different strides, since the number of values in NEURAL_NETWORK_ALIGNMENT bytes depends on the type.
+//</summary>
+//<param name='network'>A network with the same numbers of neurons.</param>
+template <typename Scalar>
+template <typename OtherScalar>
+void NeuralNetworkBase<Scalar>::CopyWeights(const NeuralNetworkBase<OtherScalar>& network)
+{
+	if(network.numberOfInputNeurons != this->numberOfInputNeurons || network.numberOfHiddenNeurons != this->numberOfHiddenNeurons
+	   || network.numberOfOutputNeurons != this->numberOfOutputNeurons)
+		throw "Different network sizes";
 
+	for(int i=0; i<this->numberOfHiddenNeurons; i++)
+		for(int j=0; j<this->numberOfInputNeurons; j++)
+			this->hiddenWeights[i * this->inputStride + j] = (Scalar)network.hiddenWeights[i * network.inputStride + j];
 	for(int i=0; i<this->numberOfOutputNeurons; i++)
-	{
-		result = 0.0;
 		for(int j=0; j<this->numberOfHiddenNeurons; j++)
-			result = result + (this->hiddenNeurons[j].Value * this->hiddenNeurons[j].Weights[i]);
-		this->outputNeurons[i].Value = this->LogisticFunction(result);
-	}
+			this->outputWeights[i * this->hiddenStride + j] = (Scalar)network.outputWeights[i * network.hiddenStride + j];
+
+	this->UpdateInputWeights();
 }
 
-void NeuralNetworkBase::InsertCurrentNetworkInput(vector<double> pattern)
+template <typename Scalar>
+void NeuralNetworkBase<Scalar>::CalculateOutputValues()
 {
-	for(unsigned int i=0; i<this->numberOfInputNeurons; i++)
-		this->inputNeurons[i].Value = pattern[i];
+	for(int i=0; i<this->numberOfOutputNeurons; i++)
+		this->outputValues[i] = (Scalar)this->SumOfProducts(&this->outputWeights[i * this->hiddenStride], &this->hiddenValues[0], this->hiddenStride);
+	NeuralNetworkKernels::Logistic(&this->outputValues[0], this->numberOfOutputNeurons, this->logisticApproximation);
+}
+
+template <typename Scalar>
+double NeuralNetworkBase<Scalar>::SumOfProducts(const Scalar* first, const Scalar* second, int numberOfValues)
+{
+	if(this->accumulateInDouble)
+		return NeuralNetworkKernels::DotProductDoubleSum(first, second, numberOfValues);
+	return NeuralNetworkKernels::DotProduct(first, second, numberOfValues);
+}
+
+template <typename Scalar>
+void NeuralNetworkBase<Scalar>::InsertCurrentNetworkInput(PatternView pattern)
+{
+	for(int i=0; i<this->numberOfInputNeurons; i++)
+		this->inputValues[i] = (Scalar)pattern[i];
 }
 
-double NeuralNetworkBase::LogisticFunction(double x)
+//<summary>
+//Returns 'numberOfValues' rounded up to a multiple of the number of values of type 'Scalar' in NEURAL_NETWORK_ALIGNMENT bytes.
+//</summary>
+template <typename Scalar>
+int NeuralNetworkBase<Scalar>::GetAlignedStride(int numberOfValues)
 {
-	double result = 1.0 / (1 + exp(-x));
-	return result;
+	int valuesPerBlock = NEURAL_NETWORK_ALIGNMENT / sizeof(Scalar);
+	return (numberOfValues + valuesPerBlock - 1) / valuesPerBlock * valuesPerBlock;
 }
 
 #endif
\ No newline at end of file
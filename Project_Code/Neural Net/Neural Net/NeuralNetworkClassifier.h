@@ -2,6 +2,7 @@
 #define NEURAL_NETWORK_CLASSIFIER_H
 
 #include "NeuralNetworkBase.h"
+#include "NeuralNetworkModel.h"
 #include <fstream>
 #include <string>
 #include <vector>
@@ -12,38 +13,104 @@ using std::ifstream;
 using std::string;
 using std::stringstream;
 
-class NeuralNetworkClassifier : public NeuralNetworkBase
+//<summary>
+//Classifies patterns with the saved weights or with the weights of a trained network. The weights are floats by default,
+//which is accurate enough for classifying; the weights saved by a network of either type can be used with both types,
+//from the text files or from a model file.
+//</summary>
+template <typename Scalar = float>
+class NeuralNetworkClassifier : public NeuralNetworkBase<Scalar>
 {
 public:
 	NeuralNetworkClassifier(int numberOfInputNeurons, int numberOfHiddenNeurons, int numberOfOutputNeurons);
-	int Classify(vector<double> pattern);
+
+	//uses the weights of 'network' instead of the saved ones, e.g. for evaluating a network right after training;
+	//the weights are converted if 'network' uses another type
+	template <typename OtherScalar>
+	NeuralNetworkClassifier(const NeuralNetworkBase<OtherScalar>& network);
+
+	//copies the weights of a model file, converting them if the file uses another type
+	NeuralNetworkClassifier(const NeuralNetworkModel& model);
+
+	//writes the weights of the text files to the model file 'modelFilename', with weights of type 'Scalar'
+	static void ConvertTextWeights(int numberOfInputNeurons, int numberOfHiddenNeurons, int numberOfOutputNeurons, const string& modelFilename);
+
+	int Classify(PatternView pattern);
+
+	//classifies a pattern of zeros and ones, e.g. the pixels of an image, using only its set values
+	int Classify(const BinaryPattern& pattern);
 
 private:
+	int GetMaximumOutputNeuron();
 	void LoadHiddenWeights();
 	void LoadOutputWeights();
 };
 
 
-NeuralNetworkClassifier::NeuralNetworkClassifier(int numberOfInputNeurons, int numberOfHiddenNeurons, int numberOfOutputNeurons)
-	: NeuralNetworkBase(numberOfInputNeurons, numberOfHiddenNeurons, numberOfOutputNeurons)
+template <typename Scalar>
+NeuralNetworkClassifier<Scalar>::NeuralNetworkClassifier(int numberOfInputNeurons, int numberOfHiddenNeurons, int numberOfOutputNeurons)
+	: NeuralNetworkBase<Scalar>(numberOfInputNeurons, numberOfHiddenNeurons, numberOfOutputNeurons)
 {
 	this->LoadHiddenWeights();
 	this->LoadOutputWeights();
+	this->UpdateInputWeights();
+}
+
+template <typename Scalar>
+template <typename OtherScalar>
+NeuralNetworkClassifier<Scalar>::NeuralNetworkClassifier(const NeuralNetworkBase<OtherScalar>& network)
+	: NeuralNetworkBase<Scalar>(network.numberOfInputNeurons, network.numberOfHiddenNeurons, network.numberOfOutputNeurons)
+{
+	this->CopyWeights(network);
+}
+
+template <typename Scalar>
+NeuralNetworkClassifier<Scalar>::NeuralNetworkClassifier(const NeuralNetworkModel& model)
+	: NeuralNetworkBase<Scalar>(model.Header.NumberOfInputNeurons, model.Header.NumberOfHiddenNeurons, model.Header.NumberOfOutputNeurons)
+{
+	model.CopyWeights(*this);
 }
 
+//<summary>
+//Converts the weights saved in the text files by an older version of the program to a model file.
+//</summary>
+//<param name='modelFilename'>The name of the model file that is written.</param>
+template <typename Scalar>
+void NeuralNetworkClassifier<Scalar>::ConvertTextWeights(int numberOfInputNeurons, int numberOfHiddenNeurons, int numberOfOutputNeurons, const string& modelFilename)
+{
+	NeuralNetworkClassifier<Scalar> classifier(numberOfInputNeurons, numberOfHiddenNeurons, numberOfOutputNeurons);
+	NeuralNetworkModel::Save(classifier, modelFilename);
+}
+
+
+template <typename Scalar>
+int NeuralNetworkClassifier<Scalar>::Classify(PatternView pattern)
+{
+	this->FeedForward(pattern);
+	return this->GetMaximumOutputNeuron();
+}
 
-int NeuralNetworkClassifier::Classify(vector<double> pattern)
+template <typename Scalar>
+int NeuralNetworkClassifier<Scalar>::Classify(const BinaryPattern& pattern)
 {
 	this->FeedForward(pattern);
+	return this->GetMaximumOutputNeuron();
+}
 
+//<summary>
+//Returns the index of the output neuron with the highest value after a pattern was fed forward.
+//</summary>
+template <typename Scalar>
+int NeuralNetworkClassifier<Scalar>::GetMaximumOutputNeuron()
+{
 	int maxClass = 0;
-	double maxValue = this->outputNeurons[0].Value;
+	Scalar maxValue = this->outputValues[0];
 
 	for(int i=1; i<this->numberOfOutputNeurons; i++)
 	{
-		if(maxValue < this->outputNeurons[i].Value)
+		if(maxValue < this->outputValues[i])
 		{
-			maxValue = this->outputNeurons[i].Value;
+			maxValue = this->outputValues[i];
 			maxClass = i;
 		}
 	}
@@ -51,7 +118,8 @@ int NeuralNetworkClassifier::Classify(vector<double> pattern)
 	return maxClass;
 }
 
-void NeuralNetworkClassifier::LoadHiddenWeights()
+template <typename Scalar>
+void NeuralNetworkClassifier<Scalar>::LoadHiddenWeights()
 {
 	//stream for reading data from the file
 	ifstream document;
@@ -78,10 +146,10 @@ void NeuralNetworkClassifier::LoadHiddenWeights()
 
 			getline(document,lineReader);
 
-			//we make sure that the file does not contain letters
+			//we make sure that the file does not contain letters other than the exponents of small weights, e.g. '5.9e-05'
 			for(unsigned int character=0; character<lineReader.size(); character++)
 			{
-				if(isalpha(lineReader[character]))
+				if(isalpha(lineReader[character]) && lineReader[character] != 'e' && lineReader[character] != 'E')
 					throw "Wrong format";
 			}
 
@@ -102,7 +170,7 @@ void NeuralNetworkClassifier::LoadHiddenWeights()
 				{
 					converter << lineReader.substr(delimiterIndex, i-delimiterIndex);
 					converter >> tempNumber;
-					this->inputNeurons[neuronCounter].Weights[weightCounter] = tempNumber;
+					this->hiddenWeights[weightCounter * this->inputStride + neuronCounter] = (Scalar)tempNumber;
 					weightCounter++;
 
 					delimiterIndex = i+1;
@@ -122,7 +190,7 @@ void NeuralNetworkClassifier::LoadHiddenWeights()
 			converter << lineReader.substr(delimiterIndex, lineReader.size()-delimiterIndex);
 			converter >> tempNumber;
 			converter.clear();
-			this->inputNeurons[neuronCounter].Weights[weightCounter] = tempNumber;
+			this->hiddenWeights[weightCounter * this->inputStride + neuronCounter] = (Scalar)tempNumber;
 
 			neuronCounter++;
 		}
@@ -139,7 +207,8 @@ void NeuralNetworkClassifier::LoadHiddenWeights()
 	}
 }
 
-void NeuralNetworkClassifier::LoadOutputWeights()
+template <typename Scalar>
+void NeuralNetworkClassifier<Scalar>::LoadOutputWeights()
 {
 	//stream for reading data from the file
 	ifstream document;
@@ -166,10 +235,10 @@ void NeuralNetworkClassifier::LoadOutputWeights()
 
 			getline(document,lineReader);
 
-			//we make sure that the file does not contain letters
+			//we make sure that the file does not contain letters other than the exponents of small weights, e.g. '5.9e-05'
 			for(unsigned int character=0; character<lineReader.size(); character++)
 			{
-				if(isalpha(lineReader[character]))
+				if(isalpha(lineReader[character]) && lineReader[character] != 'e' && lineReader[character] != 'E')
 					throw "Wrong format";
 			}
 
@@ -190,7 +259,7 @@ void NeuralNetworkClassifier::LoadOutputWeights()
 				{
 					converter << lineReader.substr(delimiterIndex, i-delimiterIndex);
 					converter >> tempNumber;
-					this->hiddenNeurons[neuronCounter].Weights[weightCounter] = tempNumber;
+					this->outputWeights[weightCounter * this->hiddenStride + neuronCounter] = (Scalar)tempNumber;
 					weightCounter++;
 
 					delimiterIndex = i+1;
@@ -210,7 +279,7 @@ void NeuralNetworkClassifier::LoadOutputWeights()
 			converter << lineReader.substr(delimiterIndex, lineReader.size()-delimiterIndex);
 			converter >> tempNumber;
 			converter.clear();
-			this->hiddenNeurons[neuronCounter].Weights[weightCounter] = tempNumber;
+			this->outputWeights[weightCounter * this->hiddenStride + neuronCounter] = (Scalar)tempNumber;
 
 			neuronCounter++;
 		}
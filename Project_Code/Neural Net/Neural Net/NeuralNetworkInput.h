@@ -1,6 +1,8 @@
 #ifndef NEURAL_NETWORK_INPUT_H
 #define NEURAL_NETWORK_INPUT_H
 
+#include "BinaryPattern.h"
+#include "NeuralNetworkKernels.h"
 #include <vector>
 using std::vector;
 
@@ -11,6 +13,60 @@ struct NeuralNetworkInput
 	double LearningRate;
 	double ErrorThreshold;
 	int NumberOfMaximumIterations;
+
+	//number of patterns whose weight corrections are added up before the weights are changed; with 1, the weights are
+	//corrected after each pattern, otherwise the patterns of a batch are processed with matrix-matrix products
+	int BatchSize;
+
+	//number of threads used for training; each batch is divided between the threads, so the batch size should be
+	//at least the number of threads
+	int NumberOfThreads;
+
+	//if true, each thread trains on its own part of the patterns and corrects the weights without waiting for the other
+	//threads (Hogwild); faster, but the result depends on the timing of the threads, and the unsynchronized access to the
+	//weights is only safe on platforms that don't tear loads and stores of the weights (see 'NeuralNetworkTrainer::TrainEpochs')
+	bool Hogwild;
+
+	//if true, a network with float weights adds up the sums of its neurons in double precision; the weights, the values
+	//and the corrections stay floats. Has no effect on networks with double weights
+	bool AccumulateInDouble;
+
+	//how the logistic function of the neurons is calculated during the training, one of the 'LOGISTIC_' constants
+	int LogisticApproximation;
+
+	//the patterns of 'Data' stored as bits; filled by 'PackBinaryData' if all patterns are binary, in which case
+	//the training on single patterns only uses the set inputs
+	vector<BinaryPattern> BinaryData;
+
+	NeuralNetworkInput();
+
+	//fills 'BinaryData' if all values of all patterns are 0 or 1; returns false (and clears 'BinaryData') otherwise
+	bool PackBinaryData();
 };
 
+//<summary>
+//Default constructor; the weights are corrected after each pattern on a single thread, in the precision of the network,
+//with the exact logistic function.
+//</summary>
+NeuralNetworkInput::NeuralNetworkInput()
+{
+	this->BatchSize = 1;
+	this->NumberOfThreads = 1;
+	this->Hogwild = false;
+	this->AccumulateInDouble = false;
+	this->LogisticApproximation = LOGISTIC_EXACT;
+}
+
+bool NeuralNetworkInput::PackBinaryData()
+{
+	this->BinaryData.clear();
+	for(unsigned int i=0; i<this->Data.size(); i++)
+		if(!BinaryPattern::IsBinary(this->Data[i]))
+			return false;
+
+	for(unsigned int i=0; i<this->Data.size(); i++)
+		this->BinaryData.push_back(BinaryPattern(this->Data[i]));
+	return true;
+}
+
 #endif
\ No newline at end of file
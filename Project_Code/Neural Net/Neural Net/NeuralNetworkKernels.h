@@ -0,0 +1,1534 @@
+#ifndef NEURAL_NETWORK_KERNELS_H
+#define NEURAL_NETWORK_KERNELS_H
+
+//the vector kernels are only compiled for x86 processors; AVX-512 intrinsics need at least Visual Studio 2017.
+//The AVX-512 kernels use the foundation instructions and the byte and word instructions (AVX-512BW) of the integer dot product
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define NEURAL_NETWORK_AVX2
+#if !defined(_MSC_VER) || _MSC_VER >= 1910
+#define NEURAL_NETWORK_AVX512
+#endif
+#endif
+
+#include <cmath>
+
+#ifdef NEURAL_NETWORK_AVX2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+//Visual Studio allows the intrinsics of any instruction set in any function, while gcc and clang
+//only allow them in functions compiled for that instruction set
+#if defined(NEURAL_NETWORK_AVX2) && !defined(_MSC_VER)
+#define NEURAL_NETWORK_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define NEURAL_NETWORK_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#else
+#define NEURAL_NETWORK_TARGET_AVX2
+#define NEURAL_NETWORK_TARGET_AVX512
+#endif
+
+//instruction sets that can be used by the kernels
+const int KERNELS_SCALAR = 0;
+const int KERNELS_AVX2 = 1;
+const int KERNELS_AVX512 = 2;
+
+//the matrix products calculate blocks of 2 rows x 4 columns of the result at a time, so that each value that is loaded
+//is used for several results; the columns are processed in groups whose rows fit into KERNELS_BLOCK_BYTES of cache
+const int KERNELS_TILE_ROWS = 2;
+const int KERNELS_TILE_COLUMNS = 4;
+const int KERNELS_BLOCK_BYTES = 128 * 1024;
+
+//ways of calculating the logistic function of the neurons:
+//	- LOGISTIC_EXACT calls 'exp' for each value, in double precision.
+//	- LOGISTIC_RATIONAL uses the continued fraction of tanh with terms up to x^7 / x^6, since 1 / (1 + exp(-x)) = (1 + tanh(x / 2)) / 2;
+//	  the arguments are limited to +-LOGISTIC_RATIONAL_LIMIT, where the fraction is closest to 1. The largest error is 3.6e-5.
+//	- LOGISTIC_TABLE interpolates linearly between LOGISTIC_TABLE_STEPS values per unit between -LOGISTIC_TABLE_RANGE
+//	  and LOGISTIC_TABLE_RANGE; outside of that range the result is the end of the table. The largest error is 3e-6.
+//With floats, the rounding of the float results adds up to 6e-8 to the errors of the approximations.
+const int LOGISTIC_EXACT = 0;
+const int LOGISTIC_RATIONAL = 1;
+const int LOGISTIC_TABLE = 2;
+
+const double LOGISTIC_RATIONAL_LIMIT = 9.58;
+const int LOGISTIC_TABLE_RANGE = 16;
+const int LOGISTIC_TABLE_STEPS = 64;
+const int LOGISTIC_TABLE_SIZE = 2 * LOGISTIC_TABLE_RANGE * LOGISTIC_TABLE_STEPS + 1;
+
+//<summary>
+//Pointers to the kernels of one scalar type ('float' or 'double') selected for the processor; see 'NeuralNetworkKernels'.
+//</summary>
+template <typename Scalar>
+struct KernelFunctions
+{
+	Scalar (*DotProduct)(const Scalar* first, const Scalar* second, int numberOfValues);
+	void (*AddScaled)(Scalar* destination, const Scalar* source, Scalar scale, int numberOfValues);
+	void (*LogisticDeltas)(const Scalar* values, const Scalar* errors, Scalar* deltas, int numberOfValues);
+	void (*LogisticRational)(Scalar* values, int numberOfValues);
+	void (*LogisticTable)(Scalar* values, int numberOfValues);
+	void (*DotProductTile)(const Scalar* first, int firstStride, const Scalar* second, int secondStride, Scalar* result, int resultStride, int numberOfValues);
+	void (*AddProductsTile)(const Scalar* coefficients, int coefficientRowStride, int coefficientStride, const Scalar* rows, int rowStride, int numberOfRows,
+							Scalar* result, int resultStride, int numberOfValues, Scalar scale);
+};
+
+//<summary>
+//Vector operations used by the forward and backward passes, with a scalar version and versions for AVX2 (with FMA)
+//and AVX-512, for 'double' and 'float' values. The best version supported by the processor and the operating system is selected
+//when the program starts; 'Select' can be used for choosing another one, e.g. for comparing the versions. Each operation is
+//overloaded for both scalar types, so the network templates call the kernels of their type. All kernels accept any number of values,
+//but the network passes the padded lengths of its rows, so the vector loops don't have to handle remainders.
+//</summary>
+class NeuralNetworkKernels
+{
+public:
+	//returns the best instruction set supported by the processor and the operating system
+	static int GetBestInstructionSet();
+
+	//selects the kernels for 'instructionSet'; returns false (and keeps the current kernels) if it is not supported
+	static bool Select(int instructionSet);
+
+	//fills the tables of LOGISTIC_TABLE; called before 'main'
+	static bool FillLogisticTables();
+
+	//returns the sum of 'first[i] * second[i]'
+	static double DotProduct(const double* first, const double* second, int numberOfValues) { return DoubleKernels.DotProduct(first, second, numberOfValues); }
+	static float DotProduct(const float* first, const float* second, int numberOfValues) { return FloatKernels.DotProduct(first, second, numberOfValues); }
+
+	//returns the sum of 'first[i] * second[i]' added up in double precision; the products of floats are exact in double precision
+	static double DotProductDoubleSum(const double* first, const double* second, int numberOfValues) { return DoubleKernels.DotProduct(first, second, numberOfValues); }
+	static double DotProductDoubleSum(const float* first, const float* second, int numberOfValues) { return FloatDotProductDoubleSum(first, second, numberOfValues); }
+
+	//returns the sum of 'values[i] * weights[i]'; the values have to be at most 127, so that the sums of two products fit into 16 bits
+	static int (*DotProductInt8)(const unsigned char* values, const signed char* weights, int numberOfValues);
+
+	//adds 'scale * source[i]' to 'destination[i]'; used for the rank-one weight updates and for the transposed products
+	static void AddScaled(double* destination, const double* source, double scale, int numberOfValues) { DoubleKernels.AddScaled(destination, source, scale, numberOfValues); }
+	static void AddScaled(float* destination, const float* source, float scale, int numberOfValues) { FloatKernels.AddScaled(destination, source, scale, numberOfValues); }
+
+	//replaces the sums of the neurons in 'values' with the logistic function of the sums, calculated with 'approximation' (one of the 'LOGISTIC_' constants)
+	static void Logistic(double* values, int numberOfValues, int approximation) { ApplyLogistic(DoubleKernels, values, numberOfValues, approximation); }
+	static void Logistic(float* values, int numberOfValues, int approximation) { ApplyLogistic(FloatKernels, values, numberOfValues, approximation); }
+
+	//sets 'deltas[i]' to 'values[i] * (1 - values[i]) * errors[i]', i.e. multiplies the errors by the derivative of the logistic function
+	static void LogisticDeltas(const double* values, const double* errors, double* deltas, int numberOfValues) { DoubleKernels.LogisticDeltas(values, errors, deltas, numberOfValues); }
+	static void LogisticDeltas(const float* values, const float* errors, float* deltas, int numberOfValues) { FloatKernels.LogisticDeltas(values, errors, deltas, numberOfValues); }
+
+	//calculates a 2x4 block of dot products between two rows of 'first' and four rows of 'second'
+	static void DotProductTile(const double* first, int firstStride, const double* second, int secondStride, double* result, int resultStride, int numberOfValues)
+	{
+		DoubleKernels.DotProductTile(first, firstStride, second, secondStride, result, resultStride, numberOfValues);
+	}
+	static void DotProductTile(const float* first, int firstStride, const float* second, int secondStride, float* result, int resultStride, int numberOfValues)
+	{
+		FloatKernels.DotProductTile(first, firstStride, second, secondStride, result, resultStride, numberOfValues);
+	}
+
+	//adds 'scale * coefficients[i * coefficientRowStride + k * coefficientStride] * rows[k][j]' to 'result[i][j]' for two rows 'i' of the result
+	static void AddProductsTile(const double* coefficients, int coefficientRowStride, int coefficientStride, const double* rows, int rowStride, int numberOfRows,
+								double* result, int resultStride, int numberOfValues, double scale)
+	{
+		DoubleKernels.AddProductsTile(coefficients, coefficientRowStride, coefficientStride, rows, rowStride, numberOfRows, result, resultStride, numberOfValues, scale);
+	}
+	static void AddProductsTile(const float* coefficients, int coefficientRowStride, int coefficientStride, const float* rows, int rowStride, int numberOfRows,
+								float* result, int resultStride, int numberOfValues, float scale)
+	{
+		FloatKernels.AddProductsTile(coefficients, coefficientRowStride, coefficientStride, rows, rowStride, numberOfRows, result, resultStride, numberOfValues, scale);
+	}
+
+	//sets 'result' to the product of 'first' and the transposed 'second' (the dot products of all pairs of rows);
+	//with 'doubleSums', each dot product is added up in double precision
+	template <typename Scalar>
+	static void MultiplyTransposed(const Scalar* first, int firstStride, int numberOfFirstRows, const Scalar* second, int secondStride, int numberOfSecondRows,
+								   Scalar* result, int resultStride, int numberOfValues, bool doubleSums);
+
+	//adds the product of 'first' and 'second' multiplied by 'scale' to 'result'
+	template <typename Scalar>
+	static void MultiplyAdd(const Scalar* first, int firstStride, int numberOfFirstRows, int numberOfFirstColumns, const Scalar* second, int secondStride,
+							Scalar* result, int resultStride, int numberOfValues, Scalar scale);
+
+	//adds the product of the transposed 'first' and 'second' multiplied by 'scale' to 'result'
+	template <typename Scalar>
+	static void MultiplyTransposedAdd(const Scalar* first, int firstStride, int numberOfFirstColumns, const Scalar* second, int secondStride, int numberOfRows,
+									  Scalar* result, int resultStride, int numberOfValues, Scalar scale);
+
+	//the instruction set of the selected kernels
+	static int InstructionSet;
+
+private:
+	static KernelFunctions<double> DoubleKernels;
+	static KernelFunctions<float> FloatKernels;
+	static double (*FloatDotProductDoubleSum)(const float* first, const float* second, int numberOfValues);
+
+	//the values of the logistic function used by LOGISTIC_TABLE, filled when the program starts
+	static double DoubleLogisticTable[LOGISTIC_TABLE_SIZE];
+	static float FloatLogisticTable[LOGISTIC_TABLE_SIZE];
+	static const double* GetLogisticTable(double) { return DoubleLogisticTable; }
+	static const float* GetLogisticTable(float) { return FloatLogisticTable; }
+
+	template <typename Scalar>
+	static void ApplyLogistic(const KernelFunctions<Scalar>& kernels, Scalar* values, int numberOfValues, int approximation);
+
+	template <typename Scalar>
+	static Scalar DotProductScalar(const Scalar* first, const Scalar* second, int numberOfValues);
+	static double DotProductDoubleSumScalar(const float* first, const float* second, int numberOfValues);
+	static int DotProductInt8Scalar(const unsigned char* values, const signed char* weights, int numberOfValues);
+	template <typename Scalar>
+	static void AddScaledScalar(Scalar* destination, const Scalar* source, Scalar scale, int numberOfValues);
+	template <typename Scalar>
+	static void LogisticDeltasScalar(const Scalar* values, const Scalar* errors, Scalar* deltas, int numberOfValues);
+	template <typename Scalar>
+	static void LogisticExactScalar(Scalar* values, int numberOfValues);
+	template <typename Scalar>
+	static void LogisticRationalScalar(Scalar* values, int numberOfValues);
+	template <typename Scalar>
+	static void LogisticTableScalar(Scalar* values, int numberOfValues);
+
+	//the approximations of a single value, also used for the values after the last full vector
+	template <typename Scalar>
+	static Scalar LogisticRationalValue(Scalar x);
+	template <typename Scalar>
+	static Scalar LogisticTableValue(Scalar x);
+	template <typename Scalar>
+	static void DotProductTileScalar(const Scalar* first, int firstStride, const Scalar* second, int secondStride, Scalar* result, int resultStride, int numberOfValues);
+	template <typename Scalar>
+	static void AddProductsTileScalar(const Scalar* coefficients, int coefficientRowStride, int coefficientStride, const Scalar* rows, int rowStride, int numberOfRows,
+									  Scalar* result, int resultStride, int numberOfValues, Scalar scale);
+
+	//the products used by 'MultiplyAdd' and 'MultiplyTransposedAdd'
+	template <typename Scalar>
+	static void AddProducts(const Scalar* coefficients, int coefficientRowStride, int coefficientStride, int numberOfResultRows, const Scalar* rows, int rowStride, int numberOfRows,
+							Scalar* result, int resultStride, int numberOfValues, Scalar scale);
+
+#ifdef NEURAL_NETWORK_AVX2
+	NEURAL_NETWORK_TARGET_AVX2 static double DotProductAvx2(const double* first, const double* second, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX2 static float DotProductAvx2(const float* first, const float* second, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX2 static double DotProductDoubleSumAvx2(const float* first, const float* second, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX2 static int DotProductInt8Avx2(const unsigned char* values, const signed char* weights, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX2 static void AddScaledAvx2(double* destination, const double* source, double scale, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX2 static void AddScaledAvx2(float* destination, const float* source, float scale, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX2 static void LogisticDeltasAvx2(const double* values, const double* errors, double* deltas, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX2 static void LogisticDeltasAvx2(const float* values, const float* errors, float* deltas, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX2 static void LogisticRationalAvx2(double* values, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX2 static void LogisticRationalAvx2(float* values, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX2 static void LogisticTableAvx2(double* values, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX2 static void LogisticTableAvx2(float* values, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX2 static void DotProductTileAvx2(const double* first, int firstStride, const double* second, int secondStride, double* result, int resultStride, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX2 static void DotProductTileAvx2(const float* first, int firstStride, const float* second, int secondStride, float* result, int resultStride, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX2 static void AddProductsTileAvx2(const double* coefficients, int coefficientRowStride, int coefficientStride, const double* rows, int rowStride, int numberOfRows,
+															   double* result, int resultStride, int numberOfValues, double scale);
+	NEURAL_NETWORK_TARGET_AVX2 static void AddProductsTileAvx2(const float* coefficients, int coefficientRowStride, int coefficientStride, const float* rows, int rowStride, int numberOfRows,
+															   float* result, int resultStride, int numberOfValues, float scale);
+#endif
+
+#ifdef NEURAL_NETWORK_AVX512
+	NEURAL_NETWORK_TARGET_AVX512 static double DotProductAvx512(const double* first, const double* second, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX512 static float DotProductAvx512(const float* first, const float* second, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX512 static double DotProductDoubleSumAvx512(const float* first, const float* second, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX512 static int DotProductInt8Avx512(const unsigned char* values, const signed char* weights, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX512 static void AddScaledAvx512(double* destination, const double* source, double scale, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX512 static void AddScaledAvx512(float* destination, const float* source, float scale, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX512 static void LogisticDeltasAvx512(const double* values, const double* errors, double* deltas, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX512 static void LogisticDeltasAvx512(const float* values, const float* errors, float* deltas, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX512 static void LogisticRationalAvx512(double* values, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX512 static void LogisticRationalAvx512(float* values, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX512 static void LogisticTableAvx512(double* values, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX512 static void LogisticTableAvx512(float* values, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX512 static void DotProductTileAvx512(const double* first, int firstStride, const double* second, int secondStride, double* result, int resultStride, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX512 static void DotProductTileAvx512(const float* first, int firstStride, const float* second, int secondStride, float* result, int resultStride, int numberOfValues);
+	NEURAL_NETWORK_TARGET_AVX512 static void AddProductsTileAvx512(const double* coefficients, int coefficientRowStride, int coefficientStride, const double* rows, int rowStride, int numberOfRows,
+																   double* result, int resultStride, int numberOfValues, double scale);
+	NEURAL_NETWORK_TARGET_AVX512 static void AddProductsTileAvx512(const float* coefficients, int coefficientRowStride, int coefficientStride, const float* rows, int rowStride, int numberOfRows,
+																   float* result, int resultStride, int numberOfValues, float scale);
+#endif
+};
+
+KernelFunctions<double> NeuralNetworkKernels::DoubleKernels;
+KernelFunctions<float> NeuralNetworkKernels::FloatKernels;
+double (*NeuralNetworkKernels::FloatDotProductDoubleSum)(const float*, const float*, int) = NeuralNetworkKernels::DotProductDoubleSumScalar;
+int (*NeuralNetworkKernels::DotProductInt8)(const unsigned char*, const signed char*, int) = NeuralNetworkKernels::DotProductInt8Scalar;
+
+int NeuralNetworkKernels::InstructionSet = KERNELS_SCALAR;
+
+double NeuralNetworkKernels::DoubleLogisticTable[LOGISTIC_TABLE_SIZE];
+float NeuralNetworkKernels::FloatLogisticTable[LOGISTIC_TABLE_SIZE];
+static bool neuralNetworkLogisticTablesFilled = NeuralNetworkKernels::FillLogisticTables();
+
+//the best kernels are selected before 'main' is called
+static bool neuralNetworkKernelsSelected = NeuralNetworkKernels::Select(NeuralNetworkKernels::GetBestInstructionSet());
+
+
+//<summary>
+//Returns the best instruction set that can be used. Besides the processor flags, the operating system has to save
+//the vector registers on context switches, which is checked with 'xgetbv'; gcc and clang check both with '__builtin_cpu_supports'.
+//</summary>
+int NeuralNetworkKernels::GetBestInstructionSet()
+{
+#if defined(NEURAL_NETWORK_AVX2) && defined(_MSC_VER)
+	int registers[4];
+	__cpuid(registers, 1);
+	bool fma = (registers[2] & (1 << 12)) != 0;
+	bool osxsave = (registers[2] & (1 << 27)) != 0;
+	if(!osxsave)
+		return KERNELS_SCALAR;
+
+	unsigned long long enabledStates = _xgetbv(0);
+	__cpuidex(registers, 7, 0);
+	bool avx2 = fma && (registers[1] & (1 << 5)) != 0 && (enabledStates & 0x06) == 0x06;
+	bool avx512 = (registers[1] & (1 << 16)) != 0 && (registers[1] & (1 << 30)) != 0 && (enabledStates & 0xE6) == 0xE6;
+#ifdef NEURAL_NETWORK_AVX512
+	if(avx512)
+		return KERNELS_AVX512;
+#endif
+	return avx2 ? KERNELS_AVX2 : KERNELS_SCALAR;
+#elif defined(NEURAL_NETWORK_AVX2)
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+		return KERNELS_AVX512;
+	if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		return KERNELS_AVX2;
+	return KERNELS_SCALAR;
+#else
+	return KERNELS_SCALAR;
+#endif
+}
+
+//<summary>
+//Selects the kernels for 'instructionSet' if it is supported; the scalar kernels are always supported.
+//</summary>
+//<param name='instructionSet'>One of the 'KERNELS_' constants.</param>
+//<returns>True if the kernels were selected.</returns>
+bool NeuralNetworkKernels::Select(int instructionSet)
+{
+	if(instructionSet > GetBestInstructionSet())
+		return false;
+
+	if(instructionSet == KERNELS_SCALAR)
+	{
+		DoubleKernels.DotProduct = DotProductScalar<double>;
+		DoubleKernels.AddScaled = AddScaledScalar<double>;
+		DoubleKernels.LogisticDeltas = LogisticDeltasScalar<double>;
+		DoubleKernels.LogisticRational = LogisticRationalScalar<double>;
+		DoubleKernels.LogisticTable = LogisticTableScalar<double>;
+		DoubleKernels.DotProductTile = DotProductTileScalar<double>;
+		DoubleKernels.AddProductsTile = AddProductsTileScalar<double>;
+		FloatKernels.DotProduct = DotProductScalar<float>;
+		FloatKernels.AddScaled = AddScaledScalar<float>;
+		FloatKernels.LogisticDeltas = LogisticDeltasScalar<float>;
+		FloatKernels.LogisticRational = LogisticRationalScalar<float>;
+		FloatKernels.LogisticTable = LogisticTableScalar<float>;
+		FloatKernels.DotProductTile = DotProductTileScalar<float>;
+		FloatKernels.AddProductsTile = AddProductsTileScalar<float>;
+		FloatDotProductDoubleSum = DotProductDoubleSumScalar;
+		DotProductInt8 = DotProductInt8Scalar;
+	}
+#ifdef NEURAL_NETWORK_AVX2
+	else if(instructionSet == KERNELS_AVX2)
+	{
+		DoubleKernels.DotProduct = DotProductAvx2;
+		DoubleKernels.AddScaled = AddScaledAvx2;
+		DoubleKernels.LogisticDeltas = LogisticDeltasAvx2;
+		DoubleKernels.LogisticRational = LogisticRationalAvx2;
+		DoubleKernels.LogisticTable = LogisticTableAvx2;
+		DoubleKernels.DotProductTile = DotProductTileAvx2;
+		DoubleKernels.AddProductsTile = AddProductsTileAvx2;
+		FloatKernels.DotProduct = DotProductAvx2;
+		FloatKernels.AddScaled = AddScaledAvx2;
+		FloatKernels.LogisticDeltas = LogisticDeltasAvx2;
+		FloatKernels.LogisticRational = LogisticRationalAvx2;
+		FloatKernels.LogisticTable = LogisticTableAvx2;
+		FloatKernels.DotProductTile = DotProductTileAvx2;
+		FloatKernels.AddProductsTile = AddProductsTileAvx2;
+		FloatDotProductDoubleSum = DotProductDoubleSumAvx2;
+		DotProductInt8 = DotProductInt8Avx2;
+	}
+#endif
+#ifdef NEURAL_NETWORK_AVX512
+	else if(instructionSet == KERNELS_AVX512)
+	{
+		DoubleKernels.DotProduct = DotProductAvx512;
+		DoubleKernels.AddScaled = AddScaledAvx512;
+		DoubleKernels.LogisticDeltas = LogisticDeltasAvx512;
+		DoubleKernels.LogisticRational = LogisticRationalAvx512;
+		DoubleKernels.LogisticTable = LogisticTableAvx512;
+		DoubleKernels.DotProductTile = DotProductTileAvx512;
+		DoubleKernels.AddProductsTile = AddProductsTileAvx512;
+		FloatKernels.DotProduct = DotProductAvx512;
+		FloatKernels.AddScaled = AddScaledAvx512;
+		FloatKernels.LogisticDeltas = LogisticDeltasAvx512;
+		FloatKernels.LogisticRational = LogisticRationalAvx512;
+		FloatKernels.LogisticTable = LogisticTableAvx512;
+		FloatKernels.DotProductTile = DotProductTileAvx512;
+		FloatKernels.AddProductsTile = AddProductsTileAvx512;
+		FloatDotProductDoubleSum = DotProductDoubleSumAvx512;
+		DotProductInt8 = DotProductInt8Avx512;
+	}
+#endif
+	else
+		return false;
+
+	InstructionSet = instructionSet;
+	return true;
+}
+
+//<summary>
+//Scalar dot product; the values are added in order, so the result is the same as with the original loops.
+//</summary>
+template <typename Scalar>
+Scalar NeuralNetworkKernels::DotProductScalar(const Scalar* first, const Scalar* second, int numberOfValues)
+{
+	Scalar result = 0.0;
+	for(int i=0; i<numberOfValues; i++)
+		result = result + (first[i] * second[i]);
+	return result;
+}
+
+double NeuralNetworkKernels::DotProductDoubleSumScalar(const float* first, const float* second, int numberOfValues)
+{
+	double result = 0.0;
+	for(int i=0; i<numberOfValues; i++)
+		result = result + ((double)first[i] * second[i]);
+	return result;
+}
+
+int NeuralNetworkKernels::DotProductInt8Scalar(const unsigned char* values, const signed char* weights, int numberOfValues)
+{
+	int result = 0;
+	for(int i=0; i<numberOfValues; i++)
+		result += values[i] * weights[i];
+	return result;
+}
+
+template <typename Scalar>
+void NeuralNetworkKernels::AddScaledScalar(Scalar* destination, const Scalar* source, Scalar scale, int numberOfValues)
+{
+	for(int i=0; i<numberOfValues; i++)
+		destination[i] = destination[i] + (scale * source[i]);
+}
+
+template <typename Scalar>
+void NeuralNetworkKernels::LogisticDeltasScalar(const Scalar* values, const Scalar* errors, Scalar* deltas, int numberOfValues)
+{
+	for(int i=0; i<numberOfValues; i++)
+		deltas[i] = values[i] * (1 - values[i]) * errors[i];
+}
+
+//<summary>
+//Fills the tables of LOGISTIC_TABLE; the float table is rounded from the double values.
+//</summary>
+bool NeuralNetworkKernels::FillLogisticTables()
+{
+	for(int i=0; i<LOGISTIC_TABLE_SIZE; i++)
+	{
+		double x = (double)(i - LOGISTIC_TABLE_RANGE * LOGISTIC_TABLE_STEPS) / LOGISTIC_TABLE_STEPS;
+		DoubleLogisticTable[i] = 1.0 / (1 + exp(-x));
+		FloatLogisticTable[i] = (float)DoubleLogisticTable[i];
+	}
+	return true;
+}
+
+template <typename Scalar>
+void NeuralNetworkKernels::ApplyLogistic(const KernelFunctions<Scalar>& kernels, Scalar* values, int numberOfValues, int approximation)
+{
+	if(approximation == LOGISTIC_RATIONAL)
+		kernels.LogisticRational(values, numberOfValues);
+	else if(approximation == LOGISTIC_TABLE)
+		kernels.LogisticTable(values, numberOfValues);
+	else
+		LogisticExactScalar(values, numberOfValues);
+}
+
+//<summary>
+//The logistic function calculated with 'exp' in double precision; there is no vector version of 'exp', so it is the same for all instruction sets.
+//</summary>
+template <typename Scalar>
+void NeuralNetworkKernels::LogisticExactScalar(Scalar* values, int numberOfValues)
+{
+	for(int i=0; i<numberOfValues; i++)
+		values[i] = (Scalar)(1.0 / (1 + exp(-(double)values[i])));
+}
+
+template <typename Scalar>
+void NeuralNetworkKernels::LogisticRationalScalar(Scalar* values, int numberOfValues)
+{
+	for(int i=0; i<numberOfValues; i++)
+		values[i] = LogisticRationalValue(values[i]);
+}
+
+template <typename Scalar>
+void NeuralNetworkKernels::LogisticTableScalar(Scalar* values, int numberOfValues)
+{
+	for(int i=0; i<numberOfValues; i++)
+		values[i] = LogisticTableValue(values[i]);
+}
+
+//<summary>
+//Returns (1 + tanh(x / 2)) / 2, with tanh(y) approximated by y (135135 + 17325 y^2 + 378 y^4 + y^6) / (135135 + 62370 y^2 + 3150 y^4 + 28 y^6).
+//</summary>
+template <typename Scalar>
+Scalar NeuralNetworkKernels::LogisticRationalValue(Scalar x)
+{
+	const Scalar limit = (Scalar)(LOGISTIC_RATIONAL_LIMIT / 2);
+	Scalar y = x * (Scalar)0.5;
+	if(y > limit)
+		y = limit;
+	else if(y < -limit)
+		y = -limit;
+
+	Scalar y2 = y * y;
+	Scalar numerator = y * ((Scalar)135135 + y2 * ((Scalar)17325 + y2 * ((Scalar)378 + y2)));
+	Scalar denominator = (Scalar)135135 + y2 * ((Scalar)62370 + y2 * ((Scalar)3150 + y2 * (Scalar)28));
+	return (Scalar)0.5 + (Scalar)0.5 * (numerator / denominator);
+}
+
+//<summary>
+//Interpolates linearly between the two entries of the table around 'x'.
+//</summary>
+template <typename Scalar>
+Scalar NeuralNetworkKernels::LogisticTableValue(Scalar x)
+{
+	const Scalar* table = GetLogisticTable(x);
+	if(x > (Scalar)LOGISTIC_TABLE_RANGE)
+		x = (Scalar)LOGISTIC_TABLE_RANGE;
+	else if(x < -(Scalar)LOGISTIC_TABLE_RANGE)
+		x = -(Scalar)LOGISTIC_TABLE_RANGE;
+
+	Scalar position = (x + (Scalar)LOGISTIC_TABLE_RANGE) * (Scalar)LOGISTIC_TABLE_STEPS;
+	int index = (int)position;
+	if(index > LOGISTIC_TABLE_SIZE - 2)
+		index = LOGISTIC_TABLE_SIZE - 2;
+	Scalar fraction = position - (Scalar)index;
+	return table[index] + fraction * (table[index + 1] - table[index]);
+}
+
+//<summary>
+//Scalar 2x4 block of dot products; each value is added in order, like in 'DotProductScalar'.
+//</summary>
+template <typename Scalar>
+void NeuralNetworkKernels::DotProductTileScalar(const Scalar* first, int firstStride, const Scalar* second, int secondStride, Scalar* result, int resultStride, int numberOfValues)
+{
+	for(int i=0; i<KERNELS_TILE_ROWS; i++)
+		for(int j=0; j<KERNELS_TILE_COLUMNS; j++)
+			result[i * resultStride + j] = DotProductScalar(first + i * firstStride, second + j * secondStride, numberOfValues);
+}
+
+//<summary>
+//Sets 'result[i][j]' to the dot product of the row 'i' of 'first' and the row 'j' of 'second'. The rows of 'second' are processed
+//in groups that fit into KERNELS_BLOCK_BYTES, so they stay in the cache while all rows of 'first' are multiplied with them;
+//within a group, 2x4 blocks of the result are calculated by 'DotProductTile' and the remaining results by 'DotProduct'.
+//With 'doubleSums', all results are calculated by 'DotProductDoubleSum' instead, which doesn't have a tile version.
+//</summary>
+//<param name='first'>Matrix with 'numberOfFirstRows' rows that start 'firstStride' values apart.</param>
+//<param name='second'>Matrix with 'numberOfSecondRows' rows that start 'secondStride' values apart.</param>
+//<param name='result'>Matrix with 'numberOfFirstRows' rows and at least 'numberOfSecondRows' columns.</param>
+//<param name='numberOfValues'>The number of values in each row of 'first' and 'second'.</param>
+//<param name='doubleSums'>True if the dot products of floats are added up in double precision.</param>
+template <typename Scalar>
+void NeuralNetworkKernels::MultiplyTransposed(const Scalar* first, int firstStride, int numberOfFirstRows, const Scalar* second, int secondStride, int numberOfSecondRows,
+											  Scalar* result, int resultStride, int numberOfValues, bool doubleSums)
+{
+	if(doubleSums)
+	{
+		for(int i=0; i<numberOfFirstRows; i++)
+			for(int j=0; j<numberOfSecondRows; j++)
+				result[i * resultStride + j] = (Scalar)DotProductDoubleSum(first + i * firstStride, second + j * secondStride, numberOfValues);
+		return;
+	}
+
+	int rowsPerBlock = KERNELS_BLOCK_BYTES / (numberOfValues * (int)sizeof(Scalar));
+	rowsPerBlock = rowsPerBlock < KERNELS_TILE_COLUMNS ? KERNELS_TILE_COLUMNS : rowsPerBlock / KERNELS_TILE_COLUMNS * KERNELS_TILE_COLUMNS;
+
+	for(int firstColumn=0; firstColumn<numberOfSecondRows; firstColumn+=rowsPerBlock)
+	{
+		int lastColumn = firstColumn + rowsPerBlock < numberOfSecondRows ? firstColumn + rowsPerBlock : numberOfSecondRows;
+		int i = 0;
+		for(; i+KERNELS_TILE_ROWS<=numberOfFirstRows; i+=KERNELS_TILE_ROWS)
+		{
+			int j = firstColumn;
+			for(; j+KERNELS_TILE_COLUMNS<=lastColumn; j+=KERNELS_TILE_COLUMNS)
+				DotProductTile(first + i * firstStride, firstStride, second + j * secondStride, secondStride, result + i * resultStride + j, resultStride, numberOfValues);
+			for(; j<lastColumn; j++)
+				for(int row=i; row<i+KERNELS_TILE_ROWS; row++)
+					result[row * resultStride + j] = DotProduct(first + row * firstStride, second + j * secondStride, numberOfValues);
+		}
+		for(; i<numberOfFirstRows; i++)
+			for(int j=firstColumn; j<lastColumn; j++)
+				result[i * resultStride + j] = DotProduct(first + i * firstStride, second + j * secondStride, numberOfValues);
+	}
+}
+
+//<summary>
+//Adds 'scale * first[i][k] * second[k][j]' to 'result[i][j]'.
+//</summary>
+//<param name='first'>Matrix with 'numberOfFirstRows' rows and 'numberOfFirstColumns' columns.</param>
+//<param name='second'>Matrix with 'numberOfFirstColumns' rows of 'numberOfValues' values.</param>
+//<param name='result'>Matrix with 'numberOfFirstRows' rows of 'numberOfValues' values.</param>
+template <typename Scalar>
+void NeuralNetworkKernels::MultiplyAdd(const Scalar* first, int firstStride, int numberOfFirstRows, int numberOfFirstColumns, const Scalar* second, int secondStride,
+									   Scalar* result, int resultStride, int numberOfValues, Scalar scale)
+{
+	AddProducts(first, firstStride, 1, numberOfFirstRows, second, secondStride, numberOfFirstColumns, result, resultStride, numberOfValues, scale);
+}
+
+//<summary>
+//Adds 'scale * first[k][i] * second[k][j]' to 'result[i][j]', i.e. the products of the columns of 'first' and the rows of 'second';
+//used for the weight corrections of a batch.
+//</summary>
+//<param name='first'>Matrix with 'numberOfRows' rows and 'numberOfFirstColumns' columns.</param>
+//<param name='second'>Matrix with 'numberOfRows' rows of 'numberOfValues' values.</param>
+//<param name='result'>Matrix with 'numberOfFirstColumns' rows of 'numberOfValues' values.</param>
+template <typename Scalar>
+void NeuralNetworkKernels::MultiplyTransposedAdd(const Scalar* first, int firstStride, int numberOfFirstColumns, const Scalar* second, int secondStride, int numberOfRows,
+												 Scalar* result, int resultStride, int numberOfValues, Scalar scale)
+{
+	AddProducts(first, 1, firstStride, numberOfFirstColumns, second, secondStride, numberOfRows, result, resultStride, numberOfValues, scale);
+}
+
+//<summary>
+//Adds 'scale * coefficients[i * coefficientRowStride + k * coefficientStride] * rows[k][j]' to 'result[i][j]'. The rows are processed
+//in groups that fit into KERNELS_BLOCK_BYTES, so they stay in the cache while they are added to all rows of the result;
+//within a group, two rows of the result are calculated at a time by 'AddProductsTile'. Each value of the result gets the products
+//in the order of the rows, so the scalar kernels give the same sums as adding the rows one by one with 'AddScaled'.
+//</summary>
+template <typename Scalar>
+void NeuralNetworkKernels::AddProducts(const Scalar* coefficients, int coefficientRowStride, int coefficientStride, int numberOfResultRows, const Scalar* rows, int rowStride, int numberOfRows,
+									   Scalar* result, int resultStride, int numberOfValues, Scalar scale)
+{
+	int rowsPerBlock = KERNELS_BLOCK_BYTES / (numberOfValues * (int)sizeof(Scalar));
+	rowsPerBlock = rowsPerBlock < 1 ? 1 : rowsPerBlock;
+
+	for(int firstRow=0; firstRow<numberOfRows; firstRow+=rowsPerBlock)
+	{
+		int numberOfBlockRows = firstRow + rowsPerBlock < numberOfRows ? rowsPerBlock : numberOfRows - firstRow;
+		const Scalar* blockCoefficients = coefficients + firstRow * coefficientStride;
+		const Scalar* blockRows = rows + firstRow * rowStride;
+
+		int i = 0;
+		for(; i+KERNELS_TILE_ROWS<=numberOfResultRows; i+=KERNELS_TILE_ROWS)
+			AddProductsTile(blockCoefficients + i * coefficientRowStride, coefficientRowStride, coefficientStride, blockRows, rowStride, numberOfBlockRows,
+							result + i * resultStride, resultStride, numberOfValues, scale);
+		for(; i<numberOfResultRows; i++)
+			for(int k=0; k<numberOfBlockRows; k++)
+				AddScaled(result + i * resultStride, blockRows + k * rowStride, scale * blockCoefficients[i * coefficientRowStride + k * coefficientStride], numberOfValues);
+	}
+}
+
+//<summary>
+//Scalar version of 'AddProductsTile'; adds the rows one by one with 'AddScaledScalar'.
+//</summary>
+template <typename Scalar>
+void NeuralNetworkKernels::AddProductsTileScalar(const Scalar* coefficients, int coefficientRowStride, int coefficientStride, const Scalar* rows, int rowStride, int numberOfRows,
+												 Scalar* result, int resultStride, int numberOfValues, Scalar scale)
+{
+	for(int i=0; i<KERNELS_TILE_ROWS; i++)
+		for(int k=0; k<numberOfRows; k++)
+			AddScaledScalar(result + i * resultStride, rows + k * rowStride, scale * coefficients[i * coefficientRowStride + k * coefficientStride], numberOfValues);
+}
+
+#ifdef NEURAL_NETWORK_AVX2
+//<summary>
+//AVX2 dot product; four independent sums of four values are kept, so that the additions don't wait for each other.
+//</summary>
+NEURAL_NETWORK_TARGET_AVX2 double NeuralNetworkKernels::DotProductAvx2(const double* first, const double* second, int numberOfValues)
+{
+	__m256d sums[4] = { _mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd() };
+	int i = 0;
+	for(; i+16<=numberOfValues; i+=16)
+	{
+		sums[0] = _mm256_fmadd_pd(_mm256_loadu_pd(first + i), _mm256_loadu_pd(second + i), sums[0]);
+		sums[1] = _mm256_fmadd_pd(_mm256_loadu_pd(first + i + 4), _mm256_loadu_pd(second + i + 4), sums[1]);
+		sums[2] = _mm256_fmadd_pd(_mm256_loadu_pd(first + i + 8), _mm256_loadu_pd(second + i + 8), sums[2]);
+		sums[3] = _mm256_fmadd_pd(_mm256_loadu_pd(first + i + 12), _mm256_loadu_pd(second + i + 12), sums[3]);
+	}
+	for(; i+4<=numberOfValues; i+=4)
+		sums[0] = _mm256_fmadd_pd(_mm256_loadu_pd(first + i), _mm256_loadu_pd(second + i), sums[0]);
+
+	__m256d sum = _mm256_add_pd(_mm256_add_pd(sums[0], sums[1]), _mm256_add_pd(sums[2], sums[3]));
+	__m128d halves = _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+	double result = _mm_cvtsd_f64(_mm_add_sd(halves, _mm_unpackhi_pd(halves, halves)));
+
+	for(; i<numberOfValues; i++)
+		result += first[i] * second[i];
+	return result;
+}
+
+//<summary>
+//AVX2 integer dot product. 'maddubs' multiplies 32 pairs of bytes and adds neighbouring products into 16-bit sums,
+//which can't overflow because the values are at most 127; 'madd' with ones then adds pairs of those into 32-bit sums.
+//</summary>
+NEURAL_NETWORK_TARGET_AVX2 int NeuralNetworkKernels::DotProductInt8Avx2(const unsigned char* values, const signed char* weights, int numberOfValues)
+{
+	__m256i ones = _mm256_set1_epi16(1);
+	__m256i firstSums = _mm256_setzero_si256();
+	__m256i secondSums = _mm256_setzero_si256();
+	int i = 0;
+	for(; i+64<=numberOfValues; i+=64)
+	{
+		__m256i firstProducts = _mm256_maddubs_epi16(_mm256_loadu_si256((const __m256i*)(values + i)), _mm256_loadu_si256((const __m256i*)(weights + i)));
+		__m256i secondProducts = _mm256_maddubs_epi16(_mm256_loadu_si256((const __m256i*)(values + i + 32)), _mm256_loadu_si256((const __m256i*)(weights + i + 32)));
+		firstSums = _mm256_add_epi32(firstSums, _mm256_madd_epi16(firstProducts, ones));
+		secondSums = _mm256_add_epi32(secondSums, _mm256_madd_epi16(secondProducts, ones));
+	}
+	for(; i+32<=numberOfValues; i+=32)
+	{
+		__m256i products = _mm256_maddubs_epi16(_mm256_loadu_si256((const __m256i*)(values + i)), _mm256_loadu_si256((const __m256i*)(weights + i)));
+		firstSums = _mm256_add_epi32(firstSums, _mm256_madd_epi16(products, ones));
+	}
+
+	__m256i sum = _mm256_add_epi32(firstSums, secondSums);
+	__m128i halves = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+	halves = _mm_add_epi32(halves, _mm_shuffle_epi32(halves, 0x4E));
+	halves = _mm_add_epi32(halves, _mm_shuffle_epi32(halves, 0xB1));
+	int result = _mm_cvtsi128_si32(halves);
+
+	for(; i<numberOfValues; i++)
+		result += values[i] * weights[i];
+	return result;
+}
+
+NEURAL_NETWORK_TARGET_AVX2 void NeuralNetworkKernels::AddScaledAvx2(double* destination, const double* source, double scale, int numberOfValues)
+{
+	__m256d scales = _mm256_set1_pd(scale);
+	int i = 0;
+	for(; i+4<=numberOfValues; i+=4)
+		_mm256_storeu_pd(destination + i, _mm256_fmadd_pd(scales, _mm256_loadu_pd(source + i), _mm256_loadu_pd(destination + i)));
+	for(; i<numberOfValues; i++)
+		destination[i] += scale * source[i];
+}
+
+NEURAL_NETWORK_TARGET_AVX2 void NeuralNetworkKernels::LogisticDeltasAvx2(const double* values, const double* errors, double* deltas, int numberOfValues)
+{
+	__m256d ones = _mm256_set1_pd(1.0);
+	int i = 0;
+	for(; i+4<=numberOfValues; i+=4)
+	{
+		__m256d currentValues = _mm256_loadu_pd(values + i);
+		__m256d derivatives = _mm256_mul_pd(currentValues, _mm256_sub_pd(ones, currentValues));
+		_mm256_storeu_pd(deltas + i, _mm256_mul_pd(derivatives, _mm256_loadu_pd(errors + i)));
+	}
+	for(; i<numberOfValues; i++)
+		deltas[i] = values[i] * (1 - values[i]) * errors[i];
+}
+
+//<summary>
+//AVX2 version of 'LogisticRationalValue'; the division is the most expensive instruction, one per four values.
+//</summary>
+NEURAL_NETWORK_TARGET_AVX2 void NeuralNetworkKernels::LogisticRationalAvx2(double* values, int numberOfValues)
+{
+	__m256d halves = _mm256_set1_pd(0.5);
+	__m256d limits = _mm256_set1_pd(LOGISTIC_RATIONAL_LIMIT / 2), negativeLimits = _mm256_set1_pd(-LOGISTIC_RATIONAL_LIMIT / 2);
+	__m256d numerator0 = _mm256_set1_pd(135135.0), numerator1 = _mm256_set1_pd(17325.0), numerator2 = _mm256_set1_pd(378.0);
+	__m256d denominator0 = _mm256_set1_pd(135135.0), denominator1 = _mm256_set1_pd(62370.0), denominator2 = _mm256_set1_pd(3150.0), denominator3 = _mm256_set1_pd(28.0);
+	int i = 0;
+	for(; i+4<=numberOfValues; i+=4)
+	{
+		__m256d y = _mm256_mul_pd(_mm256_loadu_pd(values + i), halves);
+		y = _mm256_min_pd(_mm256_max_pd(y, negativeLimits), limits);
+		__m256d y2 = _mm256_mul_pd(y, y);
+		__m256d numerator = _mm256_mul_pd(y, _mm256_fmadd_pd(y2, _mm256_fmadd_pd(y2, _mm256_add_pd(y2, numerator2), numerator1), numerator0));
+		__m256d denominator = _mm256_fmadd_pd(y2, _mm256_fmadd_pd(y2, _mm256_fmadd_pd(y2, denominator3, denominator2), denominator1), denominator0);
+		_mm256_storeu_pd(values + i, _mm256_fmadd_pd(halves, _mm256_div_pd(numerator, denominator), halves));
+	}
+	for(; i<numberOfValues; i++)
+		values[i] = LogisticRationalValue(values[i]);
+}
+
+//<summary>
+//AVX2 version of 'LogisticTableValue'; the two entries around each value are read with gather instructions.
+//</summary>
+NEURAL_NETWORK_TARGET_AVX2 void NeuralNetworkKernels::LogisticTableAvx2(double* values, int numberOfValues)
+{
+	__m256d ranges = _mm256_set1_pd(LOGISTIC_TABLE_RANGE), negativeRanges = _mm256_set1_pd(-LOGISTIC_TABLE_RANGE);
+	__m256d steps = _mm256_set1_pd(LOGISTIC_TABLE_STEPS);
+	__m128i lastIndices = _mm_set1_epi32(LOGISTIC_TABLE_SIZE - 2);
+	int i = 0;
+	for(; i+4<=numberOfValues; i+=4)
+	{
+		__m256d x = _mm256_min_pd(_mm256_max_pd(_mm256_loadu_pd(values + i), negativeRanges), ranges);
+		__m256d positions = _mm256_mul_pd(_mm256_add_pd(x, ranges), steps);
+		__m128i indices = _mm_min_epi32(_mm256_cvttpd_epi32(positions), lastIndices);
+		__m256d fractions = _mm256_sub_pd(positions, _mm256_cvtepi32_pd(indices));
+		__m256d lower = _mm256_i32gather_pd(DoubleLogisticTable, indices, 8);
+		__m256d upper = _mm256_i32gather_pd(DoubleLogisticTable + 1, indices, 8);
+		_mm256_storeu_pd(values + i, _mm256_fmadd_pd(fractions, _mm256_sub_pd(upper, lower), lower));
+	}
+	for(; i<numberOfValues; i++)
+		values[i] = LogisticTableValue(values[i]);
+}
+
+//<summary>
+//AVX2 2x4 block of dot products; the eight sums are kept in registers, so each loaded value is used two or four times.
+//</summary>
+NEURAL_NETWORK_TARGET_AVX2 void NeuralNetworkKernels::DotProductTileAvx2(const double* first, int firstStride, const double* second, int secondStride, double* result, int resultStride, int numberOfValues)
+{
+	__m256d sum00 = _mm256_setzero_pd(), sum01 = _mm256_setzero_pd(), sum02 = _mm256_setzero_pd(), sum03 = _mm256_setzero_pd();
+	__m256d sum10 = _mm256_setzero_pd(), sum11 = _mm256_setzero_pd(), sum12 = _mm256_setzero_pd(), sum13 = _mm256_setzero_pd();
+
+	//the sums are separate variables instead of an array, so that the compiler keeps them in registers
+	int k = 0;
+	for(; k+4<=numberOfValues; k+=4)
+	{
+		__m256d firstValues = _mm256_loadu_pd(first + k);
+		__m256d secondValues = _mm256_loadu_pd(first + firstStride + k);
+		__m256d columnValues = _mm256_loadu_pd(second + k);
+		sum00 = _mm256_fmadd_pd(firstValues, columnValues, sum00);
+		sum10 = _mm256_fmadd_pd(secondValues, columnValues, sum10);
+		columnValues = _mm256_loadu_pd(second + secondStride + k);
+		sum01 = _mm256_fmadd_pd(firstValues, columnValues, sum01);
+		sum11 = _mm256_fmadd_pd(secondValues, columnValues, sum11);
+		columnValues = _mm256_loadu_pd(second + 2 * secondStride + k);
+		sum02 = _mm256_fmadd_pd(firstValues, columnValues, sum02);
+		sum12 = _mm256_fmadd_pd(secondValues, columnValues, sum12);
+		columnValues = _mm256_loadu_pd(second + 3 * secondStride + k);
+		sum03 = _mm256_fmadd_pd(firstValues, columnValues, sum03);
+		sum13 = _mm256_fmadd_pd(secondValues, columnValues, sum13);
+	}
+
+	//the four sums of a row are added horizontally at once: the pairs of neighbouring values first, then the halves
+	__m256d pairs01 = _mm256_hadd_pd(sum00, sum01);
+	__m256d pairs23 = _mm256_hadd_pd(sum02, sum03);
+	_mm256_storeu_pd(result, _mm256_add_pd(_mm256_permute2f128_pd(pairs01, pairs23, 0x20), _mm256_permute2f128_pd(pairs01, pairs23, 0x31)));
+	pairs01 = _mm256_hadd_pd(sum10, sum11);
+	pairs23 = _mm256_hadd_pd(sum12, sum13);
+	_mm256_storeu_pd(result + resultStride, _mm256_add_pd(_mm256_permute2f128_pd(pairs01, pairs23, 0x20), _mm256_permute2f128_pd(pairs01, pairs23, 0x31)));
+
+	for(int i=0; i<KERNELS_TILE_ROWS; i++)
+		for(int remaining=k; remaining<numberOfValues; remaining++)
+			for(int j=0; j<KERNELS_TILE_COLUMNS; j++)
+				result[i * resultStride + j] += first[i * firstStride + remaining] * second[j * secondStride + remaining];
+}
+
+//<summary>
+//AVX2 version of 'AddProductsTile'. The result is processed in blocks of 16 values of both rows, which are kept in registers
+//while all rows are added to them, so the result is read and written once instead of once per row.
+//</summary>
+NEURAL_NETWORK_TARGET_AVX2 void NeuralNetworkKernels::AddProductsTileAvx2(const double* coefficients, int coefficientRowStride, int coefficientStride, const double* rows, int rowStride, int numberOfRows,
+																						  double* result, int resultStride, int numberOfValues, double scale)
+{
+	double* secondResult = result + resultStride;
+	int j = 0;
+	for(; j+16<=numberOfValues; j+=16)
+	{
+		__m256d sum00 = _mm256_loadu_pd(result + j), sum01 = _mm256_loadu_pd(result + j + 4);
+		__m256d sum02 = _mm256_loadu_pd(result + j + 8), sum03 = _mm256_loadu_pd(result + j + 12);
+		__m256d sum10 = _mm256_loadu_pd(secondResult + j), sum11 = _mm256_loadu_pd(secondResult + j + 4);
+		__m256d sum12 = _mm256_loadu_pd(secondResult + j + 8), sum13 = _mm256_loadu_pd(secondResult + j + 12);
+
+		const double* row = rows + j;
+		for(int k=0; k<numberOfRows; k++, row+=rowStride)
+		{
+			__m256d firstScales = _mm256_set1_pd(scale * coefficients[k * coefficientStride]);
+			__m256d secondScales = _mm256_set1_pd(scale * coefficients[coefficientRowStride + k * coefficientStride]);
+			__m256d values = _mm256_loadu_pd(row);
+			sum00 = _mm256_fmadd_pd(firstScales, values, sum00);
+			sum10 = _mm256_fmadd_pd(secondScales, values, sum10);
+			values = _mm256_loadu_pd(row + 4);
+			sum01 = _mm256_fmadd_pd(firstScales, values, sum01);
+			sum11 = _mm256_fmadd_pd(secondScales, values, sum11);
+			values = _mm256_loadu_pd(row + 8);
+			sum02 = _mm256_fmadd_pd(firstScales, values, sum02);
+			sum12 = _mm256_fmadd_pd(secondScales, values, sum12);
+			values = _mm256_loadu_pd(row + 12);
+			sum03 = _mm256_fmadd_pd(firstScales, values, sum03);
+			sum13 = _mm256_fmadd_pd(secondScales, values, sum13);
+		}
+
+		_mm256_storeu_pd(result + j, sum00);
+		_mm256_storeu_pd(result + j + 4, sum01);
+		_mm256_storeu_pd(result + j + 8, sum02);
+		_mm256_storeu_pd(result + j + 12, sum03);
+		_mm256_storeu_pd(secondResult + j, sum10);
+		_mm256_storeu_pd(secondResult + j + 4, sum11);
+		_mm256_storeu_pd(secondResult + j + 8, sum12);
+		_mm256_storeu_pd(secondResult + j + 12, sum13);
+	}
+
+	for(; j+4<=numberOfValues; j+=4)
+	{
+		__m256d firstSums = _mm256_loadu_pd(result + j);
+		__m256d secondSums = _mm256_loadu_pd(secondResult + j);
+		for(int k=0; k<numberOfRows; k++)
+		{
+			__m256d values = _mm256_loadu_pd(rows + k * rowStride + j);
+			firstSums = _mm256_fmadd_pd(_mm256_set1_pd(scale * coefficients[k * coefficientStride]), values, firstSums);
+			secondSums = _mm256_fmadd_pd(_mm256_set1_pd(scale * coefficients[coefficientRowStride + k * coefficientStride]), values, secondSums);
+		}
+		_mm256_storeu_pd(result + j, firstSums);
+		_mm256_storeu_pd(secondResult + j, secondSums);
+	}
+
+	for(; j<numberOfValues; j++)
+	{
+		for(int k=0; k<numberOfRows; k++)
+		{
+			result[j] += scale * coefficients[k * coefficientStride] * rows[k * rowStride + j];
+			secondResult[j] += scale * coefficients[coefficientRowStride + k * coefficientStride] * rows[k * rowStride + j];
+		}
+	}
+}
+
+//<summary>
+//AVX2 dot product of floats; four independent sums of eight values are kept, so that the additions don't wait for each other.
+//</summary>
+NEURAL_NETWORK_TARGET_AVX2 float NeuralNetworkKernels::DotProductAvx2(const float* first, const float* second, int numberOfValues)
+{
+	__m256 sums[4] = { _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps() };
+	int i = 0;
+	for(; i+32<=numberOfValues; i+=32)
+	{
+		sums[0] = _mm256_fmadd_ps(_mm256_loadu_ps(first + i), _mm256_loadu_ps(second + i), sums[0]);
+		sums[1] = _mm256_fmadd_ps(_mm256_loadu_ps(first + i + 8), _mm256_loadu_ps(second + i + 8), sums[1]);
+		sums[2] = _mm256_fmadd_ps(_mm256_loadu_ps(first + i + 16), _mm256_loadu_ps(second + i + 16), sums[2]);
+		sums[3] = _mm256_fmadd_ps(_mm256_loadu_ps(first + i + 24), _mm256_loadu_ps(second + i + 24), sums[3]);
+	}
+	for(; i+8<=numberOfValues; i+=8)
+		sums[0] = _mm256_fmadd_ps(_mm256_loadu_ps(first + i), _mm256_loadu_ps(second + i), sums[0]);
+
+	__m256 sum = _mm256_add_ps(_mm256_add_ps(sums[0], sums[1]), _mm256_add_ps(sums[2], sums[3]));
+	__m128 halves = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+	halves = _mm_add_ps(halves, _mm_movehl_ps(halves, halves));
+	float result = _mm_cvtss_f32(_mm_add_ss(halves, _mm_shuffle_ps(halves, halves, 0x55)));
+
+	for(; i<numberOfValues; i++)
+		result += first[i] * second[i];
+	return result;
+}
+
+//<summary>
+//AVX2 dot product of floats added up in double precision; four floats at a time are converted to doubles.
+//</summary>
+NEURAL_NETWORK_TARGET_AVX2 double NeuralNetworkKernels::DotProductDoubleSumAvx2(const float* first, const float* second, int numberOfValues)
+{
+	__m256d sums[4] = { _mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd() };
+	int i = 0;
+	for(; i+16<=numberOfValues; i+=16)
+	{
+		sums[0] = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(first + i)), _mm256_cvtps_pd(_mm_loadu_ps(second + i)), sums[0]);
+		sums[1] = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(first + i + 4)), _mm256_cvtps_pd(_mm_loadu_ps(second + i + 4)), sums[1]);
+		sums[2] = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(first + i + 8)), _mm256_cvtps_pd(_mm_loadu_ps(second + i + 8)), sums[2]);
+		sums[3] = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(first + i + 12)), _mm256_cvtps_pd(_mm_loadu_ps(second + i + 12)), sums[3]);
+	}
+	for(; i+4<=numberOfValues; i+=4)
+		sums[0] = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(first + i)), _mm256_cvtps_pd(_mm_loadu_ps(second + i)), sums[0]);
+
+	__m256d sum = _mm256_add_pd(_mm256_add_pd(sums[0], sums[1]), _mm256_add_pd(sums[2], sums[3]));
+	__m128d halves = _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+	double result = _mm_cvtsd_f64(_mm_add_sd(halves, _mm_unpackhi_pd(halves, halves)));
+
+	for(; i<numberOfValues; i++)
+		result += (double)first[i] * second[i];
+	return result;
+}
+
+NEURAL_NETWORK_TARGET_AVX2 void NeuralNetworkKernels::AddScaledAvx2(float* destination, const float* source, float scale, int numberOfValues)
+{
+	__m256 scales = _mm256_set1_ps(scale);
+	int i = 0;
+	for(; i+8<=numberOfValues; i+=8)
+		_mm256_storeu_ps(destination + i, _mm256_fmadd_ps(scales, _mm256_loadu_ps(source + i), _mm256_loadu_ps(destination + i)));
+	for(; i<numberOfValues; i++)
+		destination[i] += scale * source[i];
+}
+
+NEURAL_NETWORK_TARGET_AVX2 void NeuralNetworkKernels::LogisticDeltasAvx2(const float* values, const float* errors, float* deltas, int numberOfValues)
+{
+	__m256 ones = _mm256_set1_ps(1.0f);
+	int i = 0;
+	for(; i+8<=numberOfValues; i+=8)
+	{
+		__m256 currentValues = _mm256_loadu_ps(values + i);
+		__m256 derivatives = _mm256_mul_ps(currentValues, _mm256_sub_ps(ones, currentValues));
+		_mm256_storeu_ps(deltas + i, _mm256_mul_ps(derivatives, _mm256_loadu_ps(errors + i)));
+	}
+	for(; i<numberOfValues; i++)
+		deltas[i] = values[i] * (1 - values[i]) * errors[i];
+}
+
+NEURAL_NETWORK_TARGET_AVX2 void NeuralNetworkKernels::LogisticRationalAvx2(float* values, int numberOfValues)
+{
+	__m256 halves = _mm256_set1_ps(0.5f);
+	__m256 limits = _mm256_set1_ps((float)(LOGISTIC_RATIONAL_LIMIT / 2)), negativeLimits = _mm256_set1_ps((float)(-LOGISTIC_RATIONAL_LIMIT / 2));
+	__m256 numerator0 = _mm256_set1_ps(135135.0f), numerator1 = _mm256_set1_ps(17325.0f), numerator2 = _mm256_set1_ps(378.0f);
+	__m256 denominator0 = _mm256_set1_ps(135135.0f), denominator1 = _mm256_set1_ps(62370.0f), denominator2 = _mm256_set1_ps(3150.0f), denominator3 = _mm256_set1_ps(28.0f);
+	int i = 0;
+	for(; i+8<=numberOfValues; i+=8)
+	{
+		__m256 y = _mm256_mul_ps(_mm256_loadu_ps(values + i), halves);
+		y = _mm256_min_ps(_mm256_max_ps(y, negativeLimits), limits);
+		__m256 y2 = _mm256_mul_ps(y, y);
+		__m256 numerator = _mm256_mul_ps(y, _mm256_fmadd_ps(y2, _mm256_fmadd_ps(y2, _mm256_add_ps(y2, numerator2), numerator1), numerator0));
+		__m256 denominator = _mm256_fmadd_ps(y2, _mm256_fmadd_ps(y2, _mm256_fmadd_ps(y2, denominator3, denominator2), denominator1), denominator0);
+		_mm256_storeu_ps(values + i, _mm256_fmadd_ps(halves, _mm256_div_ps(numerator, denominator), halves));
+	}
+	for(; i<numberOfValues; i++)
+		values[i] = LogisticRationalValue(values[i]);
+}
+
+NEURAL_NETWORK_TARGET_AVX2 void NeuralNetworkKernels::LogisticTableAvx2(float* values, int numberOfValues)
+{
+	__m256 ranges = _mm256_set1_ps((float)LOGISTIC_TABLE_RANGE), negativeRanges = _mm256_set1_ps((float)-LOGISTIC_TABLE_RANGE);
+	__m256 steps = _mm256_set1_ps((float)LOGISTIC_TABLE_STEPS);
+	__m256i lastIndices = _mm256_set1_epi32(LOGISTIC_TABLE_SIZE - 2);
+	int i = 0;
+	for(; i+8<=numberOfValues; i+=8)
+	{
+		__m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(values + i), negativeRanges), ranges);
+		__m256 positions = _mm256_mul_ps(_mm256_add_ps(x, ranges), steps);
+		__m256i indices = _mm256_min_epi32(_mm256_cvttps_epi32(positions), lastIndices);
+		__m256 fractions = _mm256_sub_ps(positions, _mm256_cvtepi32_ps(indices));
+		__m256 lower = _mm256_i32gather_ps(FloatLogisticTable, indices, 4);
+		__m256 upper = _mm256_i32gather_ps(FloatLogisticTable + 1, indices, 4);
+		_mm256_storeu_ps(values + i, _mm256_fmadd_ps(fractions, _mm256_sub_ps(upper, lower), lower));
+	}
+	for(; i<numberOfValues; i++)
+		values[i] = LogisticTableValue(values[i]);
+}
+
+//<summary>
+//AVX2 2x4 block of dot products of floats; like the version for doubles, with eight values per register.
+//</summary>
+NEURAL_NETWORK_TARGET_AVX2 void NeuralNetworkKernels::DotProductTileAvx2(const float* first, int firstStride, const float* second, int secondStride, float* result, int resultStride, int numberOfValues)
+{
+	__m256 sum00 = _mm256_setzero_ps(), sum01 = _mm256_setzero_ps(), sum02 = _mm256_setzero_ps(), sum03 = _mm256_setzero_ps();
+	__m256 sum10 = _mm256_setzero_ps(), sum11 = _mm256_setzero_ps(), sum12 = _mm256_setzero_ps(), sum13 = _mm256_setzero_ps();
+
+	int k = 0;
+	for(; k+8<=numberOfValues; k+=8)
+	{
+		__m256 firstValues = _mm256_loadu_ps(first + k);
+		__m256 secondValues = _mm256_loadu_ps(first + firstStride + k);
+		__m256 columnValues = _mm256_loadu_ps(second + k);
+		sum00 = _mm256_fmadd_ps(firstValues, columnValues, sum00);
+		sum10 = _mm256_fmadd_ps(secondValues, columnValues, sum10);
+		columnValues = _mm256_loadu_ps(second + secondStride + k);
+		sum01 = _mm256_fmadd_ps(firstValues, columnValues, sum01);
+		sum11 = _mm256_fmadd_ps(secondValues, columnValues, sum11);
+		columnValues = _mm256_loadu_ps(second + 2 * secondStride + k);
+		sum02 = _mm256_fmadd_ps(firstValues, columnValues, sum02);
+		sum12 = _mm256_fmadd_ps(secondValues, columnValues, sum12);
+		columnValues = _mm256_loadu_ps(second + 3 * secondStride + k);
+		sum03 = _mm256_fmadd_ps(firstValues, columnValues, sum03);
+		sum13 = _mm256_fmadd_ps(secondValues, columnValues, sum13);
+	}
+
+	//two rounds of horizontal additions leave the sums of the four halves of each register, which are then added to the other halves
+	__m256 quarters = _mm256_hadd_ps(_mm256_hadd_ps(sum00, sum01), _mm256_hadd_ps(sum02, sum03));
+	_mm_storeu_ps(result, _mm_add_ps(_mm256_castps256_ps128(quarters), _mm256_extractf128_ps(quarters, 1)));
+	quarters = _mm256_hadd_ps(_mm256_hadd_ps(sum10, sum11), _mm256_hadd_ps(sum12, sum13));
+	_mm_storeu_ps(result + resultStride, _mm_add_ps(_mm256_castps256_ps128(quarters), _mm256_extractf128_ps(quarters, 1)));
+
+	for(int i=0; i<KERNELS_TILE_ROWS; i++)
+		for(int remaining=k; remaining<numberOfValues; remaining++)
+			for(int j=0; j<KERNELS_TILE_COLUMNS; j++)
+				result[i * resultStride + j] += first[i * firstStride + remaining] * second[j * secondStride + remaining];
+}
+
+//<summary>
+//AVX2 version of 'AddProductsTile' for floats; like the version for doubles, with blocks of 32 values of both rows.
+//</summary>
+NEURAL_NETWORK_TARGET_AVX2 void NeuralNetworkKernels::AddProductsTileAvx2(const float* coefficients, int coefficientRowStride, int coefficientStride, const float* rows, int rowStride, int numberOfRows,
+																						  float* result, int resultStride, int numberOfValues, float scale)
+{
+	float* secondResult = result + resultStride;
+	int j = 0;
+	for(; j+32<=numberOfValues; j+=32)
+	{
+		__m256 sum00 = _mm256_loadu_ps(result + j), sum01 = _mm256_loadu_ps(result + j + 8);
+		__m256 sum02 = _mm256_loadu_ps(result + j + 16), sum03 = _mm256_loadu_ps(result + j + 24);
+		__m256 sum10 = _mm256_loadu_ps(secondResult + j), sum11 = _mm256_loadu_ps(secondResult + j + 8);
+		__m256 sum12 = _mm256_loadu_ps(secondResult + j + 16), sum13 = _mm256_loadu_ps(secondResult + j + 24);
+
+		const float* row = rows + j;
+		for(int k=0; k<numberOfRows; k++, row+=rowStride)
+		{
+			__m256 firstScales = _mm256_set1_ps(scale * coefficients[k * coefficientStride]);
+			__m256 secondScales = _mm256_set1_ps(scale * coefficients[coefficientRowStride + k * coefficientStride]);
+			__m256 values = _mm256_loadu_ps(row);
+			sum00 = _mm256_fmadd_ps(firstScales, values, sum00);
+			sum10 = _mm256_fmadd_ps(secondScales, values, sum10);
+			values = _mm256_loadu_ps(row + 8);
+			sum01 = _mm256_fmadd_ps(firstScales, values, sum01);
+			sum11 = _mm256_fmadd_ps(secondScales, values, sum11);
+			values = _mm256_loadu_ps(row + 16);
+			sum02 = _mm256_fmadd_ps(firstScales, values, sum02);
+			sum12 = _mm256_fmadd_ps(secondScales, values, sum12);
+			values = _mm256_loadu_ps(row + 24);
+			sum03 = _mm256_fmadd_ps(firstScales, values, sum03);
+			sum13 = _mm256_fmadd_ps(secondScales, values, sum13);
+		}
+
+		_mm256_storeu_ps(result + j, sum00);
+		_mm256_storeu_ps(result + j + 8, sum01);
+		_mm256_storeu_ps(result + j + 16, sum02);
+		_mm256_storeu_ps(result + j + 24, sum03);
+		_mm256_storeu_ps(secondResult + j, sum10);
+		_mm256_storeu_ps(secondResult + j + 8, sum11);
+		_mm256_storeu_ps(secondResult + j + 16, sum12);
+		_mm256_storeu_ps(secondResult + j + 24, sum13);
+	}
+
+	for(; j+8<=numberOfValues; j+=8)
+	{
+		__m256 firstSums = _mm256_loadu_ps(result + j);
+		__m256 secondSums = _mm256_loadu_ps(secondResult + j);
+		for(int k=0; k<numberOfRows; k++)
+		{
+			__m256 values = _mm256_loadu_ps(rows + k * rowStride + j);
+			firstSums = _mm256_fmadd_ps(_mm256_set1_ps(scale * coefficients[k * coefficientStride]), values, firstSums);
+			secondSums = _mm256_fmadd_ps(_mm256_set1_ps(scale * coefficients[coefficientRowStride + k * coefficientStride]), values, secondSums);
+		}
+		_mm256_storeu_ps(result + j, firstSums);
+		_mm256_storeu_ps(secondResult + j, secondSums);
+	}
+
+	for(; j<numberOfValues; j++)
+	{
+		for(int k=0; k<numberOfRows; k++)
+		{
+			result[j] += scale * coefficients[k * coefficientStride] * rows[k * rowStride + j];
+			secondResult[j] += scale * coefficients[coefficientRowStride + k * coefficientStride] * rows[k * rowStride + j];
+		}
+	}
+}
+#endif
+
+#ifdef NEURAL_NETWORK_AVX512
+//<summary>
+//AVX-512 dot product; four independent sums of eight values are kept, so that the additions don't wait for each other.
+//</summary>
+NEURAL_NETWORK_TARGET_AVX512 double NeuralNetworkKernels::DotProductAvx512(const double* first, const double* second, int numberOfValues)
+{
+	__m512d sums[4] = { _mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd() };
+	int i = 0;
+	for(; i+32<=numberOfValues; i+=32)
+	{
+		sums[0] = _mm512_fmadd_pd(_mm512_loadu_pd(first + i), _mm512_loadu_pd(second + i), sums[0]);
+		sums[1] = _mm512_fmadd_pd(_mm512_loadu_pd(first + i + 8), _mm512_loadu_pd(second + i + 8), sums[1]);
+		sums[2] = _mm512_fmadd_pd(_mm512_loadu_pd(first + i + 16), _mm512_loadu_pd(second + i + 16), sums[2]);
+		sums[3] = _mm512_fmadd_pd(_mm512_loadu_pd(first + i + 24), _mm512_loadu_pd(second + i + 24), sums[3]);
+	}
+	for(; i+8<=numberOfValues; i+=8)
+		sums[0] = _mm512_fmadd_pd(_mm512_loadu_pd(first + i), _mm512_loadu_pd(second + i), sums[0]);
+
+	double result = _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(sums[0], sums[1]), _mm512_add_pd(sums[2], sums[3])));
+	for(; i<numberOfValues; i++)
+		result += first[i] * second[i];
+	return result;
+}
+
+//<summary>
+//AVX-512 integer dot product of 64 bytes at a time; see 'DotProductInt8Avx2'.
+//</summary>
+NEURAL_NETWORK_TARGET_AVX512 int NeuralNetworkKernels::DotProductInt8Avx512(const unsigned char* values, const signed char* weights, int numberOfValues)
+{
+	__m512i ones = _mm512_set1_epi16(1);
+	__m512i sums = _mm512_setzero_si512();
+	int i = 0;
+	for(; i+64<=numberOfValues; i+=64)
+	{
+		__m512i products = _mm512_maddubs_epi16(_mm512_loadu_si512((const void*)(values + i)), _mm512_loadu_si512((const void*)(weights + i)));
+		sums = _mm512_add_epi32(sums, _mm512_madd_epi16(products, ones));
+	}
+
+	int result = _mm512_reduce_add_epi32(sums);
+	for(; i<numberOfValues; i++)
+		result += values[i] * weights[i];
+	return result;
+}
+
+NEURAL_NETWORK_TARGET_AVX512 void NeuralNetworkKernels::AddScaledAvx512(double* destination, const double* source, double scale, int numberOfValues)
+{
+	__m512d scales = _mm512_set1_pd(scale);
+	int i = 0;
+	for(; i+8<=numberOfValues; i+=8)
+		_mm512_storeu_pd(destination + i, _mm512_fmadd_pd(scales, _mm512_loadu_pd(source + i), _mm512_loadu_pd(destination + i)));
+	for(; i<numberOfValues; i++)
+		destination[i] += scale * source[i];
+}
+
+NEURAL_NETWORK_TARGET_AVX512 void NeuralNetworkKernels::LogisticDeltasAvx512(const double* values, const double* errors, double* deltas, int numberOfValues)
+{
+	__m512d ones = _mm512_set1_pd(1.0);
+	int i = 0;
+	for(; i+8<=numberOfValues; i+=8)
+	{
+		__m512d currentValues = _mm512_loadu_pd(values + i);
+		__m512d derivatives = _mm512_mul_pd(currentValues, _mm512_sub_pd(ones, currentValues));
+		_mm512_storeu_pd(deltas + i, _mm512_mul_pd(derivatives, _mm512_loadu_pd(errors + i)));
+	}
+	for(; i<numberOfValues; i++)
+		deltas[i] = values[i] * (1 - values[i]) * errors[i];
+}
+
+NEURAL_NETWORK_TARGET_AVX512 void NeuralNetworkKernels::LogisticRationalAvx512(double* values, int numberOfValues)
+{
+	__m512d halves = _mm512_set1_pd(0.5);
+	__m512d limits = _mm512_set1_pd(LOGISTIC_RATIONAL_LIMIT / 2), negativeLimits = _mm512_set1_pd(-LOGISTIC_RATIONAL_LIMIT / 2);
+	__m512d numerator0 = _mm512_set1_pd(135135.0), numerator1 = _mm512_set1_pd(17325.0), numerator2 = _mm512_set1_pd(378.0);
+	__m512d denominator0 = _mm512_set1_pd(135135.0), denominator1 = _mm512_set1_pd(62370.0), denominator2 = _mm512_set1_pd(3150.0), denominator3 = _mm512_set1_pd(28.0);
+	int i = 0;
+	for(; i+8<=numberOfValues; i+=8)
+	{
+		__m512d y = _mm512_mul_pd(_mm512_loadu_pd(values + i), halves);
+		y = _mm512_min_pd(_mm512_max_pd(y, negativeLimits), limits);
+		__m512d y2 = _mm512_mul_pd(y, y);
+		__m512d numerator = _mm512_mul_pd(y, _mm512_fmadd_pd(y2, _mm512_fmadd_pd(y2, _mm512_add_pd(y2, numerator2), numerator1), numerator0));
+		__m512d denominator = _mm512_fmadd_pd(y2, _mm512_fmadd_pd(y2, _mm512_fmadd_pd(y2, denominator3, denominator2), denominator1), denominator0);
+		_mm512_storeu_pd(values + i, _mm512_fmadd_pd(halves, _mm512_div_pd(numerator, denominator), halves));
+	}
+	for(; i<numberOfValues; i++)
+		values[i] = LogisticRationalValue(values[i]);
+}
+
+NEURAL_NETWORK_TARGET_AVX512 void NeuralNetworkKernels::LogisticTableAvx512(double* values, int numberOfValues)
+{
+	__m512d ranges = _mm512_set1_pd(LOGISTIC_TABLE_RANGE), negativeRanges = _mm512_set1_pd(-LOGISTIC_TABLE_RANGE);
+	__m512d steps = _mm512_set1_pd(LOGISTIC_TABLE_STEPS);
+	__m256i lastIndices = _mm256_set1_epi32(LOGISTIC_TABLE_SIZE - 2);
+	int i = 0;
+	for(; i+8<=numberOfValues; i+=8)
+	{
+		__m512d x = _mm512_min_pd(_mm512_max_pd(_mm512_loadu_pd(values + i), negativeRanges), ranges);
+		__m512d positions = _mm512_mul_pd(_mm512_add_pd(x, ranges), steps);
+		__m256i indices = _mm256_min_epi32(_mm512_cvttpd_epi32(positions), lastIndices);
+		__m512d fractions = _mm512_sub_pd(positions, _mm512_cvtepi32_pd(indices));
+		__m512d lower = _mm512_i32gather_pd(indices, DoubleLogisticTable, 8);
+		__m512d upper = _mm512_i32gather_pd(indices, DoubleLogisticTable + 1, 8);
+		_mm512_storeu_pd(values + i, _mm512_fmadd_pd(fractions, _mm512_sub_pd(upper, lower), lower));
+	}
+	for(; i<numberOfValues; i++)
+		values[i] = LogisticTableValue(values[i]);
+}
+
+//<summary>
+//AVX-512 2x4 block of dot products; the eight sums are kept in registers, so each loaded value is used two or four times.
+//</summary>
+NEURAL_NETWORK_TARGET_AVX512 void NeuralNetworkKernels::DotProductTileAvx512(const double* first, int firstStride, const double* second, int secondStride, double* result, int resultStride, int numberOfValues)
+{
+	__m512d sum00 = _mm512_setzero_pd(), sum01 = _mm512_setzero_pd(), sum02 = _mm512_setzero_pd(), sum03 = _mm512_setzero_pd();
+	__m512d sum10 = _mm512_setzero_pd(), sum11 = _mm512_setzero_pd(), sum12 = _mm512_setzero_pd(), sum13 = _mm512_setzero_pd();
+
+	int k = 0;
+	for(; k+8<=numberOfValues; k+=8)
+	{
+		__m512d firstValues = _mm512_loadu_pd(first + k);
+		__m512d secondValues = _mm512_loadu_pd(first + firstStride + k);
+		__m512d columnValues = _mm512_loadu_pd(second + k);
+		sum00 = _mm512_fmadd_pd(firstValues, columnValues, sum00);
+		sum10 = _mm512_fmadd_pd(secondValues, columnValues, sum10);
+		columnValues = _mm512_loadu_pd(second + secondStride + k);
+		sum01 = _mm512_fmadd_pd(firstValues, columnValues, sum01);
+		sum11 = _mm512_fmadd_pd(secondValues, columnValues, sum11);
+		columnValues = _mm512_loadu_pd(second + 2 * secondStride + k);
+		sum02 = _mm512_fmadd_pd(firstValues, columnValues, sum02);
+		sum12 = _mm512_fmadd_pd(secondValues, columnValues, sum12);
+		columnValues = _mm512_loadu_pd(second + 3 * secondStride + k);
+		sum03 = _mm512_fmadd_pd(firstValues, columnValues, sum03);
+		sum13 = _mm512_fmadd_pd(secondValues, columnValues, sum13);
+	}
+
+	result[0] = _mm512_reduce_add_pd(sum00);
+	result[1] = _mm512_reduce_add_pd(sum01);
+	result[2] = _mm512_reduce_add_pd(sum02);
+	result[3] = _mm512_reduce_add_pd(sum03);
+	result[resultStride] = _mm512_reduce_add_pd(sum10);
+	result[resultStride + 1] = _mm512_reduce_add_pd(sum11);
+	result[resultStride + 2] = _mm512_reduce_add_pd(sum12);
+	result[resultStride + 3] = _mm512_reduce_add_pd(sum13);
+
+	for(int i=0; i<KERNELS_TILE_ROWS; i++)
+		for(int remaining=k; remaining<numberOfValues; remaining++)
+			for(int j=0; j<KERNELS_TILE_COLUMNS; j++)
+				result[i * resultStride + j] += first[i * firstStride + remaining] * second[j * secondStride + remaining];
+}
+
+//<summary>
+//AVX-512 version of 'AddProductsTile'; like 'AddProductsTileAvx2', with blocks of 32 values of both rows.
+//</summary>
+NEURAL_NETWORK_TARGET_AVX512 void NeuralNetworkKernels::AddProductsTileAvx512(const double* coefficients, int coefficientRowStride, int coefficientStride, const double* rows, int rowStride, int numberOfRows,
+																							  double* result, int resultStride, int numberOfValues, double scale)
+{
+	double* secondResult = result + resultStride;
+	int j = 0;
+	for(; j+32<=numberOfValues; j+=32)
+	{
+		__m512d sum00 = _mm512_loadu_pd(result + j), sum01 = _mm512_loadu_pd(result + j + 8);
+		__m512d sum02 = _mm512_loadu_pd(result + j + 16), sum03 = _mm512_loadu_pd(result + j + 24);
+		__m512d sum10 = _mm512_loadu_pd(secondResult + j), sum11 = _mm512_loadu_pd(secondResult + j + 8);
+		__m512d sum12 = _mm512_loadu_pd(secondResult + j + 16), sum13 = _mm512_loadu_pd(secondResult + j + 24);
+
+		const double* row = rows + j;
+		for(int k=0; k<numberOfRows; k++, row+=rowStride)
+		{
+			__m512d firstScales = _mm512_set1_pd(scale * coefficients[k * coefficientStride]);
+			__m512d secondScales = _mm512_set1_pd(scale * coefficients[coefficientRowStride + k * coefficientStride]);
+			__m512d values = _mm512_loadu_pd(row);
+			sum00 = _mm512_fmadd_pd(firstScales, values, sum00);
+			sum10 = _mm512_fmadd_pd(secondScales, values, sum10);
+			values = _mm512_loadu_pd(row + 8);
+			sum01 = _mm512_fmadd_pd(firstScales, values, sum01);
+			sum11 = _mm512_fmadd_pd(secondScales, values, sum11);
+			values = _mm512_loadu_pd(row + 16);
+			sum02 = _mm512_fmadd_pd(firstScales, values, sum02);
+			sum12 = _mm512_fmadd_pd(secondScales, values, sum12);
+			values = _mm512_loadu_pd(row + 24);
+			sum03 = _mm512_fmadd_pd(firstScales, values, sum03);
+			sum13 = _mm512_fmadd_pd(secondScales, values, sum13);
+		}
+
+		_mm512_storeu_pd(result + j, sum00);
+		_mm512_storeu_pd(result + j + 8, sum01);
+		_mm512_storeu_pd(result + j + 16, sum02);
+		_mm512_storeu_pd(result + j + 24, sum03);
+		_mm512_storeu_pd(secondResult + j, sum10);
+		_mm512_storeu_pd(secondResult + j + 8, sum11);
+		_mm512_storeu_pd(secondResult + j + 16, sum12);
+		_mm512_storeu_pd(secondResult + j + 24, sum13);
+	}
+
+	for(; j+8<=numberOfValues; j+=8)
+	{
+		__m512d firstSums = _mm512_loadu_pd(result + j);
+		__m512d secondSums = _mm512_loadu_pd(secondResult + j);
+		for(int k=0; k<numberOfRows; k++)
+		{
+			__m512d values = _mm512_loadu_pd(rows + k * rowStride + j);
+			firstSums = _mm512_fmadd_pd(_mm512_set1_pd(scale * coefficients[k * coefficientStride]), values, firstSums);
+			secondSums = _mm512_fmadd_pd(_mm512_set1_pd(scale * coefficients[coefficientRowStride + k * coefficientStride]), values, secondSums);
+		}
+		_mm512_storeu_pd(result + j, firstSums);
+		_mm512_storeu_pd(secondResult + j, secondSums);
+	}
+
+	for(; j<numberOfValues; j++)
+	{
+		for(int k=0; k<numberOfRows; k++)
+		{
+			result[j] += scale * coefficients[k * coefficientStride] * rows[k * rowStride + j];
+			secondResult[j] += scale * coefficients[coefficientRowStride + k * coefficientStride] * rows[k * rowStride + j];
+		}
+	}
+}
+
+//<summary>
+//AVX-512 dot product of floats; four independent sums of sixteen values are kept, so that the additions don't wait for each other.
+//</summary>
+NEURAL_NETWORK_TARGET_AVX512 float NeuralNetworkKernels::DotProductAvx512(const float* first, const float* second, int numberOfValues)
+{
+	__m512 sums[4] = { _mm512_setzero_ps(), _mm512_setzero_ps(), _mm512_setzero_ps(), _mm512_setzero_ps() };
+	int i = 0;
+	for(; i+64<=numberOfValues; i+=64)
+	{
+		sums[0] = _mm512_fmadd_ps(_mm512_loadu_ps(first + i), _mm512_loadu_ps(second + i), sums[0]);
+		sums[1] = _mm512_fmadd_ps(_mm512_loadu_ps(first + i + 16), _mm512_loadu_ps(second + i + 16), sums[1]);
+		sums[2] = _mm512_fmadd_ps(_mm512_loadu_ps(first + i + 32), _mm512_loadu_ps(second + i + 32), sums[2]);
+		sums[3] = _mm512_fmadd_ps(_mm512_loadu_ps(first + i + 48), _mm512_loadu_ps(second + i + 48), sums[3]);
+	}
+	for(; i+16<=numberOfValues; i+=16)
+		sums[0] = _mm512_fmadd_ps(_mm512_loadu_ps(first + i), _mm512_loadu_ps(second + i), sums[0]);
+
+	float result = _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(sums[0], sums[1]), _mm512_add_ps(sums[2], sums[3])));
+	for(; i<numberOfValues; i++)
+		result += first[i] * second[i];
+	return result;
+}
+
+//<summary>
+//AVX-512 dot product of floats added up in double precision; eight floats at a time are converted to doubles.
+//</summary>
+NEURAL_NETWORK_TARGET_AVX512 double NeuralNetworkKernels::DotProductDoubleSumAvx512(const float* first, const float* second, int numberOfValues)
+{
+	__m512d sums[4] = { _mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd() };
+	int i = 0;
+	for(; i+32<=numberOfValues; i+=32)
+	{
+		sums[0] = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_loadu_ps(first + i)), _mm512_cvtps_pd(_mm256_loadu_ps(second + i)), sums[0]);
+		sums[1] = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_loadu_ps(first + i + 8)), _mm512_cvtps_pd(_mm256_loadu_ps(second + i + 8)), sums[1]);
+		sums[2] = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_loadu_ps(first + i + 16)), _mm512_cvtps_pd(_mm256_loadu_ps(second + i + 16)), sums[2]);
+		sums[3] = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_loadu_ps(first + i + 24)), _mm512_cvtps_pd(_mm256_loadu_ps(second + i + 24)), sums[3]);
+	}
+	for(; i+8<=numberOfValues; i+=8)
+		sums[0] = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_loadu_ps(first + i)), _mm512_cvtps_pd(_mm256_loadu_ps(second + i)), sums[0]);
+
+	double result = _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(sums[0], sums[1]), _mm512_add_pd(sums[2], sums[3])));
+	for(; i<numberOfValues; i++)
+		result += (double)first[i] * second[i];
+	return result;
+}
+
+NEURAL_NETWORK_TARGET_AVX512 void NeuralNetworkKernels::AddScaledAvx512(float* destination, const float* source, float scale, int numberOfValues)
+{
+	__m512 scales = _mm512_set1_ps(scale);
+	int i = 0;
+	for(; i+16<=numberOfValues; i+=16)
+		_mm512_storeu_ps(destination + i, _mm512_fmadd_ps(scales, _mm512_loadu_ps(source + i), _mm512_loadu_ps(destination + i)));
+	for(; i<numberOfValues; i++)
+		destination[i] += scale * source[i];
+}
+
+NEURAL_NETWORK_TARGET_AVX512 void NeuralNetworkKernels::LogisticDeltasAvx512(const float* values, const float* errors, float* deltas, int numberOfValues)
+{
+	__m512 ones = _mm512_set1_ps(1.0f);
+	int i = 0;
+	for(; i+16<=numberOfValues; i+=16)
+	{
+		__m512 currentValues = _mm512_loadu_ps(values + i);
+		__m512 derivatives = _mm512_mul_ps(currentValues, _mm512_sub_ps(ones, currentValues));
+		_mm512_storeu_ps(deltas + i, _mm512_mul_ps(derivatives, _mm512_loadu_ps(errors + i)));
+	}
+	for(; i<numberOfValues; i++)
+		deltas[i] = values[i] * (1 - values[i]) * errors[i];
+}
+
+NEURAL_NETWORK_TARGET_AVX512 void NeuralNetworkKernels::LogisticRationalAvx512(float* values, int numberOfValues)
+{
+	__m512 halves = _mm512_set1_ps(0.5f);
+	__m512 limits = _mm512_set1_ps((float)(LOGISTIC_RATIONAL_LIMIT / 2)), negativeLimits = _mm512_set1_ps((float)(-LOGISTIC_RATIONAL_LIMIT / 2));
+	__m512 numerator0 = _mm512_set1_ps(135135.0f), numerator1 = _mm512_set1_ps(17325.0f), numerator2 = _mm512_set1_ps(378.0f);
+	__m512 denominator0 = _mm512_set1_ps(135135.0f), denominator1 = _mm512_set1_ps(62370.0f), denominator2 = _mm512_set1_ps(3150.0f), denominator3 = _mm512_set1_ps(28.0f);
+	int i = 0;
+	for(; i+16<=numberOfValues; i+=16)
+	{
+		__m512 y = _mm512_mul_ps(_mm512_loadu_ps(values + i), halves);
+		y = _mm512_min_ps(_mm512_max_ps(y, negativeLimits), limits);
+		__m512 y2 = _mm512_mul_ps(y, y);
+		__m512 numerator = _mm512_mul_ps(y, _mm512_fmadd_ps(y2, _mm512_fmadd_ps(y2, _mm512_add_ps(y2, numerator2), numerator1), numerator0));
+		__m512 denominator = _mm512_fmadd_ps(y2, _mm512_fmadd_ps(y2, _mm512_fmadd_ps(y2, denominator3, denominator2), denominator1), denominator0);
+		_mm512_storeu_ps(values + i, _mm512_fmadd_ps(halves, _mm512_div_ps(numerator, denominator), halves));
+	}
+	for(; i<numberOfValues; i++)
+		values[i] = LogisticRationalValue(values[i]);
+}
+
+NEURAL_NETWORK_TARGET_AVX512 void NeuralNetworkKernels::LogisticTableAvx512(float* values, int numberOfValues)
+{
+	__m512 ranges = _mm512_set1_ps((float)LOGISTIC_TABLE_RANGE), negativeRanges = _mm512_set1_ps((float)-LOGISTIC_TABLE_RANGE);
+	__m512 steps = _mm512_set1_ps((float)LOGISTIC_TABLE_STEPS);
+	__m512i lastIndices = _mm512_set1_epi32(LOGISTIC_TABLE_SIZE - 2);
+	int i = 0;
+	for(; i+16<=numberOfValues; i+=16)
+	{
+		__m512 x = _mm512_min_ps(_mm512_max_ps(_mm512_loadu_ps(values + i), negativeRanges), ranges);
+		__m512 positions = _mm512_mul_ps(_mm512_add_ps(x, ranges), steps);
+		__m512i indices = _mm512_min_epi32(_mm512_cvttps_epi32(positions), lastIndices);
+		__m512 fractions = _mm512_sub_ps(positions, _mm512_cvtepi32_ps(indices));
+		__m512 lower = _mm512_i32gather_ps(indices, FloatLogisticTable, 4);
+		__m512 upper = _mm512_i32gather_ps(indices, FloatLogisticTable + 1, 4);
+		_mm512_storeu_ps(values + i, _mm512_fmadd_ps(fractions, _mm512_sub_ps(upper, lower), lower));
+	}
+	for(; i<numberOfValues; i++)
+		values[i] = LogisticTableValue(values[i]);
+}
+
+//<summary>
+//AVX-512 2x4 block of dot products of floats; like the version for doubles, with sixteen values per register.
+//</summary>
+NEURAL_NETWORK_TARGET_AVX512 void NeuralNetworkKernels::DotProductTileAvx512(const float* first, int firstStride, const float* second, int secondStride, float* result, int resultStride, int numberOfValues)
+{
+	__m512 sum00 = _mm512_setzero_ps(), sum01 = _mm512_setzero_ps(), sum02 = _mm512_setzero_ps(), sum03 = _mm512_setzero_ps();
+	__m512 sum10 = _mm512_setzero_ps(), sum11 = _mm512_setzero_ps(), sum12 = _mm512_setzero_ps(), sum13 = _mm512_setzero_ps();
+
+	int k = 0;
+	for(; k+16<=numberOfValues; k+=16)
+	{
+		__m512 firstValues = _mm512_loadu_ps(first + k);
+		__m512 secondValues = _mm512_loadu_ps(first + firstStride + k);
+		__m512 columnValues = _mm512_loadu_ps(second + k);
+		sum00 = _mm512_fmadd_ps(firstValues, columnValues, sum00);
+		sum10 = _mm512_fmadd_ps(secondValues, columnValues, sum10);
+		columnValues = _mm512_loadu_ps(second + secondStride + k);
+		sum01 = _mm512_fmadd_ps(firstValues, columnValues, sum01);
+		sum11 = _mm512_fmadd_ps(secondValues, columnValues, sum11);
+		columnValues = _mm512_loadu_ps(second + 2 * secondStride + k);
+		sum02 = _mm512_fmadd_ps(firstValues, columnValues, sum02);
+		sum12 = _mm512_fmadd_ps(secondValues, columnValues, sum12);
+		columnValues = _mm512_loadu_ps(second + 3 * secondStride + k);
+		sum03 = _mm512_fmadd_ps(firstValues, columnValues, sum03);
+		sum13 = _mm512_fmadd_ps(secondValues, columnValues, sum13);
+	}
+
+	result[0] = _mm512_reduce_add_ps(sum00);
+	result[1] = _mm512_reduce_add_ps(sum01);
+	result[2] = _mm512_reduce_add_ps(sum02);
+	result[3] = _mm512_reduce_add_ps(sum03);
+	result[resultStride] = _mm512_reduce_add_ps(sum10);
+	result[resultStride + 1] = _mm512_reduce_add_ps(sum11);
+	result[resultStride + 2] = _mm512_reduce_add_ps(sum12);
+	result[resultStride + 3] = _mm512_reduce_add_ps(sum13);
+
+	for(int i=0; i<KERNELS_TILE_ROWS; i++)
+		for(int remaining=k; remaining<numberOfValues; remaining++)
+			for(int j=0; j<KERNELS_TILE_COLUMNS; j++)
+				result[i * resultStride + j] += first[i * firstStride + remaining] * second[j * secondStride + remaining];
+}
+
+//<summary>
+//AVX-512 version of 'AddProductsTile' for floats; like the version for doubles, with blocks of 64 values of both rows.
+//</summary>
+NEURAL_NETWORK_TARGET_AVX512 void NeuralNetworkKernels::AddProductsTileAvx512(const float* coefficients, int coefficientRowStride, int coefficientStride, const float* rows, int rowStride, int numberOfRows,
+																							  float* result, int resultStride, int numberOfValues, float scale)
+{
+	float* secondResult = result + resultStride;
+	int j = 0;
+	for(; j+64<=numberOfValues; j+=64)
+	{
+		__m512 sum00 = _mm512_loadu_ps(result + j), sum01 = _mm512_loadu_ps(result + j + 16);
+		__m512 sum02 = _mm512_loadu_ps(result + j + 32), sum03 = _mm512_loadu_ps(result + j + 48);
+		__m512 sum10 = _mm512_loadu_ps(secondResult + j), sum11 = _mm512_loadu_ps(secondResult + j + 16);
+		__m512 sum12 = _mm512_loadu_ps(secondResult + j + 32), sum13 = _mm512_loadu_ps(secondResult + j + 48);
+
+		const float* row = rows + j;
+		for(int k=0; k<numberOfRows; k++, row+=rowStride)
+		{
+			__m512 firstScales = _mm512_set1_ps(scale * coefficients[k * coefficientStride]);
+			__m512 secondScales = _mm512_set1_ps(scale * coefficients[coefficientRowStride + k * coefficientStride]);
+			__m512 values = _mm512_loadu_ps(row);
+			sum00 = _mm512_fmadd_ps(firstScales, values, sum00);
+			sum10 = _mm512_fmadd_ps(secondScales, values, sum10);
+			values = _mm512_loadu_ps(row + 16);
+			sum01 = _mm512_fmadd_ps(firstScales, values, sum01);
+			sum11 = _mm512_fmadd_ps(secondScales, values, sum11);
+			values = _mm512_loadu_ps(row + 32);
+			sum02 = _mm512_fmadd_ps(firstScales, values, sum02);
+			sum12 = _mm512_fmadd_ps(secondScales, values, sum12);
+			values = _mm512_loadu_ps(row + 48);
+			sum03 = _mm512_fmadd_ps(firstScales, values, sum03);
+			sum13 = _mm512_fmadd_ps(secondScales, values, sum13);
+		}
+
+		_mm512_storeu_ps(result + j, sum00);
+		_mm512_storeu_ps(result + j + 16, sum01);
+		_mm512_storeu_ps(result + j + 32, sum02);
+		_mm512_storeu_ps(result + j + 48, sum03);
+		_mm512_storeu_ps(secondResult + j, sum10);
+		_mm512_storeu_ps(secondResult + j + 16, sum11);
+		_mm512_storeu_ps(secondResult + j + 32, sum12);
+		_mm512_storeu_ps(secondResult + j + 48, sum13);
+	}
+
+	for(; j+16<=numberOfValues; j+=16)
+	{
+		__m512 firstSums = _mm512_loadu_ps(result + j);
+		__m512 secondSums = _mm512_loadu_ps(secondResult + j);
+		for(int k=0; k<numberOfRows; k++)
+		{
+			__m512 values = _mm512_loadu_ps(rows + k * rowStride + j);
+			firstSums = _mm512_fmadd_ps(_mm512_set1_ps(scale * coefficients[k * coefficientStride]), values, firstSums);
+			secondSums = _mm512_fmadd_ps(_mm512_set1_ps(scale * coefficients[coefficientRowStride + k * coefficientStride]), values, secondSums);
+		}
+		_mm512_storeu_ps(result + j, firstSums);
+		_mm512_storeu_ps(secondResult + j, secondSums);
+	}
+
+	for(; j<numberOfValues; j++)
+	{
+		for(int k=0; k<numberOfRows; k++)
+		{
+			result[j] += scale * coefficients[k * coefficientStride] * rows[k * rowStride + j];
+			secondResult[j] += scale * coefficients[coefficientRowStride + k * coefficientStride] * rows[k * rowStride + j];
+		}
+	}
+}
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef NEURAL_NETWORK_MAPPED_CLASSIFIER_H
+#define NEURAL_NETWORK_MAPPED_CLASSIFIER_H
+
+#include "NeuralNetworkModel.h"
+#include <string>
+
+using std::string;
+
+//<summary>
+//Classifies patterns with the weights of a model file mapped into memory; the weights are read directly from the mapping,
+//so creating the classifier only reads the header, regardless of the size of the network. The type of the classifier
+//has to be the type of the weights in the file; 'NeuralNetworkClassifier' can load a model of either type into a copy.
+//</summary>
+template <typename Scalar = float>
+class NeuralNetworkMappedClassifier
+{
+public:
+	//maps the model file 'filename'
+	NeuralNetworkMappedClassifier(const string& filename);
+
+	int Classify(PatternView pattern);
+
+	//how the logistic function is calculated; the activation stored in the model file by default
+	int logisticApproximation;
+
+	//values of the neurons of each layer; the padding at the end is always zero
+	typename AlignedVectorOf<Scalar>::Type inputValues;
+	typename AlignedVectorOf<Scalar>::Type hiddenValues;
+	typename AlignedVectorOf<Scalar>::Type outputValues;
+
+private:
+	NeuralNetworkModel model;
+	const Scalar* hiddenWeights;
+	const Scalar* outputWeights;
+};
+
+
+template <typename Scalar>
+NeuralNetworkMappedClassifier<Scalar>::NeuralNetworkMappedClassifier(const string& filename)
+	: model(filename)
+{
+	this->hiddenWeights = this->model.template GetHiddenWeights<Scalar>();
+	this->outputWeights = this->model.template GetOutputWeights<Scalar>();
+	this->logisticApproximation = (int)this->model.Header.Activation;
+
+	this->inputValues.assign(this->model.Header.InputStride, 0);
+	this->hiddenValues.assign(this->model.Header.HiddenStride, 0);
+	this->outputValues.assign(this->model.Header.NumberOfOutputNeurons, 0);
+}
+
+//<summary>
+//Feeds 'pattern' forward like 'NeuralNetworkBase::FeedForward', with the rows of the mapped weights.
+//</summary>
+//<returns>The index of the output neuron with the highest value.</returns>
+template <typename Scalar>
+int NeuralNetworkMappedClassifier<Scalar>::Classify(PatternView pattern)
+{
+	const NeuralNetworkModelHeader& header = this->model.Header;
+	for(int i=0; i<header.NumberOfInputNeurons; i++)
+		this->inputValues[i] = (Scalar)pattern[i];
+
+	for(int i=0; i<header.NumberOfHiddenNeurons; i++)
+		this->hiddenValues[i] = NeuralNetworkKernels::DotProduct(this->hiddenWeights + i * header.InputStride, &this->inputValues[0], header.InputStride);
+	NeuralNetworkKernels::Logistic(&this->hiddenValues[0], header.NumberOfHiddenNeurons, this->logisticApproximation);
+
+	for(int i=0; i<header.NumberOfOutputNeurons; i++)
+		this->outputValues[i] = NeuralNetworkKernels::DotProduct(this->outputWeights + i * header.HiddenStride, &this->hiddenValues[0], header.HiddenStride);
+	NeuralNetworkKernels::Logistic(&this->outputValues[0], header.NumberOfOutputNeurons, this->logisticApproximation);
+
+	int maxClass = 0;
+	for(int i=1; i<header.NumberOfOutputNeurons; i++)
+		if(this->outputValues[maxClass] < this->outputValues[i])
+			maxClass = i;
+
+	return maxClass;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,333 @@
+#ifndef NEURAL_NETWORK_MODEL_H
+#define NEURAL_NETWORK_MODEL_H
+
+#include "NeuralNetworkBase.h"
+#include <fstream>
+#include <string>
+#include <cstring>
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using std::ofstream;
+using std::string;
+
+//the first bytes of every model file
+const char NEURAL_NETWORK_MODEL_MAGIC[8] = { 'N', 'N', 'M', 'O', 'D', 'E', 'L', 0 };
+
+//version of the model files written by 'NeuralNetworkModel::Save'; files with a higher version are rejected
+const unsigned int NEURAL_NETWORK_MODEL_VERSION = 1;
+
+//types of the weights in a model file
+const unsigned int MODEL_SCALAR_FLOAT = 1;
+const unsigned int MODEL_SCALAR_DOUBLE = 2;
+
+//<summary>
+//The first 64 bytes of a model file. All numbers are stored in the byte order of the processor that wrote the file
+//(little-endian on x86); the offsets are counted from the start of the file.
+//</summary>
+struct NeuralNetworkModelHeader
+{
+	char Magic[8];
+	unsigned int Version;
+
+	//size of the header; later versions can add fields at the end, which are skipped by older programs
+	unsigned int HeaderSize;
+
+	//MODEL_SCALAR_FLOAT or MODEL_SCALAR_DOUBLE
+	unsigned int ScalarType;
+
+	//the logistic function of the neurons, one of the 'LOGISTIC_' constants: the approximation the network was trained with
+	unsigned int Activation;
+
+	int NumberOfInputNeurons;
+	int NumberOfHiddenNeurons;
+	int NumberOfOutputNeurons;
+
+	//number of weights in a row of the hidden and of the output weights, including the padding
+	int InputStride;
+	int HiddenStride;
+
+	unsigned int Reserved;
+
+	//the hidden weights are 'NumberOfHiddenNeurons' rows of 'InputStride' weights, the output weights 'NumberOfOutputNeurons' rows
+	//of 'HiddenStride' weights, both in the layout of 'NeuralNetworkBase'; both blocks start at a multiple of NEURAL_NETWORK_ALIGNMENT bytes
+	unsigned long long HiddenWeightsOffset;
+	unsigned long long OutputWeightsOffset;
+};
+
+//<summary>
+//Model file mapped into memory. A model file contains a 'NeuralNetworkModelHeader' followed by the weight matrices exactly as
+//they are stored by the network, with padded rows, so the mapped weights can be used for classifying without being parsed or
+//copied (see 'NeuralNetworkMappedClassifier'); the operating system reads the pages of the file when they are first used
+//and shares them between the programs that map the same file. The weights are stored in full precision, unlike in the text files.
+//</summary>
+class NeuralNetworkModel
+{
+public:
+	//maps the model file 'filename' into memory and checks its header
+	NeuralNetworkModel(const string& filename);
+	~NeuralNetworkModel();
+
+	//writes the weights of 'network' to the model file 'filename'
+	template <typename Scalar>
+	static void Save(const NeuralNetworkBase<Scalar>& network, const string& filename);
+
+	//returns the first hidden or output weight in the mapped file; 'Scalar' has to be the type of the weights in the file
+	template <typename Scalar>
+	const Scalar* GetHiddenWeights() const;
+	template <typename Scalar>
+	const Scalar* GetOutputWeights() const;
+
+	//copies the weights to 'network', which has to have the same numbers of neurons, converting them to the type of 'network'
+	template <typename Scalar>
+	void CopyWeights(NeuralNetworkBase<Scalar>& network) const;
+
+	NeuralNetworkModelHeader Header;
+
+private:
+	const char* data;
+	size_t size;
+
+	//the mapping can't be shared between two objects
+	NeuralNetworkModel(const NeuralNetworkModel&);
+	NeuralNetworkModel& operator=(const NeuralNetworkModel&);
+
+	void Unmap();
+	void CheckHeader();
+	template <typename Scalar>
+	void CheckScalarType() const;
+	template <typename Scalar>
+	static void CopyMatrix(const char* source, unsigned int sourceScalarType, int numberOfRows, int numberOfColumns, int sourceStride, Scalar* destination, int destinationStride);
+	static unsigned long long GetAlignedOffset(unsigned long long offset);
+	static unsigned int GetScalarType(float) { return MODEL_SCALAR_FLOAT; }
+	static unsigned int GetScalarType(double) { return MODEL_SCALAR_DOUBLE; }
+};
+
+
+//<summary>
+//Maps the whole file read-only; the mapping stays valid until the object is destroyed.
+//</summary>
+//<param name='filename'>A file written by 'Save'.</param>
+NeuralNetworkModel::NeuralNetworkModel(const string& filename)
+{
+	this->data = NULL;
+	this->size = 0;
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file == INVALID_HANDLE_VALUE)
+		throw "Error while reading file";
+
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(NeuralNetworkModelHeader))
+	{
+		CloseHandle(file);
+		throw "Wrong format";
+	}
+	this->size = (size_t)fileSize.QuadPart;
+
+	//the view keeps the mapping and the file open, so the handles can be closed right away
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if(mapping == NULL)
+		throw "Error while reading file";
+	this->data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if(this->data == NULL)
+		throw "Error while reading file";
+#else
+	int file = open(filename.c_str(), O_RDONLY);
+	if(file < 0)
+		throw "Error while reading file";
+
+	struct stat fileStatus;
+	if(fstat(file, &fileStatus) != 0 || fileStatus.st_size < (off_t)sizeof(NeuralNetworkModelHeader))
+	{
+		close(file);
+		throw "Wrong format";
+	}
+	this->size = (size_t)fileStatus.st_size;
+
+	void* mapping = mmap(NULL, this->size, PROT_READ, MAP_SHARED, file, 0);
+	close(file);
+	if(mapping == MAP_FAILED)
+		throw "Error while reading file";
+	this->data = (const char*)mapping;
+#endif
+
+	try
+	{
+		this->CheckHeader();
+	}
+	catch(...)
+	{
+		this->Unmap();
+		throw;
+	}
+}
+
+NeuralNetworkModel::~NeuralNetworkModel()
+{
+	this->Unmap();
+}
+
+void NeuralNetworkModel::Unmap()
+{
+	if(this->data == NULL)
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(this->data);
+#else
+	munmap((void*)this->data, this->size);
+#endif
+	this->data = NULL;
+}
+
+//<summary>
+//Writes the header and the weight matrices of 'network'. The rows are written with their padding, so the file
+//has the same layout as the network in memory.
+//</summary>
+//<param name='network'>A trained network.</param>
+//<param name='filename'>The name of the model file.</param>
+template <typename Scalar>
+void NeuralNetworkModel::Save(const NeuralNetworkBase<Scalar>& network, const string& filename)
+{
+	NeuralNetworkModelHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.Magic, NEURAL_NETWORK_MODEL_MAGIC, sizeof(header.Magic));
+	header.Version = NEURAL_NETWORK_MODEL_VERSION;
+	header.HeaderSize = sizeof(NeuralNetworkModelHeader);
+	header.ScalarType = GetScalarType(Scalar());
+	header.Activation = (unsigned int)network.logisticApproximation;
+	header.NumberOfInputNeurons = network.numberOfInputNeurons;
+	header.NumberOfHiddenNeurons = network.numberOfHiddenNeurons;
+	header.NumberOfOutputNeurons = network.numberOfOutputNeurons;
+	header.InputStride = network.inputStride;
+	header.HiddenStride = network.hiddenStride;
+
+	unsigned long long hiddenWeightsSize = (unsigned long long)network.numberOfHiddenNeurons * network.inputStride * sizeof(Scalar);
+	unsigned long long outputWeightsSize = (unsigned long long)network.numberOfOutputNeurons * network.hiddenStride * sizeof(Scalar);
+	header.HiddenWeightsOffset = GetAlignedOffset(sizeof(NeuralNetworkModelHeader));
+	header.OutputWeightsOffset = GetAlignedOffset(header.HiddenWeightsOffset + hiddenWeightsSize);
+
+	ofstream outFile(filename.c_str(), ofstream::binary);
+	if(!outFile)
+		throw "Error while writing file";
+
+	char padding[NEURAL_NETWORK_ALIGNMENT] = { 0 };
+	outFile.write((const char*)&header, sizeof(header));
+	outFile.write(padding, (std::streamsize)(header.HiddenWeightsOffset - sizeof(header)));
+	outFile.write((const char*)&network.hiddenWeights[0], (std::streamsize)hiddenWeightsSize);
+	outFile.write(padding, (std::streamsize)(header.OutputWeightsOffset - header.HiddenWeightsOffset - hiddenWeightsSize));
+	outFile.write((const char*)&network.outputWeights[0], (std::streamsize)outputWeightsSize);
+
+	outFile.close();
+	if(!outFile)
+		throw "Error while writing file";
+}
+
+template <typename Scalar>
+const Scalar* NeuralNetworkModel::GetHiddenWeights() const
+{
+	this->CheckScalarType<Scalar>();
+	return (const Scalar*)(this->data + this->Header.HiddenWeightsOffset);
+}
+
+template <typename Scalar>
+const Scalar* NeuralNetworkModel::GetOutputWeights() const
+{
+	this->CheckScalarType<Scalar>();
+	return (const Scalar*)(this->data + this->Header.OutputWeightsOffset);
+}
+
+//<summary>
+//Copies the weights to a network of any type, e.g. a double model to a float classifier; the strides of the network
+//can differ from the ones in the file.
+//</summary>
+template <typename Scalar>
+void NeuralNetworkModel::CopyWeights(NeuralNetworkBase<Scalar>& network) const
+{
+	if(network.numberOfInputNeurons != this->Header.NumberOfInputNeurons || network.numberOfHiddenNeurons != this->Header.NumberOfHiddenNeurons
+	   || network.numberOfOutputNeurons != this->Header.NumberOfOutputNeurons)
+		throw "Different network sizes";
+
+	CopyMatrix(this->data + this->Header.HiddenWeightsOffset, this->Header.ScalarType, this->Header.NumberOfHiddenNeurons, this->Header.NumberOfInputNeurons,
+			   this->Header.InputStride, &network.hiddenWeights[0], network.inputStride);
+	CopyMatrix(this->data + this->Header.OutputWeightsOffset, this->Header.ScalarType, this->Header.NumberOfOutputNeurons, this->Header.NumberOfHiddenNeurons,
+			   this->Header.HiddenStride, &network.outputWeights[0], network.hiddenStride);
+	network.logisticApproximation = (int)this->Header.Activation;
+	network.UpdateInputWeights();
+}
+
+//<summary>
+//Checks that the file is a model file of a supported version and that the weight matrices are inside the file.
+//</summary>
+void NeuralNetworkModel::CheckHeader()
+{
+	memcpy(&this->Header, this->data, sizeof(NeuralNetworkModelHeader));
+	if(memcmp(this->Header.Magic, NEURAL_NETWORK_MODEL_MAGIC, sizeof(this->Header.Magic)) != 0)
+		throw "Wrong format";
+	if(this->Header.Version > NEURAL_NETWORK_MODEL_VERSION || this->Header.HeaderSize < sizeof(NeuralNetworkModelHeader))
+		throw "Unsupported model version";
+	if(this->Header.ScalarType != MODEL_SCALAR_FLOAT && this->Header.ScalarType != MODEL_SCALAR_DOUBLE)
+		throw "Wrong format";
+	int activation = (int)this->Header.Activation;
+	if(activation != LOGISTIC_EXACT && activation != LOGISTIC_RATIONAL && activation != LOGISTIC_TABLE)
+		throw "Wrong format";
+
+	if(this->Header.NumberOfInputNeurons <= 0 || this->Header.NumberOfHiddenNeurons <= 0 || this->Header.NumberOfOutputNeurons <= 0
+	   || this->Header.InputStride < this->Header.NumberOfInputNeurons || this->Header.HiddenStride < this->Header.NumberOfHiddenNeurons)
+		throw "Wrong format";
+
+	//the mapping starts at a page boundary, so blocks at multiples of NEURAL_NETWORK_ALIGNMENT are aligned in memory
+	unsigned long long scalarSize = this->Header.ScalarType == MODEL_SCALAR_FLOAT ? sizeof(float) : sizeof(double);
+	unsigned long long hiddenWeightsSize = (unsigned long long)this->Header.NumberOfHiddenNeurons * this->Header.InputStride * scalarSize;
+	unsigned long long outputWeightsSize = (unsigned long long)this->Header.NumberOfOutputNeurons * this->Header.HiddenStride * scalarSize;
+	if(this->Header.HiddenWeightsOffset % NEURAL_NETWORK_ALIGNMENT != 0 || this->Header.OutputWeightsOffset % NEURAL_NETWORK_ALIGNMENT != 0
+	   || this->Header.HiddenWeightsOffset < this->Header.HeaderSize || this->Header.HiddenWeightsOffset + hiddenWeightsSize > this->size
+	   || this->Header.OutputWeightsOffset < this->Header.HeaderSize || this->Header.OutputWeightsOffset + outputWeightsSize > this->size)
+		throw "Wrong format";
+}
+
+template <typename Scalar>
+void NeuralNetworkModel::CheckScalarType() const
+{
+	if(this->Header.ScalarType != GetScalarType(Scalar()))
+		throw "Wrong scalar type";
+}
+
+template <typename Scalar>
+void NeuralNetworkModel::CopyMatrix(const char* source, unsigned int sourceScalarType, int numberOfRows, int numberOfColumns, int sourceStride, Scalar* destination, int destinationStride)
+{
+	for(int i=0; i<numberOfRows; i++)
+		for(int j=0; j<numberOfColumns; j++)
+		{
+			if(sourceScalarType == MODEL_SCALAR_FLOAT)
+				destination[i * destinationStride + j] = (Scalar)((const float*)source)[i * sourceStride + j];
+			else
+				destination[i * destinationStride + j] = (Scalar)((const double*)source)[i * sourceStride + j];
+		}
+}
+
+//<summary>
+//Returns 'offset' rounded up to a multiple of NEURAL_NETWORK_ALIGNMENT.
+//</summary>
+unsigned long long NeuralNetworkModel::GetAlignedOffset(unsigned long long offset)
+{
+	return (offset + NEURAL_NETWORK_ALIGNMENT - 1) / NEURAL_NETWORK_ALIGNMENT * NEURAL_NETWORK_ALIGNMENT;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,203 @@
+#ifndef NEURAL_NETWORK_QUANTIZED_CLASSIFIER_H
+#define NEURAL_NETWORK_QUANTIZED_CLASSIFIER_H
+
+#include "NeuralNetworkBase.h"
+#include <vector>
+#include <cmath>
+
+using std::vector;
+
+//the largest quantized weight and value; the values are 0 to 127 rather than 0 to 255 so that the sums of two products
+//of the integer dot products fit into 16 bits
+const int QUANTIZED_MAXIMUM = 127;
+
+//the lookup table of the logistic function has QUANTIZED_LOGISTIC_STEPS entries per unit between -QUANTIZED_LOGISTIC_RANGE
+//and QUANTIZED_LOGISTIC_RANGE; outside of that range the logistic function is within 0.0004 of 0 or 1, which rounds to the ends of the table
+const int QUANTIZED_LOGISTIC_RANGE = 8;
+const int QUANTIZED_LOGISTIC_STEPS = 128;
+const int QUANTIZED_LOGISTIC_TABLE_SIZE = 2 * QUANTIZED_LOGISTIC_RANGE * QUANTIZED_LOGISTIC_STEPS + 1;
+
+//<summary>
+//Classifier that uses the weights of a trained network quantized to 8-bit integers. The weights of each layer are divided by
+//a scale (the largest absolute weight of the layer divided by 127) and rounded, and the values of the input and hidden neurons
+//between 0 and 1 are stored as integers between 0 and 127, so the sums of the neurons are integer dot products.
+//The values of the hidden neurons are read from a lookup table of the logistic function; the output neurons aren't
+//passed through the logistic function at all, because it doesn't change which output neuron has the highest sum.
+//</summary>
+class NeuralNetworkQuantizedClassifier
+{
+public:
+	//quantizes the weights of 'network'
+	template <typename Scalar>
+	NeuralNetworkQuantizedClassifier(const NeuralNetworkBase<Scalar>& network);
+
+	//classifies a pattern whose values are between 0 and 1
+	int Classify(PatternView pattern);
+
+	//classifies a pattern of zeros and ones, e.g. the pixels of an image
+	int Classify(const BinaryPattern& pattern);
+
+	//the weight of the connection from the input neuron 'j' to the hidden neuron 'i' is 'hiddenScale * hiddenWeights[i * inputStride + j]'
+	AlignedInt8Vector hiddenWeights;
+	double hiddenScale;
+
+	//the weight of the connection from the hidden neuron 'j' to the output neuron 'i' is 'outputScale * outputWeights[i * hiddenStride + j]'
+	AlignedInt8Vector outputWeights;
+	double outputScale;
+
+	//values of the input and hidden neurons multiplied by 127; the padding at the end is always zero
+	AlignedUint8Vector inputValues;
+	AlignedUint8Vector hiddenValues;
+
+	//the sums of the output neurons, in units of 'outputScale / 127'
+	vector<int> outputSums;
+
+	int numberOfInputNeurons;
+	int numberOfHiddenNeurons;
+	int numberOfOutputNeurons;
+
+	//number of values in a row of 'hiddenWeights' and 'outputWeights'
+	int inputStride;
+	int hiddenStride;
+
+private:
+	//the value of a hidden neuron multiplied by 127 for each sum between -QUANTIZED_LOGISTIC_RANGE and QUANTIZED_LOGISTIC_RANGE
+	vector<unsigned char> logisticTable;
+
+	//converts the integer sum of a hidden neuron to a number of table entries from the middle of 'logisticTable'
+	double tableStepsPerSum;
+
+	//indices of the set inputs of the last binary pattern
+	vector<int> activeInputs;
+
+	int FeedForward();
+	template <typename Scalar>
+	double QuantizeWeights(const Scalar* weights, int numberOfRows, int numberOfColumns, int stride, AlignedInt8Vector& quantizedWeights, int quantizedStride);
+	int GetAlignedStride(int numberOfValues);
+};
+
+
+//<summary>
+//Quantizes the weights of 'network' and fills the lookup table of the logistic function.
+//</summary>
+//<param name='network'>A trained network, e.g. a 'NeuralNetworkClassifier' that loaded the saved weights.</param>
+template <typename Scalar>
+NeuralNetworkQuantizedClassifier::NeuralNetworkQuantizedClassifier(const NeuralNetworkBase<Scalar>& network)
+{
+	this->numberOfInputNeurons = network.numberOfInputNeurons;
+	this->numberOfHiddenNeurons = network.numberOfHiddenNeurons;
+	this->numberOfOutputNeurons = network.numberOfOutputNeurons;
+
+	this->inputStride = this->GetAlignedStride(this->numberOfInputNeurons);
+	this->hiddenStride = this->GetAlignedStride(this->numberOfHiddenNeurons);
+
+	this->hiddenScale = this->QuantizeWeights(&network.hiddenWeights[0], this->numberOfHiddenNeurons, this->numberOfInputNeurons, network.inputStride, this->hiddenWeights, this->inputStride);
+	this->outputScale = this->QuantizeWeights(&network.outputWeights[0], this->numberOfOutputNeurons, this->numberOfHiddenNeurons, network.hiddenStride, this->outputWeights, this->hiddenStride);
+
+	this->inputValues.assign(this->inputStride, 0);
+	this->hiddenValues.assign(this->hiddenStride, 0);
+	this->outputSums.assign(this->numberOfOutputNeurons, 0);
+	this->activeInputs.assign(BINARY_PATTERN_BITS, 0);
+
+	//the sum of a hidden neuron is 'hiddenScale * sum / 127', since the input values are multiplied by 127
+	this->tableStepsPerSum = this->hiddenScale / QUANTIZED_MAXIMUM * QUANTIZED_LOGISTIC_STEPS;
+	this->logisticTable.resize(QUANTIZED_LOGISTIC_TABLE_SIZE);
+	for(int i=0; i<QUANTIZED_LOGISTIC_TABLE_SIZE; i++)
+	{
+		double x = (double)(i - QUANTIZED_LOGISTIC_RANGE * QUANTIZED_LOGISTIC_STEPS) / QUANTIZED_LOGISTIC_STEPS;
+		this->logisticTable[i] = (unsigned char)floor(QUANTIZED_MAXIMUM / (1 + exp(-x)) + 0.5);
+	}
+}
+
+int NeuralNetworkQuantizedClassifier::Classify(PatternView pattern)
+{
+	for(int i=0; i<this->numberOfInputNeurons; i++)
+	{
+		double value = pattern[i] < 0.0 ? 0.0 : (pattern[i] > 1.0 ? 1.0 : pattern[i]);
+		this->inputValues[i] = (unsigned char)(value * QUANTIZED_MAXIMUM + 0.5);
+	}
+
+	return this->FeedForward();
+}
+
+int NeuralNetworkQuantizedClassifier::Classify(const BinaryPattern& pattern)
+{
+	for(int i=0; i<this->numberOfInputNeurons; i++)
+		this->inputValues[i] = 0;
+
+	int numberOfActiveInputs = pattern.GetSetBits(&this->activeInputs[0]);
+	for(int i=0; i<numberOfActiveInputs; i++)
+		this->inputValues[this->activeInputs[i]] = QUANTIZED_MAXIMUM;
+
+	return this->FeedForward();
+}
+
+//<summary>
+//Calculates the values of the hidden neurons and the sums of the output neurons for the quantized input values.
+//</summary>
+//<returns>The index of the output neuron with the highest sum.</returns>
+int NeuralNetworkQuantizedClassifier::FeedForward()
+{
+	const int tableMiddle = QUANTIZED_LOGISTIC_RANGE * QUANTIZED_LOGISTIC_STEPS;
+	for(int i=0; i<this->numberOfHiddenNeurons; i++)
+	{
+		int sum = NeuralNetworkKernels::DotProductInt8(&this->inputValues[0], &this->hiddenWeights[i * this->inputStride], this->inputStride);
+
+		int tableIndex = tableMiddle + (int)floor(sum * this->tableStepsPerSum + 0.5);
+		if(tableIndex < 0)
+			tableIndex = 0;
+		else if(tableIndex >= QUANTIZED_LOGISTIC_TABLE_SIZE)
+			tableIndex = QUANTIZED_LOGISTIC_TABLE_SIZE - 1;
+		this->hiddenValues[i] = this->logisticTable[tableIndex];
+	}
+
+	int maxClass = 0;
+	for(int i=0; i<this->numberOfOutputNeurons; i++)
+	{
+		this->outputSums[i] = NeuralNetworkKernels::DotProductInt8(&this->hiddenValues[0], &this->outputWeights[i * this->hiddenStride], this->hiddenStride);
+		if(this->outputSums[maxClass] < this->outputSums[i])
+			maxClass = i;
+	}
+
+	return maxClass;
+}
+
+//<summary>
+//Quantizes the weights of a layer with a single scale, so that the largest absolute weight becomes 127 or -127.
+//</summary>
+//<param name='weights'>The weights of the layer, one row per neuron.</param>
+//<param name='numberOfRows'>The number of neurons of the layer.</param>
+//<param name='numberOfColumns'>The number of neurons of the previous layer.</param>
+//<param name='stride'>The number of values in a row of 'weights'.</param>
+//<param name='quantizedWeights'>Filled with the quantized weights; the padding of the rows is zero.</param>
+//<param name='quantizedStride'>The number of values in a row of 'quantizedWeights'.</param>
+//<returns>The scale of the layer.</returns>
+template <typename Scalar>
+double NeuralNetworkQuantizedClassifier::QuantizeWeights(const Scalar* weights, int numberOfRows, int numberOfColumns, int stride, AlignedInt8Vector& quantizedWeights, int quantizedStride)
+{
+	double maximumWeight = 0.0;
+	for(int i=0; i<numberOfRows; i++)
+		for(int j=0; j<numberOfColumns; j++)
+			if(fabs(weights[i * stride + j]) > maximumWeight)
+				maximumWeight = fabs(weights[i * stride + j]);
+
+	double scale = maximumWeight > 0.0 ? maximumWeight / QUANTIZED_MAXIMUM : 1.0;
+
+	quantizedWeights.assign(numberOfRows * quantizedStride, 0);
+	for(int i=0; i<numberOfRows; i++)
+		for(int j=0; j<numberOfColumns; j++)
+			quantizedWeights[i * quantizedStride + j] = (signed char)floor(weights[i * stride + j] / scale + 0.5);
+
+	return scale;
+}
+
+//<summary>
+//Returns 'numberOfValues' rounded up to a multiple of NEURAL_NETWORK_ALIGNMENT bytes.
+//</summary>
+int NeuralNetworkQuantizedClassifier::GetAlignedStride(int numberOfValues)
+{
+	int valuesPerBlock = NEURAL_NETWORK_ALIGNMENT / sizeof(signed char);
+	return (numberOfValues + valuesPerBlock - 1) / valuesPerBlock * valuesPerBlock;
+}
+
+#endif
\ No newline at end of file
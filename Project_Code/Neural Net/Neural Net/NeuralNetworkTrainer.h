@@ -3,6 +3,10 @@
 
 #include "NeuralNetworkBase.h"
 #include "NeuralNetworkInput.h"
+#include "TrainingWorkspace.h"
+#include "ThreadBarrier.h"
+#include "ThreadPool.h"
+#include "NeuralNetworkModel.h"
 #include <vector>
 #include <ctime>
 #include <fstream>
@@ -10,23 +14,116 @@
 using std::vector;
 using std::ofstream;
 
-class NeuralNetworkTrainer : public NeuralNetworkBase
+//<summary>
+//Data shared by the threads that train a network together.
+//</summary>
+struct ParallelTrainingState
+{
+	ParallelTrainingState(void* trainer, const NeuralNetworkInput& trainData, int numberOfThreads, int maximumNumberOfEpochs, double errorThreshold, double* threadErrors);
+
+	//the trainer whose network is trained
+	void* Trainer;
+
+	const NeuralNetworkInput& TrainData;
+	int NumberOfThreads;
+	int MaximumNumberOfEpochs;
+	double ErrorThreshold;
+
+	ThreadBarrier Barrier;
+
+	//the squared errors of the patterns of each thread in the even and in the odd epochs; while the errors of an epoch
+	//are added up, the threads that are done with that can already write the errors of the next epoch
+	double* ThreadErrors[2];
+
+	//the sum of the squared errors of the last epoch
+	double Error;
+};
+
+//<summary>
+//Creates the state of a training with 'numberOfThreads' threads; 'threadErrors' has room for '2 * numberOfThreads' errors,
+//so that the state doesn't allocate memory.
+//</summary>
+ParallelTrainingState::ParallelTrainingState(void* trainer, const NeuralNetworkInput& trainData, int numberOfThreads, int maximumNumberOfEpochs, double errorThreshold, double* threadErrors)
+	: TrainData(trainData), Barrier(numberOfThreads)
+{
+	this->Trainer = trainer;
+	this->NumberOfThreads = numberOfThreads;
+	this->MaximumNumberOfEpochs = maximumNumberOfEpochs;
+	this->ErrorThreshold = errorThreshold;
+	this->ThreadErrors[0] = threadErrors;
+	this->ThreadErrors[1] = threadErrors + numberOfThreads;
+	this->Error = 0.0;
+}
+
+//<summary>
+//Trains a network whose weights are of type 'Scalar'; the network can also be trained with floats, optionally with the sums
+//of the neurons added up in double precision (see 'NeuralNetworkInput::AccumulateInDouble').
+//</summary>
+template <typename Scalar = double>
+class NeuralNetworkTrainer : public NeuralNetworkBase<Scalar>
 {
 public:
 	NeuralNetworkTrainer(int numberOfInputNeurons, int numberOfHiddenNeurons, int numberOfOutputNeurons);
 	void Train(NeuralNetworkInput trainData);
 
+	//corrects the weights after 'FeedForward' was called for a pattern; returns the squared error
+	double Backpropagate(PatternView expectedOutput, double learningRate);
+
+	//corrects the weights after 'FeedForward' was called for a binary pattern; only 'inputWeights' are corrected in the first layer
+	double BackpropagateBinary(PatternView expectedOutput, double learningRate);
+
+	//goes through all patterns once, in batches of 'trainData.BatchSize' patterns; returns the sum of the squared errors
+	double TrainEpoch(const NeuralNetworkInput& trainData);
+
 private:
 	void InitializeWeights();
-	double Backpropagate(vector<double> expectedOutput, double learningRate);
 	void SaveWeightsToFile();
-};
 
+	//calculates the deltas of the output and hidden neurons for the last pattern that was fed forward; returns the squared error
+	double CalculatePatternDeltas(PatternView expectedOutput);
+
+	//copies 'inputWeights' back to the hidden weights after training on binary patterns
+	void UpdateHiddenWeights();
+
+	//trains until 'maximumNumberOfEpochs' epochs are done or half of the summed squared error of an epoch is at most 'errorThreshold';
+	//returns the sum of the squared errors of the last epoch
+	double TrainEpochs(const NeuralNetworkInput& trainData, int maximumNumberOfEpochs, double errorThreshold);
+
+	//the part of the training done by the thread 'threadIndex' of 'state'
+	void TrainOnThread(ParallelTrainingState* state, int threadIndex);
+
+	//calls 'TrainOnThread' for the trainer of 'state'; run by the threads of 'threadPool'
+	static void RunTrainingThread(void* state, int threadIndex);
+
+	//feeds the patterns 'firstPattern' to 'firstPattern + numberOfPatterns - 1' forward together and calculates their deltas in 'workspace'
+	double CalculateDeltas(const NeuralNetworkInput& trainData, int firstPattern, int numberOfPatterns, TrainingWorkspace<Scalar>& workspace);
+
+	//adds the corrections of the patterns in 'workspace' to the rows 'firstRow' to 'lastRow - 1' of the weights
+	void CorrectWeights(const TrainingWorkspace<Scalar>& workspace, double learningRate, int firstRow, int lastRow);
 
-NeuralNetworkTrainer::NeuralNetworkTrainer(int numberOfInputNeurons, int numberOfHiddenNeurons, int numberOfOutputNeurons)
-	: NeuralNetworkBase(numberOfInputNeurons, numberOfHiddenNeurons, numberOfOutputNeurons){ }
+	//one workspace per training thread; the first row of the first workspace is also used by 'Backpropagate'
+	vector<TrainingWorkspace<Scalar>> workspaces;
 
-void NeuralNetworkTrainer::InitializeWeights()
+	//the threads that train together with the calling thread and the errors of their epochs; they are kept between
+	//the calls of 'TrainEpochs', so that an epoch run with 'TrainEpoch' doesn't start threads or allocate memory
+	ThreadPool threadPool;
+	vector<double> threadErrors;
+};
+
+//<summary>
+//Creates the network and the workspace used for training on single patterns, so that the training allocates memory
+//only when it needs room for bigger batches or more threads.
+//</summary>
+template <typename Scalar>
+NeuralNetworkTrainer<Scalar>::NeuralNetworkTrainer(int numberOfInputNeurons, int numberOfHiddenNeurons, int numberOfOutputNeurons)
+	: NeuralNetworkBase<Scalar>(numberOfInputNeurons, numberOfHiddenNeurons, numberOfOutputNeurons)
+{
+	this->workspaces.resize(1);
+	this->workspaces[0].Reserve(1, this->inputStride, this->hiddenStride, this->numberOfOutputNeurons);
+}
+
+template <typename Scalar>
+void NeuralNetworkTrainer<Scalar>::InitializeWeights()
 {
 	double randomNumber = 0.0;
 	srand((unsigned)time(NULL));
@@ -36,7 +133,7 @@ void NeuralNetworkTrainer::InitializeWeights()
 		{
 			//small numbers between 0 and 0.05
 			randomNumber = ((double)rand() / (double)RAND_MAX) / 20.0;
-			this->inputNeurons[i].Weights[j] = randomNumber;
+			this->hiddenWeights[j * this->inputStride + i] = (Scalar)randomNumber;
 		}
 	}
 
@@ -46,101 +143,375 @@ void NeuralNetworkTrainer::InitializeWeights()
 		{
 			//small numbers between 0 and 0.05
 			randomNumber = ((double)rand() / (double)RAND_MAX) / 20.0;
-			this->hiddenNeurons[i].Weights[j] = randomNumber;
+			this->outputWeights[j * this->hiddenStride + i] = (Scalar)randomNumber;
 		}
 	}
 }
 
-void NeuralNetworkTrainer::Train(NeuralNetworkInput trainData)
+template <typename Scalar>
+void NeuralNetworkTrainer<Scalar>::Train(NeuralNetworkInput trainData)
 {
-	unsigned int numberOfTrainingPatterns = trainData.Data.size();
-	int numberOfIterations = 0;
-	double error = 10000000;
-
 	this->InitializeWeights();
+	this->TrainEpochs(trainData, trainData.NumberOfMaximumIterations, trainData.ErrorThreshold);
+	this->SaveWeightsToFile();
+}
 
-	while(error > trainData.ErrorThreshold && numberOfIterations < trainData.NumberOfMaximumIterations)
-	{
-		error = 0.0;
+template <typename Scalar>
+double NeuralNetworkTrainer<Scalar>::Backpropagate(PatternView expectedOutput, double learningRate)
+{
+	double totalError = this->CalculatePatternDeltas(expectedOutput);
+	const Scalar *hiddenToOutputDeltas = &this->workspaces[0].OutputDeltas[0];
+	const Scalar *inputToHiddenDeltas = &this->workspaces[0].HiddenDeltas[0];
 
-		for(unsigned int i=0; i<numberOfTrainingPatterns; i++)
-		{
-			this->FeedForward(trainData.Data[i]);
-			error += this->Backpropagate(trainData.ExpectedOutputs[i], trainData.LearningRate);
-		}
+	//we correct the weights from the hidden to the output layer; the weights of the connections
+	//to an output neuron are stored next to each other, so each row is updated sequentially
+	for(int i=0; i<this->numberOfOutputNeurons; i++)
+		NeuralNetworkKernels::AddScaled(&this->outputWeights[i * this->hiddenStride], &this->hiddenValues[0], (Scalar)(learningRate * hiddenToOutputDeltas[i]), this->hiddenStride);
 
-		error /= 2.0;
-		numberOfIterations++;
-	}
+	//we correct the weights from the input to the hidden layer
+	for(int i=0; i<this->numberOfHiddenNeurons; i++)
+		NeuralNetworkKernels::AddScaled(&this->hiddenWeights[i * this->inputStride], &this->inputValues[0], (Scalar)(learningRate * inputToHiddenDeltas[i]), this->inputStride);
 
-	this->SaveWeightsToFile();
+	return totalError;
+}
+
+//<summary>
+//Corrects the weights after a binary pattern was fed forward. The correction of the weight from an input is the input value
+//multiplied by the delta of the hidden neuron, so only the weights from the set inputs change, each by 'learningRate' times the delta;
+//they form the rows of 'inputWeights' of the set inputs, which are corrected instead of the hidden weights
+//(see 'UpdateHiddenWeights'). With the scalar kernels, the weights are the same as with 'Backpropagate'.
+//</summary>
+//<param name='expectedOutput'>The expected outputs of the pattern.</param>
+//<param name='learningRate'>The learning rate.</param>
+//<returns>The squared error of the pattern.</returns>
+template <typename Scalar>
+double NeuralNetworkTrainer<Scalar>::BackpropagateBinary(PatternView expectedOutput, double learningRate)
+{
+	double totalError = this->CalculatePatternDeltas(expectedOutput);
+	const Scalar *hiddenToOutputDeltas = &this->workspaces[0].OutputDeltas[0];
+	const Scalar *inputToHiddenDeltas = &this->workspaces[0].HiddenDeltas[0];
+
+	for(int i=0; i<this->numberOfOutputNeurons; i++)
+		NeuralNetworkKernels::AddScaled(&this->outputWeights[i * this->hiddenStride], &this->hiddenValues[0], (Scalar)(learningRate * hiddenToOutputDeltas[i]), this->hiddenStride);
+
+	for(int i=0; i<this->numberOfActiveInputs; i++)
+		NeuralNetworkKernels::AddScaled(&this->inputWeights[this->activeInputs[i] * this->hiddenStride], inputToHiddenDeltas, (Scalar)learningRate, this->hiddenStride);
+
+	return totalError;
 }
 
-double NeuralNetworkTrainer::Backpropagate(vector<double> expectedOutput, double learningRate)
+//<summary>
+//Calculates the errors and the deltas of the output neurons and of the hidden neurons for the last pattern
+//that was fed forward; they are stored in the first rows of the first workspace, so no memory is allocated.
+//</summary>
+//<param name='expectedOutput'>The expected outputs of the pattern.</param>
+//<returns>The squared error of the pattern.</returns>
+template <typename Scalar>
+double NeuralNetworkTrainer<Scalar>::CalculatePatternDeltas(PatternView expectedOutput)
 {
-	//will be used for backpropagation
-	double *hiddenToOutputDeltas = new double[this->numberOfOutputNeurons];
-	double *inputToHiddenDeltas = new double[this->numberOfHiddenNeurons];
+	Scalar *hiddenToOutputDeltas = &this->workspaces[0].OutputDeltas[0];
+	Scalar *outputErrors = &this->workspaces[0].OutputErrors[0];
+	Scalar *hiddenErrors = &this->workspaces[0].HiddenErrors[0];
+	Scalar *inputToHiddenDeltas = &this->workspaces[0].HiddenDeltas[0];
 
 	double totalError = 0.0;
 	for(int i=0; i<this->numberOfOutputNeurons; i++)
 	{
-		double difference = expectedOutput[i] - this->outputNeurons[i].Value;
-		totalError = totalError + (difference * difference);
-		hiddenToOutputDeltas[i] = this->outputNeurons[i].Value * (1 - this->outputNeurons[i].Value) * difference;
+		outputErrors[i] = (Scalar)(expectedOutput[i] - this->outputValues[i]);
+		totalError = totalError + (outputErrors[i] * outputErrors[i]);
 	}
+	NeuralNetworkKernels::LogisticDeltas(&this->outputValues[0], outputErrors, hiddenToOutputDeltas, this->numberOfOutputNeurons);
+
+	//the errors of the hidden neurons are the product of the transposed output weights and the output deltas;
+	//it is calculated by adding the rows of the output weights multiplied by the deltas, so that the rows are read sequentially
+	for(int i=0; i<this->hiddenStride; i++)
+		hiddenErrors[i] = 0;
+	for(int j=0; j<this->numberOfOutputNeurons; j++)
+		NeuralNetworkKernels::AddScaled(hiddenErrors, &this->outputWeights[j * this->hiddenStride], hiddenToOutputDeltas[j], this->hiddenStride);
+	NeuralNetworkKernels::LogisticDeltas(&this->hiddenValues[0], hiddenErrors, inputToHiddenDeltas, this->hiddenStride);
 
+	return totalError;
+}
+
+template <typename Scalar>
+void NeuralNetworkTrainer<Scalar>::UpdateHiddenWeights()
+{
 	for(int i=0; i<this->numberOfHiddenNeurons; i++)
+		for(int j=0; j<this->numberOfInputNeurons; j++)
+			this->hiddenWeights[i * this->inputStride + j] = this->inputWeights[j * this->hiddenStride + i];
+}
+
+//<summary>
+//Feeds all patterns of 'trainData' through the network once and corrects the weights. With a batch size of 1, the weights
+//are corrected after each pattern; otherwise the corrections of 'BatchSize' consecutive patterns are added up, so that
+//the network only changes after each batch (the last batch may be smaller).
+//</summary>
+//<param name='trainData'>The training patterns, their expected outputs, the learning rate, the batch size and the number of threads.</param>
+//<returns>The sum of the squared errors of all patterns, before the weights were corrected for them.</returns>
+template <typename Scalar>
+double NeuralNetworkTrainer<Scalar>::TrainEpoch(const NeuralNetworkInput& trainData)
+{
+	return this->TrainEpochs(trainData, 1, -1.0);
+}
+
+//<summary>
+//Trains the network for at most 'maximumNumberOfEpochs' epochs. With more than one thread, the threads of the pool, which are
+//started by the first call and then reused, train together until the end:
+//	- Each batch is divided into one part per thread. The threads calculate the deltas of their patterns, wait for each other
+//	  and then each of them corrects a part of the rows of the weights, adding the corrections of the patterns in their order.
+//	  The result doesn't depend on the timing of the threads, and with the scalar kernels it is the same as with one thread.
+//	- In the Hogwild mode, each thread goes through its own part of the patterns in batches and corrects all weights after each
+//	  batch, without waiting for the other threads. The threads only wait for each other at the end of each epoch.
+//	  The threads read and write the same weights without synchronization, which is a data race and so undefined behaviour
+//	  in standard C++; the mode relies on the platform: on x86 and x64, aligned loads and stores of floats and doubles aren't
+//	  torn, so a thread only sees old or new weights, and lost corrections just slow the training down. Because of that,
+//	  Hogwild is off by default and has to be turned on explicitly with 'NeuralNetworkInput::Hogwild'.
+//</summary>
+//<param name='trainData'>The training patterns, their expected outputs, the learning rate, the batch size and the number of threads.</param>
+//<param name='maximumNumberOfEpochs'>The maximum number of times the network goes through all patterns.</param>
+//<param name='errorThreshold'>The training stops after the first epoch with at most this error (half of the summed squared error).</param>
+//<returns>The sum of the squared errors of the last epoch.</returns>
+template <typename Scalar>
+double NeuralNetworkTrainer<Scalar>::TrainEpochs(const NeuralNetworkInput& trainData, int maximumNumberOfEpochs, double errorThreshold)
+{
+	int numberOfTrainingPatterns = trainData.Data.size();
+	int batchSize = trainData.BatchSize < 1 ? 1 : trainData.BatchSize;
+	this->accumulateInDouble = trainData.AccumulateInDouble;
+	this->logisticApproximation = trainData.LogisticApproximation;
+
+	//without Hogwild, a thread only has work if it gets at least one pattern of each batch
+	int numberOfThreads = trainData.NumberOfThreads;
+	if(!trainData.Hogwild && numberOfThreads > batchSize)
+		numberOfThreads = batchSize;
+	if(numberOfThreads < 1)
+		numberOfThreads = 1;
+
+	if((int)this->workspaces.size() < numberOfThreads)
+		this->workspaces.resize(numberOfThreads);
+	for(int i=0; i<numberOfThreads; i++)
+		this->workspaces[i].Reserve(batchSize, this->inputStride, this->hiddenStride, this->numberOfOutputNeurons);
+
+	if(numberOfThreads > 1)
 	{
-		double derivative = this->hiddenNeurons[i].Value * (1 - this->hiddenNeurons[i].Value);
-		double correction = 0.0;
-		for(int j=0; j<this->numberOfOutputNeurons; j++)
-			correction = correction + (this->hiddenNeurons[i].Weights[j] * hiddenToOutputDeltas[j]);
+		if((int)this->threadErrors.size() < 2 * numberOfThreads)
+			this->threadErrors.resize(2 * numberOfThreads);
 
-		correction *= derivative;
-		inputToHiddenDeltas[i] = correction;
+		ParallelTrainingState state(this, trainData, numberOfThreads, maximumNumberOfEpochs, errorThreshold, &this->threadErrors[0]);
+		this->threadPool.Run(numberOfThreads, &NeuralNetworkTrainer<Scalar>::RunTrainingThread, &state);
+		return state.Error;
 	}
 
-	//we correct the weights from the hidden to the output layer
-	for(int i=0; i<this->numberOfHiddenNeurons; i++)
+	//the first layer of binary patterns is trained on 'inputWeights', which are copied back at the end; the rows of the
+	//set inputs are added up in the precision of the network, so the binary patterns aren't used for adding up in double precision
+	bool binaryData = batchSize == 1 && trainData.BinaryData.size() == trainData.Data.size() && numberOfTrainingPatterns > 0 && !this->accumulateInDouble;
+	if(binaryData)
+		this->UpdateInputWeights();
+
+	double error = 0.0;
+	for(int epoch=0; epoch<maximumNumberOfEpochs; epoch++)
 	{
-		for(int j=0; j<this->numberOfOutputNeurons; j++)
+		error = 0.0;
+		if(binaryData)
+		{
+			for(int i=0; i<numberOfTrainingPatterns; i++)
+			{
+				this->FeedForward(trainData.BinaryData[i]);
+				error += this->BackpropagateBinary(trainData.ExpectedOutputs[i], trainData.LearningRate);
+			}
+		}
+		else if(batchSize == 1)
+		{
+			for(int i=0; i<numberOfTrainingPatterns; i++)
+			{
+				this->FeedForward(trainData.Data[i]);
+				error += this->Backpropagate(trainData.ExpectedOutputs[i], trainData.LearningRate);
+			}
+		}
+		else
 		{
-			double weightCorrection = learningRate * hiddenToOutputDeltas[j] * this->hiddenNeurons[i].Value;
-			this->hiddenNeurons[i].Weights[j] = this->hiddenNeurons[i].Weights[j] + weightCorrection;
+			for(int firstPattern=0; firstPattern<numberOfTrainingPatterns; firstPattern+=batchSize)
+			{
+				int numberOfPatterns = numberOfTrainingPatterns - firstPattern < batchSize ? numberOfTrainingPatterns - firstPattern : batchSize;
+				error += this->CalculateDeltas(trainData, firstPattern, numberOfPatterns, this->workspaces[0]);
+				this->CorrectWeights(this->workspaces[0], trainData.LearningRate, 0, this->numberOfHiddenNeurons + this->numberOfOutputNeurons);
+			}
 		}
+
+		if(error / 2.0 <= errorThreshold)
+			break;
 	}
 
-	//we correct the weights from the input to the hidden layer
-	for(int i=0; i<this->numberOfInputNeurons; i++)
+	if(binaryData)
+		this->UpdateHiddenWeights();
+
+	return error;
+}
+
+//<summary>
+//Trains on the patterns of the thread 'threadIndex' of 'state' (see 'TrainEpochs') until the training is over.
+//</summary>
+//<param name='state'>The data shared by the training threads.</param>
+//<param name='threadIndex'>Index of the thread, between 0 and 'state->NumberOfThreads - 1'.</param>
+template <typename Scalar>
+void NeuralNetworkTrainer<Scalar>::TrainOnThread(ParallelTrainingState* state, int threadIndex)
+{
+	const NeuralNetworkInput& trainData = state->TrainData;
+	TrainingWorkspace<Scalar>& workspace = this->workspaces[threadIndex];
+	int numberOfThreads = state->NumberOfThreads;
+	int numberOfTrainingPatterns = trainData.Data.size();
+	int batchSize = trainData.BatchSize < 1 ? 1 : trainData.BatchSize;
+
+	//the rows of the weights corrected by this thread; the rows of the hidden weights come first
+	int numberOfRows = this->numberOfHiddenNeurons + this->numberOfOutputNeurons;
+	int firstRow = numberOfRows * threadIndex / numberOfThreads;
+	int lastRow = numberOfRows * (threadIndex + 1) / numberOfThreads;
+
+	for(int epoch=0; epoch<state->MaximumNumberOfEpochs; epoch++)
 	{
-		for(int j=0; j<this->numberOfHiddenNeurons; j++)
+		double error = 0.0;
+		if(trainData.Hogwild)
 		{
-			double weightCorrection = learningRate * inputToHiddenDeltas[j] * this->inputNeurons[i].Value;
-			this->inputNeurons[i].Weights[j] = this->inputNeurons[i].Weights[j] + weightCorrection;
+			int firstThreadPattern = numberOfTrainingPatterns * threadIndex / numberOfThreads;
+			int lastThreadPattern = numberOfTrainingPatterns * (threadIndex + 1) / numberOfThreads;
+			for(int firstPattern=firstThreadPattern; firstPattern<lastThreadPattern; firstPattern+=batchSize)
+			{
+				int numberOfPatterns = lastThreadPattern - firstPattern < batchSize ? lastThreadPattern - firstPattern : batchSize;
+				error += this->CalculateDeltas(trainData, firstPattern, numberOfPatterns, workspace);
+				this->CorrectWeights(workspace, trainData.LearningRate, 0, numberOfRows);
+			}
+		}
+		else
+		{
+			for(int firstPattern=0; firstPattern<numberOfTrainingPatterns; firstPattern+=batchSize)
+			{
+				int numberOfPatterns = numberOfTrainingPatterns - firstPattern < batchSize ? numberOfTrainingPatterns - firstPattern : batchSize;
+				int firstThreadPattern = numberOfPatterns * threadIndex / numberOfThreads;
+				int lastThreadPattern = numberOfPatterns * (threadIndex + 1) / numberOfThreads;
+				error += this->CalculateDeltas(trainData, firstPattern + firstThreadPattern, lastThreadPattern - firstThreadPattern, workspace);
+
+				//all deltas have to be calculated with the old weights, and the next batch has to use the corrected weights
+				state->Barrier.Wait();
+				for(int i=0; i<numberOfThreads; i++)
+					this->CorrectWeights(this->workspaces[i], trainData.LearningRate, firstRow, lastRow);
+				state->Barrier.Wait();
+			}
 		}
+
+		state->ThreadErrors[epoch % 2][threadIndex] = error;
+		state->Barrier.Wait();
+
+		//all threads add the errors in the same order, so they stop after the same epoch
+		double epochError = 0.0;
+		for(int i=0; i<numberOfThreads; i++)
+			epochError += state->ThreadErrors[epoch % 2][i];
+		if(threadIndex == 0)
+			state->Error = epochError;
+
+		if(epochError / 2.0 <= state->ErrorThreshold)
+			break;
 	}
+}
+
+template <typename Scalar>
+void NeuralNetworkTrainer<Scalar>::RunTrainingThread(void* state, int threadIndex)
+{
+	ParallelTrainingState* trainingState = (ParallelTrainingState*)state;
+	((NeuralNetworkTrainer<Scalar>*)trainingState->Trainer)->TrainOnThread(trainingState, threadIndex);
+}
 
-	delete [] hiddenToOutputDeltas;
-	delete [] inputToHiddenDeltas;
+//<summary>
+//Feeds a batch of patterns forward and calculates the deltas of the neurons for each pattern. The rows of the matrices
+//in 'workspace' belong to the patterns, so the values of a layer are the product of the values of the previous layer
+//and the transposed weight matrix, and each weight is read once per block of patterns instead of once per pattern.
+//</summary>
+//<param name='trainData'>The training patterns and their expected outputs.</param>
+//<param name='firstPattern'>Index of the first pattern of the batch.</param>
+//<param name='numberOfPatterns'>Number of patterns in the batch; 'workspace' needs at least as many rows.</param>
+//<param name='workspace'>The matrices in which the values and the deltas are stored.</param>
+//<returns>The sum of the squared errors of the patterns in the batch.</returns>
+template <typename Scalar>
+double NeuralNetworkTrainer<Scalar>::CalculateDeltas(const NeuralNetworkInput& trainData, int firstPattern, int numberOfPatterns, TrainingWorkspace<Scalar>& workspace)
+{
+	workspace.FirstPattern = firstPattern;
+	workspace.NumberOfPatterns = numberOfPatterns;
+
+	for(int pattern=0; pattern<numberOfPatterns; pattern++)
+		for(int i=0; i<this->numberOfInputNeurons; i++)
+			workspace.InputValues[pattern * this->inputStride + i] = (Scalar)trainData.Data[firstPattern + pattern][i];
+
+	NeuralNetworkKernels::MultiplyTransposed(&workspace.InputValues[0], this->inputStride, numberOfPatterns, &this->hiddenWeights[0], this->inputStride, this->numberOfHiddenNeurons,
+											 &workspace.HiddenValues[0], this->hiddenStride, this->inputStride, this->accumulateInDouble);
+	for(int pattern=0; pattern<numberOfPatterns; pattern++)
+		NeuralNetworkKernels::Logistic(&workspace.HiddenValues[pattern * this->hiddenStride], this->numberOfHiddenNeurons, this->logisticApproximation);
+
+	NeuralNetworkKernels::MultiplyTransposed(&workspace.HiddenValues[0], this->hiddenStride, numberOfPatterns, &this->outputWeights[0], this->hiddenStride, this->numberOfOutputNeurons,
+											 &workspace.OutputValues[0], this->numberOfOutputNeurons, this->hiddenStride, this->accumulateInDouble);
+	NeuralNetworkKernels::Logistic(&workspace.OutputValues[0], numberOfPatterns * this->numberOfOutputNeurons, this->logisticApproximation);
+
+	double totalError = 0.0;
+	for(int pattern=0; pattern<numberOfPatterns; pattern++)
+	{
+		for(int i=0; i<this->numberOfOutputNeurons; i++)
+		{
+			Scalar outputError = (Scalar)(trainData.ExpectedOutputs[firstPattern + pattern][i] - workspace.OutputValues[pattern * this->numberOfOutputNeurons + i]);
+			workspace.OutputErrors[pattern * this->numberOfOutputNeurons + i] = outputError;
+			totalError = totalError + (outputError * outputError);
+		}
+	}
+	NeuralNetworkKernels::LogisticDeltas(&workspace.OutputValues[0], &workspace.OutputErrors[0], &workspace.OutputDeltas[0], numberOfPatterns * this->numberOfOutputNeurons);
+
+	//the errors of the hidden neurons are calculated with the output weights from before the correction, like in 'Backpropagate'
+	for(int i=0; i<numberOfPatterns * this->hiddenStride; i++)
+		workspace.HiddenErrors[i] = 0;
+	NeuralNetworkKernels::MultiplyAdd(&workspace.OutputDeltas[0], this->numberOfOutputNeurons, numberOfPatterns, this->numberOfOutputNeurons, &this->outputWeights[0], this->hiddenStride,
+									  &workspace.HiddenErrors[0], this->hiddenStride, this->hiddenStride, (Scalar)1);
+	NeuralNetworkKernels::LogisticDeltas(&workspace.HiddenValues[0], &workspace.HiddenErrors[0], &workspace.HiddenDeltas[0], numberOfPatterns * this->hiddenStride);
 
 	return totalError;
 }
 
-void NeuralNetworkTrainer::SaveWeightsToFile()
+//<summary>
+//Adds the corrections of all patterns in 'workspace', multiplied by 'learningRate', to the rows 'firstRow' to 'lastRow - 1'
+//of the weights. The rows are numbered over both matrices: first the rows of the hidden weights, then the rows of the output weights.
+//</summary>
+template <typename Scalar>
+void NeuralNetworkTrainer<Scalar>::CorrectWeights(const TrainingWorkspace<Scalar>& workspace, double learningRate, int firstRow, int lastRow)
+{
+	if(firstRow < this->numberOfHiddenNeurons)
+	{
+		int lastHiddenRow = lastRow < this->numberOfHiddenNeurons ? lastRow : this->numberOfHiddenNeurons;
+		NeuralNetworkKernels::MultiplyTransposedAdd(&workspace.HiddenDeltas[firstRow], this->hiddenStride, lastHiddenRow - firstRow, &workspace.InputValues[0], this->inputStride, workspace.NumberOfPatterns,
+													&this->hiddenWeights[firstRow * this->inputStride], this->inputStride, this->inputStride, (Scalar)learningRate);
+	}
+
+	if(lastRow > this->numberOfHiddenNeurons)
+	{
+		int firstOutputRow = firstRow > this->numberOfHiddenNeurons ? firstRow - this->numberOfHiddenNeurons : 0;
+		int lastOutputRow = lastRow - this->numberOfHiddenNeurons;
+		NeuralNetworkKernels::MultiplyTransposedAdd(&workspace.OutputDeltas[firstOutputRow], this->numberOfOutputNeurons, lastOutputRow - firstOutputRow, &workspace.HiddenValues[0], this->hiddenStride, workspace.NumberOfPatterns,
+													&this->outputWeights[firstOutputRow * this->hiddenStride], this->hiddenStride, this->hiddenStride, (Scalar)learningRate);
+	}
+}
+
+//<summary>
+//Saves the weights with one line per neuron of the previous layer, containing the weights of its connections
+//to all neurons of the next layer (i.e. the transposed rows of the weight matrices), and in full precision to the model file.
+//</summary>
+template <typename Scalar>
+void NeuralNetworkTrainer<Scalar>::SaveWeightsToFile()
 {
 	ofstream outFile;
 	outFile.open(Constants::HiddenWeightsFilename);
 	for(int i=0; i<this->numberOfInputNeurons - 1; i++)
 	{
 		for(int j=0; j<this->numberOfHiddenNeurons - 1; j++)
-			outFile << this->inputNeurons[i].Weights[j] << ",";
-		outFile << this->inputNeurons[i].Weights[this->numberOfHiddenNeurons-1] << "\n";
+			outFile << this->hiddenWeights[j * this->inputStride + i] << ",";
+		outFile << this->hiddenWeights[(this->numberOfHiddenNeurons-1) * this->inputStride + i] << "\n";
 	}
 
 	for(int j=0; j<this->numberOfHiddenNeurons - 1; j++)
-		outFile << this->inputNeurons[this->numberOfInputNeurons-1].Weights[j] << ",";
-	outFile << this->inputNeurons[this->numberOfInputNeurons-1].Weights[this->numberOfHiddenNeurons-1];
+		outFile << this->hiddenWeights[j * this->inputStride + this->numberOfInputNeurons-1] << ",";
+	outFile << this->hiddenWeights[(this->numberOfHiddenNeurons-1) * this->inputStride + this->numberOfInputNeurons-1];
 
 	outFile.close();
 	outFile.clear();
@@ -149,15 +520,17 @@ void NeuralNetworkTrainer::SaveWeightsToFile()
 	for(int i=0; i<this->numberOfHiddenNeurons - 1; i++)
 	{
 		for(int j=0; j<this->numberOfOutputNeurons - 1; j++)
-			outFile << this->hiddenNeurons[i].Weights[j] << ",";
-		outFile << this->hiddenNeurons[i].Weights[this->numberOfOutputNeurons-1] << "\n";
+			outFile << this->outputWeights[j * this->hiddenStride + i] << ",";
+		outFile << this->outputWeights[(this->numberOfOutputNeurons-1) * this->hiddenStride + i] << "\n";
 	}
 
 	for(int j=0; j<this->numberOfOutputNeurons - 1; j++)
-		outFile << this->hiddenNeurons[this->numberOfHiddenNeurons-1].Weights[j] << ",";
-	outFile << this->hiddenNeurons[this->numberOfHiddenNeurons-1].Weights[this->numberOfOutputNeurons-1];
+		outFile << this->outputWeights[j * this->hiddenStride + this->numberOfHiddenNeurons-1] << ",";
+	outFile << this->outputWeights[(this->numberOfOutputNeurons-1) * this->hiddenStride + this->numberOfHiddenNeurons-1];
 
 	outFile.close();
+
+	NeuralNetworkModel::Save(*this, Constants::ModelFilename);
 }
 
 #endif
\ No newline at end of file
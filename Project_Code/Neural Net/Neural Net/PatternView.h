@@ -0,0 +1,42 @@
+#ifndef PATTERN_VIEW_H
+#define PATTERN_VIEW_H
+
+#include <vector>
+#include <stddef.h>
+using std::vector;
+
+//<summary>
+//Read-only view of the values of a pattern (or of its expected outputs) that are stored elsewhere, e.g. in a vector
+//or in a row of a matrix. The values are not copied, so the storage has to exist as long as the view is used.
+//</summary>
+struct PatternView
+{
+	PatternView(const double* values, int numberOfValues);
+
+	//a view of all values of 'values'; allows passing vectors wherever a view is expected
+	PatternView(const vector<double>& values);
+
+	const double& operator[](int index) const;
+
+	const double* Values;
+	int NumberOfValues;
+};
+
+PatternView::PatternView(const double* values, int numberOfValues)
+{
+	this->Values = values;
+	this->NumberOfValues = numberOfValues;
+}
+
+PatternView::PatternView(const vector<double>& values)
+{
+	this->Values = values.empty() ? NULL : &values[0];
+	this->NumberOfValues = values.size();
+}
+
+const double& PatternView::operator[](int index) const
+{
+	return this->Values[index];
+}
+
+#endif
\ No newline at end of file
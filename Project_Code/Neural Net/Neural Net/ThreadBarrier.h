@@ -0,0 +1,59 @@
+#ifndef THREAD_BARRIER_H
+#define THREAD_BARRIER_H
+
+#include <mutex>
+#include <condition_variable>
+using std::mutex;
+using std::unique_lock;
+using std::condition_variable;
+
+//<summary>
+//Barrier for a fixed number of threads: 'Wait' returns once all threads called it. The barrier can be used
+//again right away; the generation counter tells the waiting threads that the barrier they are waiting at was passed.
+//</summary>
+class ThreadBarrier
+{
+public:
+	ThreadBarrier(int numberOfThreads);
+
+	//blocks until all threads called 'Wait'
+	void Wait();
+
+private:
+	mutex barrierMutex;
+	condition_variable allThreadsArrived;
+
+	int numberOfThreads;
+	int numberOfWaitingThreads;
+
+	//incremented each time all threads arrive
+	unsigned long long generation;
+};
+
+
+ThreadBarrier::ThreadBarrier(int numberOfThreads)
+{
+	this->numberOfThreads = numberOfThreads;
+	this->numberOfWaitingThreads = 0;
+	this->generation = 0;
+}
+
+void ThreadBarrier::Wait()
+{
+	unique_lock<mutex> lock(this->barrierMutex);
+	unsigned long long currentGeneration = this->generation;
+
+	this->numberOfWaitingThreads++;
+	if(this->numberOfWaitingThreads == this->numberOfThreads)
+	{
+		this->numberOfWaitingThreads = 0;
+		this->generation++;
+		this->allThreadsArrived.notify_all();
+		return;
+	}
+
+	while(this->generation == currentGeneration)
+		this->allThreadsArrived.wait(lock);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,166 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+using std::vector;
+using std::thread;
+using std::mutex;
+using std::unique_lock;
+using std::lock_guard;
+using std::condition_variable;
+
+//<summary>
+//Threads that are started once and then run the same task together as often as needed, so that running a task
+//doesn't start threads or allocate memory (memory is only allocated when the pool needs more threads than before).
+//The calling thread takes part in each task as the thread with index 0. A copy of a pool has no threads;
+//it starts its own ones when it is used.
+//</summary>
+class ThreadPool
+{
+public:
+	ThreadPool();
+	ThreadPool(const ThreadPool& other);
+	ThreadPool& operator=(const ThreadPool& other);
+	~ThreadPool();
+
+	//calls 'task(context, threadIndex)' on 'numberOfThreads' threads, with the indices 0 to 'numberOfThreads - 1', and returns once all calls returned
+	void Run(int numberOfThreads, void (*task)(void* context, int threadIndex), void* context);
+
+private:
+	//waits for the tasks started after the task 'lastGeneration' and runs them as the thread 'threadIndex' until the pool is destroyed
+	void WaitForTasks(int threadIndex, unsigned long long lastGeneration);
+
+	//the threads of the pool, with the indices 1 to 'threads.size()'
+	vector<thread> threads;
+
+	mutex poolMutex;
+	condition_variable taskStarted;
+	condition_variable taskFinished;
+
+	//the current task, the number of threads that run it, the number of pool threads that are still running it,
+	//and a counter that is incremented for each task, so the waiting threads know that a new task was started
+	void (*task)(void* context, int threadIndex);
+	void* context;
+	int numberOfTaskThreads;
+	int numberOfBusyThreads;
+	unsigned long long generation;
+	bool stopping;
+};
+
+
+ThreadPool::ThreadPool()
+{
+	this->task = NULL;
+	this->context = NULL;
+	this->numberOfTaskThreads = 0;
+	this->numberOfBusyThreads = 0;
+	this->generation = 0;
+	this->stopping = false;
+}
+
+//<summary>
+//Creates an empty pool; the threads of 'other' keep working for 'other'.
+//</summary>
+ThreadPool::ThreadPool(const ThreadPool& /*other*/)
+{
+	this->task = NULL;
+	this->context = NULL;
+	this->numberOfTaskThreads = 0;
+	this->numberOfBusyThreads = 0;
+	this->generation = 0;
+	this->stopping = false;
+}
+
+//<summary>
+//Keeps the threads of this pool; there is nothing to copy from 'other'.
+//</summary>
+ThreadPool& ThreadPool::operator=(const ThreadPool& /*other*/)
+{
+	return *this;
+}
+
+//<summary>
+//Stops the threads of the pool and waits for them.
+//</summary>
+ThreadPool::~ThreadPool()
+{
+	{
+		lock_guard<mutex> lock(this->poolMutex);
+		this->stopping = true;
+	}
+	this->taskStarted.notify_all();
+
+	for(unsigned int i=0; i<this->threads.size(); i++)
+		this->threads[i].join();
+}
+
+//<summary>
+//Runs 'task' on 'numberOfThreads' threads: the calling thread runs it with the index 0 and the threads of the pool
+//with the indices 1 to 'numberOfThreads - 1'. The pool is extended first if it has too few threads.
+//</summary>
+//<param name='numberOfThreads'>The number of threads that run the task; at least 1.</param>
+//<param name='task'>The function called by each thread.</param>
+//<param name='context'>The first argument of 'task'.</param>
+void ThreadPool::Run(int numberOfThreads, void (*task)(void* context, int threadIndex), void* context)
+{
+	if(numberOfThreads > 1)
+	{
+		while((int)this->threads.size() < numberOfThreads - 1)
+			this->threads.push_back(thread(&ThreadPool::WaitForTasks, this, (int)this->threads.size() + 1, this->generation));
+
+		{
+			lock_guard<mutex> lock(this->poolMutex);
+			this->task = task;
+			this->context = context;
+			this->numberOfTaskThreads = numberOfThreads;
+			this->numberOfBusyThreads = numberOfThreads - 1;
+			this->generation++;
+		}
+		this->taskStarted.notify_all();
+	}
+
+	task(context, 0);
+
+	if(numberOfThreads > 1)
+	{
+		unique_lock<mutex> lock(this->poolMutex);
+		while(this->numberOfBusyThreads > 0)
+			this->taskFinished.wait(lock);
+	}
+}
+
+//<summary>
+//Main loop of the thread 'threadIndex' of the pool: waits for the next task and runs it if the task needs this thread.
+//A new thread gets the generation of the last task started before it, so that it doesn't run that task again.
+//</summary>
+void ThreadPool::WaitForTasks(int threadIndex, unsigned long long lastGeneration)
+{
+	unique_lock<mutex> lock(this->poolMutex);
+
+	while(true)
+	{
+		while(!this->stopping && this->generation == lastGeneration)
+			this->taskStarted.wait(lock);
+		if(this->stopping)
+			return;
+
+		lastGeneration = this->generation;
+		if(threadIndex >= this->numberOfTaskThreads)
+			continue;
+
+		void (*currentTask)(void* context, int threadIndex) = this->task;
+		void* currentContext = this->context;
+		lock.unlock();
+		currentTask(currentContext, threadIndex);
+		lock.lock();
+
+		this->numberOfBusyThreads--;
+		if(this->numberOfBusyThreads == 0)
+			this->taskFinished.notify_one();
+	}
+}
+
+#endif
\ No newline at end of file
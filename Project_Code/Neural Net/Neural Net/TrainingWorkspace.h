@@ -0,0 +1,58 @@
+#ifndef TRAINING_WORKSPACE_H
+#define TRAINING_WORKSPACE_H
+
+#include "AlignedAllocator.h"
+
+//<summary>
+//Matrices used for training on a batch of patterns, with one row per pattern: the input values, the values and deltas of
+//the hidden neurons (with 'inputStride' and 'hiddenStride' values per row) and the values, errors and deltas of the output neurons
+//('numberOfOutputNeurons' values per row), of the same type as the weights of the network. Each training thread has its own workspace.
+//</summary>
+template <typename Scalar>
+struct TrainingWorkspace
+{
+	typename AlignedVectorOf<Scalar>::Type InputValues;
+	typename AlignedVectorOf<Scalar>::Type HiddenValues;
+	typename AlignedVectorOf<Scalar>::Type HiddenErrors;
+	typename AlignedVectorOf<Scalar>::Type HiddenDeltas;
+	typename AlignedVectorOf<Scalar>::Type OutputValues;
+	typename AlignedVectorOf<Scalar>::Type OutputErrors;
+	typename AlignedVectorOf<Scalar>::Type OutputDeltas;
+
+	//the first pattern of the batch and the number of patterns whose values are in the workspace
+	int FirstPattern;
+	int NumberOfPatterns;
+
+	TrainingWorkspace();
+
+	//makes sure that the matrices have room for 'numberOfPatterns' rows
+	void Reserve(int numberOfPatterns, int inputStride, int hiddenStride, int numberOfOutputNeurons);
+};
+
+template <typename Scalar>
+TrainingWorkspace<Scalar>::TrainingWorkspace()
+{
+	this->FirstPattern = 0;
+	this->NumberOfPatterns = 0;
+}
+
+//<summary>
+//Enlarges the matrices if they have fewer than 'numberOfPatterns' rows. The padding of the rows has to be zero,
+//so the matrices are only cleared when they grow.
+//</summary>
+template <typename Scalar>
+void TrainingWorkspace<Scalar>::Reserve(int numberOfPatterns, int inputStride, int hiddenStride, int numberOfOutputNeurons)
+{
+	if((int)this->InputValues.size() >= numberOfPatterns * inputStride)
+		return;
+
+	this->InputValues.assign(numberOfPatterns * inputStride, 0);
+	this->HiddenValues.assign(numberOfPatterns * hiddenStride, 0);
+	this->HiddenErrors.assign(numberOfPatterns * hiddenStride, 0);
+	this->HiddenDeltas.assign(numberOfPatterns * hiddenStride, 0);
+	this->OutputValues.assign(numberOfPatterns * numberOfOutputNeurons, 0);
+	this->OutputErrors.assign(numberOfPatterns * numberOfOutputNeurons, 0);
+	this->OutputDeltas.assign(numberOfPatterns * numberOfOutputNeurons, 0);
+}
+
+#endif
\ No newline at end of file
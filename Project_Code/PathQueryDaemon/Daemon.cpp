@@ -0,0 +1,64 @@
+//Long-running daemon that keeps world maps in memory and answers path queries over a Unix domain socket.
+//Build on Linux with: g++ -std=c++11 -O2 -pthread Daemon.cpp -o PathQueryDaemon
+//Usage: PathQueryDaemon <socket path> <number of threads> <map id>=<map file> [<map id>=<map file> ...]
+
+#include "PathQueryServer.h"
+#include <iostream>
+#include <cstdlib>
+#include <csignal>
+#include <pthread.h>
+
+using std::cout;
+using std::cerr;
+
+int main(int argc, char** argv)
+{
+	if(argc < 4)
+	{
+		cerr << "usage: " << argv[0] << " <socket path> <number of threads> <map id>=<map file> ...\n";
+		return 1;
+	}
+
+	//the signals are blocked in all threads and handled only by 'sigwait' below
+	sigset_t signals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &signals, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	PathQueryServer server;
+
+	try
+	{
+		for(int i=3; i<argc; i++)
+		{
+			string mapArgument = argv[i];
+			size_t separator = mapArgument.find('=');
+			if(separator == string::npos)
+				throw "Wrong format";
+
+			uint32_t mapId = atoi(mapArgument.substr(0, separator).c_str());
+			uint32_t version = server.LoadMap(mapId, mapArgument.substr(separator + 1).c_str());
+			cout << "loaded map " << mapId << " (version " << version << ")\n";
+		}
+
+		server.Start(argv[1], atoi(argv[2]));
+	}
+	catch(const char* message)
+	{
+		cerr << message << "\n";
+		return 1;
+	}
+
+	cout << "listening on " << argv[1] << "\n";
+
+	int signalNumber;
+	sigwait(&signals, &signalNumber);
+
+	server.Stop();
+	PathCacheStatistics statistics = server.GetCacheStatistics();
+	cout << "answered " << server.NumberOfQueries << " queries\n";
+	cout << "path cache: " << statistics.Hits << " hits, " << statistics.SubpathHits << " subpath hits, " << statistics.Misses << " misses\n";
+	return 0;
+}
\ No newline at end of file
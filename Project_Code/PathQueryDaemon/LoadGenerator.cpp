@@ -0,0 +1,161 @@
+//Load generator for the path query daemon: sends random path queries over several connections
+//for a given number of seconds and reports the number of queries per second and the average latency.
+//If a number of update batches per second is given, another connection keeps changing random fields of the map meanwhile.
+//Build on Linux with: g++ -std=c++11 -O2 -pthread LoadGenerator.cpp -o PathQueryLoadGenerator
+//Usage: PathQueryLoadGenerator <socket path> <number of connections> <seconds> <map id> <rows> <columns> [<update batches per second>]
+
+#include "PathQueryClient.h"
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <thread>
+#include <chrono>
+
+using std::cout;
+using std::cerr;
+using std::vector;
+using std::thread;
+using std::chrono::steady_clock;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::seconds;
+using std::chrono::milliseconds;
+
+//number of fields changed by each batch of updates
+const int UPDATES_PER_BATCH = 10;
+
+//<summary>
+//Stores the results of a single connection of the load generator.
+//</summary>
+struct ConnectionResult
+{
+	unsigned long long NumberOfQueries;
+	unsigned long long NumberOfFailures;
+	double TotalLatency;
+};
+
+void sendQueries(const char* socketPath, uint32_t mapId, int numberOfRows, int numberOfColumns, steady_clock::time_point endTime, unsigned int seed, ConnectionResult* result);
+void sendUpdates(const char* socketPath, uint32_t mapId, int numberOfRows, int numberOfColumns, steady_clock::time_point endTime, int batchesPerSecond, ConnectionResult* result);
+
+int main(int argc, char** argv)
+{
+	if(argc < 7)
+	{
+		cerr << "usage: " << argv[0] << " <socket path> <number of connections> <seconds> <map id> <rows> <columns> [<update batches per second>]\n";
+		return 1;
+	}
+
+	int numberOfConnections = atoi(argv[2]);
+	int duration = atoi(argv[3]);
+	uint32_t mapId = atoi(argv[4]);
+	int numberOfRows = atoi(argv[5]);
+	int numberOfColumns = atoi(argv[6]);
+	int batchesPerSecond = argc > 7 ? atoi(argv[7]) : 0;
+
+	vector<ConnectionResult> results(numberOfConnections);
+	vector<thread> connections;
+	steady_clock::time_point endTime = steady_clock::now() + seconds(duration);
+	for(int i=0; i<numberOfConnections; i++)
+		connections.push_back(thread(sendQueries, argv[1], mapId, numberOfRows, numberOfColumns, endTime, i + 1, &results[i]));
+
+	ConnectionResult updateResult = { 0, 0, 0.0 };
+	if(batchesPerSecond > 0)
+		connections.push_back(thread(sendUpdates, argv[1], mapId, numberOfRows, numberOfColumns, endTime, batchesPerSecond, &updateResult));
+
+	for(unsigned int i=0; i<connections.size(); i++)
+		connections[i].join();
+
+	unsigned long long numberOfQueries = 0, numberOfFailures = 0;
+	double totalLatency = 0.0;
+	for(int i=0; i<numberOfConnections; i++)
+	{
+		numberOfQueries += results[i].NumberOfQueries;
+		numberOfFailures += results[i].NumberOfFailures;
+		totalLatency += results[i].TotalLatency;
+	}
+
+	cout << "queries = " << numberOfQueries << ", failures = " << numberOfFailures
+		 << ", queries per second = " << (double)numberOfQueries / duration
+		 << ", average latency = " << (numberOfQueries > 0 ? totalLatency / numberOfQueries : 0.0) << " us\n";
+	if(batchesPerSecond > 0)
+		cout << "update batches = " << updateResult.NumberOfQueries << ", failures = " << updateResult.NumberOfFailures
+			 << ", average latency = " << (updateResult.NumberOfQueries > 0 ? updateResult.TotalLatency / updateResult.NumberOfQueries : 0.0) << " us\n";
+	return 0;
+}
+
+//<summary>
+//Sends queries between random fields over a single connection until 'endTime'.
+//</summary>
+void sendQueries(const char* socketPath, uint32_t mapId, int numberOfRows, int numberOfColumns, steady_clock::time_point endTime, unsigned int seed, ConnectionResult* result)
+{
+	result->NumberOfQueries = 0;
+	result->NumberOfFailures = 0;
+	result->TotalLatency = 0.0;
+
+	PathQueryClient client;
+	vector<Coordinates2D> path;
+	uint32_t mapVersion;
+
+	try
+	{
+		client.Connect(socketPath);
+		while(steady_clock::now() < endTime)
+		{
+			Coordinates2D source(rand_r(&seed) % numberOfRows, rand_r(&seed) % numberOfColumns);
+			Coordinates2D destination(rand_r(&seed) % numberOfRows, rand_r(&seed) % numberOfColumns);
+
+			steady_clock::time_point start = steady_clock::now();
+			uint8_t status = client.FindPath(mapId, source, destination, path, mapVersion);
+			result->TotalLatency += duration_cast<microseconds>(steady_clock::now() - start).count();
+
+			result->NumberOfQueries++;
+			if(status != RESPONSE_OK)
+				result->NumberOfFailures++;
+		}
+	}
+	catch(const char* message)
+	{
+		cerr << message << "\n";
+	}
+}
+
+//<summary>
+//Sends 'batchesPerSecond' batches of updates per second over a single connection until 'endTime'.
+//Each batch sets random fields to random costs between 1 and 5.
+//</summary>
+void sendUpdates(const char* socketPath, uint32_t mapId, int numberOfRows, int numberOfColumns, steady_clock::time_point endTime, int batchesPerSecond, ConnectionResult* result)
+{
+	PathQueryClient client;
+	vector<MapCellUpdate> updates(UPDATES_PER_BATCH);
+	uint32_t mapVersion;
+	unsigned int seed = 0;
+
+	try
+	{
+		client.Connect(socketPath);
+		steady_clock::time_point nextBatch = steady_clock::now();
+		while(nextBatch < endTime)
+		{
+			for(int i=0; i<UPDATES_PER_BATCH; i++)
+			{
+				updates[i].Field = Coordinates2D(rand_r(&seed) % numberOfRows, rand_r(&seed) % numberOfColumns);
+				updates[i].Cost = 1 + rand_r(&seed) % 5;
+			}
+
+			steady_clock::time_point start = steady_clock::now();
+			uint8_t status = client.UpdateMap(mapId, updates, mapVersion);
+			result->TotalLatency += duration_cast<microseconds>(steady_clock::now() - start).count();
+
+			result->NumberOfQueries++;
+			if(status != RESPONSE_OK)
+				result->NumberOfFailures++;
+
+			nextBatch += milliseconds(1000 / batchesPerSecond);
+			std::this_thread::sleep_until(nextBatch);
+		}
+	}
+	catch(const char* message)
+	{
+		cerr << message << "\n";
+	}
+}
\ No newline at end of file
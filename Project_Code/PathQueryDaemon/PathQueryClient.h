@@ -0,0 +1,192 @@
+#ifndef PATH_QUERY_CLIENT_H
+#define PATH_QUERY_CLIENT_H
+
+#include "PathQueryProtocol.h"
+#include "../AStar/AStar/Coordinates2D.h"
+#include "../AStar/AStar/MapCellUpdate.h"
+#include "../AStar/AStar/PathDecoder.h"
+#include <vector>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+using std::vector;
+using std::string;
+
+//<summary>
+//Class used for sending requests to the path query daemon over a single connection.
+//</summary>
+class PathQueryClient
+{
+public:
+	PathQueryClient();
+	~PathQueryClient();
+
+	//connects to the daemon listening on 'socketPath'
+	void Connect(const char* socketPath);
+
+	//closes the connection
+	void Close();
+
+	//asks for a path on a map; returns the status sent by the daemon
+	uint8_t FindPath(uint32_t mapId, Coordinates2D source, Coordinates2D destination, vector<Coordinates2D>& path, uint32_t& mapVersion);
+
+	//asks the daemon to load (or replace) a map; returns the status sent by the daemon
+	uint8_t LoadMap(uint32_t mapId, const char* filename, uint32_t& mapVersion);
+
+	//asks the daemon to apply a batch of field updates to a map; returns the status sent by the daemon
+	uint8_t UpdateMap(uint32_t mapId, const vector<MapCellUpdate>& updates, uint32_t& mapVersion);
+
+	//if true (the default), the paths are requested in the compact encoding of 'PathEncoder'
+	bool CompactPaths;
+
+private:
+	int connection;
+	vector<char> response;
+};
+
+
+//<summary>
+//Default constructor; creates a client that is not connected.
+//</summary>
+PathQueryClient::PathQueryClient()
+{
+	this->connection = -1;
+	this->CompactPaths = true;
+}
+
+//<summary>
+//Destructor; closes the connection if it is open.
+//</summary>
+PathQueryClient::~PathQueryClient()
+{
+	this->Close();
+}
+
+//<summary>
+//Connects to the daemon listening on the Unix domain socket 'socketPath'.
+//</summary>
+void PathQueryClient::Connect(const char* socketPath)
+{
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if(strlen(socketPath) >= sizeof(address.sun_path))
+		throw "Socket path too long";
+	strcpy(address.sun_path, socketPath);
+
+	this->connection = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(this->connection < 0 || connect(this->connection, (sockaddr*)&address, sizeof(address)) < 0)
+	{
+		this->Close();
+		throw "Error while connecting to the daemon";
+	}
+}
+
+//<summary>
+//Closes the connection if it is open.
+//</summary>
+void PathQueryClient::Close()
+{
+	if(this->connection >= 0)
+		close(this->connection);
+	this->connection = -1;
+}
+
+//<summary>
+//Asks the daemon for a path between 'source' and 'destination' on the map with id 'mapId'.
+//</summary>
+//<param name='path'>The fields of the path are stored here; empty if no path was found.</param>
+//<param name='mapVersion'>The version of the map on which the path was found.</param>
+//<returns>The status sent by the daemon.</returns>
+uint8_t PathQueryClient::FindPath(uint32_t mapId, Coordinates2D source, Coordinates2D destination, vector<Coordinates2D>& path, uint32_t& mapVersion)
+{
+	char request[sizeof(uint32_t) + 4 * sizeof(int32_t)];
+	int32_t coordinates[4] = { source.X, source.Y, destination.X, destination.Y };
+	memcpy(request, &mapId, sizeof(mapId));
+	memcpy(request + sizeof(mapId), coordinates, sizeof(coordinates));
+
+	uint8_t status;
+	uint8_t requestType = this->CompactPaths ? COMPACT_PATH_QUERY_REQUEST : PATH_QUERY_REQUEST;
+	if(!WriteFrame(this->connection, requestType, request, sizeof(request)) || !ReadFrame(this->connection, status, this->response))
+		throw "Error while communicating with the daemon";
+
+	path.clear();
+	if(status != RESPONSE_OK)
+		return status;
+
+	memcpy(&mapVersion, &this->response[0], sizeof(uint32_t));
+	if(this->CompactPaths)
+	{
+		//the fields are decoded straight from the received frame
+		PathDecoder::Decode((const unsigned char*)&this->response[0] + sizeof(uint32_t), this->response.size() - sizeof(uint32_t), path);
+		return status;
+	}
+
+	uint32_t numberOfFields;
+	memcpy(&numberOfFields, &this->response[sizeof(uint32_t)], sizeof(uint32_t));
+
+	const char* fields = &this->response[2 * sizeof(uint32_t)];
+	for(unsigned int i=0; i<numberOfFields; i++)
+	{
+		int32_t field[2];
+		memcpy(field, fields + i * sizeof(field), sizeof(field));
+		path.push_back(Coordinates2D(field[0], field[1]));
+	}
+
+	return status;
+}
+
+//<summary>
+//Asks the daemon to load the map stored in 'filename' as the new version of the map with id 'mapId'.
+//</summary>
+//<param name='mapVersion'>The version of the loaded map.</param>
+//<returns>The status sent by the daemon.</returns>
+uint8_t PathQueryClient::LoadMap(uint32_t mapId, const char* filename, uint32_t& mapVersion)
+{
+	vector<char> request(sizeof(mapId) + strlen(filename));
+	memcpy(&request[0], &mapId, sizeof(mapId));
+	memcpy(&request[sizeof(mapId)], filename, strlen(filename));
+
+	uint8_t status;
+	if(!WriteFrame(this->connection, LOAD_MAP_REQUEST, &request[0], request.size()) || !ReadFrame(this->connection, status, this->response))
+		throw "Error while communicating with the daemon";
+
+	if(status == RESPONSE_OK)
+		memcpy(&mapVersion, &this->response[0], sizeof(uint32_t));
+
+	return status;
+}
+
+//<summary>
+//Asks the daemon to apply 'updates' to the map with id 'mapId' as a single new version of the map.
+//</summary>
+//<param name='mapVersion'>The version of the updated map.</param>
+//<returns>The status sent by the daemon.</returns>
+uint8_t PathQueryClient::UpdateMap(uint32_t mapId, const vector<MapCellUpdate>& updates, uint32_t& mapVersion)
+{
+	const size_t updateSize = 2 * sizeof(int32_t) + sizeof(double);
+	uint32_t numberOfUpdates = updates.size();
+
+	vector<char> request(2 * sizeof(uint32_t) + numberOfUpdates * updateSize);
+	memcpy(&request[0], &mapId, sizeof(mapId));
+	memcpy(&request[sizeof(mapId)], &numberOfUpdates, sizeof(numberOfUpdates));
+	for(unsigned int i=0; i<numberOfUpdates; i++)
+	{
+		int32_t field[2] = { updates[i].Field.X, updates[i].Field.Y };
+		char* update = &request[2 * sizeof(uint32_t) + i * updateSize];
+		memcpy(update, field, sizeof(field));
+		memcpy(update + sizeof(field), &updates[i].Cost, sizeof(double));
+	}
+
+	uint8_t status;
+	if(!WriteFrame(this->connection, UPDATE_MAP_REQUEST, &request[0], request.size()) || !ReadFrame(this->connection, status, this->response))
+		throw "Error while communicating with the daemon";
+
+	if(status == RESPONSE_OK)
+		memcpy(&mapVersion, &this->response[0], sizeof(uint32_t));
+
+	return status;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,114 @@
+#ifndef PATH_QUERY_PROTOCOL_H
+#define PATH_QUERY_PROTOCOL_H
+
+#include <stdint.h>
+#include <vector>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+using std::vector;
+
+//<summary>
+//Binary framing used between the path query daemon and its clients. All integers are sent in host byte order,
+//since both sides run on the same machine. Each message is a frame:
+//	- uint32: length of the rest of the frame in bytes.
+//	- uint8: message type (requests) or status (responses).
+//	- payload.
+//Path query payload (both plain and compact): uint32 map id, int32 source x, int32 source y, int32 destination x, int32 destination y.
+//Load map payload: uint32 map id, followed by the name of the map file (not null-terminated).
+//Update map payload: uint32 map id, uint32 number of updates, followed by an int32 x, int32 y and double cost for each update.
+//Path query response payload: uint32 map version, uint32 number of fields, followed by an int32 x and y for each field of the path.
+//Compact path query response payload: uint32 map version, followed by the path encoded by 'PathEncoder'.
+//Load map and update map response payload: uint32 map version, uint32 zero.
+//</summary>
+
+//message types of the requests
+const uint8_t PATH_QUERY_REQUEST = 1;
+const uint8_t LOAD_MAP_REQUEST = 2;
+const uint8_t UPDATE_MAP_REQUEST = 3;
+const uint8_t COMPACT_PATH_QUERY_REQUEST = 4;
+
+//statuses of the responses
+const uint8_t RESPONSE_OK = 0;
+const uint8_t RESPONSE_UNKNOWN_MAP = 1;
+const uint8_t RESPONSE_BAD_REQUEST = 2;
+const uint8_t RESPONSE_ERROR = 3;
+
+//frames longer than this are rejected, so that a broken client can't make the daemon allocate arbitrary memory
+const uint32_t MAXIMUM_FRAME_LENGTH = 1 << 20;
+
+//<summary>
+//Reads exactly 'length' bytes from 'socket'.
+//</summary>
+//<returns>False if the connection was closed or an error occurred.</returns>
+bool ReadFully(int socket, void* buffer, size_t length)
+{
+	char* position = (char*)buffer;
+	while(length > 0)
+	{
+		ssize_t received = read(socket, position, length);
+		if(received < 0 && errno == EINTR)
+			continue;
+		if(received <= 0)
+			return false;
+
+		position += received;
+		length -= received;
+	}
+	return true;
+}
+
+//<summary>
+//Writes exactly 'length' bytes to 'socket'.
+//</summary>
+//<returns>False if the connection was closed or an error occurred.</returns>
+bool WriteFully(int socket, const void* buffer, size_t length)
+{
+	const char* position = (const char*)buffer;
+	while(length > 0)
+	{
+		ssize_t sent = write(socket, position, length);
+		if(sent < 0 && errno == EINTR)
+			continue;
+		if(sent <= 0)
+			return false;
+
+		position += sent;
+		length -= sent;
+	}
+	return true;
+}
+
+//<summary>
+//Reads a frame from 'socket' and stores its type (or status) and payload.
+//</summary>
+//<returns>False if the connection was closed, an error occurred or the frame is too long.</returns>
+bool ReadFrame(int socket, uint8_t& type, vector<char>& payload)
+{
+	uint32_t length;
+	if(!ReadFully(socket, &length, sizeof(length)) || length == 0 || length > MAXIMUM_FRAME_LENGTH)
+		return false;
+	if(!ReadFully(socket, &type, sizeof(type)))
+		return false;
+
+	payload.resize(length - 1);
+	return payload.empty() || ReadFully(socket, &payload[0], payload.size());
+}
+
+//<summary>
+//Writes a frame with the given type (or status) and payload to 'socket' with a single system call.
+//</summary>
+//<returns>False if the connection was closed or an error occurred.</returns>
+bool WriteFrame(int socket, uint8_t type, const void* payload, uint32_t payloadLength)
+{
+	vector<char> frame(sizeof(uint32_t) + 1 + payloadLength);
+	uint32_t length = payloadLength + 1;
+	memcpy(&frame[0], &length, sizeof(length));
+	frame[sizeof(uint32_t)] = (char)type;
+	if(payloadLength > 0)
+		memcpy(&frame[sizeof(uint32_t) + 1], payload, payloadLength);
+
+	return WriteFully(socket, &frame[0], frame.size());
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,597 @@
+#ifndef PATH_QUERY_SERVER_H
+#define PATH_QUERY_SERVER_H
+
+#include "PathQueryProtocol.h"
+#include "../AStar/AStar/AStarLibrary.h"
+#include "../AStar/AStar/WorldMapReader.h"
+#include "../AStar/AStar/PathCache.h"
+#include "../AStar/AStar/VersionedWorldMap.h"
+#include "../AStar/AStar/PathEncoder.h"
+#include <vector>
+#include <map>
+#include <deque>
+#include <set>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include <poll.h>
+#include <unistd.h>
+using std::vector;
+using std::map;
+using std::deque;
+using std::set;
+using std::string;
+using std::shared_ptr;
+using std::thread;
+using std::mutex;
+using std::lock_guard;
+using std::unique_lock;
+using std::condition_variable;
+using std::atomic;
+
+//number of paths kept in the path cache of the daemon
+const unsigned int PATH_CACHE_CAPACITY = 4096;
+
+//a worker waits at most this many seconds for the rest of a frame whose first bytes arrived; a client that stalls
+//in the middle of a frame is disconnected, so that it can't keep a worker thread busy
+const int FRAME_READ_TIMEOUT_SECONDS = 5;
+
+//<summary>
+//Stores a map that is loaded in the daemon. Queries search on snapshots of the map, so they can run
+//from several threads at the same time while updates are applied; the lock only orders the updates.
+//</summary>
+struct LoadedMap
+{
+	VersionedWorldMap Map;
+	mutex UpdateMutex;
+};
+
+//<summary>
+//Class that keeps world maps in memory and answers path queries sent over a Unix domain socket.
+//Requests are served by a pool of worker threads: a polling thread watches the listening socket and the idle connections,
+//and a connection on which a request arrived is given to a worker, which answers that single request and gives the connection
+//back to the polling thread. Idle clients that keep their connections open therefore don't hold any worker. A map can be replaced while queries are running:
+//each query takes a reference to the current snapshot of the map, so the queries that already started
+//finish on the old version, which is freed once the last of them is done. Maps can also be changed field by field:
+//a batch of updates becomes a new version of the map without copying the parts of the map that didn't change.
+//</summary>
+class PathQueryServer
+{
+public:
+	PathQueryServer();
+	~PathQueryServer();
+
+	//loads a map from a file, replacing the previous version of the map with the same id
+	uint32_t LoadMap(uint32_t mapId, const char* filename);
+
+	//applies a batch of field updates to a loaded map as a new version of the map
+	uint32_t UpdateMap(uint32_t mapId, const vector<MapCellUpdate>& updates);
+
+	//starts accepting connections on the socket 'socketPath' with 'numberOfThreads' worker threads
+	void Start(const char* socketPath, int numberOfThreads);
+
+	//stops accepting connections, closes the open connections and waits for the worker threads
+	void Stop();
+
+	//returns the hit and miss counts of the path cache
+	PathCacheStatistics GetCacheStatistics();
+
+	//number of answered path queries
+	atomic<unsigned long long> NumberOfQueries;
+
+private:
+	//returns a map or NULL if the map is not loaded
+	shared_ptr<LoadedMap> GetMap(uint32_t mapId);
+
+	//accepts connections and passes the connections on which a request arrived to the worker threads
+	void PollConnections();
+
+	//takes connections with a request from the queue and answers the requests until the server is stopped
+	void ServeConnections();
+
+	//answers a single request sent over a connection; the path queries are answered with 'planner'; returns false if the connection has to be closed
+	bool ServeRequest(int connection, AStarLibrary& planner);
+
+	//wakes up the polling thread, so that it watches the current set of idle connections
+	void WakePollingThread();
+
+	//answers a path query with 'planner', with a compact encoding of the path if 'compact' is true; returns false if the response couldn't be sent
+	bool AnswerPathQuery(int connection, const vector<char>& payload, bool compact, AStarLibrary& planner);
+
+	//answers a request for loading a map; returns false if the response couldn't be sent
+	bool AnswerLoadMap(int connection, const vector<char>& payload);
+
+	//answers a request for updating a map; returns false if the response couldn't be sent
+	bool AnswerUpdateMap(int connection, const vector<char>& payload);
+
+	//loaded maps and the version that will be given to the next loaded map
+	map<uint32_t, shared_ptr<LoadedMap>> maps;
+	uint32_t nextVersion;
+	mutex mapsMutex;
+
+	//paths found on the loaded maps, kept apart by the map id and the map version
+	PathCache pathCache;
+
+	//connections waiting for a request, connections with a request that wasn't taken by a worker yet,
+	//and connections whose request is being answered
+	set<int> idleConnections;
+	deque<int> pendingConnections;
+	set<int> activeConnections;
+	mutex connectionsMutex;
+	condition_variable connectionAvailable;
+	bool stopping;
+
+	//pipe through which the polling thread is woken up when the idle connections change or the server is stopped
+	int wakePipe[2];
+
+	int listeningSocket;
+	string socketPath;
+	thread pollingThread;
+	vector<thread> workers;
+};
+
+
+//<summary>
+//Default constructor; creates a server without maps that doesn't accept connections yet.
+//</summary>
+PathQueryServer::PathQueryServer() : pathCache(PATH_CACHE_CAPACITY)
+{
+	this->NumberOfQueries = 0;
+	this->nextVersion = 1;
+	this->stopping = false;
+	this->listeningSocket = -1;
+	this->wakePipe[0] = -1;
+	this->wakePipe[1] = -1;
+}
+
+//<summary>
+//Destructor; stops the server if it is running.
+//</summary>
+PathQueryServer::~PathQueryServer()
+{
+	this->Stop();
+}
+
+//<summary>
+//Reads a map from 'filename' and makes it the current version of the map with id 'mapId'.
+//The file is read without holding any locks; only the replacement of the map pointer is locked,
+//so the queries running on other threads are never blocked by the loading.
+//</summary>
+//<param name='mapId'>Id of the map.</param>
+//<param name='filename'>Name of a file containing a grid.</param>
+//<returns>The version of the loaded map.</returns>
+uint32_t PathQueryServer::LoadMap(uint32_t mapId, const char* filename)
+{
+	vector<vector<double>> worldMap = WorldMapReader::ReadFromFile(filename, ',');
+	shared_ptr<LoadedMap> loadedMap(new LoadedMap());
+
+	uint32_t version;
+	{
+		lock_guard<mutex> lock(this->mapsMutex);
+		version = this->nextVersion++;
+	}
+	loadedMap->Map.Load(worldMap, version);
+
+	uint32_t replacedVersion = 0;
+	{
+		lock_guard<mutex> lock(this->mapsMutex);
+		if(this->maps.count(mapId) > 0)
+			replacedVersion = this->maps[mapId]->Map.GetSnapshot()->Version;
+		this->maps[mapId] = loadedMap;
+	}
+
+	//the paths of the replaced version can't be found anymore, so we free them right away
+	if(replacedVersion != 0)
+		this->pathCache.RemoveVersion(mapId, replacedVersion);
+
+	return version;
+}
+
+//<summary>
+//Applies 'updates' to the map with id 'mapId' as a single new version of the map. The queries running on other threads
+//keep using the previous version until they finish. The cached paths that are still shortest paths are moved to the new version.
+//</summary>
+//<param name='mapId'>Id of the map.</param>
+//<param name='updates'>The fields to update together with their new costs.</param>
+//<returns>The new version of the map.</returns>
+uint32_t PathQueryServer::UpdateMap(uint32_t mapId, const vector<MapCellUpdate>& updates)
+{
+	shared_ptr<LoadedMap> loadedMap = this->GetMap(mapId);
+	if(!loadedMap)
+		throw "Unknown map";
+
+	//the updates of a map are applied one at a time, so that its versions always grow
+	//and the path cache sees the changes in the same order as the map
+	lock_guard<mutex> updateLock(loadedMap->UpdateMutex);
+
+	uint32_t oldVersion = loadedMap->Map.GetSnapshot()->Version;
+	uint32_t newVersion;
+	{
+		lock_guard<mutex> lock(this->mapsMutex);
+		newVersion = this->nextVersion++;
+	}
+
+	vector<MapCellChange> changes = loadedMap->Map.ApplyUpdates(updates, newVersion);
+	this->pathCache.ApplyChanges(mapId, oldVersion, newVersion, changes);
+	return newVersion;
+}
+
+//<summary>
+//Creates the socket 'socketPath' (removing a stale socket file with the same name) and starts the threads
+//that accept and serve connections.
+//</summary>
+//<param name='socketPath'>Path of the Unix domain socket.</param>
+//<param name='numberOfThreads'>Number of worker threads.</param>
+void PathQueryServer::Start(const char* socketPath, int numberOfThreads)
+{
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if(strlen(socketPath) >= sizeof(address.sun_path))
+		throw "Socket path too long";
+	strcpy(address.sun_path, socketPath);
+
+	this->listeningSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(this->listeningSocket < 0)
+		throw "Error while creating socket";
+
+	unlink(socketPath);
+	if(bind(this->listeningSocket, (sockaddr*)&address, sizeof(address)) < 0 || listen(this->listeningSocket, 128) < 0)
+	{
+		close(this->listeningSocket);
+		this->listeningSocket = -1;
+		throw "Error while binding socket";
+	}
+
+	if(pipe(this->wakePipe) < 0)
+	{
+		close(this->listeningSocket);
+		this->listeningSocket = -1;
+		throw "Error while creating socket";
+	}
+
+	this->socketPath = socketPath;
+	this->stopping = false;
+	for(int i=0; i<numberOfThreads; i++)
+		this->workers.push_back(thread(&PathQueryServer::ServeConnections, this));
+	this->pollingThread = thread(&PathQueryServer::PollConnections, this);
+}
+
+//<summary>
+//Stops the server: the polling thread is woken up and the connections being served are shut down, which wakes up
+//the workers blocked on them; then the threads are joined and all remaining connections are closed.
+//</summary>
+void PathQueryServer::Stop()
+{
+	if(this->listeningSocket < 0)
+		return;
+
+	{
+		lock_guard<mutex> lock(this->connectionsMutex);
+		this->stopping = true;
+		for(set<int>::iterator connection = this->activeConnections.begin(); connection != this->activeConnections.end(); ++connection)
+			shutdown(*connection, SHUT_RDWR);
+	}
+	this->connectionAvailable.notify_all();
+	this->WakePollingThread();
+
+	this->pollingThread.join();
+	for(unsigned int i=0; i<this->workers.size(); i++)
+		this->workers[i].join();
+	this->workers.clear();
+
+	for(unsigned int i=0; i<this->pendingConnections.size(); i++)
+		close(this->pendingConnections[i]);
+	this->pendingConnections.clear();
+	for(set<int>::iterator connection = this->idleConnections.begin(); connection != this->idleConnections.end(); ++connection)
+		close(*connection);
+	this->idleConnections.clear();
+
+	close(this->wakePipe[0]);
+	close(this->wakePipe[1]);
+	this->wakePipe[0] = -1;
+	this->wakePipe[1] = -1;
+
+	close(this->listeningSocket);
+	unlink(this->socketPath.c_str());
+	this->listeningSocket = -1;
+}
+
+//<summary>
+//Returns the statistics of the path cache shared by all maps.
+//</summary>
+PathCacheStatistics PathQueryServer::GetCacheStatistics()
+{
+	return this->pathCache.GetStatistics();
+}
+
+//<summary>
+//Returns the current version of the map with id 'mapId' or NULL if no such map is loaded.
+//</summary>
+shared_ptr<LoadedMap> PathQueryServer::GetMap(uint32_t mapId)
+{
+	lock_guard<mutex> lock(this->mapsMutex);
+	map<uint32_t, shared_ptr<LoadedMap>>::iterator loadedMap = this->maps.find(mapId);
+	if(loadedMap == this->maps.end())
+		return shared_ptr<LoadedMap>();
+	return loadedMap->second;
+}
+
+//<summary>
+//Main loop of the polling thread: waits until a connection can be accepted, a request arrives on an idle connection
+//or the thread is woken up. New connections become idle connections; the connections on which a request arrived
+//(or which were closed by the client) are put in the queue of the worker threads until the server is stopped.
+//</summary>
+void PathQueryServer::PollConnections()
+{
+	vector<pollfd> descriptors;
+
+	while(true)
+	{
+		//the first two descriptors are the wake-up pipe and the listening socket, followed by the idle connections
+		descriptors.resize(2);
+		descriptors[0].fd = this->wakePipe[0];
+		descriptors[1].fd = this->listeningSocket;
+		{
+			lock_guard<mutex> lock(this->connectionsMutex);
+			if(this->stopping)
+				return;
+
+			for(set<int>::iterator connection = this->idleConnections.begin(); connection != this->idleConnections.end(); ++connection)
+			{
+				pollfd descriptor;
+				descriptor.fd = *connection;
+				descriptors.push_back(descriptor);
+			}
+		}
+		for(unsigned int i=0; i<descriptors.size(); i++)
+		{
+			descriptors[i].events = POLLIN;
+			descriptors[i].revents = 0;
+		}
+
+		if(poll(&descriptors[0], descriptors.size(), -1) < 0)
+			continue;
+
+		if(descriptors[0].revents != 0)
+		{
+			char wakeUps[64];
+			if(read(this->wakePipe[0], wakeUps, sizeof(wakeUps)) < 0)
+				continue;
+		}
+
+		lock_guard<mutex> lock(this->connectionsMutex);
+		if(this->stopping)
+			return;
+
+		for(unsigned int i=2; i<descriptors.size(); i++)
+		{
+			if(descriptors[i].revents == 0)
+				continue;
+
+			this->idleConnections.erase(descriptors[i].fd);
+			this->pendingConnections.push_back(descriptors[i].fd);
+			this->connectionAvailable.notify_one();
+		}
+
+		if(descriptors[1].revents != 0)
+		{
+			int connection = accept(this->listeningSocket, NULL, NULL);
+			if(connection >= 0)
+			{
+				timeval timeout;
+				timeout.tv_sec = FRAME_READ_TIMEOUT_SECONDS;
+				timeout.tv_usec = 0;
+				setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+				this->idleConnections.insert(connection);
+			}
+		}
+	}
+}
+
+//<summary>
+//Main loop of a worker thread: waits for a connection on which a request arrived, answers the request and gives
+//the connection back to the polling thread, or closes it if the client closed it or the request couldn't be answered.
+//The worker keeps a single planner for all of its queries, so its heuristic table and cache are allocated once and not for every query.
+//</summary>
+void PathQueryServer::ServeConnections()
+{
+	AStarLibrary planner;
+
+	while(true)
+	{
+		int connection;
+		{
+			unique_lock<mutex> lock(this->connectionsMutex);
+			while(!this->stopping && this->pendingConnections.empty())
+				this->connectionAvailable.wait(lock);
+			if(this->stopping)
+				return;
+
+			connection = this->pendingConnections.front();
+			this->pendingConnections.pop_front();
+			this->activeConnections.insert(connection);
+		}
+
+		bool keepConnection = this->ServeRequest(connection, planner);
+
+		{
+			lock_guard<mutex> lock(this->connectionsMutex);
+			this->activeConnections.erase(connection);
+			if(!keepConnection || this->stopping)
+			{
+				close(connection);
+				continue;
+			}
+
+			this->idleConnections.insert(connection);
+		}
+		this->WakePollingThread();
+	}
+}
+
+//<summary>
+//Reads a single request from 'connection' and answers it.
+//</summary>
+//<returns>False if the frame couldn't be read (e.g. the connection was closed) or the response couldn't be sent.</returns>
+bool PathQueryServer::ServeRequest(int connection, AStarLibrary& planner)
+{
+	uint8_t type;
+	vector<char> payload;
+	if(!ReadFrame(connection, type, payload))
+		return false;
+
+	if(type == PATH_QUERY_REQUEST)
+		return this->AnswerPathQuery(connection, payload, false, planner);
+	else if(type == COMPACT_PATH_QUERY_REQUEST)
+		return this->AnswerPathQuery(connection, payload, true, planner);
+	else if(type == LOAD_MAP_REQUEST)
+		return this->AnswerLoadMap(connection, payload);
+	else if(type == UPDATE_MAP_REQUEST)
+		return this->AnswerUpdateMap(connection, payload);
+	else
+		return WriteFrame(connection, RESPONSE_BAD_REQUEST, NULL, 0);
+}
+
+//<summary>
+//Writes a byte to the wake-up pipe, so that the polling thread returns from 'poll' and watches the current idle connections.
+//</summary>
+void PathQueryServer::WakePollingThread()
+{
+	char wakeUp = 0;
+	if(write(this->wakePipe[1], &wakeUp, 1) < 0)
+		return;
+}
+
+//<summary>
+//Finds a path on the requested map and sends the map version and the fields of the path.
+//The path is taken from the path cache if possible; otherwise, it is found with A* and cached.
+//A compact response encodes the path with 'PathEncoder' instead of sending each field as two integers.
+//</summary>
+bool PathQueryServer::AnswerPathQuery(int connection, const vector<char>& payload, bool compact, AStarLibrary& planner)
+{
+	if(payload.size() != sizeof(uint32_t) + 4 * sizeof(int32_t))
+		return WriteFrame(connection, RESPONSE_BAD_REQUEST, NULL, 0);
+
+	uint32_t mapId;
+	int32_t coordinates[4];
+	memcpy(&mapId, &payload[0], sizeof(mapId));
+	memcpy(coordinates, &payload[sizeof(mapId)], sizeof(coordinates));
+
+	shared_ptr<LoadedMap> loadedMap = this->GetMap(mapId);
+	if(!loadedMap)
+		return WriteFrame(connection, RESPONSE_UNKNOWN_MAP, NULL, 0);
+
+	//the query keeps this version of the map alive even if the map is updated or replaced in the meantime
+	shared_ptr<const WorldMapSnapshot> snapshot = loadedMap->Map.GetSnapshot();
+	for(int i=0; i<4; i++)
+		if(coordinates[i] < 0 || coordinates[i] >= (i % 2 == 0 ? snapshot->NumberOfRows : snapshot->NumberOfColumns))
+			return WriteFrame(connection, RESPONSE_BAD_REQUEST, NULL, 0);
+
+	Coordinates2D source(coordinates[0], coordinates[1]);
+	Coordinates2D destination(coordinates[2], coordinates[3]);
+	vector<Coordinates2D> path;
+	if(!this->pathCache.Find(mapId, snapshot->Version, source, destination, path))
+	{
+		//the cached heuristic values only depend on the coordinates, so the planner can move between maps and versions
+		planner.Snapshot = snapshot.get();
+		path = planner.AStar(source, destination).ShortestPath;
+		planner.Snapshot = NULL;
+		this->pathCache.Insert(mapId, snapshot->Version, path);
+	}
+	this->NumberOfQueries++;
+
+	if(compact)
+	{
+		vector<unsigned char> response(sizeof(uint32_t) + PathEncoder::GetMaximumEncodedLength(path.size()));
+		memcpy(&response[0], &snapshot->Version, sizeof(uint32_t));
+		size_t encodedLength = path.empty() ? 0 : PathEncoder::Encode(&path[0], path.size(), &response[sizeof(uint32_t)], response.size() - sizeof(uint32_t));
+		return WriteFrame(connection, RESPONSE_OK, &response[0], sizeof(uint32_t) + encodedLength);
+	}
+
+	uint32_t numberOfFields = path.size();
+	vector<int32_t> response(2 + 2 * numberOfFields);
+	memcpy(&response[0], &snapshot->Version, sizeof(uint32_t));
+	memcpy(&response[1], &numberOfFields, sizeof(uint32_t));
+	for(unsigned int i=0; i<numberOfFields; i++)
+	{
+		response[2 + 2*i] = path[i].X;
+		response[3 + 2*i] = path[i].Y;
+	}
+
+	return WriteFrame(connection, RESPONSE_OK, &response[0], response.size() * sizeof(int32_t));
+}
+
+//<summary>
+//Loads (or replaces) a map and sends its new version.
+//</summary>
+bool PathQueryServer::AnswerLoadMap(int connection, const vector<char>& payload)
+{
+	if(payload.size() <= sizeof(uint32_t))
+		return WriteFrame(connection, RESPONSE_BAD_REQUEST, NULL, 0);
+
+	uint32_t mapId;
+	memcpy(&mapId, &payload[0], sizeof(mapId));
+	string filename(payload.begin() + sizeof(mapId), payload.end());
+
+	uint32_t response[2] = { 0, 0 };
+	try
+	{
+		response[0] = this->LoadMap(mapId, filename.c_str());
+	}
+	catch(...)
+	{
+		return WriteFrame(connection, RESPONSE_ERROR, NULL, 0);
+	}
+
+	return WriteFrame(connection, RESPONSE_OK, response, sizeof(response));
+}
+
+//<summary>
+//Applies a batch of field updates to a map and sends its new version.
+//</summary>
+bool PathQueryServer::AnswerUpdateMap(int connection, const vector<char>& payload)
+{
+	const size_t updateSize = 2 * sizeof(int32_t) + sizeof(double);
+	if(payload.size() < 2 * sizeof(uint32_t))
+		return WriteFrame(connection, RESPONSE_BAD_REQUEST, NULL, 0);
+
+	uint32_t mapId, numberOfUpdates;
+	memcpy(&mapId, &payload[0], sizeof(mapId));
+	memcpy(&numberOfUpdates, &payload[sizeof(mapId)], sizeof(numberOfUpdates));
+	if(payload.size() != 2 * sizeof(uint32_t) + numberOfUpdates * updateSize)
+		return WriteFrame(connection, RESPONSE_BAD_REQUEST, NULL, 0);
+
+	vector<MapCellUpdate> updates(numberOfUpdates);
+	for(unsigned int i=0; i<numberOfUpdates; i++)
+	{
+		int32_t field[2];
+		const char* update = &payload[2 * sizeof(uint32_t) + i * updateSize];
+		memcpy(field, update, sizeof(field));
+		memcpy(&updates[i].Cost, update + sizeof(field), sizeof(double));
+		updates[i].Field = Coordinates2D(field[0], field[1]);
+	}
+
+	if(!this->GetMap(mapId))
+		return WriteFrame(connection, RESPONSE_UNKNOWN_MAP, NULL, 0);
+
+	uint32_t response[2] = { 0, 0 };
+	try
+	{
+		response[0] = this->UpdateMap(mapId, updates);
+	}
+	catch(...)
+	{
+		return WriteFrame(connection, RESPONSE_BAD_REQUEST, NULL, 0);
+	}
+
+	return WriteFrame(connection, RESPONSE_OK, response, sizeof(response));
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,394 @@
+#ifndef PLANNER_ENGINES_H
+#define PLANNER_ENGINES_H
+
+#include "../AStar/AStar/AStarLibrary.h"
+#include "../AStar/AStar/VersionedWorldMap.h"
+#include "../AStar/AStar/TiledWorldMap.h"
+#include "../AStar/AStar/ContractionHierarchy.h"
+#include "../AStar/AStar/PathCache.h"
+#include "../AStar/AStar/CoarseToFinePlanner.h"
+#include "../AStar/AStar/LatticePlanner.h"
+#include "../AStar/AStar/RealTimeSearch.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdio>
+using std::vector;
+using std::string;
+using std::shared_ptr;
+
+//file used by 'TiledAStarEngine' for the tiled copy of the map
+const char* const PLANNER_SUITE_TILED_MAP_FILE = "PlannerSuite.tiles";
+
+//how the paths of a planner are checked against the reference search; every path has to lead from the source
+//to the destination through adjacent fields, and a path has to be found if and only if the reference finds one
+//	- PLANNER_CHECK_OPTIMAL: the path has to be a shortest path.
+//	- PLANNER_CHECK_REACHES_GOAL: the cost of the path isn't checked, for planners that don't guarantee shortest paths
+//	  (none of them has a proven bound on the cost); the suite reports the highest ratio to the shortest path cost instead.
+const int PLANNER_CHECK_OPTIMAL = 0;
+const int PLANNER_CHECK_REACHES_GOAL = 1;
+
+//number of paths kept by 'PathCacheEngine'; more than the queries on a map, so the repeated queries are answered from the cache
+const unsigned int PLANNER_SUITE_PATH_CACHE_CAPACITY = 64;
+
+//'RealTimeSearchEngine' gives up after this many moves per field of the map
+const int PLANNER_SUITE_MOVES_PER_FIELD = 100;
+
+//<summary>
+//Base class for the planners compared by the suite. Each planner is prepared once per map (outside of the measured time)
+//and then answers shortest path queries; a new planner variant is added to the suite by deriving a class from this one.
+//</summary>
+class PlannerEngine
+{
+public:
+	PlannerEngine();
+	virtual ~PlannerEngine() {}
+
+	//prepares the planner for a map
+	virtual void Prepare(const vector<vector<double>>& worldMap) = 0;
+
+	//finds a shortest path; returns an empty path if there is none
+	virtual vector<Coordinates2D> FindPath(Coordinates2D source, Coordinates2D destination) = 0;
+
+	//name used in the report and in the baseline file
+	string Name;
+
+	//how the paths are checked (one of the 'PLANNER_CHECK_' constants)
+	int Check;
+};
+
+//<summary>
+//'AStarLibrary::AStar' reading the costs from 'AStarLibrary::WorldMap', with one of the 'HEURISTIC_' heuristics.
+//</summary>
+class AStarEngine : public PlannerEngine
+{
+public:
+	AStarEngine(int heuristic = HEURISTIC_EUCLIDEAN);
+	void Prepare(const vector<vector<double>>& worldMap);
+	vector<Coordinates2D> FindPath(Coordinates2D source, Coordinates2D destination);
+
+private:
+	AStarLibrary library;
+};
+
+//<summary>
+//'AStarLibrary::AStar' reading the costs from a snapshot of a versioned map.
+//</summary>
+class SnapshotAStarEngine : public PlannerEngine
+{
+public:
+	SnapshotAStarEngine();
+	void Prepare(const vector<vector<double>>& worldMap);
+	vector<Coordinates2D> FindPath(Coordinates2D source, Coordinates2D destination);
+
+private:
+	VersionedWorldMap map;
+	shared_ptr<const WorldMapSnapshot> snapshot;
+	AStarLibrary library;
+};
+
+//<summary>
+//'AStarLibrary::AStar' reading the costs from a tiled map file with only a few tiles kept in memory.
+//</summary>
+class TiledAStarEngine : public PlannerEngine
+{
+public:
+	TiledAStarEngine();
+	~TiledAStarEngine();
+	void Prepare(const vector<vector<double>>& worldMap);
+	vector<Coordinates2D> FindPath(Coordinates2D source, Coordinates2D destination);
+
+private:
+	TiledWorldMap tiles;
+	AStarLibrary library;
+};
+
+//<summary>
+//Queries on a contraction hierarchy built for the map.
+//</summary>
+class ContractionHierarchyEngine : public PlannerEngine
+{
+public:
+	ContractionHierarchyEngine();
+	void Prepare(const vector<vector<double>>& worldMap);
+	vector<Coordinates2D> FindPath(Coordinates2D source, Coordinates2D destination);
+
+private:
+	ContractionHierarchy hierarchy;
+};
+
+//<summary>
+//'AStarLibrary::AStar' whose paths are stored in a 'PathCache'; the queries that are repeated
+//(or that lie on a cached path) are answered from the cache.
+//</summary>
+class PathCacheEngine : public PlannerEngine
+{
+public:
+	PathCacheEngine();
+	void Prepare(const vector<vector<double>>& worldMap);
+	vector<Coordinates2D> FindPath(Coordinates2D source, Coordinates2D destination);
+
+private:
+	AStarLibrary library;
+	PathCache cache;
+
+	//version of the map, incremented by each 'Prepare'
+	unsigned int mapVersion;
+};
+
+//<summary>
+//'CoarseToFinePlanner::FindPath' with its default level and corridor. Its paths aren't guaranteed to be shortest paths
+//(a narrow corridor can miss the shortest path by far), so only reaching the destination is checked.
+//</summary>
+class CoarseToFineEngine : public PlannerEngine
+{
+public:
+	CoarseToFineEngine();
+	void Prepare(const vector<vector<double>>& worldMap);
+	vector<Coordinates2D> FindPath(Coordinates2D source, Coordinates2D destination);
+
+private:
+	CoarseToFinePlanner planner;
+};
+
+//<summary>
+//'LatticePlanner::Plan' starting with the robot heading north. The planner minimizes the travel time including the turns,
+//not the path cost of the suite, so only reaching the destination is checked; the turns in place are removed from the path.
+//</summary>
+class LatticeEngine : public PlannerEngine
+{
+public:
+	LatticeEngine();
+	void Prepare(const vector<vector<double>>& worldMap);
+	vector<Coordinates2D> FindPath(Coordinates2D source, Coordinates2D destination);
+
+private:
+	LatticePlanner planner;
+};
+
+//<summary>
+//'RealTimeSearch::NextMove' called until the robot reaches the destination; the path is the sequence of visited fields.
+//The robot may go back and forth while it learns the heuristic, so only reaching the destination is checked.
+//The learned heuristic values are kept between the queries, like on a robot that drives to the same destinations again.
+//</summary>
+class RealTimeSearchEngine : public PlannerEngine
+{
+public:
+	RealTimeSearchEngine();
+	void Prepare(const vector<vector<double>>& worldMap);
+	vector<Coordinates2D> FindPath(Coordinates2D source, Coordinates2D destination);
+
+private:
+	RealTimeSearch search;
+
+	//maximum number of moves of a query
+	int maximumNumberOfMoves;
+};
+
+
+//<summary>
+//Default constructor; the paths of the planner have to be shortest paths.
+//</summary>
+PlannerEngine::PlannerEngine()
+{
+	this->Check = PLANNER_CHECK_OPTIMAL;
+}
+
+
+//<summary>
+//Creates an engine searching with 'heuristic'; all heuristics are admissible on the maps of the suite, whose
+//field costs are at least 1, so the paths have to be shortest paths with each of them.
+//</summary>
+AStarEngine::AStarEngine(int heuristic)
+{
+	this->library.Heuristic = heuristic;
+	if(heuristic == HEURISTIC_MANHATTAN)
+		this->Name = "AStar Manhattan";
+	else if(heuristic == HEURISTIC_CHEBYSHEV)
+		this->Name = "AStar Chebyshev";
+	else
+		this->Name = "AStar";
+}
+
+void AStarEngine::Prepare(const vector<vector<double>>& worldMap)
+{
+	this->library.WorldMap = worldMap;
+}
+
+vector<Coordinates2D> AStarEngine::FindPath(Coordinates2D source, Coordinates2D destination)
+{
+	return this->library.AStar(source, destination).ShortestPath;
+}
+
+SnapshotAStarEngine::SnapshotAStarEngine()
+{
+	this->Name = "AStar on snapshot";
+}
+
+//<summary>
+//Loads the map as the first version of a versioned map and searches on its snapshot.
+//</summary>
+void SnapshotAStarEngine::Prepare(const vector<vector<double>>& worldMap)
+{
+	this->map.Load(worldMap, 1);
+	this->snapshot = this->map.GetSnapshot();
+	this->library.Snapshot = this->snapshot.get();
+}
+
+vector<Coordinates2D> SnapshotAStarEngine::FindPath(Coordinates2D source, Coordinates2D destination)
+{
+	return this->library.AStar(source, destination).ShortestPath;
+}
+
+TiledAStarEngine::TiledAStarEngine()
+{
+	this->Name = "AStar on tiled map";
+}
+
+//<summary>
+//Destructor; closes and removes the tiled map file.
+//</summary>
+TiledAStarEngine::~TiledAStarEngine()
+{
+	this->tiles.Close();
+	remove(PLANNER_SUITE_TILED_MAP_FILE);
+}
+
+//<summary>
+//Writes the map to a tiled map file and opens it with at most four tiles in memory.
+//</summary>
+void TiledAStarEngine::Prepare(const vector<vector<double>>& worldMap)
+{
+	this->tiles.Close();
+	TiledWorldMap::WriteToFile(worldMap, PLANNER_SUITE_TILED_MAP_FILE);
+	this->tiles.Open(PLANNER_SUITE_TILED_MAP_FILE, 4);
+	this->library.Tiles = &this->tiles;
+}
+
+vector<Coordinates2D> TiledAStarEngine::FindPath(Coordinates2D source, Coordinates2D destination)
+{
+	return this->library.AStar(source, destination).ShortestPath;
+}
+
+ContractionHierarchyEngine::ContractionHierarchyEngine()
+{
+	this->Name = "ContractionHierarchy";
+}
+
+void ContractionHierarchyEngine::Prepare(const vector<vector<double>>& worldMap)
+{
+	this->hierarchy.Build(worldMap);
+}
+
+vector<Coordinates2D> ContractionHierarchyEngine::FindPath(Coordinates2D source, Coordinates2D destination)
+{
+	return this->hierarchy.ShortestPath(source, destination).ShortestPath;
+}
+
+PathCacheEngine::PathCacheEngine() : cache(PLANNER_SUITE_PATH_CACHE_CAPACITY)
+{
+	this->Name = "AStar with PathCache";
+	this->mapVersion = 0;
+}
+
+//<summary>
+//Stores the map as a new version and removes the paths of the previous map from the cache.
+//</summary>
+void PathCacheEngine::Prepare(const vector<vector<double>>& worldMap)
+{
+	this->library.WorldMap = worldMap;
+	this->cache.Clear();
+	this->mapVersion++;
+}
+
+vector<Coordinates2D> PathCacheEngine::FindPath(Coordinates2D source, Coordinates2D destination)
+{
+	vector<Coordinates2D> path;
+	if(this->cache.Find(0, this->mapVersion, source, destination, path))
+		return path;
+
+	path = this->library.AStar(source, destination).ShortestPath;
+	if(!path.empty())
+		this->cache.Insert(0, this->mapVersion, path);
+	return path;
+}
+
+CoarseToFineEngine::CoarseToFineEngine()
+{
+	this->Name = "CoarseToFine";
+	this->Check = PLANNER_CHECK_REACHES_GOAL;
+}
+
+void CoarseToFineEngine::Prepare(const vector<vector<double>>& worldMap)
+{
+	this->planner.SetWorldMap(worldMap);
+}
+
+vector<Coordinates2D> CoarseToFineEngine::FindPath(Coordinates2D source, Coordinates2D destination)
+{
+	return this->planner.FindPath(source, destination).ShortestPath;
+}
+
+LatticeEngine::LatticeEngine()
+{
+	this->Name = "Lattice";
+	this->Check = PLANNER_CHECK_REACHES_GOAL;
+}
+
+void LatticeEngine::Prepare(const vector<vector<double>>& worldMap)
+{
+	this->planner.SetWorldMap(worldMap);
+}
+
+vector<Coordinates2D> LatticeEngine::FindPath(Coordinates2D source, Coordinates2D destination)
+{
+	vector<Coordinates2D> states = this->planner.Plan(source, HEADING_NORTH, destination).ShortestPath;
+
+	//turning in place gives consecutive states on the same field
+	vector<Coordinates2D> path;
+	for(unsigned int i=0; i<states.size(); i++)
+		if(path.empty() || path.back() != states[i])
+			path.push_back(states[i]);
+	return path;
+}
+
+RealTimeSearchEngine::RealTimeSearchEngine()
+{
+	this->Name = "RealTimeSearch";
+	this->Check = PLANNER_CHECK_REACHES_GOAL;
+	this->maximumNumberOfMoves = 0;
+}
+
+//<summary>
+//Stores the map, which forgets the heuristic values learned on the previous one.
+//</summary>
+void RealTimeSearchEngine::Prepare(const vector<vector<double>>& worldMap)
+{
+	this->search.SetWorldMap(worldMap);
+	this->maximumNumberOfMoves = PLANNER_SUITE_MOVES_PER_FIELD * worldMap.size() * worldMap[0].size();
+}
+
+//<summary>
+//Moves the robot from 'source' until it reaches 'destination'; returns an empty path if the search gets stuck
+//or doesn't arrive within the maximum number of moves.
+//</summary>
+vector<Coordinates2D> RealTimeSearchEngine::FindPath(Coordinates2D source, Coordinates2D destination)
+{
+	vector<Coordinates2D> path(1, source);
+	Coordinates2D current = source;
+	for(int move=0; move<this->maximumNumberOfMoves && current != destination; move++)
+	{
+		Coordinates2D next = this->search.NextMove(current, destination);
+		if(next == current)
+			return vector<Coordinates2D>();
+
+		path.push_back(next);
+		current = next;
+	}
+
+	if(current != destination)
+		return vector<Coordinates2D>();
+	return path;
+}
+
+#endif
\ No newline at end of file
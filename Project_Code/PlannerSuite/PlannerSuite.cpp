@@ -0,0 +1,330 @@
+//Differential correctness and performance suite for the planners: every planner answers the same queries on the shipped
+//and on generated maps, the cost of each path is compared with a reference Dijkstra search (it has to be optimal or,
+//for the planners that don't guarantee shortest paths, only lead to the destination) and the time per query
+//is compared with the baseline. The times are measured relative to the reference search, which is timed on the same
+//queries right before each planner, so that the baselines don't depend on the current speed of the machine.
+//Build with: g++ -std=c++11 -O2 PlannerSuite.cpp -o PlannerSuite
+//Usage: PlannerSuite <map directory> <baseline file> [<allowed slowdown in percent> [record]]
+//With 'record', the measured times are written to the baseline file instead of being compared with it.
+//The exit code is 1 if a planner returned a path that failed its check or got slower than allowed.
+
+#include "ReferenceDijkstra.h"
+#include "PlannerEngines.h"
+#include "../AStar/AStar/WorldMapReader.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+using std::cout;
+using std::cerr;
+using std::ifstream;
+using std::ofstream;
+using std::stringstream;
+using std::string;
+using std::vector;
+using std::map;
+using std::shared_ptr;
+using std::sort;
+using std::chrono::high_resolution_clock;
+using std::chrono::duration_cast;
+using std::chrono::nanoseconds;
+
+//number of queries on each map
+const int SUITE_QUERIES_PER_MAP = 20;
+
+//in each round, the queries of a map are answered repeatedly for at least this many seconds, first by the reference search
+//and then by the planner; the median of the ratios of the two times is kept
+const double SUITE_MINIMUM_ROUND_SECONDS = 0.02;
+const int SUITE_NUMBER_OF_ROUNDS = 7;
+
+//path costs may differ from the reference by this much because of rounding
+const double SUITE_COST_TOLERANCE = 1e-6;
+
+//<summary>
+//A map on which the planners are compared.
+//</summary>
+struct SuiteMap
+{
+	string Name;
+	vector<vector<double>> WorldMap;
+};
+
+//<summary>
+//Returns the next number of a linear congruential generator; used instead of 'rand' so that the generated maps
+//and queries are the same with every compiler.
+//</summary>
+unsigned int nextRandom(unsigned int& state)
+{
+	state = state * 1103515245u + 12345u;
+	return (state >> 16) & 0x7FFF;
+}
+
+//<summary>
+//Generates a map with random field costs between 1 and 'maximumCost' and with about 'obstaclePercentage' percent of obstacles.
+//</summary>
+vector<vector<double>> generateMap(int numberOfRows, int numberOfColumns, int maximumCost, int obstaclePercentage, unsigned int seed)
+{
+	vector<vector<double>> worldMap(numberOfRows, vector<double>(numberOfColumns));
+	for(int x=0; x<numberOfRows; x++)
+	{
+		for(int y=0; y<numberOfColumns; y++)
+		{
+			if((int)(nextRandom(seed) % 100) < obstaclePercentage)
+				worldMap[x][y] = 100.0;
+			else
+				worldMap[x][y] = 1.0 + nextRandom(seed) % maximumCost;
+		}
+	}
+
+	return worldMap;
+}
+
+//<summary>
+//Returns the cost of 'path' if it leads from 'source' to 'destination' through adjacent fields of 'worldMap' and -1.0 otherwise.
+//</summary>
+double getPathCost(const vector<vector<double>>& worldMap, const vector<Coordinates2D>& path, Coordinates2D source, Coordinates2D destination)
+{
+	if(path.empty() || path.front() != source || path.back() != destination)
+		return -1.0;
+
+	double cost = 0.0;
+	for(unsigned int i=1; i<path.size(); i++)
+	{
+		if(abs(path[i].X - path[i-1].X) + abs(path[i].Y - path[i-1].Y) != 1)
+			return -1.0;
+		if(path[i].X < 0 || path[i].X >= (int)worldMap.size() || path[i].Y < 0 || path[i].Y >= (int)worldMap[0].size())
+			return -1.0;
+
+		cost += worldMap[path[i].X][path[i].Y];
+	}
+
+	return cost;
+}
+
+//<summary>
+//Reads the baselines ("planner;map;time relative to the reference search" on each line) from 'filename'; a missing file means no baselines.
+//</summary>
+map<string, double> readBaselines(const char* filename)
+{
+	map<string, double> baselines;
+	ifstream document(filename);
+	string line;
+	while(getline(document, line))
+	{
+		size_t separator = line.rfind(';');
+		if(separator == string::npos)
+			continue;
+
+		baselines[line.substr(0, separator)] = atof(line.substr(separator + 1).c_str());
+	}
+
+	return baselines;
+}
+
+//<summary>
+//Answers all queries with 'findPath' 'repetitions' times and returns the time per query in microseconds.
+//</summary>
+template <typename PathFunction>
+double measureMicroseconds(const vector<Coordinates2D>& sources, const vector<Coordinates2D>& destinations, PathFunction findPath, int repetitions)
+{
+	high_resolution_clock::time_point start = high_resolution_clock::now();
+	for(int r=0; r<repetitions; r++)
+		for(unsigned int q=0; q<sources.size(); q++)
+			findPath(sources[q], destinations[q]);
+
+	return duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1e3 / (repetitions * sources.size());
+}
+
+//<summary>
+//Returns the number of repetitions of all queries after which 'findPath' has run for at least 'SUITE_MINIMUM_ROUND_SECONDS'.
+//</summary>
+template <typename PathFunction>
+int calibrateRepetitions(const vector<Coordinates2D>& sources, const vector<Coordinates2D>& destinations, PathFunction findPath)
+{
+	int repetitions = 1;
+	while(measureMicroseconds(sources, destinations, findPath, repetitions) * repetitions * sources.size() < SUITE_MINIMUM_ROUND_SECONDS * 1e6)
+		repetitions *= 2;
+
+	return repetitions;
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 3)
+	{
+		cerr << "usage: " << argv[0] << " <map directory> <baseline file> [<allowed slowdown in percent> [record]]\n";
+		return 1;
+	}
+
+	string mapDirectory = argv[1];
+	if(!mapDirectory.empty() && mapDirectory[mapDirectory.size() - 1] != '/' && mapDirectory[mapDirectory.size() - 1] != '\\')
+		mapDirectory += "/";
+	double allowedSlowdown = argc > 3 ? atof(argv[3]) : 20.0;
+	bool record = argc > 4 && string(argv[4]) == "record";
+
+	vector<SuiteMap> maps;
+	try
+	{
+		const char* shippedMaps[] = { "worldMap 5x5.txt", "worldMap 10x10.txt", "worldMap 50x50.txt" };
+		for(int i=0; i<3; i++)
+		{
+			SuiteMap suiteMap;
+			suiteMap.Name = shippedMaps[i];
+			suiteMap.WorldMap = WorldMapReader::ReadFromFile((mapDirectory + shippedMaps[i]).c_str(), ',');
+			maps.push_back(suiteMap);
+		}
+	}
+	catch(const char* error)
+	{
+		cerr << error << "\n";
+		return 1;
+	}
+
+	SuiteMap generatedMap;
+	generatedMap.Name = "generated 64x64";
+	generatedMap.WorldMap = generateMap(64, 64, 9, 20, 1);
+	maps.push_back(generatedMap);
+	generatedMap.Name = "generated 40x120";
+	generatedMap.WorldMap = generateMap(40, 120, 3, 35, 2);
+	maps.push_back(generatedMap);
+
+	vector<shared_ptr<PlannerEngine>> engines;
+	engines.push_back(shared_ptr<PlannerEngine>(new AStarEngine()));
+	engines.push_back(shared_ptr<PlannerEngine>(new AStarEngine(HEURISTIC_MANHATTAN)));
+	engines.push_back(shared_ptr<PlannerEngine>(new AStarEngine(HEURISTIC_CHEBYSHEV)));
+	engines.push_back(shared_ptr<PlannerEngine>(new SnapshotAStarEngine()));
+	engines.push_back(shared_ptr<PlannerEngine>(new TiledAStarEngine()));
+	engines.push_back(shared_ptr<PlannerEngine>(new ContractionHierarchyEngine()));
+	engines.push_back(shared_ptr<PlannerEngine>(new PathCacheEngine()));
+	engines.push_back(shared_ptr<PlannerEngine>(new CoarseToFineEngine()));
+	engines.push_back(shared_ptr<PlannerEngine>(new LatticeEngine()));
+	engines.push_back(shared_ptr<PlannerEngine>(new RealTimeSearchEngine()));
+
+	map<string, double> baselines = readBaselines(argv[2]);
+	map<string, double> measurements;
+	bool failed = false;
+
+	cout.setf(std::ios::fixed);
+	cout.precision(2);
+	for(unsigned int m=0; m<maps.size(); m++)
+	{
+		const vector<vector<double>>& worldMap = maps[m].WorldMap;
+		int numberOfRows = worldMap.size();
+		int numberOfColumns = worldMap[0].size();
+
+		//the queries and their reference costs are the same for all planners
+		unsigned int seed = 1000 + m;
+		vector<Coordinates2D> sources, destinations;
+		vector<double> referenceCosts;
+		for(int q=0; q<SUITE_QUERIES_PER_MAP; q++)
+		{
+			sources.push_back(Coordinates2D(nextRandom(seed) % numberOfRows, nextRandom(seed) % numberOfColumns));
+			destinations.push_back(Coordinates2D(nextRandom(seed) % numberOfRows, nextRandom(seed) % numberOfColumns));
+			referenceCosts.push_back(ReferenceDijkstra::FindPathCost(worldMap, sources[q], destinations[q]));
+		}
+
+		for(unsigned int e=0; e<engines.size(); e++)
+		{
+			PlannerEngine& engine = *engines[e];
+			try
+			{
+				engine.Prepare(worldMap);
+			}
+			catch(const char* error)
+			{
+				cout << engine.Name << " on " << maps[m].Name << ": " << error << "\n";
+				failed = true;
+				continue;
+			}
+
+			//the highest ratio of a path cost to the shortest path cost, reported for the planners that aren't checked for optimality
+			int wrongPaths = 0;
+			double worstCostRatio = 1.0;
+			for(int q=0; q<SUITE_QUERIES_PER_MAP; q++)
+			{
+				vector<Coordinates2D> path = engine.FindPath(sources[q], destinations[q]);
+				double cost = path.empty() ? -1.0 : getPathCost(worldMap, path, sources[q], destinations[q]);
+				bool wrongPath;
+				if(referenceCosts[q] < 0.0 || cost < 0.0)
+					wrongPath = referenceCosts[q] >= 0.0 || !path.empty();
+				else
+					wrongPath = engine.Check == PLANNER_CHECK_OPTIMAL && fabs(cost - referenceCosts[q]) > SUITE_COST_TOLERANCE;
+
+				if(cost > 0.0 && referenceCosts[q] > 0.0 && cost / referenceCosts[q] > worstCostRatio)
+					worstCostRatio = cost / referenceCosts[q];
+
+				if(wrongPath)
+				{
+					if(wrongPaths == 0)
+						cout << engine.Name << " on " << maps[m].Name << ": path from (" << sources[q].X << "," << sources[q].Y << ") to ("
+							 << destinations[q].X << "," << destinations[q].Y << ") costs " << cost << ", reference " << referenceCosts[q] << "\n";
+					wrongPaths++;
+				}
+			}
+
+			//the reference search is timed right before the planner in each round, so that both see the same speed of the machine
+			auto findReferencePath = [&worldMap](Coordinates2D source, Coordinates2D destination) { return ReferenceDijkstra::FindPathCost(worldMap, source, destination); };
+			auto findEnginePath = [&engine](Coordinates2D source, Coordinates2D destination) { return engine.FindPath(source, destination); };
+			int referenceRepetitions = calibrateRepetitions(sources, destinations, findReferencePath);
+			int engineRepetitions = calibrateRepetitions(sources, destinations, findEnginePath);
+
+			vector<double> ratios, times;
+			for(int round=0; round<SUITE_NUMBER_OF_ROUNDS; round++)
+			{
+				double referenceMicroseconds = measureMicroseconds(sources, destinations, findReferencePath, referenceRepetitions);
+				times.push_back(measureMicroseconds(sources, destinations, findEnginePath, engineRepetitions));
+				ratios.push_back(times.back() / referenceMicroseconds);
+			}
+			sort(ratios.begin(), ratios.end());
+			sort(times.begin(), times.end());
+			double microseconds = times[SUITE_NUMBER_OF_ROUNDS / 2];
+			double relativeTime = ratios[SUITE_NUMBER_OF_ROUNDS / 2];
+
+			string key = engine.Name + ";" + maps[m].Name;
+			measurements[key] = relativeTime;
+
+			const char* checkNames[] = { "optimal", "reaches goal" };
+			const char* failedCheckNames[] = { "NOT OPTIMAL", "DOESN'T REACH GOAL" };
+			cout << engine.Name << " on " << maps[m].Name << ": " << (wrongPaths == 0 ? checkNames[engine.Check] : failedCheckNames[engine.Check]);
+			if(engine.Check != PLANNER_CHECK_OPTIMAL)
+				cout << " (worst cost " << worstCostRatio << " x shortest)";
+			cout << ", " << microseconds << " us per query, " << relativeTime << " x reference";
+			if(wrongPaths > 0)
+				failed = true;
+
+			map<string, double>::iterator baseline = baselines.find(key);
+			if(!record && baseline != baselines.end() && baseline->second > 0.0)
+			{
+				double change = (relativeTime / baseline->second - 1.0) * 100.0;
+				cout << " (baseline " << baseline->second << ", " << (change >= 0.0 ? "+" : "") << change << "%)";
+				if(change > allowedSlowdown)
+				{
+					cout << " SLOWER THAN ALLOWED";
+					failed = true;
+				}
+			}
+			cout << "\n";
+		}
+	}
+
+	if(record)
+	{
+		ofstream document(argv[2]);
+		document.setf(std::ios::fixed);
+		document.precision(4);
+		for(map<string, double>::iterator measurement = measurements.begin(); measurement != measurements.end(); ++measurement)
+			document << measurement->first << ";" << measurement->second << "\n";
+		cout << "baselines written to " << argv[2] << "\n";
+	}
+
+	cout << (failed ? "FAILED" : "PASSED") << "\n";
+	return failed ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#ifndef REFERENCE_DIJKSTRA_H
+#define REFERENCE_DIJKSTRA_H
+
+#include "../AStar/AStar/Coordinates2D.h"
+#include <vector>
+#include <queue>
+#include <utility>
+#include <functional>
+#include <limits>
+using std::vector;
+using std::priority_queue;
+using std::pair;
+using std::make_pair;
+using std::greater;
+using std::numeric_limits;
+
+//<summary>
+//Class with a plain Dijkstra search on a grid, kept as simple as possible so that it can serve as the reference
+//for the costs of the paths found by the planners. Uses the same model as 'AStarLibrary': a field can be left
+//in the four main directions and moving to a field costs the value of the field.
+//</summary>
+class ReferenceDijkstra
+{
+public:
+	//returns the cost of a shortest path between two fields, or -1.0 if there is no path
+	static double FindPathCost(const vector<vector<double>>& worldMap, Coordinates2D source, Coordinates2D destination);
+};
+
+
+//<summary>
+//Returns the cost of a shortest path from 'source' to 'destination' on 'worldMap'.
+//</summary>
+//<param name='worldMap'>A logical grid.</param>
+//<param name='source'>Object containing the grid coordinates of the source field.</param>
+//<param name='destination'>Object containing the grid coordinates of the destination field.</param>
+//<returns>The sum of the costs of all fields on the path except the source, or -1.0 if the destination can't be reached.</returns>
+double ReferenceDijkstra::FindPathCost(const vector<vector<double>>& worldMap, Coordinates2D source, Coordinates2D destination)
+{
+	const int X_OFFSETS[4] = { -1, 0, 1, 0 };
+	const int Y_OFFSETS[4] = { 0, 1, 0, -1 };
+
+	int numberOfRows = worldMap.size();
+	int numberOfColumns = worldMap[0].size();
+	vector<double> cost(numberOfRows * numberOfColumns, numeric_limits<double>::infinity());
+	priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> open;
+
+	int destinationIndex = destination.X * numberOfColumns + destination.Y;
+	cost[source.X * numberOfColumns + source.Y] = 0.0;
+	open.push(make_pair(0.0, source.X * numberOfColumns + source.Y));
+
+	while(!open.empty())
+	{
+		pair<double, int> entry = open.top();
+		open.pop();
+		if(entry.first > cost[entry.second])
+			continue;
+		if(entry.second == destinationIndex)
+			return entry.first;
+
+		int x = entry.second / numberOfColumns;
+		int y = entry.second % numberOfColumns;
+		for(int i=0; i<4; i++)
+		{
+			int newX = x + X_OFFSETS[i];
+			int newY = y + Y_OFFSETS[i];
+			if(newX < 0 || newX >= numberOfRows || newY < 0 || newY >= numberOfColumns)
+				continue;
+
+			double newCost = entry.first + worldMap[newX][newY];
+			if(newCost < cost[newX * numberOfColumns + newY])
+			{
+				cost[newX * numberOfColumns + newY] = newCost;
+				open.push(make_pair(newCost, newX * numberOfColumns + newY));
+			}
+		}
+	}
+
+	return -1.0;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,137 @@
+//Command line tool that searches a path on a world map and saves the grid, the expanded fields and the path as an image,
+//without opening a window, so that searches can be inspected on machines without a display.
+//Build on Linux with: g++ -std=c++11 -O2 RasterExport.cpp -o RasterExport
+//Usage: RasterExport <map file> <source x> <source y> <destination x> <destination y> <image file (.png or .ppm)> [<pixels per field> [<events per frame>]]
+//If the number of events per frame is given, the search is recorded and replayed, and each frame is saved as <image file>
+//with the number of the frame inserted before the extension.
+
+#include "../AStar/AStar/AStarLibrary.h"
+#include "../AStar/AStar/WorldMapReader.h"
+#include "../AStar/AStar/RasterExporter.h"
+#include "../AStar/AStar/SearchTrace.h"
+#include "../AStar/AStar/SearchReplay.h"
+#include <iostream>
+#include <string>
+#include <exception>
+#include <cstdlib>
+#include <cstdio>
+
+using std::cout;
+using std::cerr;
+using std::string;
+using std::exception;
+
+//<summary>
+//Prints how the tool is used to the error output.
+//</summary>
+void printUsage(const char* program)
+{
+	cerr << "usage: " << program << " <map file> <source x> <source y> <destination x> <destination y> <image file> [<pixels per field> [<events per frame>]]\n";
+	cerr << "the coordinates have to lie on the map and the number of pixels per field has to be at least 1\n";
+}
+
+//<summary>
+//Writes the rendered image of 'exporter' as a PPM file if 'filename' ends with ".ppm" and as a PNG file otherwise.
+//</summary>
+void writeImage(RasterExporter& exporter, const string& filename)
+{
+	if(filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".ppm") == 0)
+		exporter.WritePpm(filename.c_str());
+	else
+		exporter.WritePng(filename.c_str());
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 7)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	int cellSize = argc > 7 ? atoi(argv[7]) : 0;
+	if(argc > 7 && cellSize < 1)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	try
+	{
+		AStarLibrary aStarLibrary;
+		aStarLibrary.WorldMap = WorldMapReader::ReadFromFile(argv[1], ',');
+
+		Coordinates2D source, destination;
+		source.X = atoi(argv[2]);
+		source.Y = atoi(argv[3]);
+		destination.X = atoi(argv[4]);
+		destination.Y = atoi(argv[5]);
+
+		int numberOfRows = aStarLibrary.WorldMap.size();
+		int numberOfColumns = numberOfRows > 0 ? aStarLibrary.WorldMap[0].size() : 0;
+		if(source.X < 0 || source.X >= numberOfRows || source.Y < 0 || source.Y >= numberOfColumns
+		|| destination.X < 0 || destination.X >= numberOfRows || destination.Y < 0 || destination.Y >= numberOfColumns)
+		{
+			printUsage(argv[0]);
+			return 1;
+		}
+
+		int eventsPerFrame = argc > 8 ? atoi(argv[8]) : 0;
+		SearchTrace trace;
+		if(eventsPerFrame > 0)
+			aStarLibrary.Trace = &trace;
+		AStarResult result = aStarLibrary.AStar(source, destination);
+
+		RasterExporter exporter;
+		if(argc > 7)
+			exporter.CellSize = cellSize;
+
+		string imageFile = argv[6];
+		cout << "path length: " << result.ShortestPath.size() << ", expanded fields: " << result.ExpandedNodes.size() << "\n";
+		if(eventsPerFrame <= 0)
+		{
+			exporter.Render(aStarLibrary.WorldMap, result);
+			writeImage(exporter, imageFile);
+			cout << "image: " << exporter.Width << " x " << exporter.Height << " pixels\n";
+			return 0;
+		}
+
+		AStarVisualWorldMap worldMap;
+		worldMap.SetVisualMap(aStarLibrary.WorldMap);
+		worldMap.SetSearchResult(result);
+
+		SearchReplay replay;
+		replay.Load(trace.Data.empty() ? NULL : &trace.Data[0], trace.Data.size());
+		replay.Restart(worldMap);
+
+		size_t extension = imageFile.rfind('.');
+		if(extension == string::npos)
+			extension = imageFile.size();
+
+		int numberOfFrames = 0;
+		do
+		{
+			replay.Step(worldMap, eventsPerFrame);
+			exporter.Render(worldMap);
+
+			char frameNumber[16];
+			sprintf(frameNumber, "_%05d", numberOfFrames++);
+			writeImage(exporter, imageFile.substr(0, extension) + frameNumber + imageFile.substr(extension));
+		}
+		while(!replay.Finished());
+
+		cout << "events: " << trace.NumberOfEvents << " (" << trace.Data.size() << " bytes), frames: " << numberOfFrames << "\n";
+	}
+	catch(const char* error)
+	{
+		cerr << error << "\n";
+		return 1;
+	}
+	catch(const exception& error)
+	{
+		cerr << error.what() << "\n";
+		return 1;
+	}
+
+	return 0;
+}
\ No newline at end of file